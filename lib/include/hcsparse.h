@@ -117,6 +117,20 @@ enum hcsparseAction_t : uint32_t{
   HCSPARSE_ACTION_NUMERIC = 1
 };
 
+// 2.2.11 hcsparseSolveAnalysisInfo_t
+
+// This is a pointer to an opaque structure holding the result of the analysis
+// phase of the triangular solves, see hcsparseXcsrsv_analysis().
+
+typedef struct hcsparseSolveAnalysisInfo* hcsparseSolveAnalysisInfo_t;
+
+// 2.2.12 hcsparseRapInfo_t
+
+// This is a pointer to an opaque structure holding the pattern of a Galerkin
+// product P^T*A*P found by hcsparseXcsrRapSymbolic(), reused by the numeric phase.
+
+typedef struct hcsparseRapInfo* hcsparseRapInfo_t;
+
 // hcsparse Helper functions 
 
 // 1. hcsparseCreate()
@@ -733,6 +747,172 @@ hcsparseDcsrgeam(hcsparseHandle_t handle,
                  int *csrRowPtrC, 
                  int *csrColIndC);
 
+// 19. hcsparseXcsrsort()
+
+// This function sorts the column indices of each row of a CSR matrix
+// in place. If P is not null it is permuted along with the column
+// indices, so that starting from the identity permutation the values
+// can afterwards be reordered with hcsparseXgthr().
+
+// Return Values
+// ----------------------------------------------------------------------
+// HCSPARSE_STATUS_SUCCESS              the operation completed successfully.
+// HCSPARSE_STATUS_NOT_INITIALIZED      the library was not initialized.
+// HCSPARSE_STATUS_ALLOC_FAILED         the resources could not be allocated.
+// HCSPARSE_STATUS_INVALID_VALUE        invalid parameters were passed (m, n, nnz<0).
+// HCSPARSE_STATUS_EXECUTION_FAILED     the function failed to launch on the GPU.
+
+hcsparseStatus_t
+hcsparseXcsrsort(hcsparseHandle_t handle, int m, int n, int nnz,
+                 const hcsparseMatDescr_t descrA,
+                 const int *csrRowPtrA, int *csrColIndA, int *P);
+
+// 20. hcsparseCreateIdentityPermutation()
+
+// This function fills p with the identity permutation 0, 1, ..., n-1.
+
+// Return Values
+// ----------------------------------------------------------------------
+// HCSPARSE_STATUS_SUCCESS              the operation completed successfully.
+// HCSPARSE_STATUS_NOT_INITIALIZED      the library was not initialized.
+// HCSPARSE_STATUS_INVALID_VALUE        invalid parameters were passed (n<0).
+
+hcsparseStatus_t
+hcsparseCreateIdentityPermutation(hcsparseHandle_t handle, int n, int *p);
+
+// 21. hcsparseXgthr()
+
+// This function gathers the elements of the dense vector y
+// listed in xInd into the sparse vector xVal:
+// xVal[i] = y[xInd[i]]
+
+// Return Values
+// ----------------------------------------------------------------------
+// HCSPARSE_STATUS_SUCCESS              the operation completed successfully.
+// HCSPARSE_STATUS_NOT_INITIALIZED      the library was not initialized.
+// HCSPARSE_STATUS_INVALID_VALUE        invalid parameters were passed (nnz<0, idxBase is neither ZERO nor ONE).
+// HCSPARSE_STATUS_EXECUTION_FAILED     the function failed to launch on the GPU.
+
+hcsparseStatus_t
+hcsparseSgthr(hcsparseHandle_t handle, int nnz, const float *y,
+              float *xVal, const int *xInd, hcsparseIndexBase_t idxBase);
+
+hcsparseStatus_t
+hcsparseDgthr(hcsparseHandle_t handle, int nnz, const double *y,
+              double *xVal, const int *xInd, hcsparseIndexBase_t idxBase);
+
+// 22. hcsparseCreateSolveAnalysisInfo()
+
+// This function creates and initializes the analysis structure
+// used by the triangular solves.
+
+// Return Values
+// ----------------------------------------------------------------------
+// HCSPARSE_STATUS_SUCCESS              the structure was initialized successfully.
+// HCSPARSE_STATUS_ALLOC_FAILED         the resources could not be allocated.
+
+hcsparseStatus_t
+hcsparseCreateSolveAnalysisInfo(hcsparseSolveAnalysisInfo_t *info);
+
+// 23. hcsparseDestroySolveAnalysisInfo()
+
+// This function destroys and releases any memory held by the analysis structure.
+
+// Return Values
+// ----------------------------------------------------------------------
+// HCSPARSE_STATUS_SUCCESS              the resources were released successfully.
+
+hcsparseStatus_t
+hcsparseDestroySolveAnalysisInfo(hcsparseSolveAnalysisInfo_t info);
+
+// 24. hcsparseXcsrsv_analysis()
+
+// This function performs the analysis phase of the triangular solves
+// op(A) * y = α * x and op(A) * Y = α * X, where A is the lower or upper
+// triangle of an m×m CSR matrix, as selected by the FillMode of descrA.
+// The rows are grouped into levels that only depend on rows of earlier
+// levels; the levels are stored in info and only depend on the sparsity
+// pattern, so they can be reused for any values on the same pattern.
+// Only HCSPARSE_OPERATION_NON_TRANSPOSE is supported.
+
+// Return Values
+// ----------------------------------------------------------------------
+// HCSPARSE_STATUS_SUCCESS              the operation completed successfully.
+// HCSPARSE_STATUS_NOT_INITIALIZED      the library was not initialized.
+// HCSPARSE_STATUS_ALLOC_FAILED         the resources could not be allocated.
+// HCSPARSE_STATUS_INVALID_VALUE        invalid parameters were passed (m, nnz<0).
+// HCSPARSE_STATUS_EXECUTION_FAILED     the function failed to launch on the GPU.
+
+hcsparseStatus_t
+hcsparseXcsrsv_analysis(hcsparseHandle_t handle, hcsparseOperation_t transA,
+                        int m, int nnz, const hcsparseMatDescr_t descrA,
+                        const int *csrRowPtrA, const int *csrColIndA,
+                        hcsparseSolveAnalysisInfo_t info);
+
+// 25. hcsparseXcsrsv_solve()
+
+// This function performs the solve phase of
+// op(A) * y = α * x
+// with the levels computed by hcsparseXcsrsv_analysis(). The FillMode and
+// IndexBase of descrA must match the analysis; DiagType selects the unit
+// or non-unit diagonal. x and y may point to the same vector.
+
+// Return Values
+// ----------------------------------------------------------------------
+// HCSPARSE_STATUS_SUCCESS              the operation completed successfully.
+// HCSPARSE_STATUS_NOT_INITIALIZED      the library was not initialized.
+// HCSPARSE_STATUS_ALLOC_FAILED         the resources could not be allocated.
+// HCSPARSE_STATUS_INVALID_VALUE        invalid parameters were passed (m<0, info does not match descrA).
+// HCSPARSE_STATUS_EXECUTION_FAILED     the function failed to launch on the GPU.
+
+hcsparseStatus_t
+hcsparseScsrsv_solve(hcsparseHandle_t handle, hcsparseOperation_t transA,
+                     int m, const float *alpha,
+                     const hcsparseMatDescr_t descrA,
+                     const float *csrValA, const int *csrRowPtrA,
+                     const int *csrColIndA, hcsparseSolveAnalysisInfo_t info,
+                     const float *x, float *y);
+
+hcsparseStatus_t
+hcsparseDcsrsv_solve(hcsparseHandle_t handle, hcsparseOperation_t transA,
+                     int m, const double *alpha,
+                     const hcsparseMatDescr_t descrA,
+                     const double *csrValA, const int *csrRowPtrA,
+                     const int *csrColIndA, hcsparseSolveAnalysisInfo_t info,
+                     const double *x, double *y);
+
+// 26. hcsparseXcsrsm_solve()
+
+// This function performs the solve phase of
+// op(A) * Y = α * X
+// for the n columns of the dense column major matrices X and Y, reusing
+// the levels computed by hcsparseXcsrsv_analysis(). X and Y may be the
+// same matrix when ldx equals ldy.
+
+// Return Values
+// ----------------------------------------------------------------------
+// HCSPARSE_STATUS_SUCCESS              the operation completed successfully.
+// HCSPARSE_STATUS_NOT_INITIALIZED      the library was not initialized.
+// HCSPARSE_STATUS_ALLOC_FAILED         the resources could not be allocated.
+// HCSPARSE_STATUS_INVALID_VALUE        invalid parameters were passed (m, n<0, ldx or ldy<m, info does not match descrA).
+// HCSPARSE_STATUS_EXECUTION_FAILED     the function failed to launch on the GPU.
+
+hcsparseStatus_t
+hcsparseScsrsm_solve(hcsparseHandle_t handle, hcsparseOperation_t transA,
+                     int m, int n, const float *alpha,
+                     const hcsparseMatDescr_t descrA,
+                     const float *csrValA, const int *csrRowPtrA,
+                     const int *csrColIndA, hcsparseSolveAnalysisInfo_t info,
+                     const float *X, int ldx, float *Y, int ldy);
+
+hcsparseStatus_t
+hcsparseDcsrsm_solve(hcsparseHandle_t handle, hcsparseOperation_t transA,
+                     int m, int n, const double *alpha,
+                     const hcsparseMatDescr_t descrA,
+                     const double *csrValA, const int *csrRowPtrA,
+                     const int *csrColIndA, hcsparseSolveAnalysisInfo_t info,
+                     const double *X, int ldx, double *Y, int ldy);
+
 
     /*!
     * \brief Initialize the hcsparse library
@@ -778,6 +958,30 @@ hcsparseDcsrgeam(hcsparseHandle_t handle,
     */
     hcsparseStatus hcsparseInitVector( hcdenseVector* vec );
 
+    /*!
+    * \brief Initialize a sparse vector structure to be used in the hcsparse library
+    * \note It is users responsibility to allocate OpenCL device memory
+    *
+    * \param[out] vec  Sparse vector structure to be initialized
+    *
+    * \returns \b hcsparseSuccess
+    *
+    * \ingroup INIT
+    */
+    hcsparseStatus hcsparseInitSparseVector( hcsparseVector* vec );
+
+    /*!
+    * \brief Initialize a mask structure to be used in the hcsparse library: no mask set,
+    * not complemented
+    *
+    * \param[out] mask  Mask structure to be initialized
+    *
+    * \returns \b hcsparseSuccess
+    *
+    * \ingroup INIT
+    */
+    hcsparseStatus hcsparseInitMask( hcsparseMask* mask );
+
     /*!
     * \brief Initialize a sparse matrix COO structure to be used in the hcsparse library
     * \note It is users responsibility to allocate OpenCL device memory
@@ -888,6 +1092,99 @@ hcsparseDcsrgeam(hcsparseHandle_t handle,
     hcsparseStatus
         hcsparseSolverPrintMode( hcsparseSolverControl* solverControl, PRINT_MODE mode );
 
+    /*!
+    * \brief Set how the iterative solvers test for convergence
+    *
+    * \param[in] solverControl  hcsparse object created with hcsparseCreateSolverControl
+    * \param[in] norm A valid enumeration constant from SOLVER_NORM, the norm of the residual
+    * \param[in] checkInterval  Number of iterations between convergence tests, at least 1.
+    * Between tests the solvers run without reading anything back to the host
+    *
+    * \returns \b hcsparseSuccess
+    *
+    * \ingroup SOLVER
+    */
+    hcsparseStatus
+        hcsparseSetSolverConvergence( hcsparseSolverControl* solverControl,
+                                      SOLVER_NORM norm, int checkInterval );
+
+    /*!
+    * \brief Set the restart length of the restarted solvers
+    *
+    * \param[in] solverControl  hcsparse object created with hcsparseCreateSolverControl
+    * \param[in] restart  Dimension of the Krylov subspace built before GMRES restarts,
+    * at least 1. GMRES keeps restart + 3 work vectors
+    *
+    * \returns \b hcsparseSuccess
+    *
+    * \ingroup SOLVER
+    */
+    hcsparseStatus
+        hcsparseSetSolverRestart( hcsparseSolverControl* solverControl, int restart );
+
+    /*!
+    * \brief Set the diagonal blocks of the BLOCK_JACOBI preconditioner
+    *
+    * \param[in] solverControl  hcsparse object created with hcsparseCreateSolverControl
+    * \param[in] blockSize  Rows per block when blockOffsets is NULL, default 4
+    * \param[in] blockOffsets  Optional host array of numBlocks + 1 increasing row
+    * offsets from 0 to the number of rows; it is read when the solver starts.
+    * Blocks are limited to 32 rows, larger ones are split
+    * \param[in] numBlocks  Number of blocks in blockOffsets
+    *
+    * \returns \b hcsparseSuccess, \b hcsparseInvalid for offsets not strictly increasing
+    * from 0; a solve whose matrix does not have blockOffsets[numBlocks] rows also returns
+    * \b hcsparseInvalid
+    *
+    * \ingroup SOLVER
+    */
+    hcsparseStatus
+        hcsparseSetSolverBlocks( hcsparseSolverControl* solverControl, int blockSize,
+                                 const int* blockOffsets, int numBlocks );
+
+    /*!
+    * \brief Create a hcsparseSolverWorkspace holding the device work vectors of the
+    * iterative solvers, so that repeated solves do not allocate
+    *
+    * \param[in] numValues  Number of rows of the systems that will be solved
+    * \param[in] valueSize  sizeof(float) or sizeof(double)
+    *
+    * \returns a new workspace, or nullptr for invalid arguments. Device memory is
+    * allocated by the first solve that uses it
+    *
+    * \ingroup SOLVER
+    */
+    hcsparseSolverWorkspace*
+        hcsparseCreateSolverWorkspace( int numValues, size_t valueSize );
+
+    /*!
+    * \brief Release a hcsparseSolverWorkspace created with hcsparseCreateSolverWorkspace
+    *
+    * \param[in,out] workspace  hcsparse object created with hcsparseCreateSolverWorkspace
+    *
+    * \returns \b hcsparseSuccess
+    *
+    * \ingroup SOLVER
+    */
+    hcsparseStatus
+        hcsparseReleaseSolverWorkspace( hcsparseSolverWorkspace* workspace );
+
+    /*!
+    * \brief Attach a workspace to a hcsparseSolverControl object. Solves run with the
+    * control reuse it when the system size and precision match, otherwise they fall
+    * back to temporary buffers
+    *
+    * \param[in] solverControl  hcsparse object created with hcsparseCreateSolverControl
+    * \param[in] workspace  hcsparse object created with hcsparseCreateSolverWorkspace, or nullptr to detach
+    *
+    * \returns \b hcsparseSuccess
+    *
+    * \ingroup SOLVER
+    */
+    hcsparseStatus
+        hcsparseSetSolverWorkspace( hcsparseSolverControl* solverControl,
+                                    hcsparseSolverWorkspace* workspace );
+
     /*!
     * \brief Execute a single precision Conjugate Gradients solver
     *
@@ -922,6 +1219,308 @@ hcsparseDcsrgeam(hcsparseHandle_t handle,
         hcsparseDcsrcg( hcdenseVector* x, const hcsparseCsrMatrix *A, const hcdenseVector *b,
                         hcsparseSolverControl* solverControl, hcsparseControl *control );
 
+    /*!
+    * \brief Execute a single precision pipelined Conjugate Gradients solver. It has one
+    * global reduction per iteration, fused with the vector updates, instead of two
+    *
+    * \param[in] x  the dense vector to solve for
+    * \param[in] A  a hcsparse CSR matrix with single precision data
+    * \param[in] b  the input dense vector with single precision data
+    * \param[in] solverControl  a valid hcsparseSolverControl object created with hcsparseCreateSolverControl
+    * \param[in] *control A valid hcsparseControl created with hcsparseCreateControl
+    *
+    * \returns \b hcsparseSuccess
+    *
+    * \ingroup SOLVER
+    */
+    hcsparseStatus
+        hcsparseScsrpipecg( hcdenseVector* x, const hcsparseCsrMatrix *A, const hcdenseVector *b,
+                            hcsparseSolverControl* solverControl, hcsparseControl *control );
+
+    /*!
+    * \brief Execute a double precision pipelined Conjugate Gradients solver. It has one
+    * global reduction per iteration, fused with the vector updates, instead of two
+    *
+    * \param[in] x  the dense vector to solve for
+    * \param[in] A  a hcsparse CSR matrix with double precision data
+    * \param[in] b  the input dense vector with double precision data
+    * \param[in] solverControl  a valid hcsparseSolverControl object created with hcsparseCreateSolverControl
+    * \param[in] *control A valid hcsparseControl created with hcsparseCreateControl
+    *
+    * \returns \b hcsparseSuccess
+    *
+    * \ingroup SOLVER
+    */
+    hcsparseStatus
+        hcsparseDcsrpipecg( hcdenseVector* x, const hcsparseCsrMatrix *A, const hcdenseVector *b,
+                            hcsparseSolverControl* solverControl, hcsparseControl *control );
+
+    /*!
+    * \brief Execute a single precision restarted GMRES solver for general matrices.
+    * The restart length is set with hcsparseSetSolverRestart
+    *
+    * \param[in] x  the dense vector to solve for
+    * \param[in] A  a hcsparse CSR matrix with single precision data
+    * \param[in] b  the input dense vector with single precision data
+    * \param[in] solverControl  a valid hcsparseSolverControl object created with hcsparseCreateSolverControl
+    * \param[in] *control A valid hcsparseControl created with hcsparseCreateControl
+    *
+    * \returns \b hcsparseSuccess
+    *
+    * \ingroup SOLVER
+    */
+    hcsparseStatus
+        hcsparseScsrgmres( hcdenseVector* x, const hcsparseCsrMatrix *A, const hcdenseVector *b,
+                           hcsparseSolverControl* solverControl, hcsparseControl *control );
+
+    /*!
+    * \brief Execute a double precision restarted GMRES solver for general matrices.
+    * The restart length is set with hcsparseSetSolverRestart
+    *
+    * \param[in] x  the dense vector to solve for
+    * \param[in] A  a hcsparse CSR matrix with double precision data
+    * \param[in] b  the input dense vector with double precision data
+    * \param[in] solverControl  a valid hcsparseSolverControl object created with hcsparseCreateSolverControl
+    * \param[in] *control A valid hcsparseControl created with hcsparseCreateControl
+    *
+    * \returns \b hcsparseSuccess
+    *
+    * \ingroup SOLVER
+    */
+    hcsparseStatus
+        hcsparseDcsrgmres( hcdenseVector* x, const hcsparseCsrMatrix *A, const hcdenseVector *b,
+                           hcsparseSolverControl* solverControl, hcsparseControl *control );
+
+    /*!
+    * \brief Execute a single precision block Conjugate Gradients solver for many right
+    * hand sides of one SPD matrix. Every iteration applies A to all unconverged columns
+    * in one pass and couples them through small dense Gram matrices; columns are
+    * dropped from the block as they converge. Up to 64 columns iterate together
+    *
+    * \param[in] X  the column major dense matrix to solve for, one column per system
+    * \param[in] A  a hcsparse CSR matrix with single precision data
+    * \param[in] B  the column major dense matrix of right hand sides
+    * \param[in] solverControl  a valid hcsparseSolverControl object created with hcsparseCreateSolverControl.
+    * The tolerances apply to every column's L2 residual, the final residual reported is the
+    * largest one
+    * \param[in] *control A valid hcsparseControl created with hcsparseCreateControl
+    *
+    * \returns \b hcsparseSuccess
+    *
+    * \ingroup SOLVER
+    */
+    hcsparseStatus
+        hcsparseScsrbcg( hcdenseMatrix* X, const hcsparseCsrMatrix *A, const hcdenseMatrix *B,
+                         hcsparseSolverControl* solverControl, hcsparseControl *control );
+
+    /*!
+    * \brief Execute a double precision block Conjugate Gradients solver for many right
+    * hand sides of one SPD matrix. Every iteration applies A to all unconverged columns
+    * in one pass and couples them through small dense Gram matrices; columns are
+    * dropped from the block as they converge. Up to 64 columns iterate together
+    *
+    * \param[in] X  the column major dense matrix to solve for, one column per system
+    * \param[in] A  a hcsparse CSR matrix with double precision data
+    * \param[in] B  the column major dense matrix of right hand sides
+    * \param[in] solverControl  a valid hcsparseSolverControl object created with hcsparseCreateSolverControl.
+    * The tolerances apply to every column's L2 residual, the final residual reported is the
+    * largest one
+    * \param[in] *control A valid hcsparseControl created with hcsparseCreateControl
+    *
+    * \returns \b hcsparseSuccess
+    *
+    * \ingroup SOLVER
+    */
+    hcsparseStatus
+        hcsparseDcsrbcg( hcdenseMatrix* X, const hcsparseCsrMatrix *A, const hcdenseMatrix *B,
+                         hcsparseSolverControl* solverControl, hcsparseControl *control );
+
+    /*!
+    * \brief Execute a mixed precision Conjugate Gradients solver. The residuals and the solution
+    * are kept in double precision while the correction equations are solved by the
+    * single precision solver on a float copy of A, with its own float preconditioner
+    *
+    * \param[in] x  the dense vector to solve for
+    * \param[in] A  a hcsparse CSR matrix with double precision data
+    * \param[in] b  the input dense vector with double precision data
+    * \param[in] solverControl  a valid hcsparseSolverControl object created with hcsparseCreateSolverControl.
+    * The tolerances are reached in double precision; nIters and maxIters count the inner
+    * single precision iterations of all refinement steps
+    * \param[in] *control A valid hcsparseControl created with hcsparseCreateControl
+    *
+    * \returns \b hcsparseSuccess
+    *
+    * \ingroup SOLVER
+    */
+    hcsparseStatus
+        hcsparseDScsrcg( hcdenseVector* x, const hcsparseCsrMatrix *A, const hcdenseVector *b,
+                         hcsparseSolverControl* solverControl, hcsparseControl *control );
+
+    /*!
+    * \brief Execute a mixed precision BiCGStab solver. The residuals and the solution
+    * are kept in double precision while the correction equations are solved by the
+    * single precision solver on a float copy of A, with its own float preconditioner
+    *
+    * \param[in] x  the dense vector to solve for
+    * \param[in] A  a hcsparse CSR matrix with double precision data
+    * \param[in] b  the input dense vector with double precision data
+    * \param[in] solverControl  a valid hcsparseSolverControl object created with hcsparseCreateSolverControl.
+    * The tolerances are reached in double precision; nIters and maxIters count the inner
+    * single precision iterations of all refinement steps
+    * \param[in] *control A valid hcsparseControl created with hcsparseCreateControl
+    *
+    * \returns \b hcsparseSuccess
+    *
+    * \ingroup SOLVER
+    */
+    hcsparseStatus
+        hcsparseDScsrbicgStab( hcdenseVector* x, const hcsparseCsrMatrix *A, const hcdenseVector *b,
+                               hcsparseSolverControl* solverControl, hcsparseControl *control );
+
+    /*!
+    * \brief Compute the k smallest or largest eigenpairs of a single precision symmetric
+    * matrix with block LOBPCG, preconditioned by the solverControl preconditioner.
+    * k is the number of columns of X and may be at most 21
+    *
+    * \param[in,out] X  column major n x k dense matrix, the initial guess on entry and
+    * the eigenvectors on exit
+    * \param[out] lambda  the k eigenvalues, in the order of the columns of X
+    * \param[in] A  a symmetric hcsparse CSR matrix with single precision data
+    * \param[in] which  EIG_SMALLEST or EIG_LARGEST
+    * \param[in] solverControl  a valid hcsparseSolverControl object created with hcsparseCreateSolverControl.
+    * An eigenpair is converged once |A x - lambda x| <= max(relTol * |lambda|, absTol);
+    * maxIters bounds the block iterations
+    * \param[in] *control A valid hcsparseControl created with hcsparseCreateControl
+    *
+    * \returns \b hcsparseSuccess
+    *
+    * \ingroup SOLVER
+    */
+    hcsparseStatus
+        hcsparseScsrlobpcg( hcdenseMatrix* X, hcdenseVector* lambda, const hcsparseCsrMatrix *A,
+                            EIG_WHICH which, hcsparseSolverControl* solverControl,
+                            hcsparseControl *control );
+
+    /*!
+    * \brief Compute the k smallest or largest eigenpairs of a double precision symmetric
+    * matrix with block LOBPCG, preconditioned by the solverControl preconditioner.
+    * k is the number of columns of X and may be at most 21
+    *
+    * \param[in,out] X  column major n x k dense matrix, the initial guess on entry and
+    * the eigenvectors on exit
+    * \param[out] lambda  the k eigenvalues, in the order of the columns of X
+    * \param[in] A  a symmetric hcsparse CSR matrix with double precision data
+    * \param[in] which  EIG_SMALLEST or EIG_LARGEST
+    * \param[in] solverControl  a valid hcsparseSolverControl object created with hcsparseCreateSolverControl.
+    * An eigenpair is converged once |A x - lambda x| <= max(relTol * |lambda|, absTol);
+    * maxIters bounds the block iterations
+    * \param[in] *control A valid hcsparseControl created with hcsparseCreateControl
+    *
+    * \returns \b hcsparseSuccess
+    *
+    * \ingroup SOLVER
+    */
+    hcsparseStatus
+        hcsparseDcsrlobpcg( hcdenseMatrix* X, hcdenseVector* lambda, const hcsparseCsrMatrix *A,
+                            EIG_WHICH which, hcsparseSolverControl* solverControl,
+                            hcsparseControl *control );
+
+    /*!
+    * \brief Compute the k smallest or largest eigenpairs of a single precision symmetric
+    * matrix with thick restart Lanczos. The basis holds max(restart, 2k + 1) vectors,
+    * the restart length being set with hcsparseSetSolverRestart. No preconditioner is used
+    *
+    * \param[in,out] X  column major n x k dense matrix; its first column is the starting
+    * vector (a pseudo random one when it is zero), the eigenvectors on exit
+    * \param[out] lambda  the k eigenvalues, in the order of the columns of X
+    * \param[in] A  a symmetric hcsparse CSR matrix with single precision data
+    * \param[in] which  EIG_SMALLEST or EIG_LARGEST
+    * \param[in] solverControl  a valid hcsparseSolverControl object created with hcsparseCreateSolverControl.
+    * An eigenpair is converged once |A x - lambda x| <= max(relTol * |lambda|, absTol);
+    * maxIters bounds the number of products with A
+    * \param[in] *control A valid hcsparseControl created with hcsparseCreateControl
+    *
+    * \returns \b hcsparseSuccess
+    *
+    * \ingroup SOLVER
+    */
+    hcsparseStatus
+        hcsparseScsrlanczos( hcdenseMatrix* X, hcdenseVector* lambda, const hcsparseCsrMatrix *A,
+                             EIG_WHICH which, hcsparseSolverControl* solverControl,
+                             hcsparseControl *control );
+
+    /*!
+    * \brief Compute the k smallest or largest eigenpairs of a double precision symmetric
+    * matrix with thick restart Lanczos. The basis holds max(restart, 2k + 1) vectors,
+    * the restart length being set with hcsparseSetSolverRestart. No preconditioner is used
+    *
+    * \param[in,out] X  column major n x k dense matrix; its first column is the starting
+    * vector (a pseudo random one when it is zero), the eigenvectors on exit
+    * \param[out] lambda  the k eigenvalues, in the order of the columns of X
+    * \param[in] A  a symmetric hcsparse CSR matrix with double precision data
+    * \param[in] which  EIG_SMALLEST or EIG_LARGEST
+    * \param[in] solverControl  a valid hcsparseSolverControl object created with hcsparseCreateSolverControl.
+    * An eigenpair is converged once |A x - lambda x| <= max(relTol * |lambda|, absTol);
+    * maxIters bounds the number of products with A
+    * \param[in] *control A valid hcsparseControl created with hcsparseCreateControl
+    *
+    * \returns \b hcsparseSuccess
+    *
+    * \ingroup SOLVER
+    */
+    hcsparseStatus
+        hcsparseDcsrlanczos( hcdenseMatrix* X, hcdenseVector* lambda, const hcsparseCsrMatrix *A,
+                             EIG_WHICH which, hcsparseSolverControl* solverControl,
+                             hcsparseControl *control );
+
+    /*!
+    * \brief Compute the PageRank vector of a graph by power iteration in single precision.
+    * Each iteration is one kernel that applies the transition matrix and adds the dangling
+    * node and teleport terms, and also computes the L1 change of the rank. The convergence
+    * test runs on the device and is read every checkInterval iterations
+    *
+    * \param[out] x  the rank vector, normalised to sum one when the teleport vector does
+    * \param[in] M  the column stochastic transition matrix, M(i, j) = 1 / outdegree(j) for
+    * every link j -> i; empty columns are dangling nodes
+    * \param[in] teleport  personalization vector summing to one, or nullptr for uniform 1 / n
+    * \param[in] damping  probability of following a link, 0 <= damping < 1 (usually 0.85)
+    * \param[in] solverControl  a valid hcsparseSolverControl object created with hcsparseCreateSolverControl.
+    * Iteration stops once |x_{k+1} - x_k|_1 <= relTol or after maxIters iterations
+    * \param[in] *control A valid hcsparseControl created with hcsparseCreateControl
+    *
+    * \returns \b hcsparseSuccess
+    *
+    * \ingroup SOLVER
+    */
+    hcsparseStatus
+        hcsparseScsrpagerank( hcdenseVector* x, const hcsparseCsrMatrix *M, const hcdenseVector* teleport,
+                              float damping, hcsparseSolverControl* solverControl,
+                              hcsparseControl *control );
+
+    /*!
+    * \brief Compute the PageRank vector of a graph by power iteration in double precision.
+    * Each iteration is one kernel that applies the transition matrix and adds the dangling
+    * node and teleport terms, and also computes the L1 change of the rank. The convergence
+    * test runs on the device and is read every checkInterval iterations
+    *
+    * \param[out] x  the rank vector, normalised to sum one when the teleport vector does
+    * \param[in] M  the column stochastic transition matrix, M(i, j) = 1 / outdegree(j) for
+    * every link j -> i; empty columns are dangling nodes
+    * \param[in] teleport  personalization vector summing to one, or nullptr for uniform 1 / n
+    * \param[in] damping  probability of following a link, 0 <= damping < 1 (usually 0.85)
+    * \param[in] solverControl  a valid hcsparseSolverControl object created with hcsparseCreateSolverControl.
+    * Iteration stops once |x_{k+1} - x_k|_1 <= relTol or after maxIters iterations
+    * \param[in] *control A valid hcsparseControl created with hcsparseCreateControl
+    *
+    * \returns \b hcsparseSuccess
+    *
+    * \ingroup SOLVER
+    */
+    hcsparseStatus
+        hcsparseDcsrpagerank( hcdenseVector* x, const hcsparseCsrMatrix *M, const hcdenseVector* teleport,
+                              double damping, hcsparseSolverControl* solverControl,
+                              hcsparseControl *control );
+
      /*!
      * \brief Execute a single precision Bi-Conjugate Gradients Stabilized solver
      *
@@ -1114,6 +1713,39 @@ hcsparseDcsrgeam(hcsparseHandle_t handle,
      */
     hcsparseStatus
         hcsparseCsrMetaCompute( hcsparseCsrMatrix* csrMatx, hcsparseControl *control );
+
+    /*!
+     * \brief Record that the values of a CSR matrix changed but not its pattern
+     * \details For a matrix tracked with hcsparseCsrStructureChanged the analyses of the
+     * pattern are kept: hcsparseCsrMetaCompute returns at once, a solver control reuses
+     * the preconditioner of the last solve with the matrix (ILU(0) refactorizes on its
+     * level schedules, the diagonal preconditioner extracts into its buffers),
+     * hcsparse[S|D]csrRapNumeric accepts an analysis of the same patterns and
+     * hcsparseScsrSpGemm reuses the symbolic phase of its last product of tracked
+     * operands. Call it after every update of the values. Does nothing for an untracked
+     * matrix.
+     * \param[in,out] csrMatx  The CSR sparse structure whose values were written
+     *
+     * \ingroup FILE
+     */
+    hcsparseStatus
+        hcsparseCsrValuesChanged( hcsparseCsrMatrix* csrMatx );
+
+    /*!
+     * \brief Record that the pattern of a CSR matrix changed, or start tracking it
+     * \details The first call turns on change tracking for the matrix, which
+     * hcsparseInitCsrMatrix leaves off: without it every analysis is recomputed on each
+     * call, as the library cannot tell that the matrix is unchanged. Every later call
+     * invalidates the analyses of the old pattern: rowBlocks, cached preconditioners,
+     * Galerkin products analysed by hcsparseXcsrRapSymbolic and the SpGEMM symbolic
+     * phase. Versions come from one process wide counter, so a matrix cleared or
+     * reallocated at the address of an old one never matches an analysis of the old one.
+     * \param[in,out] csrMatx  The CSR sparse structure whose rowOffsets or colIndices were written
+     *
+     * \ingroup FILE
+     */
+    hcsparseStatus
+        hcsparseCsrStructureChanged( hcsparseCsrMatrix* csrMatx );
     /**@}*/
 
     /*!
@@ -1344,6 +1976,40 @@ hcsparseDcsrgeam(hcsparseHandle_t handle,
                      const hcdenseVector* y,
                      hcsparseControl *control );
 
+    /*!
+     * \brief Calculates k single precision dot-products r[j] = <x[j], y[j]> in one pass
+     * \param[out] r  Output dense vector holding at least k values
+     * \param[in] k  Number of dot-products, at most 8
+     * \param[in] x  Array of k input dense vectors
+     * \param[in] y  Array of k input dense vectors
+     * \param[in] *control A valid hcsparseControl created with hcsparseCreateControl
+     *
+     * \ingroup BLAS-1
+     */
+    hcsparseStatus
+        hcdenseSmultiDot( hcdenseVector* r,
+                          int k,
+                          const hcdenseVector* const* x,
+                          const hcdenseVector* const* y,
+                          hcsparseControl *control );
+
+    /*!
+     * \brief Calculates k double precision dot-products r[j] = <x[j], y[j]> in one pass
+     * \param[out] r  Output dense vector holding at least k values
+     * \param[in] k  Number of dot-products, at most 8
+     * \param[in] x  Array of k input dense vectors
+     * \param[in] y  Array of k input dense vectors
+     * \param[in] *control A valid hcsparseControl created with hcsparseCreateControl
+     *
+     * \ingroup BLAS-1
+     */
+    hcsparseStatus
+        hcdenseDmultiDot( hcdenseVector* r,
+                          int k,
+                          const hcdenseVector* const* x,
+                          const hcdenseVector* const* y,
+                          hcsparseControl *control );
+
                  /* element-wise operations for dense vectors +, -, *, / */
 
     /*!
@@ -1513,6 +2179,154 @@ hcsparseDcsrgeam(hcsparseHandle_t handle,
                         hcdenseVector* y,
                         hcsparseControl *control );
 
+    /*!
+     * \brief Single precision CSR sparse matrix times dense vector over a semiring
+     * \details \f$ y_i \leftarrow \bigoplus_j A_{ij} \otimes x_j \f$, or
+     * \f$ y_i \leftarrow y_i \oplus \bigoplus_j A_{ij} \otimes x_j \f$ when accumulating.
+     * Rows without entries get the identity of \f$ \oplus \f$; for min-plus that is
+     * the largest finite value, which stands for infinity.
+     * \param[in] semiring  the (add, multiply) pair, see SEMIRING
+     * \param[in] matx  Input CSR sparse matrix
+     * \param[in] x  Input dense vector
+     * \param[in,out] y  Output dense vector
+     * \param[in] accumulate  combine the product with the old y instead of overwriting it
+     * \param[in] *control A valid hcsparseControl created with hcsparseCreateControl
+     *
+     * \ingroup BLAS-2
+    */
+    hcsparseStatus
+        hcsparseScsrmvSemiring( SEMIRING semiring,
+                                const hcsparseCsrMatrix* matx,
+                                const hcdenseVector* x,
+                                hcdenseVector* y,
+                                bool accumulate,
+                                hcsparseControl *control );
+
+    /*!
+     * \brief Double precision CSR sparse matrix times dense vector over a semiring
+     * \details \f$ y_i \leftarrow \bigoplus_j A_{ij} \otimes x_j \f$, or
+     * \f$ y_i \leftarrow y_i \oplus \bigoplus_j A_{ij} \otimes x_j \f$ when accumulating.
+     * Rows without entries get the identity of \f$ \oplus \f$; for min-plus that is
+     * the largest finite value, which stands for infinity.
+     * \param[in] semiring  the (add, multiply) pair, see SEMIRING
+     * \param[in] matx  Input CSR sparse matrix
+     * \param[in] x  Input dense vector
+     * \param[in,out] y  Output dense vector
+     * \param[in] accumulate  combine the product with the old y instead of overwriting it
+     * \param[in] *control A valid hcsparseControl created with hcsparseCreateControl
+     *
+     * \ingroup BLAS-2
+    */
+    hcsparseStatus
+        hcsparseDcsrmvSemiring( SEMIRING semiring,
+                                const hcsparseCsrMatrix* matx,
+                                const hcdenseVector* x,
+                                hcdenseVector* y,
+                                bool accumulate,
+                                hcsparseControl *control );
+
+    /*!
+     * \brief Single precision sparse matrix times sparse vector over a semiring
+     * \details \f$ y \leftarrow A \otimes x \f$ for a sparse x such as the frontier of a
+     * graph traversal. Only the columns of A named by x are read, so the cost follows the
+     * number of entries in those columns. When these exceed nnz(A) / 14 and csrMatx is
+     * given, the dense semiring csrmv on the rows of A is used instead.
+     * Entries of y equal to the zero of the semiring are not stored.
+     * \param[in] semiring  the (add, multiply) pair, see SEMIRING
+     * \param[in] matx  Input sparse matrix A in CSC form
+     * \param[in] csrMatx  The same matrix in CSR form, or nullptr to always gather columns
+     * \param[in] x  Input sparse vector
+     * \param[out] y  Output sparse vector; indices and values must have room for
+     * y->num_values entries, num_nonzeros is set
+     * \param[in] *control A valid hcsparseControl created with hcsparseCreateControl
+     *
+     * \ingroup BLAS-2
+    */
+    hcsparseStatus
+        hcsparseSspmspv( SEMIRING semiring,
+                         const hcsparseCscMatrix* matx,
+                         const hcsparseCsrMatrix* csrMatx,
+                         const hcsparseVector* x,
+                         hcsparseVector* y,
+                         hcsparseControl *control );
+
+    /*!
+     * \brief Double precision sparse matrix times sparse vector over a semiring
+     * \details \f$ y \leftarrow A \otimes x \f$ for a sparse x such as the frontier of a
+     * graph traversal. Only the columns of A named by x are read, so the cost follows the
+     * number of entries in those columns. When these exceed nnz(A) / 14 and csrMatx is
+     * given, the dense semiring csrmv on the rows of A is used instead.
+     * Entries of y equal to the zero of the semiring are not stored.
+     * \param[in] semiring  the (add, multiply) pair, see SEMIRING
+     * \param[in] matx  Input sparse matrix A in CSC form
+     * \param[in] csrMatx  The same matrix in CSR form, or nullptr to always gather columns
+     * \param[in] x  Input sparse vector
+     * \param[out] y  Output sparse vector; indices and values must have room for
+     * y->num_values entries, num_nonzeros is set
+     * \param[in] *control A valid hcsparseControl created with hcsparseCreateControl
+     *
+     * \ingroup BLAS-2
+    */
+    hcsparseStatus
+        hcsparseDspmspv( SEMIRING semiring,
+                         const hcsparseCscMatrix* matx,
+                         const hcsparseCsrMatrix* csrMatx,
+                         const hcsparseVector* x,
+                         hcsparseVector* y,
+                         hcsparseControl *control );
+
+    /*!
+     * \brief Single precision masked CSR sparse matrix times dense vector over a semiring
+     * \details As hcsparseScsrmvSemiring, restricted to the rows i of y where mask(i) is
+     * nonzero, or zero with complement; the other rows of y are left untouched and their
+     * rows of A are not read. A complemented visited vector gives a masked BFS step.
+     * \param[in] semiring  the (add, multiply) pair, see SEMIRING
+     * \param[in] matx  Input CSR sparse matrix
+     * \param[in] x  Input dense vector
+     * \param[in,out] y  Output dense vector
+     * \param[in] accumulate  combine the product with the old y instead of overwriting it
+     * \param[in] mask  Dense vector of the length of y selecting the rows to compute
+     * \param[in] complement  compute the rows where mask is zero instead
+     * \param[in] *control A valid hcsparseControl created with hcsparseCreateControl
+     *
+     * \ingroup BLAS-2
+    */
+    hcsparseStatus
+        hcsparseScsrmvMasked( SEMIRING semiring,
+                              const hcsparseCsrMatrix* matx,
+                              const hcdenseVector* x,
+                              hcdenseVector* y,
+                              bool accumulate,
+                              const hcdenseVector* mask,
+                              bool complement,
+                              hcsparseControl *control );
+
+    /*!
+     * \brief Double precision masked CSR sparse matrix times dense vector over a semiring
+     * \details As hcsparseDcsrmvSemiring, restricted to the rows i of y where mask(i) is
+     * nonzero, or zero with complement; the other rows of y are left untouched and their
+     * rows of A are not read. A complemented visited vector gives a masked BFS step.
+     * \param[in] semiring  the (add, multiply) pair, see SEMIRING
+     * \param[in] matx  Input CSR sparse matrix
+     * \param[in] x  Input dense vector
+     * \param[in,out] y  Output dense vector
+     * \param[in] accumulate  combine the product with the old y instead of overwriting it
+     * \param[in] mask  Dense vector of the length of y selecting the rows to compute
+     * \param[in] complement  compute the rows where mask is zero instead
+     * \param[in] *control A valid hcsparseControl created with hcsparseCreateControl
+     *
+     * \ingroup BLAS-2
+    */
+    hcsparseStatus
+        hcsparseDcsrmvMasked( SEMIRING semiring,
+                              const hcsparseCsrMatrix* matx,
+                              const hcdenseVector* x,
+                              hcdenseVector* y,
+                              bool accumulate,
+                              const hcdenseVector* mask,
+                              bool complement,
+                              hcsparseControl *control );
+
 
     /*!
      * \brief Single precision COO sparse matrix times dense vector
@@ -1617,6 +2431,9 @@ hcsparseDcsrgeam(hcsparseHandle_t handle,
      * \param[out] sparseMatC Output CSR sparse matrix
      * \param[in] *control A valid hcsparseControl created with hcsparseCreateControl
      * \pre The input sparse matrices data must first be sorted by rows, then by columns
+     * \note When A and B are tracked (hcsparseCsrStructureChanged) the symbolic phase,
+     * which depends only on their patterns, is kept for the next product of the same
+     * patterns, e.g. after hcsparseCsrValuesChanged.
      * \ingroup BLAS-3
      */
    hcsparseStatus
@@ -1624,6 +2441,161 @@ hcsparseDcsrgeam(hcsparseHandle_t handle,
                           const hcsparseCsrMatrix* sparseMatB,
                                 hcsparseCsrMatrix* sparseMatC,
                           hcsparseControl *control );
+
+    /*!
+     * \brief Single Precision number of entries of a masked CSR Sparse Matrix times Sparse Matrix
+     * \details Counts the entries of \f$ (A \ast B) .\ast M \f$ with the same passes as
+     * hcsparseScsrSpGemmMasked, to size the output of the product for any mask.
+     * \param[in] sparseMatA Input CSR sparse matrix
+     * \param[in] sparseMatB Input CSR sparse matrix
+     * \param[in] mask CSR pattern or dense mask of the size of C, possibly complemented;
+     * exactly one of mask->pattern and mask->bitmap is set
+     * \param[out] nnzC Number of entries of the masked product
+     * \param[in] *control A valid hcsparseControl created with hcsparseCreateControl
+     * \pre The input sparse matrices and the CSR mask must be sorted by rows, then by columns
+     * \ingroup BLAS-3
+     */
+   hcsparseStatus
+      hcsparseScsrSpGemmMaskedNnz( const hcsparseCsrMatrix* sparseMatA,
+                                   const hcsparseCsrMatrix* sparseMatB,
+                                   const hcsparseMask* mask,
+                                   int* nnzC,
+                                   hcsparseControl *control );
+
+    /*!
+     * \brief Single Precision masked CSR Sparse Matrix times Sparse Matrix
+     * \details \f$ C \leftarrow (A \ast B) .\ast M \f$ for a structural mask M, e.g.
+     * \f$ (A \ast A) .\ast A \f$ for triangle counting. Products outside the mask are
+     * dropped as they are formed, so only the masked result is ever stored.
+     * \param[in] sparseMatA Input CSR sparse matrix
+     * \param[in] sparseMatB Input CSR sparse matrix
+     * \param[in] mask CSR pattern or dense mask of the size of C, possibly complemented;
+     * exactly one of mask->pattern and mask->bitmap is set
+     * \param[out] sparseMatC Output CSR sparse matrix; colIndices and values must hold
+     * the entries of the result, as counted by hcsparseScsrSpGemmMaskedNnz
+     * \param[in] *control A valid hcsparseControl created with hcsparseCreateControl
+     * \pre The input sparse matrices and the CSR mask must be sorted by rows, then by columns
+     * \ingroup BLAS-3
+     */
+   hcsparseStatus
+      hcsparseScsrSpGemmMasked( const hcsparseCsrMatrix* sparseMatA,
+                                const hcsparseCsrMatrix* sparseMatB,
+                                const hcsparseMask* mask,
+                                      hcsparseCsrMatrix* sparseMatC,
+                                hcsparseControl *control );
+
+    /*!
+     * \brief Double Precision number of entries of a masked CSR Sparse Matrix times Sparse Matrix
+     * \details Counts the entries of \f$ (A \ast B) .\ast M \f$ with the same passes as
+     * hcsparseDcsrSpGemmMasked, to size the output of the product for any mask.
+     * \param[in] sparseMatA Input CSR sparse matrix
+     * \param[in] sparseMatB Input CSR sparse matrix
+     * \param[in] mask CSR pattern or dense mask of the size of C, possibly complemented;
+     * exactly one of mask->pattern and mask->bitmap is set
+     * \param[out] nnzC Number of entries of the masked product
+     * \param[in] *control A valid hcsparseControl created with hcsparseCreateControl
+     * \pre The input sparse matrices and the CSR mask must be sorted by rows, then by columns
+     * \ingroup BLAS-3
+     */
+   hcsparseStatus
+      hcsparseDcsrSpGemmMaskedNnz( const hcsparseCsrMatrix* sparseMatA,
+                                   const hcsparseCsrMatrix* sparseMatB,
+                                   const hcsparseMask* mask,
+                                   int* nnzC,
+                                   hcsparseControl *control );
+
+    /*!
+     * \brief Double Precision masked CSR Sparse Matrix times Sparse Matrix
+     * \details \f$ C \leftarrow (A \ast B) .\ast M \f$ for a structural mask M, e.g.
+     * \f$ (A \ast A) .\ast A \f$ for triangle counting. Products outside the mask are
+     * dropped as they are formed, so only the masked result is ever stored.
+     * \param[in] sparseMatA Input CSR sparse matrix
+     * \param[in] sparseMatB Input CSR sparse matrix
+     * \param[in] mask CSR pattern or dense mask of the size of C, possibly complemented;
+     * exactly one of mask->pattern and mask->bitmap is set
+     * \param[out] sparseMatC Output CSR sparse matrix; colIndices and values must hold
+     * the entries of the result, as counted by hcsparseDcsrSpGemmMaskedNnz
+     * \param[in] *control A valid hcsparseControl created with hcsparseCreateControl
+     * \pre The input sparse matrices and the CSR mask must be sorted by rows, then by columns
+     * \ingroup BLAS-3
+     */
+   hcsparseStatus
+      hcsparseDcsrSpGemmMasked( const hcsparseCsrMatrix* sparseMatA,
+                                const hcsparseCsrMatrix* sparseMatB,
+                                const hcsparseMask* mask,
+                                      hcsparseCsrMatrix* sparseMatC,
+                                hcsparseControl *control );
+
+    /*!
+     * \brief Create the structure holding the analysis of a Galerkin product
+     * \param[out] info The new, empty analysis
+     * \ingroup BLAS-3
+     */
+   hcsparseStatus
+      hcsparseCreateRapInfo( hcsparseRapInfo_t* info );
+
+    /*!
+     * \brief Release an analysis created with hcsparseCreateRapInfo and its device memory
+     * \param[in] info The analysis to release
+     * \ingroup BLAS-3
+     */
+   hcsparseStatus
+      hcsparseDestroyRapInfo( hcsparseRapInfo_t info );
+
+    /*!
+     * \brief Symbolic phase of the Galerkin product \f$ C \leftarrow P^T \ast A \ast P \f$
+     * \details Finds the pattern of the coarse operator of multigrid straight from the
+     * rows of A and P, neither \f$ P^T \f$ nor \f$ A \ast P \f$ being formed. The
+     * pattern is kept in info for any number of numeric phases on A and P with the
+     * same patterns.
+     * \param[in] sparseMatA Square fine CSR sparse matrix
+     * \param[in] sparseMatP CSR prolongation, as many rows as A
+     * \param[out] info Analysis created with hcsparseCreateRapInfo
+     * \param[out] nnzC Number of entries of C, to size its colIndices and values
+     * \param[in] *control A valid hcsparseControl created with hcsparseCreateControl
+     * \pre The input sparse matrices data must first be sorted by rows, then by columns
+     * \ingroup BLAS-3
+     */
+   hcsparseStatus
+      hcsparseXcsrRapSymbolic( const hcsparseCsrMatrix* sparseMatA,
+                               const hcsparseCsrMatrix* sparseMatP,
+                               hcsparseRapInfo_t info,
+                               int* nnzC,
+                               hcsparseControl *control );
+
+    /*!
+     * \brief Single Precision numeric phase of the Galerkin product \f$ C \leftarrow P^T \ast A \ast P \f$
+     * \param[in] sparseMatA Fine CSR sparse matrix analysed by hcsparseXcsrRapSymbolic
+     * \param[in] sparseMatP CSR prolongation analysed by hcsparseXcsrRapSymbolic
+     * \param[in] info Result of hcsparseXcsrRapSymbolic
+     * \param[out] sparseMatC Output CSR sparse matrix, rowOffsets of P->num_cols + 1 entries,
+     * colIndices and values of nnzC; it comes out sorted
+     * \param[in] *control A valid hcsparseControl created with hcsparseCreateControl
+     * \ingroup BLAS-3
+     */
+   hcsparseStatus
+      hcsparseScsrRapNumeric( const hcsparseCsrMatrix* sparseMatA,
+                              const hcsparseCsrMatrix* sparseMatP,
+                              const hcsparseRapInfo_t info,
+                                    hcsparseCsrMatrix* sparseMatC,
+                              hcsparseControl *control );
+
+    /*!
+     * \brief Double Precision numeric phase of the Galerkin product \f$ C \leftarrow P^T \ast A \ast P \f$
+     * \param[in] sparseMatA Fine CSR sparse matrix analysed by hcsparseXcsrRapSymbolic
+     * \param[in] sparseMatP CSR prolongation analysed by hcsparseXcsrRapSymbolic
+     * \param[in] info Result of hcsparseXcsrRapSymbolic
+     * \param[out] sparseMatC Output CSR sparse matrix, rowOffsets of P->num_cols + 1 entries,
+     * colIndices and values of nnzC; it comes out sorted
+     * \param[in] *control A valid hcsparseControl created with hcsparseCreateControl
+     * \ingroup BLAS-3
+     */
+   hcsparseStatus
+      hcsparseDcsrRapNumeric( const hcsparseCsrMatrix* sparseMatA,
+                              const hcsparseCsrMatrix* sparseMatP,
+                              const hcsparseRapInfo_t info,
+                                    hcsparseCsrMatrix* sparseMatC,
+                              hcsparseControl *control );
     /**@}*/
 
     /*!
@@ -1692,6 +2664,38 @@ hcsparseDcsrgeam(hcsparseHandle_t handle,
                           hcsparseCsrMatrix* csr,
                           hcsparseControl *control );
 
+    /*!
+     * \brief Assemble a single precision CSR matrix from unsorted COO triplets
+     * \details Triplets are sorted by row, then by column, and entries that share
+     * the same (row, col) position are summed. The output is canonical CSR.
+     * \param[in] coo  Input COO encoded sparse matrix; may be unsorted and contain duplicates
+     * \param[out] csr  Output CSR encoded sparse matrix; values and colIndices must hold
+     * coo->num_nonzeros entries. num_nonzeros is set to the number of distinct entries
+     * \param[in] *control A valid hcsparseControl created with hcsparseCreateControl
+     *
+     * \ingroup CONVERT
+     */
+    hcsparseStatus
+        hcsparseScoo2csrAssemble( const hcsparseCooMatrix* coo,
+                                  hcsparseCsrMatrix* csr,
+                                  hcsparseControl *control );
+
+    /*!
+     * \brief Assemble a double precision CSR matrix from unsorted COO triplets
+     * \details Triplets are sorted by row, then by column, and entries that share
+     * the same (row, col) position are summed. The output is canonical CSR.
+     * \param[in] coo  Input COO encoded sparse matrix; may be unsorted and contain duplicates
+     * \param[out] csr  Output CSR encoded sparse matrix; values and colIndices must hold
+     * coo->num_nonzeros entries. num_nonzeros is set to the number of distinct entries
+     * \param[in] *control A valid hcsparseControl created with hcsparseCreateControl
+     *
+     * \ingroup CONVERT
+     */
+    hcsparseStatus
+        hcsparseDcoo2csrAssemble( const hcsparseCooMatrix* coo,
+                                  hcsparseCsrMatrix* csr,
+                                  hcsparseControl *control );
+
     /*!
      * \brief Convert a single precision CSR encoded sparse matrix into a dense matrix
      * \param[in] csr  Input CSR encoded sparse matrix
@@ -2,6 +2,7 @@
 #define _HC_SPARSE_STRUCT_H_
 
 #include <iostream>
+#include <memory>
 #include <hc.hpp>
 #include <hc_math.hpp>
 #include <hc_am.hpp>
@@ -99,9 +100,53 @@ typedef enum _print_mode
 typedef enum _precond
 {
     NOPRECOND = 0,
-    DIAGONAL
+    DIAGONAL,
+    ILU0,
+    AMG,
+    CHEBYSHEV,
+    BLOCK_JACOBI
 } PRECONDITIONER;
 
+/*! \brief Enumeration to select the vector norm the iterative solvers use
+ * to measure the residual
+ *
+ * \ingroup SOLVER
+ */
+typedef enum _solver_norm
+{
+    NORM_L1 = 0,
+    NORM_L2,
+    NORM_LINF
+} SOLVER_NORM;
+
+/*! \brief Enumeration to select which end of the spectrum the eigensolvers
+ * compute
+ *
+ * \ingroup SOLVER
+ */
+typedef enum _eig_which
+{
+    EIG_SMALLEST = 0,
+    EIG_LARGEST
+} EIG_WHICH;
+
+/*! \brief Enumeration of the semirings (add, multiply) of the graph
+ * kernels: plus-times is the usual product, min-plus relaxes shortest
+ * paths, max-times finds most reliable paths, or-and gives reachability,
+ * and max-min gives widest paths
+ *
+ * \ingroup BLAS-2
+ */
+typedef enum _semiring
+{
+    SR_PLUS_TIMES = 0,
+    SR_MIN_PLUS,
+    SR_MAX_TIMES,
+    SR_OR_AND,
+    SR_PLUS_MIN,
+    SR_MAX_MIN
+} SEMIRING;
+
 /*! \brief Structure to encapsulate scalar data to hcsparse API
  */
 typedef struct hcsparseScalar_
@@ -138,6 +183,24 @@ typedef struct hcdenseVector_
     }
 } hcdenseVector;
 
+/*! \brief Structure to encapsulate sparse vector data to hcsparse API
+ * \note The indices stored are 0-based and ascending
+ */
+typedef struct hcsparseVector_
+{
+    int num_values;  /*!< Length of the vector if viewed as dense */
+    int num_nonzeros;  /*!< Number of stored entries */
+    void* values;  /*!< stored values of size num_nonzeros */
+    void* indices;  /*!< position of the corresponding value of size num_nonzeros */
+    long offValues;
+    long offIndices;
+    void clear( )
+    {
+        num_values = num_nonzeros = 0;
+        values = indices = nullptr;
+    }
+} hcsparseVector;
+
 struct hcsparseControl_
 {
     hc::accelerator_view accl_view;
@@ -194,12 +257,27 @@ typedef struct hcsparseCsrMatrix_
     /**@}*/
 
     size_t rowBlockSize;  /*!< Size of array used by the rowBlocks handle */
+
+    /** @name Change tracking */
+    /**@{*/
+    unsigned long structureVersion;  /*!< New, never reused, value when rowOffsets or colIndices change; 0 if not tracked */
+    unsigned long valuesVersion;  /*!< New, never reused, value when values change; 0 if not tracked */
+    unsigned long rowBlocksVersion;  /*!< structureVersion the rowBlocks were computed for */
+    /**@}*/
+
     void clear( )
     {
         num_rows = num_cols = num_nonzeros = 0;
         values = nullptr;
         colIndices = rowOffsets = rowBlocks = nullptr;
         rowBlockSize = 0;
+        structureVersion = valuesVersion = rowBlocksVersion = 0;
+    }
+
+    // analyses of the pattern are reused only for a tracked matrix
+    bool structureTracked() const
+    {
+        return structureVersion != 0;
     }
 
     uint nnz_per_row() const
@@ -371,12 +449,61 @@ typedef struct hcdenseMatrix_
     }
 } hcdenseMatrix;
 
+/*! \brief Structural mask of the masked sparse products: either the pattern
+ * of a CSR matrix, whose values are ignored, or the nonzero entries of a
+ * dense matrix. With complement set the entries outside the mask are kept.
+ */
+typedef struct hcsparseMask_
+{
+    const hcsparseCsrMatrix* pattern;  /*!< CSR mask, or nullptr */
+    const hcdenseMatrix* bitmap;  /*!< dense mask read in the precision of the routine, or nullptr */
+    bool complement;  /*!< keep the entries where the mask is not set */
+
+    void clear( )
+    {
+        pattern = nullptr;
+        bitmap = nullptr;
+        complement = false;
+    }
+} hcsparseMask;
+
+/*! \brief Device work vectors and scalars of the iterative solvers, kept
+ * alive across solves of systems with the same size and precision
+ *
+ * \ingroup SOLVER
+ */
+typedef struct _solverWorkspace
+{
+    _solverWorkspace() : num_values(0), value_size(0), num_vectors(0),
+        num_scalars(0), vectors(nullptr), scalars(nullptr)
+    {
+
+    }
+
+    // length of every work vector
+    int num_values;
+
+    // size in bytes of one value, sizeof(float) or sizeof(double)
+    size_t value_size;
+
+    // number of work vectors and scalars currently allocated
+    int num_vectors;
+    int num_scalars;
+
+    void *vectors;
+    void *scalars;
+} hcsparseSolverWorkspace;
+
 typedef struct _solverControl
 {
 
     _solverControl() : nIters(0), maxIters(0), preconditioner(NOPRECOND),
         relativeTolerance(0.0), absoluteTolerance(0.0),
-        initialResidual(0), currentResidual(0), printMode(VERBOSE)
+        initialResidual(0), currentResidual(0), printMode(VERBOSE),
+        residualNorm(NORM_L2), checkInterval(1), restart(30), blockSize(4),
+        blockOffsets(nullptr), numBlocks(0), workspace(nullptr),
+        precondMatrix(nullptr), precondType(NOPRECOND), precondValueSize(0),
+        precondStructure(0), precondValues(0)
     {
 
     }
@@ -410,6 +537,25 @@ typedef struct _solverControl
         }
     }
 
+    // residual is tested every checkInterval iterations and on the last one
+    bool checkDue(const int iteration)
+    {
+        return iteration % checkInterval == 0 || iteration >= maxIters;
+    }
+
+    std::string printNorm()
+    {
+        switch(residualNorm)
+        {
+        case NORM_L1:
+            return "L1";
+        case NORM_LINF:
+            return "Linf";
+        default:
+            return "L2";
+        }
+    }
+
     std::string printPreconditioner()
     {
 
@@ -419,6 +565,14 @@ typedef struct _solverControl
             return "No preconditioner";
         case DIAGONAL:
             return "Diagonal";
+        case ILU0:
+            return "ILU(0)";
+        case AMG:
+            return "Smoothed aggregation AMG";
+        case CHEBYSHEV:
+            return "Chebyshev";
+        case BLOCK_JACOBI:
+            return "Block Jacobi";
         }
     }
 
@@ -431,6 +585,9 @@ typedef struct _solverControl
                       << "\n\tabsolute tolerance = " << absoluteTolerance
                       << "\n\tmax iterations = " << maxIters
                       << "\n\tPreconditioner: " << printPreconditioner()
+                      << "\n\tresidual norm: " << printNorm()
+                      << "\n\tcheck interval = " << checkInterval
+                      << "\n\trestart = " << restart
                       << std::endl;
 
             std::cout << "Solver finished calculations with status "
@@ -462,6 +619,34 @@ typedef struct _solverControl
     double currentResidual;
 
     PRINT_MODE printMode;
+
+    // norm of the residual used in the convergence test
+    SOLVER_NORM residualNorm;
+
+    // iterations between convergence tests
+    int checkInterval;
+
+    // Krylov subspace dimension of restarted solvers (GMRES)
+    int restart;
+
+    // diagonal blocks of the block Jacobi preconditioner, either of
+    // blockSize rows or given by the host row partition blockOffsets
+    int blockSize;
+    const int *blockOffsets;
+    int numBlocks;
+
+    // optional workspace reused by every solve run with this control
+    hcsparseSolverWorkspace *workspace;
+
+    // preconditioner of the last solve, kept for a tracked matrix and
+    // reused while the pattern of the matrix is unchanged, see
+    // hcsparseCsrValuesChanged
+    std::shared_ptr<void> precondCache;
+    const hcsparseCsrMatrix *precondMatrix;
+    PRECONDITIONER precondType;
+    size_t precondValueSize;
+    unsigned long precondStructure;
+    unsigned long precondValues;
 } hcsparseSolverControl;
 
 #endif
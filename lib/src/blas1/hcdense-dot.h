@@ -2,6 +2,8 @@
 #include "reduce-operators.h"
 #define BLOCK_SIZE 256
 
+// Single pass dot product; partial sums live in the shared reduction scratch
+// and the last tile to finish writes the result (see tile_reduce_finish).
 template <typename T>
 void inner_product (const long size,
                     T *pR,
@@ -10,10 +12,14 @@ void inner_product (const long size,
                     const long pXOffset,
                     T *pY,
                     const long pYOffset,
-                    T *partial,
-                    const int REDUCE_BLOCKS_NUMBER,
                     hcsparseControl* control)
 {
+    const int REDUCE_BLOCKS_NUMBER = reduce_num_blocks(size);
+
+    char *scratch = (char*) reduce_get_scratch(sizeof(T) * REDUCE_BLOCKS_NUMBER, control);
+    unsigned int *counter = (unsigned int*) scratch;
+    T *partial = (T*) (scratch + REDUCE_PARTIAL_OFFSET);
+
     hc::extent<1> grdExt(REDUCE_BLOCKS_NUMBER * BLOCK_SIZE);
     hc::tiled_extent<1> t_ext = grdExt.tile(BLOCK_SIZE);
     hc::parallel_for_each(control->accl_view,
@@ -21,43 +27,25 @@ void inner_product (const long size,
                           [=](hc::tiled_index<1> tidx) [[hc]]
     {
         tile_static T buf_tmp[BLOCK_SIZE];
+        tile_static bool is_last;
 
         T sum = 0;
 
-	    int eidx = tidx.global[0];
+        long eidx = tidx.global[0];
         while(eidx < size)
         {
             sum += pX[pXOffset + eidx] * pY[pYOffset + eidx];
             eidx += REDUCE_BLOCKS_NUMBER * BLOCK_SIZE;
         }
-        buf_tmp[tidx.local[0]] = sum;
-        tidx.barrier.wait();
 
-        // Seqential part
-        if (tidx.local[0] == 0)
+        T total;
+        if (tile_reduce_finish<T>(sum, total, buf_tmp, partial, counter,
+                                  REDUCE_BLOCKS_NUMBER, is_last, tidx))
         {
-            sum = 0;
-            for (uint i = 0; i < BLOCK_SIZE; i++)
-            {
-                sum += buf_tmp[i];
-            }
-            partial[tidx.tile[0]] = sum;
+            if (tidx.local[0] == 0)
+                pR[pROffset] = total;
         }
     }).wait();
-
-    hc::extent<1> grdExt1(1);
-    hc::tiled_extent<1> t_ext1 = grdExt1.tile(1);
-    hc::parallel_for_each(control->accl_view,
-                          t_ext1,
-                          [=](hc::tiled_index<1> tidx) [[hc]]
-    {
-        T sum = 0;
-        for (uint i = 0; i < REDUCE_BLOCKS_NUMBER; i++)
-        {
-            sum += partial[i];
-        }
-        pR[pROffset] = sum;
-    }).wait();
 }
 
 template <typename T>
@@ -68,11 +56,6 @@ hcsparseStatus dot(hcsparseScalar* pR,
                    hcsparseControl* control)
 {
     int size = pX->num_values;
-    int REDUCE_BLOCKS_NUMBER = size/BLOCK_SIZE + 1;
-
-    hc::accelerator acc = (control->accl_view).get_accelerator();
-
-    T *partial = (T*) am_alloc(sizeof(T) * REDUCE_BLOCKS_NUMBER, acc, 0);
 
     T *avR = static_cast<T*>(pR->value);
     T *avX = static_cast<T*>(pX->values);
@@ -85,12 +68,127 @@ hcsparseStatus dot(hcsparseScalar* pR,
                      pX->offValues,
                      avY,
                      pY->offValues,
-                     partial, REDUCE_BLOCKS_NUMBER, control);
+                     control);
+
+    return hcsparseSuccess;
+}
 
-    control->accl_view.wait();
+// Upper bound on the number of inner products computed by one multi_dot call.
+#define MULTI_DOT_MAX 8
 
-    am_free(partial);
+// Distinct operand arrays of a multi_dot and, for every product j, which of
+// them form the pair. Operands shared between products are loaded once.
+template <typename T>
+struct multiDotOperands
+{
+    const T *values[2 * MULTI_DOT_MAX];
+    int x[MULTI_DOT_MAX];
+    int y[MULTI_DOT_MAX];
+    int num_values;
+};
 
-    return hcsparseSuccess;
+template <typename T>
+int
+multi_dot_operand (multiDotOperands<T> &ops,
+                   const hcdenseVector *v)
+{
+    const T *p = static_cast<const T*>(v->values) + v->offValues;
+    for (int d = 0; d < ops.num_values; d++)
+    {
+        if (ops.values[d] == p)
+            return d;
+    }
+    ops.values[ops.num_values] = p;
+    return ops.num_values++;
 }
 
+// r[j] = <x[j], y[j]> for j < k in a single pass over the operands.
+// This is the entry point for callers that only need the products. The
+// solvers compute theirs in the same pass as the vector updates that feed
+// them (fused_blas1 in BiCGStab, pipecg_update in pipelined CG), which a
+// separate multi_dot would have to read back from memory.
+template <typename T>
+hcsparseStatus
+multi_dot (hcdenseVector *pR,
+           const int k,
+           const hcdenseVector* const *pX,
+           const hcdenseVector* const *pY,
+           hcsparseControl* control)
+{
+    if (k < 1 || k > MULTI_DOT_MAX || pR->num_values < k)
+        return hcsparseInvalid;
+
+    const long size = pX[0]->num_values;
+
+    multiDotOperands<T> ops;
+    ops.num_values = 0;
+    for (int j = 0; j < k; j++)
+    {
+        if (pX[j]->num_values != size || pY[j]->num_values != size)
+            return hcsparseInvalid;
+        ops.x[j] = multi_dot_operand<T>(ops, pX[j]);
+        ops.y[j] = multi_dot_operand<T>(ops, pY[j]);
+    }
+
+    T *avR = static_cast<T*>(pR->values) + pR->offValues;
+
+    const int REDUCE_BLOCKS_NUMBER = reduce_num_blocks(size);
+
+    char *scratch = (char*) reduce_get_scratch(k * sizeof(T) * REDUCE_BLOCKS_NUMBER, control);
+    unsigned int *counter = (unsigned int*) scratch;
+    T *partial = (T*) (scratch + REDUCE_PARTIAL_OFFSET);
+
+    hc::extent<1> grdExt(REDUCE_BLOCKS_NUMBER * BLOCK_SIZE);
+    hc::tiled_extent<1> t_ext = grdExt.tile(BLOCK_SIZE);
+    hc::parallel_for_each(control->accl_view, t_ext, [=] (hc::tiled_index<1>& tidx) [[hc]]
+    {
+        tile_static T buf_tmp[BLOCK_SIZE];
+        tile_static bool is_last;
+        int lid = tidx.local[0];
+        long eidx = tidx.global[0];
+        T v[2 * MULTI_DOT_MAX];
+        T sum[MULTI_DOT_MAX];
+
+        for (int j = 0; j < k; j++)
+            sum[j] = 0;
+
+        while (eidx < size)
+        {
+            for (int d = 0; d < ops.num_values; d++)
+                v[d] = ops.values[d][eidx];
+            for (int j = 0; j < k; j++)
+                sum[j] += v[ops.x[j]] * v[ops.y[j]];
+            eidx += REDUCE_BLOCKS_NUMBER * BLOCK_SIZE;
+        }
+
+        for (int j = 0; j < k; j++)
+        {
+            T s = tile_reduce<T>(sum[j], buf_tmp, tidx);
+            if (lid == 0)
+                partial[j * REDUCE_BLOCKS_NUMBER + tidx.tile[0]] = s;
+        }
+        tidx.barrier.wait_with_global_memory_fence();
+
+        if (lid == 0)
+            is_last = (hc::atomic_fetch_inc(counter) == (unsigned int)(REDUCE_BLOCKS_NUMBER - 1));
+        tidx.barrier.wait_with_global_memory_fence();
+
+        if (!is_last)
+            return;
+
+        for (int j = 0; j < k; j++)
+        {
+            T acc = 0;
+            for (int i = lid; i < REDUCE_BLOCKS_NUMBER; i += BLOCK_SIZE)
+                acc += partial[j * REDUCE_BLOCKS_NUMBER + i];
+            T total = tile_reduce<T>(acc, buf_tmp, tidx);
+            if (lid == 0)
+                avR[j] = total;
+        }
+
+        if (lid == 0)
+            *counter = 0;
+    }).wait();
+
+    return hcsparseSuccess;
+}
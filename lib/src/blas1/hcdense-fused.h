@@ -0,0 +1,435 @@
+#ifndef _HCDENSE_FUSED_H_
+#define _HCDENSE_FUSED_H_
+
+#include "hcsparse.h"
+#include "elementwise-operators.h"
+#include "reduce-operators.h"
+#include <type_traits>
+#define BLOCK_SIZE 256
+
+/*
+ * Expression templates for fusing chains of BLAS-1 statements into a single
+ * kernel. Vector and scalar operands are wrapped in small value types that
+ * are captured by the kernel lambda and evaluated per element, so a sequence
+ * like
+ *
+ *     r -= alpha * y;  rz = <r, z>;  nrm = |r|_1
+ *
+ * reads every vector once and runs as one launch:
+ *
+ *     fused_blas1<T>(N,
+ *                    fused_sub(&r, fused_scal<T>(&alpha) * fused_vec<T>(&y)),
+ *                    fused_nop(),
+ *                    fused_dot(&rz, fused_vec<T>(&r), fused_vec<T>(&z)),
+ *                    fused_norm1(&nrm, fused_vec<T>(&r)),
+ *                    control);
+ *
+ * Assignments run in argument order and the reductions see their results,
+ * matching the order the statements would have as separate calls.
+ */
+
+struct fused_expr_tag {};
+
+template <typename T>
+struct fused_vector : fused_expr_tag
+{
+    typedef T value_type;
+    const T *values;
+    long offset;
+
+    T at (const long i) const __attribute__((hc, cpu))
+    {
+        return values[offset + i];
+    }
+};
+
+template <typename T>
+struct fused_scalar : fused_expr_tag
+{
+    typedef T value_type;
+    const T *value;
+    long offset;
+
+    T at (const long i) const __attribute__((hc, cpu))
+    {
+        return value[offset];
+    }
+};
+
+template <typename T>
+struct fused_constant : fused_expr_tag
+{
+    typedef T value_type;
+    T value;
+
+    T at (const long i) const __attribute__((hc, cpu))
+    {
+        return value;
+    }
+};
+
+template <typename T, ElementWiseOperator OP, typename L, typename R>
+struct fused_binary : fused_expr_tag
+{
+    typedef T value_type;
+    L l;
+    R r;
+
+    T at (const long i) const __attribute__((hc, cpu))
+    {
+        return operation<T, OP>(l.at(i), r.at(i));
+    }
+};
+
+template <typename T>
+fused_vector<T>
+fused_vec (const hcdenseVector *x)
+{
+    fused_vector<T> e;
+    e.values = static_cast<const T*>(x->values);
+    e.offset = x->offValues;
+    return e;
+}
+
+template <typename T>
+fused_scalar<T>
+fused_scal (const hcsparseScalar *a)
+{
+    fused_scalar<T> e;
+    e.value = static_cast<const T*>(a->value);
+    e.offset = a->offValue;
+    return e;
+}
+
+template <typename T>
+fused_constant<T>
+fused_const (const T c)
+{
+    fused_constant<T> e;
+    e.value = c;
+    return e;
+}
+
+// Only expression operands get the overloaded operators below; for anything
+// else fused_result has no type and the overloads drop out.
+template <ElementWiseOperator OP, typename L, typename R,
+          bool = std::is_base_of<fused_expr_tag, L>::value &&
+                 std::is_base_of<fused_expr_tag, R>::value>
+struct fused_result
+{
+};
+
+template <ElementWiseOperator OP, typename L, typename R>
+struct fused_result<OP, L, R, true>
+{
+    typedef fused_binary<typename L::value_type, OP, L, R> type;
+};
+
+template <ElementWiseOperator OP, typename L, typename R>
+typename fused_result<OP, L, R>::type
+fused_make_binary (const L &l, const R &r)
+{
+    typename fused_result<OP, L, R>::type e;
+    e.l = l;
+    e.r = r;
+    return e;
+}
+
+template <typename L, typename R>
+typename fused_result<EW_PLUS, L, R>::type
+operator+ (const L &l, const R &r)
+{
+    return fused_make_binary<EW_PLUS>(l, r);
+}
+
+template <typename L, typename R>
+typename fused_result<EW_MINUS, L, R>::type
+operator- (const L &l, const R &r)
+{
+    return fused_make_binary<EW_MINUS>(l, r);
+}
+
+template <typename L, typename R>
+typename fused_result<EW_MULTIPLY, L, R>::type
+operator* (const L &l, const R &r)
+{
+    return fused_make_binary<EW_MULTIPLY>(l, r);
+}
+
+// division by zero yields zero, see div()
+template <typename L, typename R>
+typename fused_result<EW_DIV, L, R>::type
+operator/ (const L &l, const R &r)
+{
+    return fused_make_binary<EW_DIV>(l, r);
+}
+
+// Stores expr into a vector; OP combines it with the old value, EW_DUMMY
+// overwrites.
+template <typename T, ElementWiseOperator OP, typename E>
+struct fused_assign
+{
+    T *values;
+    long offset;
+    E expr;
+
+    void apply (const long i) const __attribute__((hc, cpu))
+    {
+        T v = expr.at(i);
+        if (OP == EW_DUMMY)
+            values[offset + i] = v;
+        else
+            values[offset + i] = operation<T, OP>(values[offset + i], v);
+    }
+};
+
+// Reduces expr over all elements with G_OP and applies F_OP to the total.
+template <typename T, ReduceOperator G_OP, ReduceOperator F_OP, typename E>
+struct fused_reduction
+{
+    static const bool reduces = true;
+    static const ReduceOperator combine = G_OP;
+    T *value;
+    long offset;
+    E expr;
+
+    T accumulate (T sum, const long i) const __attribute__((hc, cpu))
+    {
+        return reduceOperation<T, G_OP>(sum, expr.at(i));
+    }
+
+    void store (T total) const __attribute__((hc, cpu))
+    {
+        value[offset] = reduceOperation<T, F_OP>(total);
+    }
+};
+
+// Placeholder for an unused assignment or reduction slot of fused_blas1.
+struct fused_nop_t
+{
+    static const bool reduces = false;
+    static const ReduceOperator combine = RO_PLUS;
+
+    void apply (const long i) const __attribute__((hc, cpu)) {}
+
+    template <typename S>
+    S accumulate (S sum, const long i) const __attribute__((hc, cpu))
+    {
+        return sum;
+    }
+
+    template <typename S>
+    void store (S total) const __attribute__((hc, cpu)) {}
+};
+
+inline fused_nop_t
+fused_nop ()
+{
+    return fused_nop_t();
+}
+
+template <ElementWiseOperator OP, typename E>
+fused_assign<typename E::value_type, OP, E>
+fused_make_assign (hcdenseVector *r, const E &expr)
+{
+    typedef typename E::value_type T;
+    fused_assign<T, OP, E> a;
+    a.values = static_cast<T*>(r->values);
+    a.offset = r->offValues;
+    a.expr = expr;
+    return a;
+}
+
+// r = expr
+template <typename E>
+fused_assign<typename E::value_type, EW_DUMMY, E>
+fused_set (hcdenseVector *r, const E &expr)
+{
+    return fused_make_assign<EW_DUMMY>(r, expr);
+}
+
+// r += expr
+template <typename E>
+fused_assign<typename E::value_type, EW_PLUS, E>
+fused_add (hcdenseVector *r, const E &expr)
+{
+    return fused_make_assign<EW_PLUS>(r, expr);
+}
+
+// r -= expr
+template <typename E>
+fused_assign<typename E::value_type, EW_MINUS, E>
+fused_sub (hcdenseVector *r, const E &expr)
+{
+    return fused_make_assign<EW_MINUS>(r, expr);
+}
+
+template <ReduceOperator G_OP, ReduceOperator F_OP, typename E>
+fused_reduction<typename E::value_type, G_OP, F_OP, E>
+fused_make_reduction (hcsparseScalar *s, const E &expr)
+{
+    typedef typename E::value_type T;
+    fused_reduction<T, G_OP, F_OP, E> red;
+    red.value = static_cast<T*>(s->value);
+    red.offset = s->offValue;
+    red.expr = expr;
+    return red;
+}
+
+// s = <l, r>
+template <typename L, typename R>
+fused_reduction<typename L::value_type, RO_PLUS, RO_DUMMY,
+                typename fused_result<EW_MULTIPLY, L, R>::type>
+fused_dot (hcsparseScalar *s, const L &l, const R &r)
+{
+    return fused_make_reduction<RO_PLUS, RO_DUMMY>(s, l * r);
+}
+
+// s = |expr|_1
+template <typename E>
+fused_reduction<typename E::value_type, RO_FABS, RO_DUMMY, E>
+fused_norm1 (hcsparseScalar *s, const E &expr)
+{
+    return fused_make_reduction<RO_FABS, RO_DUMMY>(s, expr);
+}
+
+// s = |expr|_2
+template <typename E>
+fused_reduction<typename E::value_type, RO_SQR, RO_SQRT, E>
+fused_norm2 (hcsparseScalar *s, const E &expr)
+{
+    return fused_make_reduction<RO_SQR, RO_SQRT>(s, expr);
+}
+
+// s = |expr|_inf
+template <typename E>
+fused_reduction<typename E::value_type, RO_FMAX, RO_DUMMY, E>
+fused_norminf (hcsparseScalar *s, const E &expr)
+{
+    return fused_make_reduction<RO_FMAX, RO_DUMMY>(s, expr);
+}
+
+// Runs up to two assignments followed by up to two reductions over size
+// elements in one kernel. Reductions follow the single pass scheme of
+// global_reduce and share its scratch buffer.
+template <typename T, typename A0, typename A1, typename R0, typename R1>
+hcsparseStatus
+fused_blas1 (const long size,
+             const A0 a0,
+             const A1 a1,
+             const R0 r0,
+             const R1 r1,
+             hcsparseControl* control)
+{
+    if (size <= 0)
+        return hcsparseSuccess;
+
+    if (!R0::reduces && !R1::reduces)
+    {
+        hc::extent<1> grdExt(BLOCK_SIZE * ((size - 1)/BLOCK_SIZE + 1));
+        hc::tiled_extent<1> t_ext = grdExt.tile(BLOCK_SIZE);
+        hc::parallel_for_each(control->accl_view, t_ext, [=] (hc::tiled_index<1>& tidx) [[hc]]
+        {
+            long i = tidx.global[0];
+            if (i < size)
+            {
+                a0.apply(i);
+                a1.apply(i);
+            }
+        }).wait();
+
+        return hcsparseSuccess;
+    }
+
+    const int REDUCE_BLOCKS_NUMBER = reduce_num_blocks(size);
+
+    char *scratch = (char*) reduce_get_scratch(2 * sizeof(T) * REDUCE_BLOCKS_NUMBER, control);
+    unsigned int *counter = (unsigned int*) scratch;
+    T *partial = (T*) (scratch + REDUCE_PARTIAL_OFFSET);
+
+    hc::extent<1> grdExt(REDUCE_BLOCKS_NUMBER * BLOCK_SIZE);
+    hc::tiled_extent<1> t_ext = grdExt.tile(BLOCK_SIZE);
+    hc::parallel_for_each(control->accl_view, t_ext, [=] (hc::tiled_index<1>& tidx) [[hc]]
+    {
+        tile_static T buf_tmp[BLOCK_SIZE];
+        tile_static bool is_last;
+        int lid = tidx.local[0];
+        long eidx = tidx.global[0];
+        T sum0 = 0;
+        T sum1 = 0;
+
+        while (eidx < size)
+        {
+            a0.apply(eidx);
+            a1.apply(eidx);
+            sum0 = r0.accumulate(sum0, eidx);
+            sum1 = r1.accumulate(sum1, eidx);
+            eidx += REDUCE_BLOCKS_NUMBER * BLOCK_SIZE;
+        }
+
+        if (R0::reduces)
+            sum0 = tile_reduce<T, R0::combine>(sum0, buf_tmp, tidx);
+        if (R1::reduces)
+            sum1 = tile_reduce<T, R1::combine>(sum1, buf_tmp, tidx);
+        if (lid == 0)
+        {
+            partial[tidx.tile[0]] = sum0;
+            partial[REDUCE_BLOCKS_NUMBER + tidx.tile[0]] = sum1;
+        }
+        tidx.barrier.wait_with_global_memory_fence();
+
+        if (lid == 0)
+            is_last = (hc::atomic_fetch_inc(counter) == (unsigned int)(REDUCE_BLOCKS_NUMBER - 1));
+        tidx.barrier.wait_with_global_memory_fence();
+
+        if (!is_last)
+            return;
+
+        T acc0 = 0;
+        T acc1 = 0;
+        for (int i = lid; i < REDUCE_BLOCKS_NUMBER; i += BLOCK_SIZE)
+        {
+            acc0 = reduceCombine<T, R0::combine>(acc0, partial[i]);
+            acc1 = reduceCombine<T, R1::combine>(acc1, partial[REDUCE_BLOCKS_NUMBER + i]);
+        }
+        if (R0::reduces)
+            acc0 = tile_reduce<T, R0::combine>(acc0, buf_tmp, tidx);
+        if (R1::reduces)
+            acc1 = tile_reduce<T, R1::combine>(acc1, buf_tmp, tidx);
+
+        if (lid == 0)
+        {
+            r0.store(acc0);
+            r1.store(acc1);
+            *counter = 0;
+        }
+    }).wait();
+
+    return hcsparseSuccess;
+}
+
+// fused_blas1 whose first reduction is the norm of expr selected at run time,
+// as the solvers do for hcsparseSolverControl::residualNorm.
+template <typename T, typename A0, typename A1, typename E, typename R1>
+hcsparseStatus
+fused_blas1_norm (const long size,
+                  const A0 a0,
+                  const A1 a1,
+                  const SOLVER_NORM norm,
+                  hcsparseScalar *s,
+                  const E &expr,
+                  const R1 r1,
+                  hcsparseControl* control)
+{
+    switch (norm)
+    {
+    case NORM_L1:
+        return fused_blas1<T>(size, a0, a1, fused_norm1(s, expr), r1, control);
+    case NORM_LINF:
+        return fused_blas1<T>(size, a0, a1, fused_norminf(s, expr), r1, control);
+    default:
+        return fused_blas1<T>(size, a0, a1, fused_norm2(s, expr), r1, control);
+    }
+}
+
+#endif //_HCDENSE_FUSED_H_
@@ -2,6 +2,121 @@
 #include "reduce-operators.h"
 #define BLOCK_SIZE 256
 
+// Upper bound on the number of tiles a global reduction launches; every
+// thread strides over the input so larger inputs only lengthen the loop.
+#define REDUCE_MAX_BLOCKS 1024
+
+// Offset of the per tile partials inside the reduction scratch; the first
+// word holds the tile completion counter.
+#define REDUCE_PARTIAL_OFFSET 16
+
+// Device scratch shared by the single pass reductions. The leading counter
+// is zeroed when the buffer is (re)allocated and every reduction hands it
+// back as zero, so steady-state calls neither allocate nor clear anything.
+typedef struct reduceScratch_
+{
+    void *buffer;
+    size_t bytes;
+} reduceScratch;
+
+static reduceScratch reduce_scratch = { nullptr, 0 };
+
+inline void*
+reduce_get_scratch (size_t partial_bytes,
+                    hcsparseControl* control)
+{
+    size_t bytes = REDUCE_PARTIAL_OFFSET + partial_bytes;
+
+    if (bytes > reduce_scratch.bytes)
+    {
+        hc::accelerator acc = (control->accl_view).get_accelerator();
+        if (reduce_scratch.buffer != nullptr)
+            am_free(reduce_scratch.buffer);
+        reduce_scratch.buffer = am_alloc(bytes, acc, 0);
+        reduce_scratch.bytes = bytes;
+
+        unsigned int zero = 0;
+        control->accl_view.copy(&zero, reduce_scratch.buffer, sizeof(unsigned int));
+    }
+
+    return reduce_scratch.buffer;
+}
+
+inline void
+reduce_release_scratch ()
+{
+    if (reduce_scratch.buffer != nullptr)
+        am_free(reduce_scratch.buffer);
+    reduce_scratch.buffer = nullptr;
+    reduce_scratch.bytes = 0;
+}
+
+inline int
+reduce_num_blocks (const long size)
+{
+    long blocks = size / BLOCK_SIZE + 1;
+    return blocks < REDUCE_MAX_BLOCKS ? (int)blocks : REDUCE_MAX_BLOCKS;
+}
+
+// Tree reduction of one value per thread of the tile; every thread gets the
+// result. Partial results are combined as described by reduceCombine.
+template <typename T, ReduceOperator C_OP = RO_PLUS>
+T tile_reduce (T sum,
+               T *buf,
+               hc::tiled_index<1> &tidx) [[hc]]
+{
+    int lid = tidx.local[0];
+    buf[lid] = sum;
+    tidx.barrier.wait();
+    for (int s = BLOCK_SIZE >> 1; s > 0; s >>= 1)
+    {
+        if (lid < s)
+            buf[lid] = sum = reduceCombine<T, C_OP>(sum, buf[lid + s]);
+        tidx.barrier.wait();
+    }
+    T total = buf[0];
+    tidx.barrier.wait();
+    return total;
+}
+
+// Called by every tile once it has reduced its share into sum. The tile that
+// finishes last sums all partials, so the whole reduction takes one launch.
+// Returns true in the last tile, where total then holds the grand total.
+template <typename T, ReduceOperator C_OP = RO_PLUS>
+bool tile_reduce_finish (T sum,
+                         T &total,
+                         T *buf,
+                         T *partial,
+                         unsigned int *counter,
+                         const int num_blocks,
+                         bool &is_last,
+                         hc::tiled_index<1> &tidx) [[hc]]
+{
+    int lid = tidx.local[0];
+
+    sum = tile_reduce<T, C_OP>(sum, buf, tidx);
+    if (lid == 0)
+        partial[tidx.tile[0]] = sum;
+    tidx.barrier.wait_with_global_memory_fence();
+
+    if (lid == 0)
+        is_last = (hc::atomic_fetch_inc(counter) == (unsigned int)(num_blocks - 1));
+    tidx.barrier.wait_with_global_memory_fence();
+
+    if (!is_last)
+        return false;
+
+    T acc = 0;
+    for (int i = lid; i < num_blocks; i += BLOCK_SIZE)
+        acc = reduceCombine<T, C_OP>(acc, partial[i]);
+    total = tile_reduce<T, C_OP>(acc, buf, tidx);
+
+    if (lid == 0)
+        *counter = 0;
+
+    return true;
+}
+
 template <typename T, ReduceOperator G_OP, ReduceOperator F_OP = RO_DUMMY>
 void reduce_row_column (T *pX,
                         T *partial,
@@ -15,7 +130,6 @@ void reduce_row_column (T *pX,
     hc::parallel_for_each(control->accl_view, t_ext, [=] (hc::tiled_index<1>& tidx) [[hc]]
     {
         tile_static T buf_tmp[BLOCK_SIZE];
-        uint idx = tidx.global[0];
         uint lidx = tidx.local[0];
         uint eidx = lidx;
         T sum = 0;
@@ -24,16 +138,11 @@ void reduce_row_column (T *pX,
           sum += pX[tidx.tile[0] * n + eidx];
           eidx += BLOCK_SIZE;
         }
-        buf_tmp[lidx] = sum;
-        tidx.barrier.wait();
 
-        if (lidx == 0) {
-          sum = 0;
-          for (uint i = 0; i < n; i++) { 
-            sum += buf_tmp[i]; 
-          }
+        sum = tile_reduce<T>(sum, buf_tmp, tidx);
+
+        if (lidx == 0)
           partial[tidx.tile[0]] = sum;
-        }
     }).wait();
 }
 
@@ -43,20 +152,21 @@ void global_reduce (const long size,
                     const long pROffset,
                     T *pX,
                     const long pXOffset,
-                    T *partial,
-                    const int REDUCE_BLOCKS_NUMBER,
                     hcsparseControl* control)
 {
+    const int REDUCE_BLOCKS_NUMBER = reduce_num_blocks(size);
+
+    char *scratch = (char*) reduce_get_scratch(sizeof(T) * REDUCE_BLOCKS_NUMBER, control);
+    unsigned int *counter = (unsigned int*) scratch;
+    T *partial = (T*) (scratch + REDUCE_PARTIAL_OFFSET);
 
     hc::extent<1> grdExt(REDUCE_BLOCKS_NUMBER * BLOCK_SIZE);
     hc::tiled_extent<1> t_ext = grdExt.tile(BLOCK_SIZE);
     hc::parallel_for_each(control->accl_view, t_ext, [=] (hc::tiled_index<1>& tidx) [[hc]]
     {
         tile_static T buf_tmp[BLOCK_SIZE];
-        int idx = tidx.global[0];
-        int block_idx = idx / BLOCK_SIZE;
-        int thread_in_block_idx = idx % BLOCK_SIZE;
-        int eidx = idx;
+        tile_static bool is_last;
+        long eidx = tidx.global[0];
         T sum = 0;
 
         while(eidx < size)
@@ -64,32 +174,15 @@ void global_reduce (const long size,
             sum = reduceOperation<T, G_OP>(sum, pX[pXOffset + eidx]);
             eidx += REDUCE_BLOCKS_NUMBER * BLOCK_SIZE;
         }
-        buf_tmp[thread_in_block_idx] = sum;
-        tidx.barrier.wait();
 
-        // Seqential part
-        if (tidx.local[0] == 0)
+        T total;
+        if (tile_reduce_finish<T, G_OP>(sum, total, buf_tmp, partial, counter,
+                                        REDUCE_BLOCKS_NUMBER, is_last, tidx))
         {
-            sum = 0;
-            for (uint i = 0; i < BLOCK_SIZE; i++)
-            {
-                sum += buf_tmp[i];
-            }
-            partial[block_idx] = sum;
+            if (tidx.local[0] == 0)
+                pR[pROffset] = reduceOperation<T, F_OP>(total);
         }
     }).wait();
-
-    hc::extent<1> grdExt1(1);
-    hc::tiled_extent<1> t_ext1 = grdExt1.tile(1);
-    hc::parallel_for_each(control->accl_view, t_ext1, [=] (hc::tiled_index<1>& tidx) [[hc]]
-    {
-        T sum = 0;
-        for (uint i = 0; i < REDUCE_BLOCKS_NUMBER; i++)
-        {
-            sum += partial[i];
-        }
-        pR[pROffset] = reduceOperation<T, F_OP>(sum);
-    }).wait();
 }
 
 template <typename T, ReduceOperator G_OP, ReduceOperator F_OP = RO_DUMMY>
@@ -99,21 +192,11 @@ reduce (hcsparseScalar* pR,
         hcsparseControl* control)
 {
     int size = pX->num_values;
-    int REDUCE_BLOCKS_NUMBER = size/BLOCK_SIZE + 1;
-
-    hc::accelerator acc = (control->accl_view).get_accelerator();
-
-    T *partial = (T*) am_alloc(sizeof(T) * REDUCE_BLOCKS_NUMBER, acc, 0);
 
     T *avR = static_cast<T*>(pR->value);
     T *avX = static_cast<T*>(pX->values);
 
-    global_reduce<T, G_OP, F_OP> (size, avR, pR->offValue, avX, pX->offValues, partial, REDUCE_BLOCKS_NUMBER, control);
-
-    control->accl_view.wait();
-
-    am_free(partial);
+    global_reduce<T, G_OP, F_OP> (size, avR, pR->offValue, avX, pX->offValues, control);
 
     return hcsparseSuccess;
 }
-
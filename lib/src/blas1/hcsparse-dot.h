@@ -7,52 +7,35 @@ void inner_product (const long size,
                     T *pX,
                     int *pXInd,
                     T *pY,
-                    T *partial,
-                    const int REDUCE_BLOCKS_NUMBER,
                     hcsparseControl *control)
 {
+    const int REDUCE_BLOCKS_NUMBER = reduce_num_blocks(size);
+
+    char *scratch = (char*) reduce_get_scratch(sizeof(T) * REDUCE_BLOCKS_NUMBER, control);
+    unsigned int *counter = (unsigned int*) scratch;
+    T *partial = (T*) (scratch + REDUCE_PARTIAL_OFFSET);
+
     hc::extent<1> grdExt(REDUCE_BLOCKS_NUMBER * BLOCK_SIZE);
     hc::tiled_extent<1> t_ext = grdExt.tile(BLOCK_SIZE);
-    hc::parallel_for_each(control->accl_view, t_ext, [=] (hc::tiled_index<1>& tidx) __attribute__((hc, cpu))
+    hc::parallel_for_each(control->accl_view, t_ext, [=] (hc::tiled_index<1>& tidx) [[hc]]
     {
         tile_static T buf_tmp[BLOCK_SIZE];
-        int idx = tidx.global[0];
-        int block_idx = idx / BLOCK_SIZE;
-        int thread_in_block_idx = idx % BLOCK_SIZE;
-        int eidx = idx;
+        tile_static bool is_last;
+        long eidx = tidx.global[0];
         T sum = 0;
 
         while(eidx < size)
         {
-            sum = pX[eidx] * pY[pXInd[eidx]];
+            sum += pX[eidx] * pY[pXInd[eidx]];
             eidx += REDUCE_BLOCKS_NUMBER * BLOCK_SIZE;
         }
-        buf_tmp[thread_in_block_idx] = sum;
-        tidx.barrier.wait();
-
-        // Seqential part
-        if (tidx.local[0] == 0)
-        {
-            sum = 0;
-            for (uint i = 0; i < BLOCK_SIZE; i++)
-            {
-                sum += buf_tmp[i];
-            }
-            partial[block_idx] = sum;
-        }
-    }).wait();
 
-    hc::extent<1> grdExt1(1);
-    hc::tiled_extent<1> t_ext1 = grdExt1.tile(1);
-    hc::parallel_for_each(control->accl_view, t_ext1, [=] (hc::tiled_index<1>& tidx) __attribute__((hc, cpu))
-    {
-        T sum = 0;
-        for (uint i = 0; i < REDUCE_BLOCKS_NUMBER; i++)
+        T total;
+        if (tile_reduce_finish<T>(sum, total, buf_tmp, partial, counter,
+                                  REDUCE_BLOCKS_NUMBER, is_last, tidx))
         {
-            sum += partial[i];
+            if (tidx.local[0] == 0)
+                pR[0] = total;
         }
-        pR[0] = sum;
     }).wait();
-
 }
-
@@ -7,6 +7,7 @@ enum ReduceOperator
     RO_SQR,
     RO_SQRT,
     RO_FABS,
+    RO_FMAX,
     RO_DUMMY //does nothing
 };
 
@@ -28,6 +29,13 @@ T fabs (T a, T b) __attribute__((hc, cpu))
     return a + hc::precise_math::fabsf((float)b);
 }
 
+template <typename T>
+T fmax_abs (T a, T b) __attribute__((hc, cpu))
+{
+    T c = b < 0 ? -b : b;
+    return a >= c ? a : c;
+}
+
 template <typename T>
 T sqr_root (T a) __attribute__((hc, cpu))
 {
@@ -49,6 +57,8 @@ T reduceOperation (T a, T b) __attribute__((hc, cpu))
         return sqr<T>(a, b);
     else if (OP == RO_FABS)
         return fabs<T>(a, b);
+    else if (OP == RO_FMAX)
+        return fmax_abs<T>(a, b);
 }
 
 template <typename T, ReduceOperator OP>
@@ -59,4 +69,13 @@ T reduceOperation (T a) __attribute__((hc, cpu))
     else
         return reduce_dummy<T>(a);
 }
+// combines two partial results of a reduction that used OP
+template <typename T, ReduceOperator OP>
+T reduceCombine (T a, T b) __attribute__((hc, cpu))
+{
+    if (OP == RO_FMAX)
+        return a >= b ? a : b;
+    else
+        return a + b;
+}
 #endif
@@ -0,0 +1,178 @@
+#ifndef _HCSPARSE_CSRMV_SEMIRING_H_
+#define _HCSPARSE_CSRMV_SEMIRING_H_
+
+#include "hcsparse.h"
+#include "semiring.h"
+
+// y(row) = add_j mul(A(row, j), x(j)), or add(y(row), .) when accumulating.
+// With a mask only the rows where (mask(row) != 0) != complement are
+// computed, the others are neither read nor written.
+// SUB lanes share a row, the same csr-vector scheme as csrmv_vector_kernel;
+// a tile moves through the rows in lockstep so that every lane meets the
+// same barriers even past the last row.
+template <typename T, typename SR, int SUB>
+void
+csrmv_semiring_kernel (const int num_rows,
+                       const int *row_offset,
+                       const int *col,
+                       const T *val,
+                       const T *x,
+                       T *y,
+                       const bool accumulate,
+                       const T *mask,
+                       const bool complement,
+                       const uint global_work_size,
+                       hcsparseControl *control)
+{
+    hc::extent<1> grdExt(global_work_size);
+    hc::tiled_extent<1> t_ext = grdExt.tile(BLOCK_SIZE);
+    hc::parallel_for_each(control->accl_view, t_ext, [=] (hc::tiled_index<1> &tidx) [[hc]]
+    {
+        tile_static T sdata[BLOCK_SIZE];
+
+        const int local_id = tidx.local[0];
+        const int thread_lane = local_id & (SUB - 1);
+        const int num_vectors = global_work_size / SUB;
+        const int first_vector = tidx.tile[0] * (BLOCK_SIZE / SUB);
+
+        for (int base = first_vector; base < num_rows; base += num_vectors)
+        {
+            const int row = base + local_id / SUB;
+            const bool active = row < num_rows &&
+                                (mask == nullptr || ((mask[row] != 0) != complement));
+
+            T sum = SR::zero();
+            if (active)
+            {
+                for (int j = row_offset[row] + thread_lane; j < row_offset[row + 1]; j += SUB)
+                    sum = SR::add(sum, SR::mul(val[j], x[col[j]]));
+            }
+
+            sdata[local_id] = sum;
+            for (int i = SUB >> 1; i > 0; i >>= 1)
+            {
+                tidx.barrier.wait();
+                if (thread_lane < i)
+                    sum = SR::add(sum, sdata[local_id + i]);
+                tidx.barrier.wait();
+                sdata[local_id] = sum;
+            }
+
+            if (thread_lane == 0 && active)
+                y[row] = accumulate ? SR::add(y[row], sum) : sum;
+
+            tidx.barrier.wait();
+        }
+    }).wait();
+}
+
+/*
+ * Sparse matrix times dense vector over the semiring SR. The lanes per row
+ * follow the average row length, as csrmv does, and are a template
+ * argument so the reduction unrolls. pMask, when given, selects the rows
+ * of y to compute (its nonzeros, or the zeros with complement), e.g. the
+ * unvisited vertices of a breadth first search.
+ */
+template <typename T, typename SR>
+hcsparseStatus
+csrmv_semiring (const hcsparseCsrMatrix *pA,
+                const hcdenseVector *pX,
+                hcdenseVector *pY,
+                const bool accumulate,
+                hcsparseControl *control,
+                const hcdenseVector *pMask = nullptr,
+                const bool complement = false)
+{
+    if (pA->num_cols != pX->num_values || pA->num_rows != pY->num_values ||
+        (pMask != nullptr && pMask->num_values != pY->num_values))
+    {
+        return hcsparseInvalid;
+    }
+
+    if (pA->num_rows == 0)
+    {
+        return hcsparseSuccess;
+    }
+
+    const int *rowOff = static_cast<const int*>(pA->rowOffsets) + pA->offRowOff;
+    const int *colInd = static_cast<const int*>(pA->colIndices) + pA->offColInd;
+    const T *vals = static_cast<const T*>(pA->values) + pA->offValues;
+    const T *x = static_cast<const T*>(pX->values) + pX->offValues;
+    T *y = static_cast<T*>(pY->values) + pY->offValues;
+    const T *mask = pMask == nullptr ? nullptr : static_cast<const T*>(pMask->values) + pMask->offValues;
+
+    const int num_rows = pA->num_rows;
+    const uint nnz_per_row = pA->nnz_per_row();
+
+    // lanes per row: the average row length rounded up to a power of two,
+    // at least 2 and at most a wavefront
+    int sub = 2;
+    while (sub < 64 && sub < (int)nnz_per_row)
+        sub <<= 1;
+
+    uint predicted = (uint)sub * num_rows;
+    uint global_work_size = BLOCK_SIZE * ((predicted + BLOCK_SIZE - 1) / BLOCK_SIZE);
+
+    switch (sub)
+    {
+    case 2:
+        csrmv_semiring_kernel<T, SR, 2>(num_rows, rowOff, colInd, vals, x, y, accumulate,
+                                        mask, complement, global_work_size, control);
+        break;
+    case 4:
+        csrmv_semiring_kernel<T, SR, 4>(num_rows, rowOff, colInd, vals, x, y, accumulate,
+                                        mask, complement, global_work_size, control);
+        break;
+    case 8:
+        csrmv_semiring_kernel<T, SR, 8>(num_rows, rowOff, colInd, vals, x, y, accumulate,
+                                        mask, complement, global_work_size, control);
+        break;
+    case 16:
+        csrmv_semiring_kernel<T, SR, 16>(num_rows, rowOff, colInd, vals, x, y, accumulate,
+                                         mask, complement, global_work_size, control);
+        break;
+    case 32:
+        csrmv_semiring_kernel<T, SR, 32>(num_rows, rowOff, colInd, vals, x, y, accumulate,
+                                         mask, complement, global_work_size, control);
+        break;
+    default:
+        csrmv_semiring_kernel<T, SR, 64>(num_rows, rowOff, colInd, vals, x, y, accumulate,
+                                         mask, complement, global_work_size, control);
+        break;
+    }
+
+    return hcsparseSuccess;
+}
+
+// Runtime selection among the predefined semirings of the public API
+template <typename T>
+hcsparseStatus
+csrmv_semiring (const SEMIRING semiring,
+                const hcsparseCsrMatrix *pA,
+                const hcdenseVector *pX,
+                hcdenseVector *pY,
+                const bool accumulate,
+                hcsparseControl *control,
+                const hcdenseVector *pMask = nullptr,
+                const bool complement = false)
+{
+    switch (semiring)
+    {
+    case SR_PLUS_TIMES:
+        return csrmv_semiring<T, PlusTimes<T>>(pA, pX, pY, accumulate, control, pMask, complement);
+    case SR_MIN_PLUS:
+        return csrmv_semiring<T, MinPlus<T>>(pA, pX, pY, accumulate, control, pMask, complement);
+    case SR_MAX_TIMES:
+        return csrmv_semiring<T, MaxTimes<T>>(pA, pX, pY, accumulate, control, pMask, complement);
+    case SR_OR_AND:
+        return csrmv_semiring<T, OrAnd<T>>(pA, pX, pY, accumulate, control, pMask, complement);
+    case SR_PLUS_MIN:
+        return csrmv_semiring<T, PlusMin<T>>(pA, pX, pY, accumulate, control, pMask, complement);
+    case SR_MAX_MIN:
+        return csrmv_semiring<T, MaxMin<T>>(pA, pX, pY, accumulate, control, pMask, complement);
+    default:
+        return hcsparseInvalid;
+    }
+}
+
+#endif //_HCSPARSE_CSRMV_SEMIRING_H_
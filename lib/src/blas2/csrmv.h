@@ -255,7 +255,8 @@ T atomic_two_sum_float (T *x_ptr,
 // INDEX_TYPE - typename for the type of integer data read by the kernel,  usually unsigned int
 // T - typename for the type of floating point data, usually double
 // SUBWAVE_SIZE - the length of a "sub-wave", a power of 2, i.e. 1,2,4,...,WAVE_SIZE, assigned to process a single matrix row
-template <typename T>
+// BASE - index base of row_offset and col, 0 or 1
+template <typename T, int BASE = 0>
 void csrmv_vector_kernel (const INDEX_TYPE num_rows,
                           const T *alpha,
                           const SIZE_TYPE off_alpha,
@@ -289,15 +290,15 @@ void csrmv_vector_kernel (const INDEX_TYPE num_rows,
 
         for(INDEX_TYPE row = vector_id; row < num_rows; row += num_vectors)
         {
-            const INDEX_TYPE row_start = row_offset[row];
-            const INDEX_TYPE row_end   = row_offset[row+1];
+            const INDEX_TYPE row_start = row_offset[row] - BASE;
+            const INDEX_TYPE row_end   = row_offset[row+1] - BASE;
             T sum = 0.;
 
             T sumk_e = 0.;
             // It is about 5% faster to always multiply by alpha, rather than to
             // check whether alpha is 0, 1, or other and do different code paths.
             for(INDEX_TYPE j = row_start + thread_lane; j < row_end; j += SUBWAVE_SIZE)
-                sum = two_fma<T> (_alpha * val[j], x[off_x + col[j]], sum, sumk_e);
+                sum = two_fma<T> (_alpha * val[j], x[off_x + col[j] - BASE], sum, sumk_e);
             T new_error = 0.;
             sum = two_sum<T> (sum, sumk_e, new_error);
 
@@ -847,7 +848,7 @@ csrmv (const hcsparseScalar *pAlpha,
     }
 }
 
-template <typename T>
+template <typename T, int BASE = 0>
 hcsparseStatus
 csrmv ( hcsparseControl *control,
         int m, int n, int nnz, const T *alpha,
@@ -900,7 +901,7 @@ csrmv ( hcsparseControl *control,
         global_work_size = WG_SIZE;
     }
 
-    csrmv_vector_kernel<T> (m, alpha, 0,
+    csrmv_vector_kernel<T, BASE> (m, alpha, 0,
                             csrRowPtrA, csrColIndA, csrValA,
                             x, 0, beta, 0,
                             y, 0, global_work_size, control);
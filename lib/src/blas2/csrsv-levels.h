@@ -0,0 +1,161 @@
+#ifndef _HCSPARSE_CSRSV_LEVELS_H_
+#define _HCSPARSE_CSRSV_LEVELS_H_
+
+#include "hcsparse.h"
+#include <algorithm>
+#include <vector>
+
+#define LEVEL_BLOCK_SIZE 256
+
+/*
+ * Level set (wavefront) schedule of the lower or upper triangle of a CSR
+ * matrix. Row i of the lower triangle lands one level after the deepest row
+ * j < i it references (j > i for the upper triangle), so all rows of one
+ * level are independent and are solved by a single launch. The schedule
+ * only depends on the sparsity pattern and is built once on the host.
+ */
+typedef struct _levelSchedule
+{
+    _levelSchedule() : num_rows(0), num_levels(0), rows(nullptr)
+    {
+
+    }
+
+    int num_rows;
+
+    int num_levels;
+
+    // first entry of every level in rows, num_levels + 1 entries (host)
+    std::vector<int> level_ptr;
+
+    // row indices ordered by level (device)
+    int *rows;
+} levelSchedule;
+
+// rowOffsets and colIndices are host copies of the matrix pattern, with
+// indices starting at base
+template <bool lower>
+hcsparseStatus
+level_schedule_build (levelSchedule *ls,
+                      const int num_rows,
+                      const int *rowOffsets,
+                      const int *colIndices,
+                      hcsparseControl *control,
+                      const int base = 0)
+{
+    std::vector<int> level(num_rows, 0);
+    int num_levels = 0;
+
+    for (int k = 0; k < num_rows; k++)
+    {
+        int i = lower ? k : num_rows - 1 - k;
+        int lev = 0;
+        for (int p = rowOffsets[i] - base; p < rowOffsets[i + 1] - base; p++)
+        {
+            int j = colIndices[p] - base;
+            if ((lower && j < i) || (!lower && j > i))
+                lev = std::max(lev, level[j] + 1);
+        }
+        level[i] = lev;
+        num_levels = std::max(num_levels, lev + 1);
+    }
+
+    // counting sort of the rows by level
+    ls->level_ptr.assign(num_levels + 1, 0);
+    for (int i = 0; i < num_rows; i++)
+        ls->level_ptr[level[i] + 1]++;
+    for (int l = 0; l < num_levels; l++)
+        ls->level_ptr[l + 1] += ls->level_ptr[l];
+
+    std::vector<int> next(ls->level_ptr.begin(), ls->level_ptr.end() - 1);
+    std::vector<int> rows(num_rows);
+    for (int i = 0; i < num_rows; i++)
+        rows[next[level[i]]++] = i;
+
+    hc::accelerator acc = (control->accl_view).get_accelerator();
+
+    if (ls->rows != nullptr)
+        am_free(ls->rows);
+    ls->rows = (int*) am_alloc(sizeof(int) * std::max(num_rows, 1), acc, 0);
+    if (ls->rows == nullptr)
+        return hcsparseInvalid;
+
+    control->accl_view.copy(rows.data(), ls->rows, sizeof(int) * num_rows);
+
+    ls->num_rows = num_rows;
+    ls->num_levels = num_levels;
+
+    return hcsparseSuccess;
+}
+
+inline void
+level_schedule_free (levelSchedule *ls)
+{
+    if (ls->rows != nullptr)
+        am_free(ls->rows);
+    ls->rows = nullptr;
+    ls->level_ptr.clear();
+    ls->num_rows = 0;
+    ls->num_levels = 0;
+}
+
+/*
+ * Solves the lower (or upper) triangle of A for the nrhs columns of Y, one
+ * launch per level and one thread per row and column:
+ *     Y[i] = alpha * X[i] - sum_{j < i} A_ij Y[j]    (divided by A_ii unless unit)
+ * X and Y are column major with leading dimensions ldx and ldy and may be
+ * the same matrix. alpha is a device scalar, nullptr stands for one.
+ */
+template <typename T, bool lower, bool unit, int BASE = 0>
+void
+level_triangular_solve (const levelSchedule *ls,
+                        const T *alpha,
+                        const int *rowOffsets,
+                        const int *colIndices,
+                        const T *values,
+                        const T *X,
+                        const int ldx,
+                        T *Y,
+                        const int ldy,
+                        const int nrhs,
+                        hcsparseControl *control)
+{
+    const int *rows = ls->rows;
+
+    for (int l = 0; l < ls->num_levels; l++)
+    {
+        const int first = ls->level_ptr[l];
+        const int count = ls->level_ptr[l + 1] - first;
+        const int total = count * nrhs;
+
+        hc::extent<1> grdExt(LEVEL_BLOCK_SIZE * ((total - 1)/LEVEL_BLOCK_SIZE + 1));
+        hc::tiled_extent<1> t_ext = grdExt.tile(LEVEL_BLOCK_SIZE);
+        hc::parallel_for_each(control->accl_view, t_ext, [=] (hc::tiled_index<1>& tidx) [[hc]]
+        {
+            int gid = tidx.global[0];
+            if (gid < total)
+            {
+                int row = rows[first + gid % count];
+                int rhs = gid / count;
+                const T *x = X + (long)rhs * ldx;
+                T *y = Y + (long)rhs * ldy;
+
+                T sum = (alpha == nullptr ? (T)1 : alpha[0]) * x[row];
+                T diag = 1;
+
+                for (int p = rowOffsets[row] - BASE; p < rowOffsets[row + 1] - BASE; p++)
+                {
+                    int col = colIndices[p] - BASE;
+                    if ((lower && col < row) || (!lower && col > row))
+                        sum -= values[p] * y[col];
+                    else if (col == row)
+                        diag = values[p];
+                }
+
+                y[row] = unit ? sum : sum / diag;
+            }
+        }).wait();
+    }
+}
+
+#endif //_HCSPARSE_CSRSV_LEVELS_H_
@@ -0,0 +1,123 @@
+#ifndef _HCSPARSE_CSRSV_H_
+#define _HCSPARSE_CSRSV_H_
+
+#include "hcsparse.h"
+#include "csrsv-levels.h"
+
+// Opaque result of hcsparseXcsrsv_analysis: the level schedule of the
+// triangle named by the fill mode, valid for any values on that pattern.
+struct hcsparseSolveAnalysisInfo
+{
+    hcsparseSolveAnalysisInfo() : m(0), fillMode(HCSPARSE_FILL_MODE_LOWER),
+        indexBase(HCSPARSE_INDEX_BASE_ZERO), analysed(false)
+    {
+
+    }
+
+    ~hcsparseSolveAnalysisInfo()
+    {
+        level_schedule_free(&levels);
+    }
+
+    int m;
+
+    hcsparseFillMode_t fillMode;
+
+    hcsparseIndexBase_t indexBase;
+
+    bool analysed;
+
+    levelSchedule levels;
+};
+
+inline hcsparseStatus
+csrsv_analysis (hcsparseControl *control,
+                int m, int nnz,
+                hcsparseFillMode_t fillMode,
+                hcsparseIndexBase_t indexBase,
+                const int *csrRowPtrA,
+                const int *csrColIndA,
+                hcsparseSolveAnalysisInfo *info)
+{
+    int *h_rowPtr = (int*) calloc(m + 1, sizeof(int));
+    int *h_colInd = (int*) calloc(std::max(nnz, 1), sizeof(int));
+
+    control->accl_view.copy(csrRowPtrA, h_rowPtr, sizeof(int) * (m + 1));
+    control->accl_view.copy(csrColIndA, h_colInd, sizeof(int) * nnz);
+
+    int base = (indexBase == HCSPARSE_INDEX_BASE_ONE) ? 1 : 0;
+    hcsparseStatus stat;
+
+    if (fillMode == HCSPARSE_FILL_MODE_LOWER)
+        stat = level_schedule_build<true>(&info->levels, m, h_rowPtr, h_colInd, control, base);
+    else
+        stat = level_schedule_build<false>(&info->levels, m, h_rowPtr, h_colInd, control, base);
+
+    free(h_rowPtr);
+    free(h_colInd);
+
+    info->m = m;
+    info->fillMode = fillMode;
+    info->indexBase = indexBase;
+    info->analysed = (stat == hcsparseSuccess);
+
+    return stat;
+}
+
+template <typename T, bool lower, int BASE>
+void
+csrsv_solve_dispatch (hcsparseControl *control,
+                      bool unit, const T *alpha,
+                      const T *csrValA, const int *csrRowPtrA, const int *csrColIndA,
+                      const hcsparseSolveAnalysisInfo *info,
+                      const T *X, int ldx, T *Y, int ldy, int nrhs)
+{
+    if (unit)
+        level_triangular_solve<T, lower, true, BASE>(&info->levels, alpha, csrRowPtrA, csrColIndA,
+                                                     csrValA, X, ldx, Y, ldy, nrhs, control);
+    else
+        level_triangular_solve<T, lower, false, BASE>(&info->levels, alpha, csrRowPtrA, csrColIndA,
+                                                      csrValA, X, ldx, Y, ldy, nrhs, control);
+}
+
+// Y = alpha * op(A)^{-1} X for the nrhs columns of X, op(A) being the
+// triangle of A analysed into info
+template <typename T>
+hcsparseStatus
+csrsv_solve (hcsparseControl *control,
+             int m, int nrhs, const T *alpha,
+             const hcsparseMatDescr_t descrA,
+             const T *csrValA, const int *csrRowPtrA, const int *csrColIndA,
+             const hcsparseSolveAnalysisInfo *info,
+             const T *X, int ldx, T *Y, int ldy)
+{
+    if (!info->analysed || info->m != m ||
+        info->fillMode != descrA->FillMode || info->indexBase != descrA->IndexBase)
+        return hcsparseInvalid;
+
+    bool unit = (descrA->DiagType == HCSPARSE_DIAG_TYPE_UNIT);
+    bool lower = (descrA->FillMode == HCSPARSE_FILL_MODE_LOWER);
+
+    if (descrA->IndexBase == HCSPARSE_INDEX_BASE_ONE)
+    {
+        if (lower)
+            csrsv_solve_dispatch<T, true, 1>(control, unit, alpha, csrValA, csrRowPtrA, csrColIndA,
+                                             info, X, ldx, Y, ldy, nrhs);
+        else
+            csrsv_solve_dispatch<T, false, 1>(control, unit, alpha, csrValA, csrRowPtrA, csrColIndA,
+                                              info, X, ldx, Y, ldy, nrhs);
+    }
+    else
+    {
+        if (lower)
+            csrsv_solve_dispatch<T, true, 0>(control, unit, alpha, csrValA, csrRowPtrA, csrColIndA,
+                                             info, X, ldx, Y, ldy, nrhs);
+        else
+            csrsv_solve_dispatch<T, false, 0>(control, unit, alpha, csrValA, csrRowPtrA, csrColIndA,
+                                              info, X, ldx, Y, ldy, nrhs);
+    }
+
+    return hcsparseSuccess;
+}
+
+#endif //_HCSPARSE_CSRSV_H_
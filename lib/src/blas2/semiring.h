@@ -0,0 +1,74 @@
+#ifndef _HCSPARSE_SEMIRING_H_
+#define _HCSPARSE_SEMIRING_H_
+
+#include "hcsparse.h"
+#include <limits>
+
+/* Semirings for the graph kernels. A semiring is a type with three static
+   functions callable on the device: zero(), the identity of add and the
+   value of an empty row, add(a, b), the reduction along a row, which must
+   be associative and commutative, and mul(a, b), applied to a matrix
+   entry a and a vector entry b. Any type of this shape can be passed to
+   csrmv_semiring and spmspv directly.
+*/
+
+// (+, *): the usual product
+template <typename T>
+struct PlusTimes
+{
+    static T zero() __attribute__((hc, cpu)) { return 0; }
+    static T add(T a, T b) __attribute__((hc, cpu)) { return a + b; }
+    static T mul(T a, T b) __attribute__((hc, cpu)) { return a * b; }
+};
+
+// (min, +) tropical semiring, one relaxation step of shortest paths;
+// the largest finite value stands for infinity and absorbs additions
+template <typename T>
+struct MinPlus
+{
+    static T zero() __attribute__((hc, cpu)) { return std::numeric_limits<T>::max(); }
+    static T add(T a, T b) __attribute__((hc, cpu)) { return a <= b ? a : b; }
+    static T mul(T a, T b) __attribute__((hc, cpu))
+    {
+        return (a == zero() || b == zero()) ? zero() : a + b;
+    }
+};
+
+// (max, *): most reliable path with edge probabilities
+template <typename T>
+struct MaxTimes
+{
+    static T zero() __attribute__((hc, cpu)) { return 0; }
+    static T add(T a, T b) __attribute__((hc, cpu)) { return a >= b ? a : b; }
+    static T mul(T a, T b) __attribute__((hc, cpu)) { return a * b; }
+};
+
+// (or, and) on values read as booleans, nonzero being true: reachability
+// and breadth first search
+template <typename T>
+struct OrAnd
+{
+    static T zero() __attribute__((hc, cpu)) { return 0; }
+    static T add(T a, T b) __attribute__((hc, cpu)) { return (a != 0 || b != 0) ? 1 : 0; }
+    static T mul(T a, T b) __attribute__((hc, cpu)) { return (a != 0 && b != 0) ? 1 : 0; }
+};
+
+// (+, min)
+template <typename T>
+struct PlusMin
+{
+    static T zero() __attribute__((hc, cpu)) { return 0; }
+    static T add(T a, T b) __attribute__((hc, cpu)) { return a + b; }
+    static T mul(T a, T b) __attribute__((hc, cpu)) { return a <= b ? a : b; }
+};
+
+// (max, min): widest path, the bottleneck capacity of the best route
+template <typename T>
+struct MaxMin
+{
+    static T zero() __attribute__((hc, cpu)) { return 0; }
+    static T add(T a, T b) __attribute__((hc, cpu)) { return a >= b ? a : b; }
+    static T mul(T a, T b) __attribute__((hc, cpu)) { return a <= b ? a : b; }
+};
+
+#endif //_HCSPARSE_SEMIRING_H_
@@ -0,0 +1,382 @@
+#ifndef _HCSPARSE_SPMSPV_H_
+#define _HCSPARSE_SPMSPV_H_
+
+#include "hcsparse.h"
+#include "semiring.h"
+#include "csrmv-semiring.h"
+
+// The product switches to the dense csrmv over the rows of A once the
+// columns named by x hold more than nnz(A) / SPMSPV_PULL_RATIO entries
+// (Beamer's direction optimizing traversal uses the same test)
+#define SPMSPV_PULL_RATIO 14
+
+// lengths[k] = number of entries in the column of A named by x(k)
+inline void
+spmspv_column_lengths (const int nnz_x,
+                       const int *xInd,
+                       const int *colOff,
+                       int *lengths,
+                       hcsparseControl *control)
+{
+    hc::extent<1> grdExt(BLOCK_SIZE * ((nnz_x - 1)/BLOCK_SIZE + 1));
+    hc::tiled_extent<1> t_ext = grdExt.tile(BLOCK_SIZE);
+    hc::parallel_for_each(control->accl_view, t_ext, [=] (hc::tiled_index<1>& tidx) [[hc]]
+    {
+        int k = tidx.global[0];
+        if (k < nnz_x)
+            lengths[k] = colOff[xInd[k] + 1] - colOff[xInd[k]];
+    }).wait();
+}
+
+// One thread per gathered entry e: the frontier entry k owning it is found
+// by binary search in the exclusive offsets, so the work is balanced over
+// edges whatever the column lengths. keys[e] is the row reached and
+// prods[e] = mul(A(row, col), x(col)).
+template <typename T, typename SR>
+void
+spmspv_expand (const int num_edges,
+               const int nnz_x,
+               const int *offsets,
+               const int *xInd,
+               const T *xVal,
+               const int *colOff,
+               const int *rowInd,
+               const T *vals,
+               int *keys,
+               T *prods,
+               hcsparseControl *control)
+{
+    hc::extent<1> grdExt(BLOCK_SIZE * ((num_edges - 1)/BLOCK_SIZE + 1));
+    hc::tiled_extent<1> t_ext = grdExt.tile(BLOCK_SIZE);
+    hc::parallel_for_each(control->accl_view, t_ext, [=] (hc::tiled_index<1>& tidx) [[hc]]
+    {
+        int e = tidx.global[0];
+        if (e >= num_edges)
+            return;
+
+        // last k with offsets[k] <= e; empty columns share their offset
+        // with the next entry and are skipped this way
+        int lo = 0;
+        int hi = nnz_x - 1;
+        while (lo < hi)
+        {
+            int mid = (lo + hi + 1) / 2;
+            if (offsets[mid] <= e)
+                lo = mid;
+            else
+                hi = mid - 1;
+        }
+
+        int col = xInd[lo];
+        int p = colOff[col] + e - offsets[lo];
+        keys[e] = rowInd[p];
+        prods[e] = SR::mul(vals[p], xVal[lo]);
+    }).wait();
+}
+
+// SR::add as the operator of the segmented scan
+template <typename T, typename SR>
+struct spmspv_add
+{
+    static T apply(T a, T b) __attribute__((hc, cpu)) { return SR::add(a, b); }
+};
+
+// Folds the runs of equal keys of the sorted (keys, prods) with SR::add by
+// a segmented scan over the run heads, so a row reached from many columns
+// is reduced in parallel; the last entry i of a run writes the run into
+// slot slots[i] - 1.
+template <typename T, typename SR>
+void
+spmspv_merge (const int size,
+              const int *keys,
+              const T *prods,
+              const int *heads,
+              const int *slots,
+              int *runKeys,
+              T *runVals,
+              hcsparseControl *control)
+{
+    hc::accelerator acc = (control->accl_view).get_accelerator();
+    T *sums = (T*) am_alloc(size * sizeof(T), acc, 0);
+
+    scan_lookback_by<T, spmspv_add<T, SR>, true>(size, sums, prods, heads, SR::zero(), control, (int)false);
+
+    hc::extent<1> grdExt(BLOCK_SIZE * ((size - 1)/BLOCK_SIZE + 1));
+    hc::tiled_extent<1> t_ext = grdExt.tile(BLOCK_SIZE);
+    hc::parallel_for_each(control->accl_view, t_ext, [=] (hc::tiled_index<1>& tidx) [[hc]]
+    {
+        int i = tidx.global[0];
+        if (i >= size || (i + 1 < size && !heads[i + 1]))
+            return;
+
+        runKeys[slots[i] - 1] = keys[i];
+        runVals[slots[i] - 1] = sums[i];
+    }).wait();
+
+    am_free(sums);
+}
+
+// flags[i] = 1 where keys[i] starts a new run of the sorted keys
+inline void
+spmspv_heads (const int size,
+              const int *keys,
+              int *flags,
+              hcsparseControl *control)
+{
+    hc::extent<1> grdExt(BLOCK_SIZE * ((size - 1)/BLOCK_SIZE + 1));
+    hc::tiled_extent<1> t_ext = grdExt.tile(BLOCK_SIZE);
+    hc::parallel_for_each(control->accl_view, t_ext, [=] (hc::tiled_index<1>& tidx) [[hc]]
+    {
+        int i = tidx.global[0];
+        if (i < size)
+            flags[i] = (i == 0 || keys[i] != keys[i - 1]) ? 1 : 0;
+    }).wait();
+}
+
+// Copies the entries of vals that differ from SR::zero() into y, in order;
+// their index is keys[i], or i when keys is nullptr. Returns the count.
+template <typename T, typename SR>
+int
+spmspv_compact (const int size,
+                const int *keys,
+                const T *vals,
+                int *yInd,
+                T *yVal,
+                hcsparseControl *control)
+{
+    if (size == 0)
+        return 0;
+
+    hc::accelerator acc = (control->accl_view).get_accelerator();
+    int *flags = (int*) am_alloc(size * sizeof(int), acc, 0);
+    int *slots = (int*) am_alloc(size * sizeof(int), acc, 0);
+
+    hc::extent<1> grdExt(BLOCK_SIZE * ((size - 1)/BLOCK_SIZE + 1));
+    hc::tiled_extent<1> t_ext = grdExt.tile(BLOCK_SIZE);
+    hc::parallel_for_each(control->accl_view, t_ext, [=] (hc::tiled_index<1>& tidx) [[hc]]
+    {
+        int i = tidx.global[0];
+        if (i < size)
+            flags[i] = (vals[i] != SR::zero()) ? 1 : 0;
+    }).wait();
+
+    inclusive_scan<int, EW_PLUS>(size, slots, flags, control);
+
+    hc::parallel_for_each(control->accl_view, t_ext, [=] (hc::tiled_index<1>& tidx) [[hc]]
+    {
+        int i = tidx.global[0];
+        if (i < size && flags[i])
+        {
+            yInd[slots[i] - 1] = keys == nullptr ? i : keys[i];
+            yVal[slots[i] - 1] = vals[i];
+        }
+    }).wait();
+
+    int count = 0;
+    control->accl_view.copy(slots + (size - 1), &count, sizeof(int));
+
+    am_free(flags);
+    am_free(slots);
+
+    return count;
+}
+
+// Dense direction: x is scattered into a dense vector, multiplied with the
+// rows of A by csrmv_semiring and the result compacted back.
+template <typename T, typename SR>
+hcsparseStatus
+spmspv_pull (const hcsparseCsrMatrix *pA,
+             const hcsparseVector *pX,
+             hcsparseVector *pY,
+             hcsparseControl *control)
+{
+    hc::accelerator acc = (control->accl_view).get_accelerator();
+
+    const int n = pA->num_cols;
+    const int m = pA->num_rows;
+    const int nnz_x = pX->num_nonzeros;
+    const int *xInd = static_cast<const int*>(pX->indices) + pX->offIndices;
+    const T *xVal = static_cast<const T*>(pX->values) + pX->offValues;
+
+    hcdenseVector xd, yd;
+    xd.values = am_alloc(n * sizeof(T), acc, 0);
+    xd.num_values = n;
+    xd.offValues = 0;
+    yd.values = am_alloc(m * sizeof(T), acc, 0);
+    yd.num_values = m;
+    yd.offValues = 0;
+
+    T *avXd = static_cast<T*>(xd.values);
+
+    hc::extent<1> grdExt(BLOCK_SIZE * ((n - 1)/BLOCK_SIZE + 1));
+    hc::tiled_extent<1> t_ext = grdExt.tile(BLOCK_SIZE);
+    hc::parallel_for_each(control->accl_view, t_ext, [=] (hc::tiled_index<1>& tidx) [[hc]]
+    {
+        int i = tidx.global[0];
+        if (i < n)
+            avXd[i] = SR::zero();
+    }).wait();
+
+    if (nnz_x > 0)
+    {
+        hc::extent<1> grdExt_x(BLOCK_SIZE * ((nnz_x - 1)/BLOCK_SIZE + 1));
+        hc::tiled_extent<1> t_ext_x = grdExt_x.tile(BLOCK_SIZE);
+        hc::parallel_for_each(control->accl_view, t_ext_x, [=] (hc::tiled_index<1>& tidx) [[hc]]
+        {
+            int k = tidx.global[0];
+            if (k < nnz_x)
+                avXd[xInd[k]] = xVal[k];
+        }).wait();
+    }
+
+    hcsparseStatus status = csrmv_semiring<T, SR>(pA, &xd, &yd, false, control);
+
+    if (status == hcsparseSuccess)
+    {
+        pY->num_nonzeros = spmspv_compact<T, SR>(m, nullptr, static_cast<T*>(yd.values),
+                                                 static_cast<int*>(pY->indices) + pY->offIndices,
+                                                 static_cast<T*>(pY->values) + pY->offValues,
+                                                 control);
+    }
+
+    am_free(xd.values);
+    am_free(yd.values);
+
+    return status;
+}
+
+/*
+ * y = A x over the semiring SR for a sparse x, e.g. one level of a
+ * breadth first search from the frontier x. Only the columns of A named by
+ * x are read, from its CSC form: their entries are gathered one thread per
+ * entry, sorted by row and folded with SR::add, so the cost follows the
+ * number of edges leaving the frontier rather than the size of A. When
+ * those edges exceed nnz(A) / SPMSPV_PULL_RATIO and the CSR form is given
+ * the dense csrmv_semiring is used instead. In both directions y keeps
+ * only the entries that differ from SR::zero().
+ * y->indices and y->values must have room for y->num_values entries.
+ */
+template <typename T, typename SR>
+hcsparseStatus
+spmspv (const hcsparseCscMatrix *pA,
+        const hcsparseCsrMatrix *pA_csr,
+        const hcsparseVector *pX,
+        hcsparseVector *pY,
+        hcsparseControl *control)
+{
+    if (pA->num_cols != pX->num_values || pA->num_rows != pY->num_values ||
+        (pA_csr != nullptr && (pA_csr->num_rows != pA->num_rows ||
+                               pA_csr->num_cols != pA->num_cols)))
+    {
+        return hcsparseInvalid;
+    }
+
+    const int nnz_x = pX->num_nonzeros;
+    if (nnz_x == 0)
+    {
+        pY->num_nonzeros = 0;
+        return hcsparseSuccess;
+    }
+
+    hc::accelerator acc = (control->accl_view).get_accelerator();
+
+    const int *xInd = static_cast<const int*>(pX->indices) + pX->offIndices;
+    const T *xVal = static_cast<const T*>(pX->values) + pX->offValues;
+    const int *colOff = static_cast<const int*>(pA->colOffsets) + pA->offColOff;
+    const int *rowInd = static_cast<const int*>(pA->rowIndices) + pA->offRowInd;
+    const T *vals = static_cast<const T*>(pA->values) + pA->offValues;
+
+    int *lengths = (int*) am_alloc(nnz_x * sizeof(int), acc, 0);
+    int *offsets = (int*) am_alloc(nnz_x * sizeof(int), acc, 0);
+
+    spmspv_column_lengths(nnz_x, xInd, colOff, lengths, control);
+    exclusive_scan<int, EW_PLUS>(nnz_x, offsets, lengths, control);
+
+    int last[2];
+    control->accl_view.copy(offsets + (nnz_x - 1), &last[0], sizeof(int));
+    control->accl_view.copy(lengths + (nnz_x - 1), &last[1], sizeof(int));
+    const int num_edges = last[0] + last[1];
+
+    if (pA_csr != nullptr && (long)num_edges * SPMSPV_PULL_RATIO > (long)pA->num_nonzeros)
+    {
+        am_free(lengths);
+        am_free(offsets);
+        return spmspv_pull<T, SR>(pA_csr, pX, pY, control);
+    }
+
+    if (num_edges == 0)
+    {
+        am_free(lengths);
+        am_free(offsets);
+        pY->num_nonzeros = 0;
+        return hcsparseSuccess;
+    }
+
+    int *keys = (int*) am_alloc(num_edges * sizeof(int), acc, 0);
+    T *prods = (T*) am_alloc(num_edges * sizeof(T), acc, 0);
+    int *heads = (int*) am_alloc(num_edges * sizeof(int), acc, 0);
+    int *slots = (int*) am_alloc(num_edges * sizeof(int), acc, 0);
+    int *runKeys = (int*) am_alloc(num_edges * sizeof(int), acc, 0);
+    T *runVals = (T*) am_alloc(num_edges * sizeof(T), acc, 0);
+
+    spmspv_expand<T, SR>(num_edges, nnz_x, offsets, xInd, xVal, colOff, rowInd, vals,
+                         keys, prods, control);
+
+    sort_by_key<int, T>(num_edges, keys, prods, control);
+
+    // slots[i] is one past the output run of entry i
+    spmspv_heads(num_edges, keys, heads, control);
+    inclusive_scan<int, EW_PLUS>(num_edges, slots, heads, control);
+
+    int num_runs = 0;
+    control->accl_view.copy(slots + (num_edges - 1), &num_runs, sizeof(int));
+
+    spmspv_merge<T, SR>(num_edges, keys, prods, heads, slots, runKeys, runVals, control);
+
+    pY->num_nonzeros = spmspv_compact<T, SR>(num_runs, runKeys, runVals,
+                                             static_cast<int*>(pY->indices) + pY->offIndices,
+                                             static_cast<T*>(pY->values) + pY->offValues,
+                                             control);
+
+    am_free(lengths);
+    am_free(offsets);
+    am_free(keys);
+    am_free(prods);
+    am_free(heads);
+    am_free(slots);
+    am_free(runKeys);
+    am_free(runVals);
+
+    return hcsparseSuccess;
+}
+
+// Runtime selection among the predefined semirings of the public API
+template <typename T>
+hcsparseStatus
+spmspv (const SEMIRING semiring,
+        const hcsparseCscMatrix *pA,
+        const hcsparseCsrMatrix *pA_csr,
+        const hcsparseVector *pX,
+        hcsparseVector *pY,
+        hcsparseControl *control)
+{
+    switch (semiring)
+    {
+    case SR_PLUS_TIMES:
+        return spmspv<T, PlusTimes<T>>(pA, pA_csr, pX, pY, control);
+    case SR_MIN_PLUS:
+        return spmspv<T, MinPlus<T>>(pA, pA_csr, pX, pY, control);
+    case SR_MAX_TIMES:
+        return spmspv<T, MaxTimes<T>>(pA, pA_csr, pX, pY, control);
+    case SR_OR_AND:
+        return spmspv<T, OrAnd<T>>(pA, pA_csr, pX, pY, control);
+    case SR_PLUS_MIN:
+        return spmspv<T, PlusMin<T>>(pA, pA_csr, pX, pY, control);
+    case SR_MAX_MIN:
+        return spmspv<T, MaxMin<T>>(pA, pA_csr, pX, pY, control);
+    default:
+        return hcsparseInvalid;
+    }
+}
+
+#endif //_HCSPARSE_SPMSPV_H_
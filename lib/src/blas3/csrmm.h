@@ -3,7 +3,8 @@
 #define WAVE_SIZE 64
 #define GROUP_SIZE 256
 
-template <typename T>
+// BASE - index base of row_offset and col, 0 or 1
+template <typename T, int BASE = 0>
 void
 csrmv_kernel( const int num_rows,
               const int subwave_size,
@@ -42,17 +43,17 @@ csrmv_kernel( const int num_rows,
         const T _beta = beta[ off_beta ];
         for( int row = vector_id; row < num_rows; row += num_vectors )
         {
-            const int row_start = row_offset[ row ];
-            const int row_end = row_offset[ row + 1 ];
+            const int row_start = row_offset[ row ] - BASE;
+            const int row_end = row_offset[ row + 1 ] - BASE;
             T sum = (T)0;
             for( int j = row_start + thread_lane; j < row_end; j += subwave_size )
             {
                 if( _alpha == 1 )
-                    sum = val[ j ] * x[ off_x + ( col[ j ] * ldx_t )  + curr_col * ldx ] + sum;
+                    sum = val[ j ] * x[ off_x + ( ( col[ j ] - BASE ) * ldx_t ) + curr_col * ldx ] + sum;
                 else if( _alpha == 0 )
                     sum = 0;
                 else
-                    sum = _alpha * val[ j ] * x[ off_x + ( col[ j ] * ldx_t )+ curr_col * ldx ] + sum;
+                    sum = _alpha * val[ j ] * x[ off_x + ( ( col[ j ] - BASE ) * ldx_t ) + curr_col * ldx ] + sum;
             }
 
             sdata[ local_id ] = sum;
@@ -83,7 +84,7 @@ csrmv_kernel( const int num_rows,
     }).wait();
 }
 
-template<typename T>
+template<typename T, int BASE = 0>
 void csrmv_batched( const int num_rows,
                     const int nnz_per_row,
                     const T *alpha,
@@ -123,11 +124,11 @@ void csrmv_batched( const int num_rows,
     //  the global pointers to the dense B and C matrices a column for each iteration.
     for( int curr_col = 0; curr_col < num_cols_C; ++curr_col )
     {
-        csrmv_kernel<T> (num_rows, subwave_size, alpha, off_alpha, rowOffsets, colInd, values, denseB, ldb, ldb_t, off_B, beta, off_beta, denseC, ldC, off_C, curr_col, control);
+        csrmv_kernel<T, BASE> (num_rows, subwave_size, alpha, off_alpha, rowOffsets, colInd, values, denseB, ldb, ldb_t, off_B, beta, off_beta, denseC, ldC, off_C, curr_col, control);
     }
 }
 
-template<typename T>
+template<typename T, int BASE = 0>
 hcsparseStatus 
 csrmm (hcsparseControl *control, const int nnzPerRow,
        const int m, const int n, const int k,
@@ -144,7 +145,7 @@ csrmm (hcsparseControl *control, const int nnzPerRow,
   int alphaOffValue = 0;
   int betaOffValue = 0;
 
-  csrmv_batched<T>(ARows, nnzPerRow, alpha, alphaOffValue, 
+  csrmv_batched<T, BASE>(ARows, nnzPerRow, alpha, alphaOffValue, 
                    csrRowPtrA, csrColIndA, csrValA, B, 
                    ldb, ldb_t, BOffValue, beta, betaOffValue, 
                    C, CRows, CCols, ldc, COffValue, control);
@@ -0,0 +1,480 @@
+#ifndef _HCSPARSE_RAP_H_
+#define _HCSPARSE_RAP_H_
+
+#include "hcsparse.h"
+#include <algorithm>
+#include <vector>
+
+#define BLOCK_SIZE 256
+
+// the hash table of coarse entries starts at RAP_HASH_FILL slots per
+// expected entry and is doubled whenever it gets more than half full
+#define RAP_HASH_FILL 2
+#define RAP_EMPTY_KEY (~(uint64_t)0)
+
+/* Galerkin triple product C = P^T A P for the coarse operators of
+   multigrid. Every entry a_ik of A contributes p_iI a_ik p_kJ to C(I, J)
+   for all I in row i and J in row k of P, so the product is formed from
+   the rows of A and P alone: neither P^T nor A P is built. The entries of
+   C are collected in a device hash table keyed by (I, J). The symbolic
+   phase fills the table and derives the sorted pattern of C, remembering
+   the position in C of every slot; the numeric phase looks the slots up
+   and adds the contributions atomically, so it can be repeated for new
+   values of A and P on the same patterns.
+*/
+struct hcsparseRapInfo
+{
+    hcsparseRapInfo() : num_fine(0), num_coarse(0), nnzA(0), nnzP(0),
+        structureA(0), structureP(0), nnzC(0),
+        capacity(0), keys(nullptr), slotPos(nullptr), rowOffsets(nullptr),
+        colIndices(nullptr), analysed(false)
+    {
+
+    }
+
+    ~hcsparseRapInfo()
+    {
+        release();
+    }
+
+    void release()
+    {
+        if (keys != nullptr)
+            am_free(keys);
+        if (slotPos != nullptr)
+            am_free(slotPos);
+        if (rowOffsets != nullptr)
+            am_free(rowOffsets);
+        if (colIndices != nullptr)
+            am_free(colIndices);
+        keys = nullptr;
+        slotPos = nullptr;
+        rowOffsets = nullptr;
+        colIndices = nullptr;
+        analysed = false;
+    }
+
+    // patterns the analysis was done for
+    int num_fine;
+    int num_coarse;
+    int nnzA;
+    int nnzP;
+
+    // structure versions of tracked A and P, see hcsparseCsrStructureChanged
+    unsigned long structureA;
+    unsigned long structureP;
+
+    int nnzC;
+
+    // hash table: keys I * num_coarse + J and the position of the entry in C
+    int capacity;
+    uint64_t *keys;
+    int *slotPos;
+
+    // pattern of C
+    int *rowOffsets;
+    int *colIndices;
+
+    bool analysed;
+};
+
+inline unsigned int
+rap_hash (const uint64_t key,
+          const int log2cap) __attribute__((hc, cpu))
+{
+    return (unsigned int)((key * 0x9E3779B97F4A7C15ull) >> (64 - log2cap));
+}
+
+inline void
+rap_atomic_add (float *addr,
+                const float v) __attribute__((hc))
+{
+    union { float f; unsigned int u; } cur, next;
+    cur.f = *addr;
+    do
+    {
+        next.f = cur.f + v;
+    } while (!hc::atomic_compare_exchange((unsigned int*)addr, &cur.u, next.u));
+}
+
+inline void
+rap_atomic_add (double *addr,
+                const double v) __attribute__((hc))
+{
+    union { double f; uint64_t u; } cur, next;
+    cur.f = *addr;
+    do
+    {
+        next.f = cur.f + v;
+    } while (!hc::atomic_compare_exchange((uint64_t*)addr, &cur.u, next.u));
+}
+
+// Row of the CSR entry p: the last i with rowOff[i] <= p
+inline int
+rap_row_of (const int *rowOff,
+            const int num_rows,
+            const int p) __attribute__((hc, cpu))
+{
+    int lo = 0;
+    int hi = num_rows - 1;
+    while (lo < hi)
+    {
+        int mid = (lo + hi + 1) / 2;
+        if (rowOff[mid] <= p)
+            lo = mid;
+        else
+            hi = mid - 1;
+    }
+    return lo;
+}
+
+// Symbolic pass: one thread per entry of A inserts the keys of its
+// contributions. A new key bumps the count of its row of C; the table is
+// abandoned (*overflow set) once it is half full.
+inline void
+rap_insert_keys (const int n,
+                 const int nnzA,
+                 const int nc,
+                 const int *rowOffA,
+                 const int *colIndA,
+                 const int *rowOffP,
+                 const int *colIndP,
+                 uint64_t *keys,
+                 const int capacity,
+                 const int log2cap,
+                 int *rowCounts,
+                 unsigned int *inserted,
+                 int *overflow,
+                 hcsparseControl *control)
+{
+    hc::extent<1> grdExt(BLOCK_SIZE * ((nnzA - 1)/BLOCK_SIZE + 1));
+    hc::tiled_extent<1> t_ext = grdExt.tile(BLOCK_SIZE);
+    hc::parallel_for_each(control->accl_view, t_ext, [=] (hc::tiled_index<1>& tidx) [[hc]]
+    {
+        int p = tidx.global[0];
+        if (p >= nnzA)
+            return;
+
+        const int i = rap_row_of(rowOffA, n, p);
+        const int k = colIndA[p];
+
+        for (int q = rowOffP[k]; q < rowOffP[k + 1]; q++)
+        {
+            for (int r = rowOffP[i]; r < rowOffP[i + 1]; r++)
+            {
+                if (*overflow)
+                    return;
+
+                const int I = colIndP[r];
+                const uint64_t key = (uint64_t)I * nc + colIndP[q];
+                unsigned int slot = rap_hash(key, log2cap);
+
+                for (int probe = 0; ; probe++)
+                {
+                    if (probe == capacity)
+                    {
+                        *overflow = 1;
+                        return;
+                    }
+
+                    uint64_t expected = RAP_EMPTY_KEY;
+                    if (hc::atomic_compare_exchange(&keys[slot], &expected, key))
+                    {
+                        hc::atomic_fetch_inc(&rowCounts[I]);
+                        if (hc::atomic_fetch_inc(inserted) + 1 > (unsigned int)capacity / 2)
+                            *overflow = 1;
+                        break;
+                    }
+                    if (expected == key)
+                        break;
+
+                    slot = (slot + 1) & (capacity - 1);
+                }
+            }
+        }
+    }).wait();
+}
+
+/*
+ * Pattern of C = P^T A P into info. A is n x n and P is n x nc; both must
+ * have sorted rows.
+ */
+inline hcsparseStatus
+rap_symbolic (const hcsparseCsrMatrix *pA,
+              const hcsparseCsrMatrix *pP,
+              hcsparseRapInfo *info,
+              hcsparseControl *control)
+{
+    if (pA->num_rows != pA->num_cols || pA->num_rows != pP->num_rows)
+    {
+        return hcsparseInvalid;
+    }
+
+    hc::accelerator acc = (control->accl_view).get_accelerator();
+
+    const int n = pA->num_rows;
+    const int nc = pP->num_cols;
+    const int nnzA = pA->num_nonzeros;
+
+    const int *rowOffA = static_cast<const int*>(pA->rowOffsets) + pA->offRowOff;
+    const int *colIndA = static_cast<const int*>(pA->colIndices) + pA->offColInd;
+    const int *rowOffP = static_cast<const int*>(pP->rowOffsets) + pP->offRowOff;
+    const int *colIndP = static_cast<const int*>(pP->colIndices) + pP->offColInd;
+
+    info->release();
+    info->num_fine = n;
+    info->num_coarse = nc;
+    info->nnzA = nnzA;
+    info->nnzP = pP->num_nonzeros;
+    info->structureA = pA->structureVersion;
+    info->structureP = pP->structureVersion;
+
+    int *rowCounts = (int*) am_alloc(sizeof(int) * (nc + 1), acc, 0);
+    unsigned int *inserted = (unsigned int*) am_alloc(sizeof(unsigned int), acc, 0);
+    int *overflow = (int*) am_alloc(sizeof(int), acc, 0);
+
+    // the coarse operator is about as dense per row as the fine one
+    long expected = std::max((long)nc, (long)nnzA * nc / std::max(n, 1));
+    int log2cap = 8;
+    while ((1l << log2cap) < RAP_HASH_FILL * expected)
+        log2cap++;
+
+    std::vector<int> h_counts(nc + 1, 0);
+    unsigned int h_inserted = 0;
+    int h_overflow = 0;
+
+    while (true)
+    {
+        const int capacity = 1 << log2cap;
+        info->capacity = capacity;
+        info->keys = (uint64_t*) am_alloc(sizeof(uint64_t) * capacity, acc, 0);
+
+        uint64_t *keys = info->keys;
+        hc::extent<1> grdExt(BLOCK_SIZE * ((capacity - 1)/BLOCK_SIZE + 1));
+        hc::tiled_extent<1> t_ext = grdExt.tile(BLOCK_SIZE);
+        hc::parallel_for_each(control->accl_view, t_ext, [=] (hc::tiled_index<1>& tidx) [[hc]]
+        {
+            int s = tidx.global[0];
+            if (s < capacity)
+                keys[s] = RAP_EMPTY_KEY;
+        }).wait();
+
+        std::fill(h_counts.begin(), h_counts.end(), 0);
+        h_inserted = 0;
+        h_overflow = 0;
+        control->accl_view.copy(h_counts.data(), rowCounts, sizeof(int) * (nc + 1));
+        control->accl_view.copy(&h_inserted, inserted, sizeof(unsigned int));
+        control->accl_view.copy(&h_overflow, overflow, sizeof(int));
+
+        if (nnzA > 0)
+            rap_insert_keys(n, nnzA, nc, rowOffA, colIndA, rowOffP, colIndP, keys,
+                            capacity, log2cap, rowCounts, inserted, overflow, control);
+
+        control->accl_view.copy(overflow, &h_overflow, sizeof(int));
+        if (!h_overflow)
+            break;
+
+        am_free(info->keys);
+        info->keys = nullptr;
+        log2cap++;
+    }
+
+    // offsets of the rows of C
+    control->accl_view.copy(rowCounts, h_counts.data(), sizeof(int) * nc);
+    std::vector<int> h_offsets(nc + 1, 0);
+    for (int I = 0; I < nc; I++)
+        h_offsets[I + 1] = h_offsets[I] + h_counts[I];
+
+    const int nnzC = h_offsets[nc];
+    const int capacity = info->capacity;
+
+    info->nnzC = nnzC;
+    info->rowOffsets = (int*) am_alloc(sizeof(int) * (nc + 1), acc, 0);
+    info->colIndices = (int*) am_alloc(sizeof(int) * std::max(nnzC, 1), acc, 0);
+    info->slotPos = (int*) am_alloc(sizeof(int) * capacity, acc, 0);
+    control->accl_view.copy(h_offsets.data(), info->rowOffsets, sizeof(int) * (nc + 1));
+    control->accl_view.copy(h_offsets.data(), rowCounts, sizeof(int) * nc);
+
+    // scatter the slots into their rows, rowCounts now being the cursors
+    const uint64_t *keys = info->keys;
+    int *slotPos = info->slotPos;
+    int *rowOffC = info->rowOffsets;
+    int *colIndC = info->colIndices;
+    int *slotOf = (int*) am_alloc(sizeof(int) * std::max(nnzC, 1), acc, 0);
+    int *cursor = rowCounts;
+
+    hc::extent<1> grdExt(BLOCK_SIZE * ((capacity - 1)/BLOCK_SIZE + 1));
+    hc::tiled_extent<1> t_ext = grdExt.tile(BLOCK_SIZE);
+    hc::parallel_for_each(control->accl_view, t_ext, [=] (hc::tiled_index<1>& tidx) [[hc]]
+    {
+        int s = tidx.global[0];
+        if (s >= capacity || keys[s] == RAP_EMPTY_KEY)
+            return;
+
+        int I = (int)(keys[s] / nc);
+        int pos = hc::atomic_fetch_inc(&cursor[I]);
+        colIndC[pos] = (int)(keys[s] % nc);
+        slotOf[pos] = s;
+    }).wait();
+
+    // sort every row of C by column, a thread per row; the rows of a
+    // coarse operator are short
+    if (nc > 0)
+    {
+        hc::extent<1> grdExt_rows(BLOCK_SIZE * ((nc - 1)/BLOCK_SIZE + 1));
+        hc::tiled_extent<1> t_ext_rows = grdExt_rows.tile(BLOCK_SIZE);
+        hc::parallel_for_each(control->accl_view, t_ext_rows, [=] (hc::tiled_index<1>& tidx) [[hc]]
+        {
+            int I = tidx.global[0];
+            if (I >= nc)
+                return;
+
+            for (int p = rowOffC[I] + 1; p < rowOffC[I + 1]; p++)
+            {
+                int col = colIndC[p];
+                int slot = slotOf[p];
+                int q = p - 1;
+                while (q >= rowOffC[I] && colIndC[q] > col)
+                {
+                    colIndC[q + 1] = colIndC[q];
+                    slotOf[q + 1] = slotOf[q];
+                    q--;
+                }
+                colIndC[q + 1] = col;
+                slotOf[q + 1] = slot;
+            }
+
+            for (int p = rowOffC[I]; p < rowOffC[I + 1]; p++)
+                slotPos[slotOf[p]] = p;
+        }).wait();
+    }
+
+    am_free(slotOf);
+    am_free(rowCounts);
+    am_free(inserted);
+    am_free(overflow);
+
+    info->analysed = true;
+
+    return hcsparseSuccess;
+}
+
+/*
+ * C = P^T A P on the pattern found by rap_symbolic. C->rowOffsets must
+ * hold num_coarse + 1 entries, C->colIndices and C->values info->nnzC.
+ */
+template <typename T>
+hcsparseStatus
+rap_numeric (const hcsparseCsrMatrix *pA,
+             const hcsparseCsrMatrix *pP,
+             const hcsparseRapInfo *info,
+             hcsparseCsrMatrix *pC,
+             hcsparseControl *control)
+{
+    if (!info->analysed || pA->num_rows != info->num_fine || pP->num_cols != info->num_coarse ||
+        pA->num_nonzeros != info->nnzA || pP->num_nonzeros != info->nnzP)
+    {
+        return hcsparseInvalid;
+    }
+
+    // the pattern of a tracked matrix changed since the analysis
+    if ((pA->structureTracked() && pA->structureVersion != info->structureA) ||
+        (pP->structureTracked() && pP->structureVersion != info->structureP))
+    {
+        return hcsparseInvalid;
+    }
+
+    const int n = info->num_fine;
+    const int nc = info->num_coarse;
+    const int nnzA = info->nnzA;
+    const int nnzC = info->nnzC;
+    const int capacity = info->capacity;
+    int log2cap = 0;
+    while ((1 << log2cap) < capacity)
+        log2cap++;
+
+    const int *rowOffA = static_cast<const int*>(pA->rowOffsets) + pA->offRowOff;
+    const int *colIndA = static_cast<const int*>(pA->colIndices) + pA->offColInd;
+    const T *valA = static_cast<const T*>(pA->values) + pA->offValues;
+    const int *rowOffP = static_cast<const int*>(pP->rowOffsets) + pP->offRowOff;
+    const int *colIndP = static_cast<const int*>(pP->colIndices) + pP->offColInd;
+    const T *valP = static_cast<const T*>(pP->values) + pP->offValues;
+
+    int *rowOffC = static_cast<int*>(pC->rowOffsets) + pC->offRowOff;
+    int *colIndC = static_cast<int*>(pC->colIndices) + pC->offColInd;
+    T *valC = static_cast<T*>(pC->values) + pC->offValues;
+
+    control->accl_view.copy(info->rowOffsets, rowOffC, sizeof(int) * (nc + 1));
+    if (nnzC > 0)
+        control->accl_view.copy(info->colIndices, colIndC, sizeof(int) * nnzC);
+
+    pC->num_rows = nc;
+    pC->num_cols = nc;
+    pC->num_nonzeros = nnzC;
+
+    if (nnzC == 0)
+        return hcsparseSuccess;
+
+    hc::extent<1> grdExt_c(BLOCK_SIZE * ((nnzC - 1)/BLOCK_SIZE + 1));
+    hc::tiled_extent<1> t_ext_c = grdExt_c.tile(BLOCK_SIZE);
+    hc::parallel_for_each(control->accl_view, t_ext_c, [=] (hc::tiled_index<1>& tidx) [[hc]]
+    {
+        int p = tidx.global[0];
+        if (p < nnzC)
+            valC[p] = 0;
+    }).wait();
+
+    const uint64_t *keys = info->keys;
+    const int *slotPos = info->slotPos;
+
+    // set by a product missing from the table: the patterns are not the
+    // analysed ones
+    hc::accelerator acc = (control->accl_view).get_accelerator();
+    int *missing = (int*) am_alloc(sizeof(int), acc, 0);
+    int h_missing = 0;
+    control->accl_view.copy(&h_missing, missing, sizeof(int));
+
+    hc::extent<1> grdExt(BLOCK_SIZE * ((nnzA - 1)/BLOCK_SIZE + 1));
+    hc::tiled_extent<1> t_ext = grdExt.tile(BLOCK_SIZE);
+    hc::parallel_for_each(control->accl_view, t_ext, [=] (hc::tiled_index<1>& tidx) [[hc]]
+    {
+        int p = tidx.global[0];
+        if (p >= nnzA)
+            return;
+
+        const int i = rap_row_of(rowOffA, n, p);
+        const int k = colIndA[p];
+        const T a = valA[p];
+
+        for (int q = rowOffP[k]; q < rowOffP[k + 1]; q++)
+        {
+            const T ap = a * valP[q];
+            for (int r = rowOffP[i]; r < rowOffP[i + 1]; r++)
+            {
+                const uint64_t key = (uint64_t)colIndP[r] * nc + colIndP[q];
+                unsigned int slot = rap_hash(key, log2cap);
+                int probe = 0;
+                while (probe < capacity && keys[slot] != key && keys[slot] != RAP_EMPTY_KEY)
+                {
+                    slot = (slot + 1) & (capacity - 1);
+                    probe++;
+                }
+
+                if (probe == capacity || keys[slot] != key)
+                {
+                    *missing = 1;
+                    return;
+                }
+
+                rap_atomic_add(&valC[slotPos[slot]], valP[r] * ap);
+            }
+        }
+    }).wait();
+
+    control->accl_view.copy(missing, &h_missing, sizeof(int));
+    am_free(missing);
+
+    return h_missing ? hcsparseInvalid : hcsparseSuccess;
+}
+
+#endif //_HCSPARSE_RAP_H_
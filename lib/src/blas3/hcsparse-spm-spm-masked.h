@@ -0,0 +1,307 @@
+#ifndef _HCSPARSE_SPM_SPM_MASKED_H_
+#define _HCSPARSE_SPM_SPM_MASKED_H_
+
+#include "hcsparse.h"
+
+// Device side test of a CSR mask: binary search in the sorted row i
+struct csr_mask_view
+{
+    const int *rowOff;
+    const int *colInd;
+
+    bool contains (const int i, const int j) const __attribute__((hc, cpu))
+    {
+        int lo = rowOff[i];
+        int hi = rowOff[i + 1] - 1;
+        while (lo <= hi)
+        {
+            int mid = (lo + hi) / 2;
+            if (colInd[mid] == j)
+                return true;
+            if (colInd[mid] < j)
+                lo = mid + 1;
+            else
+                hi = mid - 1;
+        }
+        return false;
+    }
+};
+
+// Device side test of a dense mask: the entry is set when nonzero
+template <typename T>
+struct dense_mask_view
+{
+    const T *values;
+    long lead_dim;
+    bool row_major;
+
+    bool contains (const int i, const int j) const __attribute__((hc, cpu))
+    {
+        return (row_major ? values[i * lead_dim + j] : values[j * lead_dim + i]) != 0;
+    }
+};
+
+// One thread per entry A(i, k), walking row k of B; both passes see the
+// same products in the same order. Without out the products kept by the
+// mask are only counted, into counts; with out they are written as COO
+// triplets from offsets[p] on, without values when outVals is null.
+template <typename T, typename MASK>
+void
+csrSpGemm_masked_products (const int m,
+                           const int nnzA,
+                           const int *rowOffA,
+                           const int *colIndA,
+                           const T *valA,
+                           const int *rowOffB,
+                           const int *colIndB,
+                           const T *valB,
+                           const MASK mask,
+                           const bool complement,
+                           int *counts,
+                           const int *offsets,
+                           int *outRows,
+                           int *outCols,
+                           T *outVals,
+                           hcsparseControl *control)
+{
+    const bool write = outRows != nullptr;
+
+    hc::extent<1> grdExt(BLOCK_SIZE * ((nnzA - 1)/BLOCK_SIZE + 1));
+    hc::tiled_extent<1> t_ext = grdExt.tile(BLOCK_SIZE);
+    hc::parallel_for_each(control->accl_view, t_ext, [=] (hc::tiled_index<1>& tidx) [[hc]]
+    {
+        int p = tidx.global[0];
+        if (p >= nnzA)
+            return;
+
+        // row of the entry: last i with rowOffA[i] <= p
+        int lo = 0;
+        int hi = m - 1;
+        while (lo < hi)
+        {
+            int mid = (lo + hi + 1) / 2;
+            if (rowOffA[mid] <= p)
+                lo = mid;
+            else
+                hi = mid - 1;
+        }
+        const int i = lo;
+        const int k = colIndA[p];
+
+        int count = 0;
+        int pos = write ? offsets[p] : 0;
+        for (int q = rowOffB[k]; q < rowOffB[k + 1]; q++)
+        {
+            const int j = colIndB[q];
+            if (mask.contains(i, j) == complement)
+                continue;
+
+            if (write)
+            {
+                outRows[pos] = i;
+                outCols[pos] = j;
+                if (outVals != nullptr)
+                    outVals[pos] = valA[p] * valB[q];
+                pos++;
+            }
+            else
+            {
+                count++;
+            }
+        }
+
+        if (!write)
+            counts[p] = count;
+    }).wait();
+}
+
+// Number of distinct entries among the COO triplets of products
+template <typename T>
+int
+csrSpGemm_masked_count (const hcsparseCooMatrix* products,
+                        hcsparseControl* control)
+{
+    hc::accelerator acc = (control->accl_view).get_accelerator();
+
+    const int size = products->num_nonzeros;
+    if (size == 0)
+        return 0;
+
+    const ulong num_cols = products->num_cols;
+    const int *rows = static_cast<const int*>(products->rowIndices);
+    const int *cols = static_cast<const int*>(products->colIndices);
+
+    ulong *keys = (ulong*) am_alloc(size * sizeof(ulong), acc, 0);
+    ulong *uniqueKeys = (ulong*) am_alloc(size * sizeof(ulong), acc, 0);
+    T *values = (T*) am_alloc(size * sizeof(T), acc, 0);
+    T *sums = (T*) am_alloc(size * sizeof(T), acc, 0);
+
+    hc::extent<1> grdExt(BLOCK_SIZE * ((size - 1)/BLOCK_SIZE + 1));
+    hc::tiled_extent<1> t_ext = grdExt.tile(BLOCK_SIZE);
+    hc::parallel_for_each(control->accl_view, t_ext, [=] (hc::tiled_index<1>& tidx) [[hc]]
+    {
+        int i = tidx.global[0];
+        if (i < size)
+        {
+            keys[i] = (ulong)rows[i] * num_cols + (ulong)cols[i];
+            values[i] = 0;
+        }
+    }).wait();
+
+    sort_by_key<ulong, T>(size, keys, values, control);
+
+    int num_unique = 0;
+    reduce_by_key<ulong, T>(size, uniqueKeys, sums, keys, values, &num_unique, control);
+
+    am_free(keys);
+    am_free(uniqueKeys);
+    am_free(values);
+    am_free(sums);
+
+    return num_unique;
+}
+
+/*
+ * C = (A * B) .* M for a structural mask M. The products falling outside
+ * the mask are discarded as they are formed, in the counting (symbolic)
+ * pass as well as in the one writing them (numeric), so memory follows
+ * the masked result rather than the full product: only the kept products
+ * are stored, as COO triplets, and coo_assemble sums the ones landing on
+ * the same entry and builds C. Work is spread one thread per entry of A.
+ * C->colIndices and C->values must hold nnz(C) entries. With nnzC given
+ * only nnz(C) is computed, from the same triplets, and C is not touched.
+ */
+template <typename T, typename MASK>
+hcsparseStatus
+csrSpGemm_masked (const hcsparseCsrMatrix* matA,
+                  const hcsparseCsrMatrix* matB,
+                  const MASK mask,
+                  const bool complement,
+                  hcsparseCsrMatrix* matC,
+                  int* nnzC,
+                  hcsparseControl* control)
+{
+    hc::accelerator acc = (control->accl_view).get_accelerator();
+
+    const int m = matA->num_rows;
+    const int nnzA = matA->num_nonzeros;
+
+    const int *rowOffA = static_cast<const int*>(matA->rowOffsets) + matA->offRowOff;
+    const int *colIndA = static_cast<const int*>(matA->colIndices) + matA->offColInd;
+    const T *valA = static_cast<const T*>(matA->values) + matA->offValues;
+    const int *rowOffB = static_cast<const int*>(matB->rowOffsets) + matB->offRowOff;
+    const int *colIndB = static_cast<const int*>(matB->colIndices) + matB->offColInd;
+    const T *valB = static_cast<const T*>(matB->values) + matB->offValues;
+
+    hcsparseCooMatrix products;
+    products.clear();
+    products.num_rows = m;
+    products.num_cols = matB->num_cols;
+    products.offValues = products.offColInd = products.offRowInd = 0;
+
+    int *counts = nullptr;
+    int *offsets = nullptr;
+
+    if (nnzA > 0)
+    {
+        counts = (int*) am_alloc(nnzA * sizeof(int), acc, 0);
+        offsets = (int*) am_alloc(nnzA * sizeof(int), acc, 0);
+
+        // symbolic: kept products per entry of A
+        csrSpGemm_masked_products<T, MASK>(m, nnzA, rowOffA, colIndA, valA, rowOffB, colIndB, valB,
+                                           mask, complement, counts, nullptr,
+                                           nullptr, nullptr, nullptr, control);
+
+        exclusive_scan<int, EW_PLUS>(nnzA, offsets, counts, control);
+
+        int last[2];
+        control->accl_view.copy(offsets + (nnzA - 1), &last[0], sizeof(int));
+        control->accl_view.copy(counts + (nnzA - 1), &last[1], sizeof(int));
+        products.num_nonzeros = last[0] + last[1];
+    }
+
+    if (products.num_nonzeros > 0)
+    {
+        products.rowIndices = am_alloc(products.num_nonzeros * sizeof(int), acc, 0);
+        products.colIndices = am_alloc(products.num_nonzeros * sizeof(int), acc, 0);
+        // the count needs the positions of the products only
+        if (nnzC == nullptr)
+            products.values = am_alloc(products.num_nonzeros * sizeof(T), acc, 0);
+
+        // numeric: the kept products themselves
+        csrSpGemm_masked_products<T, MASK>(m, nnzA, rowOffA, colIndA, valA, rowOffB, colIndB, valB,
+                                           mask, complement, nullptr, offsets,
+                                           static_cast<int*>(products.rowIndices),
+                                           static_cast<int*>(products.colIndices),
+                                           static_cast<T*>(products.values), control);
+    }
+
+    hcsparseStatus status = hcsparseSuccess;
+    if (nnzC != nullptr)
+        *nnzC = csrSpGemm_masked_count<T>(&products, control);
+    else
+        status = coo_assemble<T>(&products, matC, control);
+
+    if (counts != nullptr)
+    {
+        am_free(counts);
+        am_free(offsets);
+    }
+    if (products.num_nonzeros > 0)
+    {
+        am_free(products.rowIndices);
+        am_free(products.colIndices);
+        if (products.values != nullptr)
+            am_free(products.values);
+    }
+
+    return status;
+}
+
+// Builds the device view of the mask and runs the masked product, or
+// only counts its entries into nnzC when given
+template <typename T>
+hcsparseStatus
+csrSpGemm_masked (const hcsparseCsrMatrix* matA,
+                  const hcsparseCsrMatrix* matB,
+                  const hcsparseMask* mask,
+                  hcsparseCsrMatrix* matC,
+                  hcsparseControl* control,
+                  int* nnzC = nullptr)
+{
+    if (matA->num_cols != matB->num_rows ||
+        (mask->pattern == nullptr) == (mask->bitmap == nullptr))
+    {
+        return hcsparseInvalid;
+    }
+
+    if (mask->pattern != nullptr)
+    {
+        const hcsparseCsrMatrix *M = mask->pattern;
+        if (M->num_rows != matA->num_rows || M->num_cols != matB->num_cols)
+        {
+            return hcsparseInvalid;
+        }
+
+        csr_mask_view view;
+        view.rowOff = static_cast<const int*>(M->rowOffsets) + M->offRowOff;
+        view.colInd = static_cast<const int*>(M->colIndices) + M->offColInd;
+        return csrSpGemm_masked<T, csr_mask_view>(matA, matB, view, mask->complement, matC, nnzC, control);
+    }
+    else
+    {
+        const hcdenseMatrix *M = mask->bitmap;
+        if ((int)M->num_rows != matA->num_rows || (int)M->num_cols != matB->num_cols)
+        {
+            return hcsparseInvalid;
+        }
+
+        dense_mask_view<T> view;
+        view.values = static_cast<const T*>(M->values) + M->offValues;
+        view.lead_dim = M->lead_dim;
+        view.row_major = (M->major == rowMajor);
+        return csrSpGemm_masked<T, dense_mask_view<T>>(matA, matB, view, mask->complement, matC, nnzC, control);
+    }
+}
+
+#endif //_HCSPARSE_SPM_SPM_MASKED_H_
@@ -1,4 +1,5 @@
 #include "hcsparse.h"
+#include <cstring>
 
 #define GROUPSIZE_256 256
 #define TUPLE_QUEUE 6
@@ -1666,6 +1667,49 @@ csrSpGemm(hcsparseControl* control,
         return hcsparseInvalid;
 } 
 
+// Symbolic phase of csrSpGemm for the last pair of tracked operands: the
+// products per row of A*B (stage 1) and the row bins and queue built from
+// them on the host (stage 2). Both depend only on the patterns, so while
+// the structure versions match a product after hcsparseCsrValuesChanged
+// skips the stage 1 kernel and its host round trip. The merge path of the
+// longest bin rewrites the queue, so a pristine host copy is kept.
+typedef struct spgemmPlan_
+{
+    unsigned long structureA;
+    unsigned long structureB;
+    int m;
+    int nnzCt;
+    int *csrRowPtrCt_d;
+    int *queue_one_d;
+    int *queue_one;
+    int *counter_one;
+} spgemmPlan;
+
+static spgemmPlan spgemm_plan = { 0, 0, 0, 0, nullptr, nullptr, nullptr, nullptr };
+
+inline void
+spgemm_release_plan ()
+{
+    if (spgemm_plan.csrRowPtrCt_d != nullptr)
+        am_free(spgemm_plan.csrRowPtrCt_d);
+    if (spgemm_plan.queue_one_d != nullptr)
+        am_free(spgemm_plan.queue_one_d);
+    free(spgemm_plan.queue_one);
+    free(spgemm_plan.counter_one);
+    spgemm_plan = { 0, 0, 0, 0, nullptr, nullptr, nullptr, nullptr };
+}
+
+inline bool
+spgemm_plan_matches (const hcsparseCsrMatrix* matA,
+                     const hcsparseCsrMatrix* matB)
+{
+    return matA->structureTracked() && matB->structureTracked() &&
+           spgemm_plan.csrRowPtrCt_d != nullptr &&
+           spgemm_plan.structureA == matA->structureVersion &&
+           spgemm_plan.structureB == matB->structureVersion &&
+           spgemm_plan.m == matA->num_rows;
+}
+
 template <typename T>
 hcsparseStatus
 csrSpGemm (const hcsparseCsrMatrix* matA,
@@ -1697,26 +1741,64 @@ csrSpGemm (const hcsparseCsrMatrix* matA,
     
     int *csrRowPtrC = static_cast<int*>(matC->rowOffsets);
 
-    int* csrRowPtrCt_h = (int*) calloc (m + 1, sizeof(int));
-    int* csrRowPtrCt_d = (int*) am_alloc((m + 1) * sizeof(int), acc, 0);
- 
-    // STAGE 1
-    compute_nnzCt<T> (m, csrRowPtrA, csrColIndA, csrRowPtrB, csrColIndB, csrRowPtrCt_d, control);
+    const bool reuse = spgemm_plan_matches(matA, matB);
 
-    control->accl_view.copy(csrRowPtrCt_d, csrRowPtrCt_h, (m + 1) * sizeof(int));   
- 
-    // statistics
     int* counter = (int*) calloc (NUM_SEGMENTS, sizeof(int));
     int* counter_one = (int*) calloc (NUM_SEGMENTS + 1, sizeof(int));
     int* counter_sum = (int*) calloc (NUM_SEGMENTS + 1, sizeof(int));
     int* queue_one = (int*) calloc (m * TUPLE_QUEUE, sizeof(int));
-    
-    // STAGE 2 - STEP 1 : statistics
-    int nnzCt = statistics(csrRowPtrCt_h, counter, counter_one, counter_sum, queue_one, m);
-    // STAGE 2 - STEP 2 : create Ct
+    int* csrRowPtrCt_d;
+    int *queue_one_d;
+    int nnzCt;
 
-    int *queue_one_d = (int*) am_alloc(m * TUPLE_QUEUE * sizeof(int), acc, 0);
-    control->accl_view.copy(queue_one, queue_one_d, m * TUPLE_QUEUE * sizeof(int));
+    if (reuse)
+    {
+        csrRowPtrCt_d = spgemm_plan.csrRowPtrCt_d;
+        queue_one_d = spgemm_plan.queue_one_d;
+        nnzCt = spgemm_plan.nnzCt;
+        memcpy(counter_one, spgemm_plan.counter_one, (NUM_SEGMENTS + 1) * sizeof(int));
+        memcpy(queue_one, spgemm_plan.queue_one, m * TUPLE_QUEUE * sizeof(int));
+
+        // the merge path rewrote the device queue of the last product
+        if (counter_one[NUM_SEGMENTS] != counter_one[NUM_SEGMENTS - 1])
+            control->accl_view.copy(queue_one, queue_one_d, m * TUPLE_QUEUE * sizeof(int));
+    }
+    else
+    {
+        int* csrRowPtrCt_h = (int*) calloc (m + 1, sizeof(int));
+        csrRowPtrCt_d = (int*) am_alloc((m + 1) * sizeof(int), acc, 0);
+
+        // STAGE 1
+        compute_nnzCt<T> (m, csrRowPtrA, csrColIndA, csrRowPtrB, csrColIndB, csrRowPtrCt_d, control);
+
+        control->accl_view.copy(csrRowPtrCt_d, csrRowPtrCt_h, (m + 1) * sizeof(int));
+
+        // STAGE 2 - STEP 1 : statistics
+        nnzCt = statistics(csrRowPtrCt_h, counter, counter_one, counter_sum, queue_one, m);
+        // STAGE 2 - STEP 2 : create Ct
+
+        queue_one_d = (int*) am_alloc(m * TUPLE_QUEUE * sizeof(int), acc, 0);
+        control->accl_view.copy(queue_one, queue_one_d, m * TUPLE_QUEUE * sizeof(int));
+
+        free(csrRowPtrCt_h);
+
+        if (matA->structureTracked() && matB->structureTracked())
+        {
+            spgemm_release_plan();
+            spgemm_plan.structureA = matA->structureVersion;
+            spgemm_plan.structureB = matB->structureVersion;
+            spgemm_plan.m = m;
+            spgemm_plan.nnzCt = nnzCt;
+            spgemm_plan.csrRowPtrCt_d = csrRowPtrCt_d;
+            spgemm_plan.queue_one_d = queue_one_d;
+            spgemm_plan.counter_one = (int*) malloc((NUM_SEGMENTS + 1) * sizeof(int));
+            spgemm_plan.queue_one = (int*) malloc(m * TUPLE_QUEUE * sizeof(int));
+            memcpy(spgemm_plan.counter_one, counter_one, (NUM_SEGMENTS + 1) * sizeof(int));
+            memcpy(spgemm_plan.queue_one, queue_one, m * TUPLE_QUEUE * sizeof(int));
+        }
+    }
+    // the device buffers belong to the plan when it keeps them
+    const bool planned = spgemm_plan.csrRowPtrCt_d == csrRowPtrCt_d;
 
     int *csrColIndCt = (int*) am_alloc(nnzCt * sizeof(int), acc, 0);
     T *csrValCt = (T*) am_alloc(nnzCt * sizeof(T), acc, 0);
@@ -1753,10 +1835,13 @@ csrSpGemm (const hcsparseCsrMatrix* matA,
 
     control->accl_view.wait();
 
-    am_free(csrRowPtrCt_d);
+    if (!planned)
+    {
+        am_free(csrRowPtrCt_d);
+        am_free(queue_one_d);
+    }
     am_free(csrColIndCt);
     am_free(csrValCt);
-    am_free(queue_one_d);
     free(counter);
     free(counter_one);
     free(counter_sum);
@@ -1,9 +1,11 @@
 #include "hcsparse.h"
 #include "hc_am.hpp"
+#include <atomic>
 #include "blas2/csrmv.h"
 #include "blas3/csrmm.h"
 #include "blas3/hcsparse-spm-spm.h"
 #include "blas3/hcsparse-spAdd.h"
+#include "blas3/hcsparse-rap.h"
 #include "blas1/hcdense-scale.h"
 #include "blas1/hcdense-axpby.h"
 #include "blas1/hcdense-axpy.h"
@@ -13,26 +15,51 @@
 #include "blas1/hcdense-nrm2.h"
 #include "blas1/hcdense-dot.h"
 #include "blas1/hcsparse-dot.h"
+#include "blas1/hcdense-fused.h"
 #include "blas1/elementwise-transform.h"
 #include "io/mm_reader.h"
 #include "blas2/csr_meta.h"
-#include "solvers/preconditioners/preconditioner.h"
-#include "solvers/preconditioners/diagonal.h"
-#include "solvers/preconditioners/void.h"
+#include "blas2/csrsv.h"
+#include "blas2/csrmv-semiring.h"
+#include "solvers/solver-preconditioner.h"
 #include "solvers/solver-control.h"
+#include "solvers/solver-workspace.h"
 #include "solvers/biconjugate-gradients-stabilized.h"
 #include "solvers/conjugate-gradients.h"
+#include "solvers/pipelined-conjugate-gradients.h"
+#include "solvers/gmres.h"
+#include "solvers/block-conjugate-gradients.h"
+#include "solvers/iterative-refinement.h"
+#include "solvers/lobpcg.h"
+#include "solvers/lanczos.h"
+#include "solvers/pagerank.h"
 #include "transform/scan.h"
 #include "transform/reduce-by-key.h"
+#include "transform/sort-by-key.h"
 #include "transform/conversion-utils.h"
 #include "transform/hcsparse-coo2csr.h"
+#include "transform/hcsparse-coo-assemble.h"
+#include "transform/hcsparse-csrsort.h"
 #include "transform/hcsparse-csr2coo.h"
 #include "transform/hcsparse-csr2dense.h"
 #include "transform/hcsparse-dense2csr.h"
 #include "transform/hcsparse-dense2csc.h"
+#include "blas2/spmspv.h"
+#include "blas3/hcsparse-spm-spm-masked.h"
 
 int hcsparseInitialized = 0;
 
+// Source of the CSR structure and values versions. Shared by all matrices
+// so that a version is never handed out twice, even to a matrix cleared or
+// reallocated at the address of an old one.
+static std::atomic<unsigned long> hcsparseVersionCounter(0);
+
+static unsigned long
+next_version ()
+{
+    return ++hcsparseVersionCounter;
+}
+
 // hcsparse Helper functions 
 
 // 1. hcsparseCreate()
@@ -246,47 +273,11 @@ hcsparseScsrmm(hcsparseHandle_t handle,
   int nnzPerRow = ((nnz-1)/m)+1;
 
   if (descrA->IndexBase == HCSPARSE_INDEX_BASE_ONE)
-  {
-    int* tmpCsrColInd = am_alloc(sizeof(int)*nnz, handle->currentAccl, 0);
-    handle->currentAcclView.copy((void*)csrColIndA, tmpCsrColInd, sizeof(int)*nnz);
-    int* tmpCsrRowPtr = am_alloc(sizeof(int)*(m+1), handle->currentAccl, 0);
-    handle->currentAcclView.copy((void*)csrRowPtrA, tmpCsrRowPtr, sizeof(int)*(m+1));
-
-    int size = (m)/256 + 1;
-    hc::extent<1> grdExt(size*256);
-    hc::tiled_extent<1> t_ext = grdExt.tile(256);
-    hc::parallel_for_each(control.accl_view, t_ext, [=] (hc::tiled_index<1> &tidx) [[hc]]
-    {
-        int id = tidx.global[0];
-        if (id < (m+1))
-        {
-            tmpCsrRowPtr[id]--;
-        }
-    }).wait();
-
-    size = (nnz-1)/256 + 1;
-    hc::extent<1> grdExt1(size*256);
-    hc::tiled_extent<1> t_ext1 = grdExt1.tile(256);
-    hc::parallel_for_each(control.accl_view, t_ext1, [=] (hc::tiled_index<1> &tidx) [[hc]]
-    {
-        int id = tidx.global[0];
-        if (id < nnz)
-        {
-            tmpCsrColInd[id]--;
-        }
-    }).wait();
-
-    stat = csrmm<float>(&control, nnzPerRow, m, n, k, alpha, csrValA, tmpCsrRowPtr,
-                        tmpCsrColInd, B, ldb, 1, beta, C, ldc);
-
-    am_free(tmpCsrColInd);
-    am_free(tmpCsrRowPtr);
-  }
+    stat = csrmm<float, 1>(&control, nnzPerRow, m, n, k, alpha, csrValA, csrRowPtrA,
+                           csrColIndA, B, ldb, 1, beta, C, ldc);
   else
-  {
-    stat = csrmm<float>(&control, nnzPerRow, m, n, k, alpha, csrValA, csrRowPtrA,
-                        csrColIndA, B, ldb, 1, beta, C, ldc);
-  }
+    stat = csrmm<float, 0>(&control, nnzPerRow, m, n, k, alpha, csrValA, csrRowPtrA,
+                           csrColIndA, B, ldb, 1, beta, C, ldc);
 
   if (stat != hcsparseSuccess)
     return HCSPARSE_STATUS_EXECUTION_FAILED;
@@ -325,47 +316,11 @@ hcsparseDcsrmm(hcsparseHandle_t handle,
   int nnzPerRow = ((nnz-1)/m)+1;
 
   if (descrA->IndexBase == HCSPARSE_INDEX_BASE_ONE)
-  {
-    int* tmpCsrColInd = am_alloc(sizeof(int)*nnz, handle->currentAccl, 0);
-    handle->currentAcclView.copy((void*)csrColIndA, tmpCsrColInd, sizeof(int)*nnz);
-    int* tmpCsrRowPtr = am_alloc(sizeof(int)*(m+1), handle->currentAccl, 0);
-    handle->currentAcclView.copy((void*)csrRowPtrA, tmpCsrRowPtr, sizeof(int)*(m+1));
-
-    int size = (m)/256 + 1;
-    hc::extent<1> grdExt(size*256);
-    hc::tiled_extent<1> t_ext = grdExt.tile(256);
-    hc::parallel_for_each(control.accl_view, t_ext, [=] (hc::tiled_index<1> &tidx) [[hc]]
-    {
-        int id = tidx.global[0];
-        if (id < (m+1))
-        {
-            tmpCsrRowPtr[id]--;
-        }
-    }).wait();
-
-    size = (nnz-1)/256 + 1;
-    hc::extent<1> grdExt1(size*256);
-    hc::tiled_extent<1> t_ext1 = grdExt1.tile(256);
-    hc::parallel_for_each(control.accl_view, t_ext1, [=] (hc::tiled_index<1> &tidx) [[hc]]
-    {
-        int id = tidx.global[0];
-        if (id < nnz)
-        {
-            tmpCsrColInd[id]--;
-        }
-    }).wait();
-
-    stat = csrmm<double>(&control, nnzPerRow, m, n, k, alpha, csrValA, tmpCsrRowPtr,
-                        tmpCsrColInd, B, ldb, 1, beta, C, ldc);
-
-    am_free(tmpCsrColInd);
-    am_free(tmpCsrRowPtr);
-  }
+    stat = csrmm<double, 1>(&control, nnzPerRow, m, n, k, alpha, csrValA, csrRowPtrA,
+                            csrColIndA, B, ldb, 1, beta, C, ldc);
   else
-  {
-    stat = csrmm<double>(&control, nnzPerRow, m, n, k, alpha, csrValA, csrRowPtrA,
-                        csrColIndA, B, ldb, 1, beta, C, ldc);
-  }
+    stat = csrmm<double, 0>(&control, nnzPerRow, m, n, k, alpha, csrValA, csrRowPtrA,
+                            csrColIndA, B, ldb, 1, beta, C, ldc);
 
   if (stat != hcsparseSuccess)
     return HCSPARSE_STATUS_EXECUTION_FAILED;
@@ -418,47 +373,11 @@ hcsparseScsrmm2(hcsparseHandle_t handle,
   int nnzPerRow = ((nnz-1)/m)+1;
 
   if (descrA->IndexBase == HCSPARSE_INDEX_BASE_ONE)
-  {
-    int* tmpCsrColInd = am_alloc(sizeof(int)*nnz, handle->currentAccl, 0);
-    handle->currentAcclView.copy((void*)csrColIndA, tmpCsrColInd, sizeof(int)*nnz);
-    int* tmpCsrRowPtr = am_alloc(sizeof(int)*(m+1), handle->currentAccl, 0);
-    handle->currentAcclView.copy((void*)csrRowPtrA, tmpCsrRowPtr, sizeof(int)*(m+1));
-
-    int size = (m)/256 + 1;
-    hc::extent<1> grdExt(size*256);
-    hc::tiled_extent<1> t_ext = grdExt.tile(256);
-    hc::parallel_for_each(control.accl_view, t_ext, [=] (hc::tiled_index<1> &tidx) [[hc]]
-    {
-        int id = tidx.global[0];
-        if (id < (m+1))
-        {
-            tmpCsrRowPtr[id]--;
-        }
-    }).wait();
-
-    size = (nnz-1)/256 + 1;
-    hc::extent<1> grdExt1(size*256);
-    hc::tiled_extent<1> t_ext1 = grdExt1.tile(256);
-    hc::parallel_for_each(control.accl_view, t_ext1, [=] (hc::tiled_index<1> &tidx) [[hc]]
-    {
-        int id = tidx.global[0];
-        if (id < nnz)
-        {
-            tmpCsrColInd[id]--;
-        }
-    }).wait();
-
-    stat = csrmm<float>(&control, nnzPerRow, m, n, k, alpha, csrValA, tmpCsrRowPtr,
-                        tmpCsrColInd, B, ldb_nt, ldb_t, beta, C, ldc);
-
-    am_free(tmpCsrColInd);
-    am_free(tmpCsrRowPtr);
-  }
+    stat = csrmm<float, 1>(&control, nnzPerRow, m, n, k, alpha, csrValA, csrRowPtrA,
+                           csrColIndA, B, ldb_nt, ldb_t, beta, C, ldc);
   else
-  {
-    stat = csrmm<float>(&control, nnzPerRow, m, n, k, alpha, csrValA, csrRowPtrA,
-                        csrColIndA, B, ldb_nt, ldb_t, beta, C, ldc);
-  }
+    stat = csrmm<float, 0>(&control, nnzPerRow, m, n, k, alpha, csrValA, csrRowPtrA,
+                           csrColIndA, B, ldb_nt, ldb_t, beta, C, ldc);
 
   if (stat != hcsparseSuccess)
     return HCSPARSE_STATUS_EXECUTION_FAILED;
@@ -511,47 +430,11 @@ hcsparseDcsrmm2(hcsparseHandle_t handle,
   int nnzPerRow = ((nnz-1)/m)+1;
 
   if (descrA->IndexBase == HCSPARSE_INDEX_BASE_ONE)
-  {
-    int* tmpCsrColInd = am_alloc(sizeof(int)*nnz, handle->currentAccl, 0);
-    handle->currentAcclView.copy((void*)csrColIndA, tmpCsrColInd, sizeof(int)*nnz);
-    int* tmpCsrRowPtr = am_alloc(sizeof(int)*(m+1), handle->currentAccl, 0);
-    handle->currentAcclView.copy((void*)csrRowPtrA, tmpCsrRowPtr, sizeof(int)*(m+1));
-
-    int size = (m)/256 + 1;
-    hc::extent<1> grdExt(size*256);
-    hc::tiled_extent<1> t_ext = grdExt.tile(256);
-    hc::parallel_for_each(control.accl_view, t_ext, [=] (hc::tiled_index<1> &tidx) [[hc]]
-    {
-        int id = tidx.global[0];
-        if (id < (m+1))
-        {
-            tmpCsrRowPtr[id]--;
-        }
-    }).wait();
-
-    size = (nnz-1)/256 + 1;
-    hc::extent<1> grdExt1(size*256);
-    hc::tiled_extent<1> t_ext1 = grdExt1.tile(256);
-    hc::parallel_for_each(control.accl_view, t_ext1, [=] (hc::tiled_index<1> &tidx) [[hc]]
-    {
-        int id = tidx.global[0];
-        if (id < nnz)
-        {
-            tmpCsrColInd[id]--;
-        }
-    }).wait();
-
-    stat = csrmm<double>(&control, nnzPerRow, m, n, k, alpha, csrValA, tmpCsrRowPtr,
-                        tmpCsrColInd, B, ldb_nt, ldb_t, beta, C, ldc);
-
-    am_free(tmpCsrColInd);
-    am_free(tmpCsrRowPtr);
-  }
+    stat = csrmm<double, 1>(&control, nnzPerRow, m, n, k, alpha, csrValA, csrRowPtrA,
+                            csrColIndA, B, ldb_nt, ldb_t, beta, C, ldc);
   else
-  {
-    stat = csrmm<double>(&control, nnzPerRow, m, n, k, alpha, csrValA, csrRowPtrA,
-                        csrColIndA, B, ldb_nt, ldb_t, beta, C, ldc);
-  }
+    stat = csrmm<double, 0>(&control, nnzPerRow, m, n, k, alpha, csrValA, csrRowPtrA,
+                            csrColIndA, B, ldb_nt, ldb_t, beta, C, ldc);
 
   if (stat != hcsparseSuccess)
     return HCSPARSE_STATUS_EXECUTION_FAILED;
@@ -1223,18 +1106,14 @@ hcsparseSdoti(hcsparseHandle_t handle, int nnz,
   hcsparseControl control(handle->currentAcclView);
   hcsparseStatus stat = hcsparseSuccess;
 
-  int REDUCE_BLOCKS_NUMBER = nnz/BLOCK_SIZE + 1; 
-  float* partial = am_alloc(sizeof(float) * REDUCE_BLOCKS_NUMBER, 
-                            handle->currentAccl, 0);
   float* result = am_alloc(sizeof(float) * 1, handle->currentAccl, 0);
   
   inner_product<float> (nnz, result, (float *)xVal, (int *)xInd, 
-			(float *)y, partial, REDUCE_BLOCKS_NUMBER, &control);
+			(float *)y, &control);
 
   handle->currentAcclView.copy(result, resultDevHostPtr, sizeof(float)*1);
 
   // Deallocate resources
-  hc::am_free(partial);
   hc::am_free(result);
 
   return HCSPARSE_STATUS_SUCCESS;
@@ -1261,18 +1140,14 @@ hcsparseDdoti(hcsparseHandle_t handle, int nnz,
   hcsparseControl control(handle->currentAcclView);
   hcsparseStatus stat = hcsparseSuccess;
 
-  int REDUCE_BLOCKS_NUMBER = nnz/BLOCK_SIZE + 1; 
-  double* partial = am_alloc(sizeof(double) * REDUCE_BLOCKS_NUMBER, 
-                            handle->currentAccl, 0);
   double* result = am_alloc(sizeof(double) * 1, handle->currentAccl, 0);
   
   inner_product<double> (nnz, result, (double *)xVal, (int *)xInd, 
-			(double *)y, partial, REDUCE_BLOCKS_NUMBER, &control);
+			(double *)y, &control);
 
   handle->currentAcclView.copy(result, resultDevHostPtr, sizeof(double)*1);
 
   // Deallocate resources
-  hc::am_free(partial);
   hc::am_free(result);
 
   return HCSPARSE_STATUS_SUCCESS;
@@ -1460,7 +1335,7 @@ hcsparseXcsr2coo(hcsparseHandle_t handle, const int *csrRowPtr,
   if (handle == nullptr) 
     return HCSPARSE_STATUS_NOT_INITIALIZED;
 
-  if (idxBase != HCSPARSE_INDEX_BASE_ZERO)
+  if (idxBase != HCSPARSE_INDEX_BASE_ZERO && idxBase != HCSPARSE_INDEX_BASE_ONE)
     return HCSPARSE_STATUS_INVALID_VALUE;
 
   // temp code 
@@ -1468,7 +1343,10 @@ hcsparseXcsr2coo(hcsparseHandle_t handle, const int *csrRowPtr,
   hcsparseControl control(handle->currentAcclView);
   hcsparseStatus stat = hcsparseSuccess;
 
-  stat = offsets_to_indices<int> (m, nnz, cooRowInd, csrRowPtr, &control);
+  if (idxBase == HCSPARSE_INDEX_BASE_ONE)
+    stat = offsets_to_indices<int, 1> (m, nnz, cooRowInd, csrRowPtr, &control);
+  else
+    stat = offsets_to_indices<int, 0> (m, nnz, cooRowInd, csrRowPtr, &control);
 
   if (stat != hcsparseSuccess)
     return HCSPARSE_STATUS_EXECUTION_FAILED;
@@ -1501,33 +1379,15 @@ hcsparseXcoo2csr(hcsparseHandle_t handle, const int *cooRowInd,
   if (idxBase != HCSPARSE_INDEX_BASE_ZERO && idxBase != HCSPARSE_INDEX_BASE_ONE)
     return HCSPARSE_STATUS_INVALID_VALUE;
 
-  if (idxBase == HCSPARSE_INDEX_BASE_ONE)
-    m = m+1;
-
   // temp code 
   // TODO : Remove this in the future
   hcsparseControl control(handle->currentAcclView);
   hcsparseStatus stat = hcsparseSuccess;
 
   if (idxBase == HCSPARSE_INDEX_BASE_ONE)
-    stat = indices_to_offsets_oneBase<int> (m, nnz, csrRowPtr, cooRowInd, &control);
+    stat = indices_to_offsets<int, 1> (m, nnz, csrRowPtr, cooRowInd, &control);
   else
-    stat = indices_to_offsets<int> (m, nnz, csrRowPtr, cooRowInd, &control);
-
-  if (idxBase == HCSPARSE_INDEX_BASE_ONE)
-  {
-    int size = (m-1)/256 + 1;
-    hc::extent<1> grdExt(size*256);
-    hc::tiled_extent<1> t_ext = grdExt.tile(256);
-    hc::parallel_for_each(control.accl_view, t_ext, [=] (hc::tiled_index<1> &tidx) [[hc]]
-    {
-        int id = tidx.global[0];
-        if (id < m)
-        {
-            csrRowPtr[id]++;
-        }
-    }).wait();
-  }
+    stat = indices_to_offsets<int, 0> (m, nnz, csrRowPtr, cooRowInd, &control);
 
   if (stat != hcsparseSuccess)
     return HCSPARSE_STATUS_EXECUTION_FAILED;
@@ -1580,7 +1440,10 @@ hcsparseScsrmv(hcsparseHandle_t handle, hcsparseOperation_t transA,
   hcsparseControl control(handle->currentAcclView);
   hcsparseStatus stat = hcsparseSuccess;
 
-  csrmv <float> (&control, m, n, nnz, alpha, csrValA, csrRowPtrA, csrColIndA, x, beta, y);
+  if (descrA->IndexBase == HCSPARSE_INDEX_BASE_ONE)
+    stat = csrmv<float, 1> (&control, m, n, nnz, alpha, csrValA, csrRowPtrA, csrColIndA, x, beta, y);
+  else
+    stat = csrmv<float, 0> (&control, m, n, nnz, alpha, csrValA, csrRowPtrA, csrColIndA, x, beta, y);
 
   if (stat != hcsparseSuccess)
     return HCSPARSE_STATUS_EXECUTION_FAILED;
@@ -1615,7 +1478,10 @@ hcsparseDcsrmv(hcsparseHandle_t handle, hcsparseOperation_t transA,
   hcsparseControl control(handle->currentAcclView);
   hcsparseStatus stat = hcsparseSuccess;
 
-  csrmv <double> (&control, m, n, nnz, alpha, csrValA, csrRowPtrA, csrColIndA, x, beta, y);
+  if (descrA->IndexBase == HCSPARSE_INDEX_BASE_ONE)
+    stat = csrmv<double, 1> (&control, m, n, nnz, alpha, csrValA, csrRowPtrA, csrColIndA, x, beta, y);
+  else
+    stat = csrmv<double, 0> (&control, m, n, nnz, alpha, csrValA, csrRowPtrA, csrColIndA, x, beta, y);
 
   if (stat != hcsparseSuccess)
     return HCSPARSE_STATUS_EXECUTION_FAILED;
@@ -1867,167 +1733,675 @@ hcsparseDcsrgeam(hcsparseHandle_t handle,
 
 }
 
+// 19. hcsparseXcsrsort()
 
-hcsparseStatus
-hcsparseSetup(void)
-{
-    if(hcsparseInitialized)
-    {
-        return hcsparseSuccess;
-    }
+// This function sorts the column indices of each row of a CSR matrix
+// in place. If P is not null it is permuted along with the column
+// indices, so that starting from the identity permutation the values
+// can afterwards be reordered with hcsparseXgthr().
 
-    hcsparseInitialized = 1;
-    return hcsparseSuccess;
-}
+// Return Values
+// ----------------------------------------------------------------------
+// HCSPARSE_STATUS_SUCCESS              the operation completed successfully.
+// HCSPARSE_STATUS_NOT_INITIALIZED      the library was not initialized.
+// HCSPARSE_STATUS_ALLOC_FAILED         the resources could not be allocated.
+// HCSPARSE_STATUS_INVALID_VALUE        invalid parameters were passed (m, n, nnz<0).
+// HCSPARSE_STATUS_EXECUTION_FAILED     the function failed to launch on the GPU.
 
-hcsparseStatus
-hcsparseTeardown(void)
+hcsparseStatus_t
+hcsparseXcsrsort(hcsparseHandle_t handle, int m, int n, int nnz,
+                 const hcsparseMatDescr_t descrA,
+                 const int *csrRowPtrA, int *csrColIndA, int *P)
 {
-    if(!hcsparseInitialized)
-    {
-        return hcsparseSuccess;
-    }
+  if (handle == nullptr)
+    return HCSPARSE_STATUS_NOT_INITIALIZED;
 
-    hcsparseInitialized = 0;
-    return hcsparseSuccess;
-}
+  if (m < 0 || n < 0 || nnz < 0)
+    return HCSPARSE_STATUS_INVALID_VALUE;
 
-// Convenience sparse matrix construction functions
-hcsparseStatus
-hcsparseInitScalar (hcsparseScalar* scalar)
-{
-    scalar->clear( );
+  if (!csrRowPtrA || !csrColIndA)
+    return HCSPARSE_STATUS_ALLOC_FAILED;
 
-    return hcsparseSuccess;
-};
+  hcsparseControl control(handle->currentAcclView);
+  hcsparseStatus stat = hcsparseSuccess;
 
-hcsparseStatus
-hcsparseInitVector (hcdenseVector* vec)
-{
-    vec->clear( );
+  if (descrA->IndexBase == HCSPARSE_INDEX_BASE_ONE)
+  {
+    if (P)
+      stat = csrsort<1>(&control, m, nnz, csrRowPtrA, csrColIndA, P);
+    else
+      stat = csrsort<1>(&control, m, nnz, csrRowPtrA, csrColIndA);
+  }
+  else
+  {
+    if (P)
+      stat = csrsort<0>(&control, m, nnz, csrRowPtrA, csrColIndA, P);
+    else
+      stat = csrsort<0>(&control, m, nnz, csrRowPtrA, csrColIndA);
+  }
 
-    return hcsparseSuccess;
-};
+  if (stat != hcsparseSuccess)
+    return HCSPARSE_STATUS_EXECUTION_FAILED;
 
-hcsparseStatus
-hcsparseInitCooMatrix (hcsparseCooMatrix* cooMatx)
-{
-    cooMatx->clear( );
+  return HCSPARSE_STATUS_SUCCESS;
+}
 
-    return hcsparseSuccess;
-};
+// 20. hcsparseCreateIdentityPermutation()
 
-hcsparseStatus
-hcsparseInitCsrMatrix (hcsparseCsrMatrix* csrMatx)
-{
-    csrMatx->clear( );
+// This function fills p with the identity permutation 0, 1, ..., n-1.
 
-    return hcsparseSuccess;
-};
+// Return Values
+// ----------------------------------------------------------------------
+// HCSPARSE_STATUS_SUCCESS              the operation completed successfully.
+// HCSPARSE_STATUS_NOT_INITIALIZED      the library was not initialized.
+// HCSPARSE_STATUS_INVALID_VALUE        invalid parameters were passed (n<0).
 
-hcsparseStatus
-hcsparseInitCscMatrix (hcsparseCscMatrix* cscMatx)
+hcsparseStatus_t
+hcsparseCreateIdentityPermutation(hcsparseHandle_t handle, int n, int *p)
 {
-    cscMatx->clear( );
+  if (handle == nullptr)
+    return HCSPARSE_STATUS_NOT_INITIALIZED;
 
-    return hcsparseSuccess;
-};
+  if (n < 0 || (n > 0 && !p))
+    return HCSPARSE_STATUS_INVALID_VALUE;
 
-hcsparseStatus
-hcdenseInitMatrix (hcdenseMatrix* denseMatx)
-{
-    denseMatx->clear();
+  hcsparseControl control(handle->currentAcclView);
 
-    return hcsparseSuccess;
+  if (identity_permutation(&control, n, p) != hcsparseSuccess)
+    return HCSPARSE_STATUS_EXECUTION_FAILED;
+
+  return HCSPARSE_STATUS_SUCCESS;
 }
 
-hcsparseStatus
-hcsparseScsrmv (const hcsparseScalar* alpha,
-                const hcsparseCsrMatrix* matx,
-                const hcdenseVector* x,
-                const hcsparseScalar* beta,
-                hcdenseVector* y,
-                hcsparseControl* control)
-{
-    if (!hcsparseInitialized)
-    {
-        return hcsparseInvalid;
-    }
+// 21. hcsparseXgthr()
 
-    //check opencl elements
-    if (x->values == nullptr || y->values == nullptr)
-    {
-        return hcsparseInvalid;
-    }
+// This function gathers the elements of the dense vector y
+// listed in xInd into the sparse vector xVal:
+// xVal[i] = y[xInd[i]]
 
-    return csrmv<float>(alpha, matx, x, beta, y, control);
-}
+// Return Values
+// ----------------------------------------------------------------------
+// HCSPARSE_STATUS_SUCCESS              the operation completed successfully.
+// HCSPARSE_STATUS_NOT_INITIALIZED      the library was not initialized.
+// HCSPARSE_STATUS_INVALID_VALUE        invalid parameters were passed (nnz<0, idxBase is neither ZERO nor ONE).
+// HCSPARSE_STATUS_EXECUTION_FAILED     the function failed to launch on the GPU.
 
-hcsparseStatus
-hcsparseDcsrmv (const hcsparseScalar* alpha,
-                const hcsparseCsrMatrix* matx,
-                const hcdenseVector* x,
-                const hcsparseScalar* beta,
-                hcdenseVector* y,
-                hcsparseControl* control)
+hcsparseStatus_t
+hcsparseSgthr(hcsparseHandle_t handle, int nnz, const float *y,
+              float *xVal, const int *xInd, hcsparseIndexBase_t idxBase)
 {
-    if (!hcsparseInitialized)
-    {
-        return hcsparseInvalid;
-    }
+  if (handle == nullptr)
+    return HCSPARSE_STATUS_NOT_INITIALIZED;
 
-    //check opencl elements
-    if (x->values == nullptr || y->values == nullptr)
-    {
-        return hcsparseInvalid;
-    }
+  if (nnz < 0)
+    return HCSPARSE_STATUS_INVALID_VALUE;
 
-    return csrmv<double>(alpha, matx, x, beta, y, control);
-}
+  if (idxBase != HCSPARSE_INDEX_BASE_ZERO && idxBase != HCSPARSE_INDEX_BASE_ONE)
+    return HCSPARSE_STATUS_INVALID_VALUE;
 
-hcsparseStatus
-hcsparseScsrmm (const hcsparseScalar* alpha,
-                const hcsparseCsrMatrix* sparseCsrA,
-                const hcdenseMatrix* denseB,
-                const hcsparseScalar* beta,
-                hcdenseMatrix* denseC,
-                hcsparseControl *control)
-{
-    if( !hcsparseInitialized )
-    {
-        return hcsparseInvalid;
-    }
+  hcsparseControl control(handle->currentAcclView);
+  int base = (idxBase == HCSPARSE_INDEX_BASE_ONE) ? 1 : 0;
 
-    if( denseB->values == nullptr || denseC->values == nullptr)
-    {
-        return hcsparseInvalid;
-    }
+  if (gather<float>(&control, nnz, y, xVal, xInd, base) != hcsparseSuccess)
+    return HCSPARSE_STATUS_EXECUTION_FAILED;
 
-    return csrmm<float> ( alpha, sparseCsrA, denseB, beta, denseC, control );
+  return HCSPARSE_STATUS_SUCCESS;
 }
 
-hcsparseStatus
-hcsparseDcsrmm (const hcsparseScalar* alpha,
-                const hcsparseCsrMatrix* sparseCsrA,
-                const hcdenseMatrix* denseB,
-                const hcsparseScalar* beta,
-                hcdenseMatrix* denseC,
-                hcsparseControl *control)
+hcsparseStatus_t
+hcsparseDgthr(hcsparseHandle_t handle, int nnz, const double *y,
+              double *xVal, const int *xInd, hcsparseIndexBase_t idxBase)
 {
-    if( !hcsparseInitialized )
-    {
-        return hcsparseInvalid;
-    }
+  if (handle == nullptr)
+    return HCSPARSE_STATUS_NOT_INITIALIZED;
 
-    if( denseB->values == nullptr || denseC->values == nullptr)
-    {
-        return hcsparseInvalid;
-    }
+  if (nnz < 0)
+    return HCSPARSE_STATUS_INVALID_VALUE;
 
-    return csrmm<double> ( alpha, sparseCsrA, denseB, beta, denseC, control );
-}
+  if (idxBase != HCSPARSE_INDEX_BASE_ZERO && idxBase != HCSPARSE_INDEX_BASE_ONE)
+    return HCSPARSE_STATUS_INVALID_VALUE;
 
-hcsparseStatus
+  hcsparseControl control(handle->currentAcclView);
+  int base = (idxBase == HCSPARSE_INDEX_BASE_ONE) ? 1 : 0;
+
+  if (gather<double>(&control, nnz, y, xVal, xInd, base) != hcsparseSuccess)
+    return HCSPARSE_STATUS_EXECUTION_FAILED;
+
+  return HCSPARSE_STATUS_SUCCESS;
+}
+
+// 22. hcsparseCreateSolveAnalysisInfo()
+
+// This function creates and initializes the analysis structure
+// used by the triangular solves.
+
+// Return Values
+// ----------------------------------------------------------------------
+// HCSPARSE_STATUS_SUCCESS              the structure was initialized successfully.
+// HCSPARSE_STATUS_ALLOC_FAILED         the resources could not be allocated.
+
+hcsparseStatus_t
+hcsparseCreateSolveAnalysisInfo(hcsparseSolveAnalysisInfo_t *info)
+{
+  if (info == nullptr)
+    return HCSPARSE_STATUS_INVALID_VALUE;
+
+  *info = new hcsparseSolveAnalysisInfo();
+
+  if (*info == nullptr)
+    return HCSPARSE_STATUS_ALLOC_FAILED;
+
+  return HCSPARSE_STATUS_SUCCESS;
+}
+
+// 23. hcsparseDestroySolveAnalysisInfo()
+
+// This function destroys and releases any memory held by the analysis structure.
+
+// Return Values
+// ----------------------------------------------------------------------
+// HCSPARSE_STATUS_SUCCESS              the resources were released successfully.
+
+hcsparseStatus_t
+hcsparseDestroySolveAnalysisInfo(hcsparseSolveAnalysisInfo_t info)
+{
+  delete info;
+
+  return HCSPARSE_STATUS_SUCCESS;
+}
+
+// 24. hcsparseXcsrsv_analysis()
+
+// This function performs the analysis phase of the triangular solves:
+// the rows of the triangle selected by descrA are grouped into levels
+// that are solved one after the other, every row of a level in parallel.
+
+// Return Values
+// ----------------------------------------------------------------------
+// HCSPARSE_STATUS_SUCCESS              the operation completed successfully.
+// HCSPARSE_STATUS_NOT_INITIALIZED      the library was not initialized.
+// HCSPARSE_STATUS_ALLOC_FAILED         the resources could not be allocated.
+// HCSPARSE_STATUS_INVALID_VALUE        invalid parameters were passed (m, nnz<0).
+// HCSPARSE_STATUS_EXECUTION_FAILED     the function failed to launch on the GPU.
+
+hcsparseStatus_t
+hcsparseXcsrsv_analysis(hcsparseHandle_t handle, hcsparseOperation_t transA,
+                        int m, int nnz, const hcsparseMatDescr_t descrA,
+                        const int *csrRowPtrA, const int *csrColIndA,
+                        hcsparseSolveAnalysisInfo_t info)
+{
+  if (handle == nullptr)
+    return HCSPARSE_STATUS_NOT_INITIALIZED;
+
+  if (!csrRowPtrA || !csrColIndA || !info)
+    return HCSPARSE_STATUS_ALLOC_FAILED;
+
+  if (transA != HCSPARSE_OPERATION_NON_TRANSPOSE)
+    return HCSPARSE_STATUS_INVALID_VALUE;
+
+  if (m < 0 || nnz < 0)
+    return HCSPARSE_STATUS_INVALID_VALUE;
+
+  hcsparseControl control(handle->currentAcclView);
+
+  if (csrsv_analysis(&control, m, nnz, descrA->FillMode, descrA->IndexBase,
+                     csrRowPtrA, csrColIndA, info) != hcsparseSuccess)
+    return HCSPARSE_STATUS_EXECUTION_FAILED;
+
+  return HCSPARSE_STATUS_SUCCESS;
+}
+
+// 25. hcsparseXcsrsv_solve()
+
+// This function performs the solve phase of
+// op(A) * y = α * x
+// with the levels computed by hcsparseXcsrsv_analysis().
+
+// Return Values
+// ----------------------------------------------------------------------
+// HCSPARSE_STATUS_SUCCESS              the operation completed successfully.
+// HCSPARSE_STATUS_NOT_INITIALIZED      the library was not initialized.
+// HCSPARSE_STATUS_ALLOC_FAILED         the resources could not be allocated.
+// HCSPARSE_STATUS_INVALID_VALUE        invalid parameters were passed (m<0, info does not match descrA).
+// HCSPARSE_STATUS_EXECUTION_FAILED     the function failed to launch on the GPU.
+
+hcsparseStatus_t
+hcsparseScsrsv_solve(hcsparseHandle_t handle, hcsparseOperation_t transA,
+                     int m, const float *alpha,
+                     const hcsparseMatDescr_t descrA,
+                     const float *csrValA, const int *csrRowPtrA,
+                     const int *csrColIndA, hcsparseSolveAnalysisInfo_t info,
+                     const float *x, float *y)
+{
+  if (handle == nullptr)
+    return HCSPARSE_STATUS_NOT_INITIALIZED;
+
+  if (!csrValA || !csrRowPtrA || !csrColIndA || !info || !x || !y || !alpha)
+    return HCSPARSE_STATUS_ALLOC_FAILED;
+
+  if (transA != HCSPARSE_OPERATION_NON_TRANSPOSE || m < 0)
+    return HCSPARSE_STATUS_INVALID_VALUE;
+
+  hcsparseControl control(handle->currentAcclView);
+
+  if (csrsv_solve<float>(&control, m, 1, alpha, descrA, csrValA, csrRowPtrA, csrColIndA,
+                     info, x, m, y, m) != hcsparseSuccess)
+    return HCSPARSE_STATUS_INVALID_VALUE;
+
+  return HCSPARSE_STATUS_SUCCESS;
+}
+
+hcsparseStatus_t
+hcsparseDcsrsv_solve(hcsparseHandle_t handle, hcsparseOperation_t transA,
+                     int m, const double *alpha,
+                     const hcsparseMatDescr_t descrA,
+                     const double *csrValA, const int *csrRowPtrA,
+                     const int *csrColIndA, hcsparseSolveAnalysisInfo_t info,
+                     const double *x, double *y)
+{
+  if (handle == nullptr)
+    return HCSPARSE_STATUS_NOT_INITIALIZED;
+
+  if (!csrValA || !csrRowPtrA || !csrColIndA || !info || !x || !y || !alpha)
+    return HCSPARSE_STATUS_ALLOC_FAILED;
+
+  if (transA != HCSPARSE_OPERATION_NON_TRANSPOSE || m < 0)
+    return HCSPARSE_STATUS_INVALID_VALUE;
+
+  hcsparseControl control(handle->currentAcclView);
+
+  if (csrsv_solve<double>(&control, m, 1, alpha, descrA, csrValA, csrRowPtrA, csrColIndA,
+                     info, x, m, y, m) != hcsparseSuccess)
+    return HCSPARSE_STATUS_INVALID_VALUE;
+
+  return HCSPARSE_STATUS_SUCCESS;
+}
+
+// 26. hcsparseXcsrsm_solve()
+
+// This function performs the solve phase of
+// op(A) * Y = α * X
+// for the n columns of X, reusing the levels computed by hcsparseXcsrsv_analysis().
+
+// Return Values
+// ----------------------------------------------------------------------
+// HCSPARSE_STATUS_SUCCESS              the operation completed successfully.
+// HCSPARSE_STATUS_NOT_INITIALIZED      the library was not initialized.
+// HCSPARSE_STATUS_ALLOC_FAILED         the resources could not be allocated.
+// HCSPARSE_STATUS_INVALID_VALUE        invalid parameters were passed (m, n<0, ldx or ldy<m, info does not match descrA).
+// HCSPARSE_STATUS_EXECUTION_FAILED     the function failed to launch on the GPU.
+
+hcsparseStatus_t
+hcsparseScsrsm_solve(hcsparseHandle_t handle, hcsparseOperation_t transA,
+                     int m, int n, const float *alpha,
+                     const hcsparseMatDescr_t descrA,
+                     const float *csrValA, const int *csrRowPtrA,
+                     const int *csrColIndA, hcsparseSolveAnalysisInfo_t info,
+                     const float *X, int ldx, float *Y, int ldy)
+{
+  if (handle == nullptr)
+    return HCSPARSE_STATUS_NOT_INITIALIZED;
+
+  if (!csrValA || !csrRowPtrA || !csrColIndA || !info || !X || !Y || !alpha)
+    return HCSPARSE_STATUS_ALLOC_FAILED;
+
+  if (transA != HCSPARSE_OPERATION_NON_TRANSPOSE)
+    return HCSPARSE_STATUS_INVALID_VALUE;
+
+  if (m < 0 || n < 0 || ldx < m || ldy < m)
+    return HCSPARSE_STATUS_INVALID_VALUE;
+
+  hcsparseControl control(handle->currentAcclView);
+
+  if (csrsv_solve<float>(&control, m, n, alpha, descrA, csrValA, csrRowPtrA, csrColIndA,
+                     info, X, ldx, Y, ldy) != hcsparseSuccess)
+    return HCSPARSE_STATUS_INVALID_VALUE;
+
+  return HCSPARSE_STATUS_SUCCESS;
+}
+
+hcsparseStatus_t
+hcsparseDcsrsm_solve(hcsparseHandle_t handle, hcsparseOperation_t transA,
+                     int m, int n, const double *alpha,
+                     const hcsparseMatDescr_t descrA,
+                     const double *csrValA, const int *csrRowPtrA,
+                     const int *csrColIndA, hcsparseSolveAnalysisInfo_t info,
+                     const double *X, int ldx, double *Y, int ldy)
+{
+  if (handle == nullptr)
+    return HCSPARSE_STATUS_NOT_INITIALIZED;
+
+  if (!csrValA || !csrRowPtrA || !csrColIndA || !info || !X || !Y || !alpha)
+    return HCSPARSE_STATUS_ALLOC_FAILED;
+
+  if (transA != HCSPARSE_OPERATION_NON_TRANSPOSE)
+    return HCSPARSE_STATUS_INVALID_VALUE;
+
+  if (m < 0 || n < 0 || ldx < m || ldy < m)
+    return HCSPARSE_STATUS_INVALID_VALUE;
+
+  hcsparseControl control(handle->currentAcclView);
+
+  if (csrsv_solve<double>(&control, m, n, alpha, descrA, csrValA, csrRowPtrA, csrColIndA,
+                     info, X, ldx, Y, ldy) != hcsparseSuccess)
+    return HCSPARSE_STATUS_INVALID_VALUE;
+
+  return HCSPARSE_STATUS_SUCCESS;
+}
+
+
+hcsparseStatus
+hcsparseSetup(void)
+{
+    if(hcsparseInitialized)
+    {
+        return hcsparseSuccess;
+    }
+
+    hcsparseInitialized = 1;
+    return hcsparseSuccess;
+}
+
+hcsparseStatus
+hcsparseTeardown(void)
+{
+    if(!hcsparseInitialized)
+    {
+        return hcsparseSuccess;
+    }
+
+    scan_release_scratch();
+    reduce_release_scratch();
+    spgemm_release_plan();
+
+    hcsparseInitialized = 0;
+    return hcsparseSuccess;
+}
+
+// Convenience sparse matrix construction functions
+hcsparseStatus
+hcsparseInitScalar (hcsparseScalar* scalar)
+{
+    scalar->clear( );
+
+    return hcsparseSuccess;
+};
+
+hcsparseStatus
+hcsparseInitVector (hcdenseVector* vec)
+{
+    vec->clear( );
+
+    return hcsparseSuccess;
+};
+
+hcsparseStatus
+hcsparseInitSparseVector (hcsparseVector* vec)
+{
+    vec->clear( );
+
+    return hcsparseSuccess;
+};
+
+hcsparseStatus
+hcsparseInitMask (hcsparseMask* mask)
+{
+    mask->clear( );
+
+    return hcsparseSuccess;
+};
+
+hcsparseStatus
+hcsparseInitCooMatrix (hcsparseCooMatrix* cooMatx)
+{
+    cooMatx->clear( );
+
+    return hcsparseSuccess;
+};
+
+hcsparseStatus
+hcsparseInitCsrMatrix (hcsparseCsrMatrix* csrMatx)
+{
+    csrMatx->clear( );
+
+    return hcsparseSuccess;
+};
+
+hcsparseStatus
+hcsparseInitCscMatrix (hcsparseCscMatrix* cscMatx)
+{
+    cscMatx->clear( );
+
+    return hcsparseSuccess;
+};
+
+hcsparseStatus
+hcdenseInitMatrix (hcdenseMatrix* denseMatx)
+{
+    denseMatx->clear();
+
+    return hcsparseSuccess;
+}
+
+hcsparseStatus
+hcsparseScsrmv (const hcsparseScalar* alpha,
+                const hcsparseCsrMatrix* matx,
+                const hcdenseVector* x,
+                const hcsparseScalar* beta,
+                hcdenseVector* y,
+                hcsparseControl* control)
+{
+    if (!hcsparseInitialized)
+    {
+        return hcsparseInvalid;
+    }
+
+    //check opencl elements
+    if (x->values == nullptr || y->values == nullptr)
+    {
+        return hcsparseInvalid;
+    }
+
+    return csrmv<float>(alpha, matx, x, beta, y, control);
+}
+
+hcsparseStatus
+hcsparseDcsrmv (const hcsparseScalar* alpha,
+                const hcsparseCsrMatrix* matx,
+                const hcdenseVector* x,
+                const hcsparseScalar* beta,
+                hcdenseVector* y,
+                hcsparseControl* control)
+{
+    if (!hcsparseInitialized)
+    {
+        return hcsparseInvalid;
+    }
+
+    //check opencl elements
+    if (x->values == nullptr || y->values == nullptr)
+    {
+        return hcsparseInvalid;
+    }
+
+    return csrmv<double>(alpha, matx, x, beta, y, control);
+}
+
+hcsparseStatus
+hcsparseScsrmvSemiring (SEMIRING semiring,
+                        const hcsparseCsrMatrix* matx,
+                        const hcdenseVector* x,
+                        hcdenseVector* y,
+                        bool accumulate,
+                        hcsparseControl* control)
+{
+    if (!hcsparseInitialized)
+    {
+        return hcsparseInvalid;
+    }
+
+    if (x->values == nullptr || y->values == nullptr)
+    {
+        return hcsparseInvalid;
+    }
+
+    return csrmv_semiring<float>(semiring, matx, x, y, accumulate, control);
+}
+
+hcsparseStatus
+hcsparseDcsrmvSemiring (SEMIRING semiring,
+                        const hcsparseCsrMatrix* matx,
+                        const hcdenseVector* x,
+                        hcdenseVector* y,
+                        bool accumulate,
+                        hcsparseControl* control)
+{
+    if (!hcsparseInitialized)
+    {
+        return hcsparseInvalid;
+    }
+
+    if (x->values == nullptr || y->values == nullptr)
+    {
+        return hcsparseInvalid;
+    }
+
+    return csrmv_semiring<double>(semiring, matx, x, y, accumulate, control);
+}
+
+hcsparseStatus
+hcsparseSspmspv (SEMIRING semiring,
+                 const hcsparseCscMatrix* matx,
+                 const hcsparseCsrMatrix* csrMatx,
+                 const hcsparseVector* x,
+                 hcsparseVector* y,
+                 hcsparseControl* control)
+{
+    if (!hcsparseInitialized)
+    {
+        return hcsparseInvalid;
+    }
+
+    if (y->values == nullptr || y->indices == nullptr ||
+        (x->num_nonzeros > 0 && (x->values == nullptr || x->indices == nullptr)))
+    {
+        return hcsparseInvalid;
+    }
+
+    return spmspv<float>(semiring, matx, csrMatx, x, y, control);
+}
+
+hcsparseStatus
+hcsparseDspmspv (SEMIRING semiring,
+                 const hcsparseCscMatrix* matx,
+                 const hcsparseCsrMatrix* csrMatx,
+                 const hcsparseVector* x,
+                 hcsparseVector* y,
+                 hcsparseControl* control)
+{
+    if (!hcsparseInitialized)
+    {
+        return hcsparseInvalid;
+    }
+
+    if (y->values == nullptr || y->indices == nullptr ||
+        (x->num_nonzeros > 0 && (x->values == nullptr || x->indices == nullptr)))
+    {
+        return hcsparseInvalid;
+    }
+
+    return spmspv<double>(semiring, matx, csrMatx, x, y, control);
+}
+
+hcsparseStatus
+hcsparseScsrmvMasked (SEMIRING semiring,
+                      const hcsparseCsrMatrix* matx,
+                      const hcdenseVector* x,
+                      hcdenseVector* y,
+                      bool accumulate,
+                      const hcdenseVector* mask,
+                      bool complement,
+                      hcsparseControl* control)
+{
+    if (!hcsparseInitialized)
+    {
+        return hcsparseInvalid;
+    }
+
+    if (x->values == nullptr || y->values == nullptr || mask->values == nullptr)
+    {
+        return hcsparseInvalid;
+    }
+
+    return csrmv_semiring<float>(semiring, matx, x, y, accumulate, control, mask, complement);
+}
+
+hcsparseStatus
+hcsparseDcsrmvMasked (SEMIRING semiring,
+                      const hcsparseCsrMatrix* matx,
+                      const hcdenseVector* x,
+                      hcdenseVector* y,
+                      bool accumulate,
+                      const hcdenseVector* mask,
+                      bool complement,
+                      hcsparseControl* control)
+{
+    if (!hcsparseInitialized)
+    {
+        return hcsparseInvalid;
+    }
+
+    if (x->values == nullptr || y->values == nullptr || mask->values == nullptr)
+    {
+        return hcsparseInvalid;
+    }
+
+    return csrmv_semiring<double>(semiring, matx, x, y, accumulate, control, mask, complement);
+}
+
+hcsparseStatus
+hcsparseScsrmm (const hcsparseScalar* alpha,
+                const hcsparseCsrMatrix* sparseCsrA,
+                const hcdenseMatrix* denseB,
+                const hcsparseScalar* beta,
+                hcdenseMatrix* denseC,
+                hcsparseControl *control)
+{
+    if( !hcsparseInitialized )
+    {
+        return hcsparseInvalid;
+    }
+
+    if( denseB->values == nullptr || denseC->values == nullptr)
+    {
+        return hcsparseInvalid;
+    }
+
+    return csrmm<float> ( alpha, sparseCsrA, denseB, beta, denseC, control );
+}
+
+hcsparseStatus
+hcsparseDcsrmm (const hcsparseScalar* alpha,
+                const hcsparseCsrMatrix* sparseCsrA,
+                const hcdenseMatrix* denseB,
+                const hcsparseScalar* beta,
+                hcdenseMatrix* denseC,
+                hcsparseControl *control)
+{
+    if( !hcsparseInitialized )
+    {
+        return hcsparseInvalid;
+    }
+
+    if( denseB->values == nullptr || denseC->values == nullptr)
+    {
+        return hcsparseInvalid;
+    }
+
+    return csrmm<double> ( alpha, sparseCsrA, denseB, beta, denseC, control );
+}
+
+hcsparseStatus
 hcdenseSscale (hcdenseVector* r,
                const hcsparseScalar* alpha,
                const hcdenseVector* y,
@@ -2038,781 +2412,1495 @@ hcdenseSscale (hcdenseVector* r,
         return hcsparseInvalid;
     }
 
-    if (r->values == nullptr || y->values == nullptr)
+    if (r->values == nullptr || y->values == nullptr)
+    {
+        return hcsparseInvalid;
+    }
+
+    return scale<float> (r, alpha, y, control);
+}
+
+
+hcsparseStatus
+hcdenseDscale (hcdenseVector* r,
+               const hcsparseScalar* alpha,
+               const hcdenseVector* y,
+               hcsparseControl* control)
+{
+    if (!hcsparseInitialized)
+    {
+        return hcsparseInvalid;
+    }
+
+    if (r->values == nullptr || y->values == nullptr)
+    {
+        return hcsparseInvalid;
+    }
+
+    return scale<double> (r, alpha, y, control);
+}
+
+hcsparseStatus
+hcdenseSaxpy (hcdenseVector* r,
+              const hcsparseScalar* alpha,
+              const hcdenseVector* x,
+              const hcdenseVector* y,
+              hcsparseControl* control)
+{
+    if (!hcsparseInitialized)
+    {
+        return hcsparseInvalid;
+    }
+
+    if (r->values == nullptr || y->values == nullptr || x->values == nullptr)
+    {
+        return hcsparseInvalid;
+    }
+
+    return axpy<float> (r, alpha, x, y,  control);
+}
+
+hcsparseStatus
+hcdenseDaxpy (hcdenseVector* r,
+              const hcsparseScalar* alpha,
+              const hcdenseVector* x,
+              const hcdenseVector* y,
+              hcsparseControl* control)
+{
+    if (!hcsparseInitialized)
+    {
+        return hcsparseInvalid;
+    }
+
+    if (r->values == nullptr || y->values == nullptr || x->values == nullptr)
+    {
+        return hcsparseInvalid;
+    }
+
+    return axpy<double> (r, alpha, x, y,  control);
+}
+
+hcsparseStatus
+hcdenseSaxpby (hcdenseVector* r,
+               const hcsparseScalar* alpha,
+               const hcdenseVector* x,
+               const hcsparseScalar* beta,
+               const hcdenseVector* y,
+               hcsparseControl* control)
+{
+    if (!hcsparseInitialized)
+    {
+        return hcsparseInvalid;
+    }
+
+    if (r->values == nullptr || y->values == nullptr || x->values == nullptr)
+    {
+        return hcsparseInvalid;
+    }
+
+    return axpby<float> (r, alpha, x, beta, y,  control);
+}
+
+hcsparseStatus
+hcdenseDaxpby (hcdenseVector* r,
+               const hcsparseScalar* alpha,
+               const hcdenseVector* x,
+               const hcsparseScalar* beta,
+               const hcdenseVector* y,
+               hcsparseControl* control)
+{
+    if (!hcsparseInitialized)
+    {
+        return hcsparseInvalid;
+    }
+
+    if (r->values == nullptr || y->values == nullptr || x->values == nullptr)
+    {
+        return hcsparseInvalid;
+    }
+
+    return axpby<double> (r, alpha, x, beta, y,  control);
+}
+
+hcsparseStatus
+hcdenseIreduce (hcsparseScalar* s,
+                const hcdenseVector* x,
+                hcsparseControl* control)
+{
+    if (!hcsparseInitialized)
+    {
+        return hcsparseInvalid;
+    }
+
+    if (x->values == nullptr)
+    {
+        return hcsparseInvalid;
+    }
+
+    return reduce<int, RO_PLUS>(s, x, control);
+}
+
+hcsparseStatus
+hcdenseSreduce (hcsparseScalar* s,
+                const hcdenseVector* x,
+                hcsparseControl* control)
+{
+    if (!hcsparseInitialized)
+    {
+        return hcsparseInvalid;
+    }
+
+    if (x->values == nullptr)
+    {
+        return hcsparseInvalid;
+    }
+
+    return reduce<float, RO_PLUS>(s, x, control);
+}
+
+hcsparseStatus
+hcdenseDreduce (hcsparseScalar* s,
+                const hcdenseVector* x,
+                hcsparseControl* control)
+{
+    if (!hcsparseInitialized)
+    {
+        return hcsparseInvalid;
+    }
+
+    if (x->values == nullptr)
+    {
+        return hcsparseInvalid;
+    }
+
+    return reduce<double, RO_PLUS>(s, x, control);
+}
+
+hcsparseStatus
+hcdenseSadd (hcdenseVector* r,
+             const hcdenseVector* x,
+             const hcdenseVector* y,
+             hcsparseControl* control)
+{
+    if (!hcsparseInitialized)
+    {
+        return hcsparseInvalid;
+    }
+
+    if (r->values == nullptr || x->values == nullptr || y->values == nullptr)
+    {
+        return hcsparseInvalid;
+    }
+
+    return elementwise_transform<float, EW_PLUS> (r, x, y, control);
+}
+
+hcsparseStatus
+hcdenseDadd (hcdenseVector* r,
+             const hcdenseVector* x,
+             const hcdenseVector* y,
+             hcsparseControl* control)
+{
+    if (!hcsparseInitialized)
+    {
+        return hcsparseInvalid;
+    }
+
+    if (r->values == nullptr || x->values == nullptr || y->values == nullptr)
+    {
+        return hcsparseInvalid;
+    }
+
+    return elementwise_transform<double, EW_PLUS> (r, x, y, control);
+}
+
+hcsparseStatus
+hcdenseSsub (hcdenseVector* r,
+             const hcdenseVector* x,
+             const hcdenseVector* y,
+             hcsparseControl* control)
+{
+    if (!hcsparseInitialized)
+    {
+        return hcsparseInvalid;
+    }
+
+    if (r->values == nullptr || x->values == nullptr || y->values == nullptr)
+    {
+        return hcsparseInvalid;
+    }
+
+    return elementwise_transform<float, EW_MINUS> (r, x, y, control);
+}
+
+hcsparseStatus
+hcdenseDsub (hcdenseVector* r,
+             const hcdenseVector* x,
+             const hcdenseVector* y,
+             hcsparseControl* control)
+{
+    if (!hcsparseInitialized)
+    {
+        return hcsparseInvalid;
+    }
+
+    if (r->values == nullptr || x->values == nullptr || y->values == nullptr)
+    {
+        return hcsparseInvalid;
+    }
+
+    return elementwise_transform<double, EW_MINUS> (r, x, y, control);
+}
+
+hcsparseStatus
+hcdenseSmul (hcdenseVector* r,
+             const hcdenseVector* x,
+             const hcdenseVector* y,
+             hcsparseControl* control)
+{
+    if (!hcsparseInitialized)
+    {
+        return hcsparseInvalid;
+    }
+
+    if (r->values == nullptr || x->values == nullptr || y->values == nullptr)
+    {
+        return hcsparseInvalid;
+    }
+
+    return elementwise_transform<float, EW_MULTIPLY> (r, x, y, control);
+}
+
+hcsparseStatus
+hcdenseDmul (hcdenseVector* r,
+             const hcdenseVector* x,
+             const hcdenseVector* y,
+             hcsparseControl* control)
+{
+    if (!hcsparseInitialized)
+    {
+        return hcsparseInvalid;
+    }
+
+    if (r->values == nullptr || x->values == nullptr || y->values == nullptr)
+    {
+        return hcsparseInvalid;
+    }
+
+    return elementwise_transform<double, EW_MULTIPLY> (r, x, y, control);
+}
+
+hcsparseStatus
+hcdenseSdiv (hcdenseVector* r,
+             const hcdenseVector* x,
+             const hcdenseVector* y,
+             hcsparseControl* control)
+{
+    if (!hcsparseInitialized)
+    {
+        return hcsparseInvalid;
+    }
+
+    if (r->values == nullptr || x->values == nullptr || y->values == nullptr)
+    {
+        return hcsparseInvalid;
+    }
+
+    return elementwise_transform<float, EW_DIV> (r, x, y, control);
+}
+
+hcsparseStatus
+hcdenseDdiv (hcdenseVector* r,
+             const hcdenseVector* x,
+             const hcdenseVector* y,
+             hcsparseControl* control)
+{
+    if (!hcsparseInitialized)
+    {
+        return hcsparseInvalid;
+    }
+
+    if (r->values == nullptr || x->values == nullptr || y->values == nullptr)
+    {
+        return hcsparseInvalid;
+    }
+
+    return elementwise_transform<double, EW_DIV> (r, x, y, control);
+}
+
+hcsparseStatus
+hcdenseSnrm1 (hcsparseScalar* s,
+              const hcdenseVector* x,
+              hcsparseControl* control)
+{
+    if (!hcsparseInitialized)
+    {
+        return hcsparseInvalid;
+    }
+
+    if (x->values == nullptr)
+    {
+        return hcsparseInvalid;
+    }
+
+    return Norm1<float>(s, x, control);
+}
+
+hcsparseStatus
+hcdenseDnrm1 (hcsparseScalar* s,
+              const hcdenseVector* x,
+              hcsparseControl* control)
+{
+    if (!hcsparseInitialized)
+    {
+        return hcsparseInvalid;
+    }
+
+    if (x->values == nullptr)
+    {
+        return hcsparseInvalid;
+    }
+
+    return Norm1<double>(s, x, control);
+}
+
+hcsparseStatus
+hcdenseSnrm2 (hcsparseScalar* s,
+              const hcdenseVector* x,
+              hcsparseControl* control)
+{
+    if (!hcsparseInitialized)
+    {
+        return hcsparseInvalid;
+    }
+
+    if (x->values == nullptr)
+    {
+        return hcsparseInvalid;
+    }
+
+    return Norm2<float>(s, x, control);
+}
+
+hcsparseStatus
+hcdenseDnrm2 (hcsparseScalar* s,
+              const hcdenseVector* x,
+              hcsparseControl* control)
+{
+    if (!hcsparseInitialized)
+    {
+        return hcsparseInvalid;
+    }
+
+    if (x->values == nullptr)
+    {
+        return hcsparseInvalid;
+    }
+
+    return Norm2<double>(s, x, control);
+}
+
+hcsparseStatus
+hcdenseSdot (hcsparseScalar* r,
+             const hcdenseVector* x,
+             const hcdenseVector* y,
+             hcsparseControl* control)
+{
+    if (!hcsparseInitialized)
+    {
+        return hcsparseInvalid;
+    }
+
+    //check opencl elements
+    if (x->values == nullptr || y->values == nullptr)
+    {
+        return hcsparseInvalid;
+    }
+
+    return dot<float>(r, x, y, control);
+}
+
+hcsparseStatus
+hcdenseDdot (hcsparseScalar* r,
+             const hcdenseVector* x,
+             const hcdenseVector* y,
+             hcsparseControl* control)
+{
+    if (!hcsparseInitialized)
+    {
+        return hcsparseInvalid;
+    }
+
+    //check opencl elements
+    if (x->values == nullptr || y->values == nullptr)
+    {
+        return hcsparseInvalid;
+    }
+
+    return dot<double>(r, x, y, control);
+}
+
+hcsparseStatus
+hcdenseSmultiDot (hcdenseVector* r,
+                   int k,
+                   const hcdenseVector* const* x,
+                   const hcdenseVector* const* y,
+                   hcsparseControl* control)
+{
+    if (!hcsparseInitialized)
+    {
+        return hcsparseInvalid;
+    }
+
+    if (r->values == nullptr || x == nullptr || y == nullptr)
+    {
+        return hcsparseInvalid;
+    }
+
+    for (int j = 0; j < k; j++)
+    {
+        if (x[j]->values == nullptr || y[j]->values == nullptr)
+        {
+            return hcsparseInvalid;
+        }
+    }
+
+    return multi_dot<float>(r, k, x, y, control);
+}
+
+hcsparseStatus
+hcdenseDmultiDot (hcdenseVector* r,
+                   int k,
+                   const hcdenseVector* const* x,
+                   const hcdenseVector* const* y,
+                   hcsparseControl* control)
+{
+    if (!hcsparseInitialized)
+    {
+        return hcsparseInvalid;
+    }
+
+    if (r->values == nullptr || x == nullptr || y == nullptr)
+    {
+        return hcsparseInvalid;
+    }
+
+    for (int j = 0; j < k; j++)
+    {
+        if (x[j]->values == nullptr || y[j]->values == nullptr)
+        {
+            return hcsparseInvalid;
+        }
+    }
+
+    return multi_dot<double>(r, k, x, y, control);
+}
+
+// This function reads the file header at the given filepath, and returns the size
+// of the sparse matrix in the hcsparseCooMatrix parameter.
+// Post-condition: clears hcsparseCooMatrix, then sets pCooMatx->m, pCooMatx->n
+// pCooMatx->nnz
+hcsparseStatus
+hcsparseHeaderfromFile (int* nnz, int* row, int* col, const char* filePath)
+{
+
+    // Check that the file format is matrix market; the only format we can read right now
+    // This is not a complete solution, and fails for directories with file names etc...
+    // TODO: Should we use boost filesystem?
+    std::string strPath( filePath );
+    if( strPath.find_last_of( '.' ) != std::string::npos )
+    {
+        std::string ext = strPath.substr( strPath.find_last_of( '.' ) + 1 );
+        if( ext != "mtx" )
+            return hcsparseInvalid;
+    }
+    else
+        return hcsparseInvalid;
+
+   MatrixMarketReader< float > mm_reader;
+
+    if( mm_reader.MMReadHeader( filePath ) )
+        return hcsparseInvalid;
+
+    *row = mm_reader.GetNumRows( );
+    *col = mm_reader.GetNumCols( );
+    *nnz = mm_reader.GetNumNonZeroes( );
+
+    return hcsparseSuccess;
+}
+
+// This function reads the file at the given filepath, and returns the sparse
+// matrix in the COO struct.  All matrix data is written to device memory
+// Pre-condition: This function assumes that the device memory buffers have been
+// pre-allocated by the caller
+hcsparseStatus
+hcsparseSCooMatrixfromFile (hcsparseCooMatrix* cooMatx, const char* filePath, hcsparseControl *control, bool read_explicit_zeroes)
+{
+    // Check that the file format is matrix market; the only format we can read right now
+    // This is not a complete solution, and fails for directories with file names etc...
+    std::string strPath( filePath );
+    if( strPath.find_last_of( '.' ) != std::string::npos )
     {
+        std::string ext = strPath.substr( strPath.find_last_of( '.' ) + 1 );
+        if( ext != "mtx" )
+            return hcsparseInvalid;
+    }
+    else
+        return hcsparseInvalid;
+
+    MatrixMarketReader< float > mm_reader;
+    if( mm_reader.MMReadFormat( filePath, read_explicit_zeroes ) )
         return hcsparseInvalid;
+
+    cooMatx->num_rows = mm_reader.GetNumRows( );
+    cooMatx->num_cols = mm_reader.GetNumCols( );
+    cooMatx->num_nonzeros = mm_reader.GetNumNonZeroes( );
+
+    Coordinate<float>* coords = mm_reader.GetUnsymCoordinates( );
+
+    std::sort( coords, coords + cooMatx->num_nonzeros, CoordinateCompare< float > );
+
+    float *values = (float*) calloc(cooMatx->num_nonzeros, sizeof(float));
+    int *rowIndices = (int*) calloc(cooMatx->num_nonzeros, sizeof(int));
+    int *colIndices = (int*) calloc(cooMatx->num_nonzeros, sizeof(int));
+
+    for( int c = 0; c < cooMatx->num_nonzeros; ++c )
+    {
+        rowIndices[ c ] = coords[c].x;
+        colIndices[ c ] = coords[c].y;
+        values[ c ] = coords[c].val;
     }
 
-    return scale<float> (r, alpha, y, control);
+    control->accl_view.copy(values, cooMatx->values, cooMatx->num_nonzeros * sizeof(float));
+    control->accl_view.copy(rowIndices, cooMatx->rowIndices, cooMatx->num_nonzeros * sizeof(int));
+    control->accl_view.copy(colIndices, cooMatx->colIndices, cooMatx->num_nonzeros * sizeof(int));
+
+    free(values);
+    free(rowIndices);
+    free(colIndices);
+
+    return hcsparseSuccess;
 }
 
-
 hcsparseStatus
-hcdenseDscale (hcdenseVector* r,
-               const hcsparseScalar* alpha,
-               const hcdenseVector* y,
-               hcsparseControl* control)
+hcsparseDCooMatrixfromFile (hcsparseCooMatrix* cooMatx, const char* filePath, hcsparseControl *control, bool read_explicit_zeroes)
 {
-    if (!hcsparseInitialized)
+    // Check that the file format is matrix market; the only format we can read right now
+    // This is not a complete solution, and fails for directories with file names etc...
+    std::string strPath( filePath );
+    if( strPath.find_last_of( '.' ) != std::string::npos )
     {
-        return hcsparseInvalid;
+        std::string ext = strPath.substr( strPath.find_last_of( '.' ) + 1 );
+        if( ext != "mtx" )
+            return hcsparseInvalid;
     }
+    else
+        return hcsparseInvalid;
 
-    if (r->values == nullptr || y->values == nullptr)
-    {
+    MatrixMarketReader< double > mm_reader;
+    if( mm_reader.MMReadFormat( filePath, read_explicit_zeroes ) )
         return hcsparseInvalid;
-    }
 
-    return scale<double> (r, alpha, y, control);
-}
+    cooMatx->num_rows = mm_reader.GetNumRows( );
+    cooMatx->num_cols = mm_reader.GetNumCols( );
+    cooMatx->num_nonzeros = mm_reader.GetNumNonZeroes( );
 
-hcsparseStatus
-hcdenseSaxpy (hcdenseVector* r,
-              const hcsparseScalar* alpha,
-              const hcdenseVector* x,
-              const hcdenseVector* y,
-              hcsparseControl* control)
-{
-    if (!hcsparseInitialized)
-    {
-        return hcsparseInvalid;
-    }
+    Coordinate<double>* coords = mm_reader.GetUnsymCoordinates( );
 
-    if (r->values == nullptr || y->values == nullptr || x->values == nullptr)
+    std::sort( coords, coords + cooMatx->num_nonzeros, CoordinateCompare<double> );
+
+    double *values = (double*) calloc(cooMatx->num_nonzeros, sizeof(double));
+    int *rowIndices = (int*) calloc(cooMatx->num_nonzeros, sizeof(int));
+    int *colIndices = (int*) calloc(cooMatx->num_nonzeros, sizeof(int));
+
+    for( int c = 0; c < cooMatx->num_nonzeros; ++c )
     {
-        return hcsparseInvalid;
+        rowIndices[ c ] = coords[c].x;
+        colIndices[ c ] = coords[c].y;
+        values[ c ] = coords[c].val;
     }
 
-    return axpy<float> (r, alpha, x, y,  control);
+    control->accl_view.copy(values, cooMatx->values, cooMatx->num_nonzeros * sizeof(double));
+    control->accl_view.copy(rowIndices, cooMatx->rowIndices, cooMatx->num_nonzeros * sizeof(int));
+    control->accl_view.copy(colIndices, cooMatx->colIndices, cooMatx->num_nonzeros * sizeof(int));
+
+    free(values);
+    free(rowIndices);
+    free(colIndices);
+
+    return hcsparseSuccess;
 }
 
 hcsparseStatus
-hcdenseDaxpy (hcdenseVector* r,
-              const hcsparseScalar* alpha,
-              const hcdenseVector* x,
-              const hcdenseVector* y,
-              hcsparseControl* control)
+hcsparseSCsrMatrixfromFile (hcsparseCsrMatrix* csrMatx, const char* filePath, hcsparseControl *control, bool read_explicit_zeroes)
 {
-    if (!hcsparseInitialized)
-    {
-        return hcsparseInvalid;
-    }
 
-    if (r->values == nullptr || y->values == nullptr || x->values == nullptr)
+    // Check that the file format is matrix market; the only format we can read right now
+    // This is not a complete solution, and fails for directories with file names etc...
+    // TODO: Should we use boost filesystem?
+    std::string strPath( filePath );
+    if( strPath.find_last_of( '.' ) != std::string::npos )
     {
-        return hcsparseInvalid;
+        std::string ext = strPath.substr( strPath.find_last_of( '.' ) + 1 );
+        if( ext != "mtx" )
+            return hcsparseInvalid;
     }
+    else
+        return hcsparseInvalid;
 
-    return axpy<double> (r, alpha, x, y,  control);
-}
+    // Read data from a file on disk into CPU buffers
+    // Data is read natively as COO format with the reader
+    MatrixMarketReader< float > mm_reader;
 
-hcsparseStatus
-hcdenseSaxpby (hcdenseVector* r,
-               const hcsparseScalar* alpha,
-               const hcdenseVector* x,
-               const hcsparseScalar* beta,
-               const hcdenseVector* y,
-               hcsparseControl* control)
-{
-    if (!hcsparseInitialized)
-    {
+    // Read header data of input file
+    if( mm_reader.MMReadHeader( filePath ) )
+        return hcsparseInvalid;
+    int header_nnz = mm_reader.GetNumNonZeroes( );
+
+    if( mm_reader.MMReadFormat( filePath, read_explicit_zeroes ) )
         return hcsparseInvalid;
+
+    // JPA: Shouldn't that just be an assertion check? It seems to me that
+    // the user have to call hcsparseHeaderfromFile before calling this function,
+    // otherwise the whole pCsrMatrix will be broken;
+
+    csrMatx->num_rows = mm_reader.GetNumRows( );
+    csrMatx->num_cols = mm_reader.GetNumCols( );
+    csrMatx->num_nonzeros = mm_reader.GetNumNonZeroes( );
+
+
+    Coordinate<float>* coords = mm_reader.GetUnsymCoordinates( );
+
+    std::sort( coords, coords + csrMatx->num_nonzeros, CoordinateCompare< float > );
+
+    float *values;
+    int *rowOffsets, *colIndices;
+
+    if (header_nnz > csrMatx->num_nonzeros)  {
+      values = (float*)calloc(header_nnz, sizeof(float));
+      rowOffsets = (int*)calloc((csrMatx->num_rows)+1, sizeof(int));
+      colIndices = (int*)calloc(header_nnz, sizeof(int));
+    } else {
+      values = (float*)calloc(csrMatx->num_nonzeros, sizeof(float));
+      rowOffsets = (int*)calloc((csrMatx->num_rows)+1, sizeof(int));
+      colIndices = (int*)calloc(csrMatx->num_nonzeros, sizeof(int));
     }
 
-    if (r->values == nullptr || y->values == nullptr || x->values == nullptr)
+    int current_row = 0;
+    rowOffsets[ 0 ] = 0;
+    for( int i = 0; i < csrMatx->num_nonzeros; i++ )
     {
-        return hcsparseInvalid;
+        colIndices[ i ] = coords[i].y;
+        values[ i ] = coords[i].val;
+
+        while( coords[i].x >= current_row )
+            rowOffsets[ current_row++ ] = i;
+    }
+    rowOffsets[ current_row ] = csrMatx->num_nonzeros;
+    while( current_row <= csrMatx->num_rows )
+        rowOffsets[ current_row++ ] = csrMatx->num_nonzeros;
+
+    if (header_nnz > csrMatx->num_nonzeros) {
+      control->accl_view.copy(values, csrMatx->values, sizeof(float) * header_nnz);
+      control->accl_view.copy(rowOffsets, csrMatx->rowOffsets, sizeof(int) * (csrMatx->num_rows+1));
+      control->accl_view.copy(colIndices, csrMatx->colIndices, sizeof(int) * header_nnz);
+    } else {
+      control->accl_view.copy(values, csrMatx->values, sizeof(float) * csrMatx->num_nonzeros);
+      control->accl_view.copy(rowOffsets, csrMatx->rowOffsets, sizeof(int) * (csrMatx->num_rows+1));
+      control->accl_view.copy(colIndices, csrMatx->colIndices, sizeof(int) * csrMatx->num_nonzeros);
     }
 
-    return axpby<float> (r, alpha, x, beta, y,  control);
+    free(values);
+    free(rowOffsets);
+    free(colIndices);
+
+    return hcsparseSuccess;
 }
 
 hcsparseStatus
-hcdenseDaxpby (hcdenseVector* r,
-               const hcsparseScalar* alpha,
-               const hcdenseVector* x,
-               const hcsparseScalar* beta,
-               const hcdenseVector* y,
-               hcsparseControl* control)
+hcsparseDCsrMatrixfromFile (hcsparseCsrMatrix* csrMatx, const char* filePath, hcsparseControl *control, bool read_explicit_zeroes)
 {
-    if (!hcsparseInitialized)
+    // Check that the file format is matrix market; the only format we can read right now
+    // This is not a complete solution, and fails for directories with file names etc...
+    // TODO: Should we use boost filesystem?
+    std::string strPath( filePath );
+    if( strPath.find_last_of( '.' ) != std::string::npos )
     {
+        std::string ext = strPath.substr( strPath.find_last_of( '.' ) + 1 );
+        if( ext != "mtx" )
+            return hcsparseInvalid;
+    }
+    else
+        return hcsparseInvalid;
+
+    // Read data from a file on disk into CPU buffers
+    // Data is read natively as COO format with the reader
+    MatrixMarketReader< double > mm_reader; 
+
+    // Read header data of input file
+    if( mm_reader.MMReadHeader( filePath ) )
+        return hcsparseInvalid;
+    int header_nnz = mm_reader.GetNumNonZeroes( );
+
+    if( mm_reader.MMReadFormat( filePath, read_explicit_zeroes ) )
         return hcsparseInvalid;
+
+    csrMatx->num_rows = mm_reader.GetNumRows( );
+    csrMatx->num_cols = mm_reader.GetNumCols( );
+    csrMatx->num_nonzeros = mm_reader.GetNumNonZeroes( );
+
+    Coordinate<double>* coords = mm_reader.GetUnsymCoordinates( );
+
+    std::sort( coords, coords + csrMatx->num_nonzeros, CoordinateCompare<double> );
+
+    double *values;
+    int *rowOffsets;
+    int *colIndices;
+
+    if (header_nnz > csrMatx->num_nonzeros) {
+      values = (double*)calloc(header_nnz, sizeof(double));
+      rowOffsets = (int*)calloc(csrMatx->num_rows+1, sizeof(int));
+      colIndices = (int*)calloc(header_nnz, sizeof(int));
+    } else {  
+      values = (double*)calloc(csrMatx->num_nonzeros, sizeof(double));
+      rowOffsets = (int*)calloc(csrMatx->num_rows+1, sizeof(int));
+      colIndices = (int*)calloc(csrMatx->num_nonzeros, sizeof(int));
     }
 
-    if (r->values == nullptr || y->values == nullptr || x->values == nullptr)
+    int current_row = 0;
+    rowOffsets[ 0 ] = 0;
+    for( int i = 0; i < csrMatx->num_nonzeros; i++ )
     {
-        return hcsparseInvalid;
+        colIndices[ i ] = coords[i].y;
+        values[ i ] = coords[i].val;
+
+        while( coords[i].x >= current_row )
+            rowOffsets[ current_row++ ] = i;
+    }
+    rowOffsets[ current_row ] = csrMatx->num_nonzeros;
+    while( current_row <= csrMatx->num_rows )
+        rowOffsets[ current_row++ ] = csrMatx->num_nonzeros;
+
+    if (header_nnz > csrMatx->num_nonzeros) {
+      control->accl_view.copy(values, csrMatx->values, sizeof(double) * header_nnz);
+      control->accl_view.copy(rowOffsets, csrMatx->rowOffsets, sizeof(int) * (csrMatx->num_rows+1));
+      control->accl_view.copy(colIndices, csrMatx->colIndices, sizeof(int) * header_nnz);
+    } else {
+      control->accl_view.copy(values, csrMatx->values, sizeof(double) * csrMatx->num_nonzeros);
+      control->accl_view.copy(rowOffsets, csrMatx->rowOffsets, sizeof(int) * (csrMatx->num_rows+1));
+      control->accl_view.copy(colIndices, csrMatx->colIndices, sizeof(int) * csrMatx->num_nonzeros);
     }
 
-    return axpby<double> (r, alpha, x, beta, y,  control);
+    free(values);
+    free(rowOffsets);
+    free(colIndices);
+
+    return hcsparseSuccess;
 }
 
 hcsparseStatus
-hcdenseIreduce (hcsparseScalar* s,
-                const hcdenseVector* x,
-                hcsparseControl* control)
+hcsparseCsrMetaSize (hcsparseCsrMatrix* csrMatx, hcsparseControl *control)
 {
-    if (!hcsparseInitialized)
+    // rowBlocks of the current pattern already computed: the size is known
+    if (csrMatx->structureTracked() && csrMatx->rowBlocksVersion == csrMatx->structureVersion)
     {
-        return hcsparseInvalid;
+        return hcsparseSuccess;
     }
 
-    if (x->values == nullptr)
-    {
-        return hcsparseInvalid;
-    }
+    int *rCsrRowOffsets = (int*)calloc(csrMatx->num_rows+1, sizeof(int));
+    control->accl_view.copy(csrMatx->rowOffsets, rCsrRowOffsets, sizeof(int) * (csrMatx->num_rows+1));
+
+    csrMatx->rowBlockSize = ComputeRowBlocksSize( rCsrRowOffsets, csrMatx->num_rows, BLOCKSIZE, BLOCK_MULTIPLIER, ROWS_FOR_VECTOR );
 
-    return reduce<int, RO_PLUS>(s, x, control);
+    control->accl_view.copy(rCsrRowOffsets, csrMatx->rowOffsets, sizeof(int) * (csrMatx->num_rows+1));
+
+    free(rCsrRowOffsets);
+
+    return hcsparseSuccess;
 }
 
 hcsparseStatus
-hcdenseSreduce (hcsparseScalar* s,
-                const hcdenseVector* x,
-                hcsparseControl* control)
+hcsparseCsrMetaCompute (hcsparseCsrMatrix* csrMatx, hcsparseControl *control)
 {
-    if (!hcsparseInitialized)
+    // Check to ensure nRows can fit in 32 bits
+    if( static_cast<ulong>( csrMatx->num_rows ) > static_cast<ulong>( std::pow( 2, ( 64 - ROWBITS ) ) ) )
     {
+        printf( "Number of Rows in the Sparse Matrix is greater than what is supported at present ((64-WG_BITS) bits) !" );
         return hcsparseInvalid;
     }
 
-    if (x->values == nullptr)
+    // a tracked pattern is only analysed again after it changed
+    if (csrMatx->structureTracked() && csrMatx->rowBlocksVersion == csrMatx->structureVersion)
     {
-        return hcsparseInvalid;
+        return hcsparseSuccess;
     }
 
-    return reduce<float, RO_PLUS>(s, x, control);
+    int *rCsrRowOffsets = (int*)calloc(csrMatx->num_rows+1, sizeof(int));
+    ulong *rRowBlocks = (ulong*)calloc(csrMatx->num_nonzeros, sizeof(ulong));
+
+    control->accl_view.copy(csrMatx->rowOffsets, rCsrRowOffsets, sizeof(int) * (csrMatx->num_rows+1));
+    control->accl_view.copy(csrMatx->rowBlocks, rRowBlocks, sizeof(ulong) * csrMatx->num_nonzeros);
+
+    ComputeRowBlocks(rRowBlocks, csrMatx->rowBlockSize, rCsrRowOffsets, csrMatx->num_rows, BLOCKSIZE, BLOCK_MULTIPLIER, ROWS_FOR_VECTOR, true );
+
+    control->accl_view.copy(rCsrRowOffsets, csrMatx->rowOffsets, sizeof(int) * (csrMatx->num_rows+1));
+    control->accl_view.copy(rRowBlocks, csrMatx->rowBlocks, sizeof(ulong) * csrMatx->num_nonzeros);
+
+    free(rCsrRowOffsets);
+    free(rRowBlocks);
+
+    csrMatx->rowBlocksVersion = csrMatx->structureVersion;
+
+    return hcsparseSuccess;
 }
 
 hcsparseStatus
-hcdenseDreduce (hcsparseScalar* s,
-                const hcdenseVector* x,
-                hcsparseControl* control)
+hcsparseCsrValuesChanged (hcsparseCsrMatrix* csrMatx)
 {
-    if (!hcsparseInitialized)
+    if (csrMatx == nullptr)
     {
         return hcsparseInvalid;
     }
 
-    if (x->values == nullptr)
+    // values of an untracked matrix are never cached against
+    if (csrMatx->structureTracked())
     {
-        return hcsparseInvalid;
+        csrMatx->valuesVersion = next_version();
     }
 
-    return reduce<double, RO_PLUS>(s, x, control);
+    return hcsparseSuccess;
 }
 
 hcsparseStatus
-hcdenseSadd (hcdenseVector* r,
-             const hcdenseVector* x,
-             const hcdenseVector* y,
-             hcsparseControl* control)
+hcsparseCsrStructureChanged (hcsparseCsrMatrix* csrMatx)
 {
-    if (!hcsparseInitialized)
+    if (csrMatx == nullptr)
     {
         return hcsparseInvalid;
     }
 
-    if (r->values == nullptr || x->values == nullptr || y->values == nullptr)
-    {
-        return hcsparseInvalid;
-    }
+    csrMatx->structureVersion = next_version();
+    csrMatx->valuesVersion = next_version();
 
-    return elementwise_transform<float, EW_PLUS> (r, x, y, control);
+    return hcsparseSuccess;
 }
 
 hcsparseStatus
-hcdenseDadd (hcdenseVector* r,
-             const hcdenseVector* x,
-             const hcdenseVector* y,
-             hcsparseControl* control)
+hcsparseScsrbicgStab (hcdenseVector* x, const hcsparseCsrMatrix *A, const hcdenseVector *b,
+                      hcsparseSolverControl *solverControl, hcsparseControl *control)
 {
+    using T = float;
+
     if (!hcsparseInitialized)
     {
         return hcsparseInvalid;
     }
 
-    if (r->values == nullptr || x->values == nullptr || y->values == nullptr)
+    if (x->values == nullptr || b->values == nullptr)
     {
         return hcsparseInvalid;
     }
 
-    return elementwise_transform<double, EW_PLUS> (r, x, y, control);
-}
-
-hcsparseStatus
-hcdenseSsub (hcdenseVector* r,
-             const hcdenseVector* x,
-             const hcdenseVector* y,
-             hcsparseControl* control)
-{
-    if (!hcsparseInitialized)
+    if (solverControl == nullptr)
     {
         return hcsparseInvalid;
     }
 
-    if (r->values == nullptr || x->values == nullptr || y->values == nullptr)
+    std::shared_ptr<PreconditionerHandler<T>> preconditioner =
+        solver_preconditioner<T>(A, solverControl, control);
+    if (!preconditioner)
     {
         return hcsparseInvalid;
     }
 
-    return elementwise_transform<float, EW_MINUS> (r, x, y, control);
+    hcsparseSolverWorkspace local;
+    hcsparseSolverWorkspace *workspace = workspace_begin<T>(solverControl, x->num_values, local);
+
+    hcsparseStatus status = bicgStab<T>(x, A, b, *preconditioner, solverControl, workspace, control);
+
+    workspace_end(workspace, local);
+
+    solverControl->printSummary(status);
+
+    return status;
 }
 
 hcsparseStatus
-hcdenseDsub (hcdenseVector* r,
-             const hcdenseVector* x,
-             const hcdenseVector* y,
-             hcsparseControl* control)
+hcsparseDcsrbicgStab (hcdenseVector* x, const hcsparseCsrMatrix *A, const hcdenseVector *b,
+                      hcsparseSolverControl *solverControl, hcsparseControl *control)
 {
+    using T = double;
+
     if (!hcsparseInitialized)
     {
         return hcsparseInvalid;
     }
 
-    if (r->values == nullptr || x->values == nullptr || y->values == nullptr)
+    if (x->values == nullptr || b->values == nullptr)
     {
         return hcsparseInvalid;
     }
 
-    return elementwise_transform<double, EW_MINUS> (r, x, y, control);
-}
-
-hcsparseStatus
-hcdenseSmul (hcdenseVector* r,
-             const hcdenseVector* x,
-             const hcdenseVector* y,
-             hcsparseControl* control)
-{
-    if (!hcsparseInitialized)
+    if (solverControl == nullptr)
     {
         return hcsparseInvalid;
     }
 
-    if (r->values == nullptr || x->values == nullptr || y->values == nullptr)
+    std::shared_ptr<PreconditionerHandler<T>> preconditioner =
+        solver_preconditioner<T>(A, solverControl, control);
+    if (!preconditioner)
     {
         return hcsparseInvalid;
     }
 
-    return elementwise_transform<float, EW_MULTIPLY> (r, x, y, control);
+    hcsparseSolverWorkspace local;
+    hcsparseSolverWorkspace *workspace = workspace_begin<T>(solverControl, x->num_values, local);
+
+    hcsparseStatus status = bicgStab<T>(x, A, b, *preconditioner, solverControl, workspace, control);
+
+    workspace_end(workspace, local);
+
+    solverControl->printSummary(status);
+
+    return status;
 }
 
 hcsparseStatus
-hcdenseDmul (hcdenseVector* r,
-             const hcdenseVector* x,
-             const hcdenseVector* y,
-             hcsparseControl* control)
+hcsparseScsrcg (hcdenseVector *x,
+                const hcsparseCsrMatrix *A,
+                const hcdenseVector *b,
+                hcsparseSolverControl *solverControl,
+                hcsparseControl *control)
 {
+    using T = float;
+
     if (!hcsparseInitialized)
     {
         return hcsparseInvalid;
     }
 
-    if (r->values == nullptr || x->values == nullptr || y->values == nullptr)
+    if (x->values == nullptr || b->values == nullptr)
     {
         return hcsparseInvalid;
     }
 
-    return elementwise_transform<double, EW_MULTIPLY> (r, x, y, control);
-}
-
-hcsparseStatus
-hcdenseSdiv (hcdenseVector* r,
-             const hcdenseVector* x,
-             const hcdenseVector* y,
-             hcsparseControl* control)
-{
-    if (!hcsparseInitialized)
+    if (solverControl == nullptr)
     {
         return hcsparseInvalid;
     }
 
-    if (r->values == nullptr || x->values == nullptr || y->values == nullptr)
+    std::shared_ptr<PreconditionerHandler<T>> preconditioner =
+        solver_preconditioner<T>(A, solverControl, control);
+    if (!preconditioner)
     {
         return hcsparseInvalid;
     }
 
-    return elementwise_transform<float, EW_DIV> (r, x, y, control);
+    hcsparseSolverWorkspace local;
+    hcsparseSolverWorkspace *workspace = workspace_begin<T>(solverControl, x->num_values, local);
+
+    hcsparseStatus status = cg<T>(x, A, b, *preconditioner, solverControl, workspace, control);
+
+    workspace_end(workspace, local);
+
+    solverControl->printSummary(status);
+
+    return status;
 }
 
 hcsparseStatus
-hcdenseDdiv (hcdenseVector* r,
-             const hcdenseVector* x,
-             const hcdenseVector* y,
-             hcsparseControl* control)
+hcsparseDcsrcg (hcdenseVector *x,
+                const hcsparseCsrMatrix *A,
+                const hcdenseVector *b,
+                hcsparseSolverControl *solverControl,
+                hcsparseControl *control)
 {
+    using T = double;
+
     if (!hcsparseInitialized)
     {
         return hcsparseInvalid;
     }
 
-    if (r->values == nullptr || x->values == nullptr || y->values == nullptr)
+    if (x->values == nullptr || b->values == nullptr)
     {
         return hcsparseInvalid;
     }
 
-    return elementwise_transform<double, EW_DIV> (r, x, y, control);
-}
-
-hcsparseStatus
-hcdenseSnrm1 (hcsparseScalar* s,
-              const hcdenseVector* x,
-              hcsparseControl* control)
-{
-    if (!hcsparseInitialized)
+    if (solverControl == nullptr)
     {
         return hcsparseInvalid;
     }
 
-    if (x->values == nullptr)
+    std::shared_ptr<PreconditionerHandler<T>> preconditioner =
+        solver_preconditioner<T>(A, solverControl, control);
+    if (!preconditioner)
     {
         return hcsparseInvalid;
     }
 
-    return Norm1<float>(s, x, control);
+    hcsparseSolverWorkspace local;
+    hcsparseSolverWorkspace *workspace = workspace_begin<T>(solverControl, x->num_values, local);
+
+    hcsparseStatus status = cg<T>(x, A, b, *preconditioner, solverControl, workspace, control);
+
+    workspace_end(workspace, local);
+
+    solverControl->printSummary(status);
+
+    return status;
 }
 
 hcsparseStatus
-hcdenseDnrm1 (hcsparseScalar* s,
-              const hcdenseVector* x,
-              hcsparseControl* control)
+hcsparseScsrpipecg (hcdenseVector *x,
+                    const hcsparseCsrMatrix *A,
+                    const hcdenseVector *b,
+                    hcsparseSolverControl *solverControl,
+                    hcsparseControl *control)
 {
+    using T = float;
+
     if (!hcsparseInitialized)
     {
         return hcsparseInvalid;
     }
 
-    if (x->values == nullptr)
+    if (x->values == nullptr || b->values == nullptr)
     {
         return hcsparseInvalid;
     }
 
-    return Norm1<double>(s, x, control);
-}
-
-hcsparseStatus
-hcdenseSnrm2 (hcsparseScalar* s,
-              const hcdenseVector* x,
-              hcsparseControl* control)
-{
-    if (!hcsparseInitialized)
+    if (solverControl == nullptr)
     {
         return hcsparseInvalid;
     }
 
-    if (x->values == nullptr)
+    std::shared_ptr<PreconditionerHandler<T>> preconditioner =
+        solver_preconditioner<T>(A, solverControl, control);
+    if (!preconditioner)
     {
         return hcsparseInvalid;
     }
 
-    return Norm2<float>(s, x, control);
+    hcsparseSolverWorkspace local;
+    hcsparseSolverWorkspace *workspace = workspace_begin<T>(solverControl, x->num_values, local);
+
+    hcsparseStatus status = pipecg<T>(x, A, b, *preconditioner, solverControl, workspace, control);
+
+    workspace_end(workspace, local);
+
+    solverControl->printSummary(status);
+
+    return status;
 }
 
 hcsparseStatus
-hcdenseDnrm2 (hcsparseScalar* s,
-              const hcdenseVector* x,
-              hcsparseControl* control)
+hcsparseDcsrpipecg (hcdenseVector *x,
+                    const hcsparseCsrMatrix *A,
+                    const hcdenseVector *b,
+                    hcsparseSolverControl *solverControl,
+                    hcsparseControl *control)
 {
+    using T = double;
+
     if (!hcsparseInitialized)
     {
         return hcsparseInvalid;
     }
 
-    if (x->values == nullptr)
+    if (x->values == nullptr || b->values == nullptr)
     {
         return hcsparseInvalid;
     }
 
-    return Norm2<double>(s, x, control);
-}
-
-hcsparseStatus
-hcdenseSdot (hcsparseScalar* r,
-             const hcdenseVector* x,
-             const hcdenseVector* y,
-             hcsparseControl* control)
-{
-    if (!hcsparseInitialized)
+    if (solverControl == nullptr)
     {
         return hcsparseInvalid;
     }
 
-    //check opencl elements
-    if (x->values == nullptr || y->values == nullptr)
+    std::shared_ptr<PreconditionerHandler<T>> preconditioner =
+        solver_preconditioner<T>(A, solverControl, control);
+    if (!preconditioner)
     {
         return hcsparseInvalid;
     }
 
-    return dot<float>(r, x, y, control);
+    hcsparseSolverWorkspace local;
+    hcsparseSolverWorkspace *workspace = workspace_begin<T>(solverControl, x->num_values, local);
+
+    hcsparseStatus status = pipecg<T>(x, A, b, *preconditioner, solverControl, workspace, control);
+
+    workspace_end(workspace, local);
+
+    solverControl->printSummary(status);
+
+    return status;
 }
 
 hcsparseStatus
-hcdenseDdot (hcsparseScalar* r,
-             const hcdenseVector* x,
-             const hcdenseVector* y,
-             hcsparseControl* control)
+hcsparseScsrgmres (hcdenseVector *x,
+                   const hcsparseCsrMatrix *A,
+                   const hcdenseVector *b,
+                   hcsparseSolverControl *solverControl,
+                   hcsparseControl *control)
 {
+    using T = float;
+
     if (!hcsparseInitialized)
     {
         return hcsparseInvalid;
     }
 
-    //check opencl elements
-    if (x->values == nullptr || y->values == nullptr)
+    if (x->values == nullptr || b->values == nullptr)
     {
         return hcsparseInvalid;
     }
 
-    return dot<double>(r, x, y, control);
-}
-
-// This function reads the file header at the given filepath, and returns the size
-// of the sparse matrix in the hcsparseCooMatrix parameter.
-// Post-condition: clears hcsparseCooMatrix, then sets pCooMatx->m, pCooMatx->n
-// pCooMatx->nnz
-hcsparseStatus
-hcsparseHeaderfromFile (int* nnz, int* row, int* col, const char* filePath)
-{
-
-    // Check that the file format is matrix market; the only format we can read right now
-    // This is not a complete solution, and fails for directories with file names etc...
-    // TODO: Should we use boost filesystem?
-    std::string strPath( filePath );
-    if( strPath.find_last_of( '.' ) != std::string::npos )
-    {
-        std::string ext = strPath.substr( strPath.find_last_of( '.' ) + 1 );
-        if( ext != "mtx" )
-            return hcsparseInvalid;
+    if (solverControl == nullptr)
+    {
+        return hcsparseInvalid;
     }
-    else
+
+    std::shared_ptr<PreconditionerHandler<T>> preconditioner =
+        solver_preconditioner<T>(A, solverControl, control);
+    if (!preconditioner)
+    {
         return hcsparseInvalid;
+    }
 
-   MatrixMarketReader< float > mm_reader;
+    hcsparseSolverWorkspace local;
+    hcsparseSolverWorkspace *workspace = workspace_begin<T>(solverControl, x->num_values, local);
 
-    if( mm_reader.MMReadHeader( filePath ) )
-        return hcsparseInvalid;
+    hcsparseStatus status = gmres<T>(x, A, b, *preconditioner, solverControl, workspace, control);
 
-    *row = mm_reader.GetNumRows( );
-    *col = mm_reader.GetNumCols( );
-    *nnz = mm_reader.GetNumNonZeroes( );
+    workspace_end(workspace, local);
 
-    return hcsparseSuccess;
+    solverControl->printSummary(status);
+
+    return status;
 }
 
-// This function reads the file at the given filepath, and returns the sparse
-// matrix in the COO struct.  All matrix data is written to device memory
-// Pre-condition: This function assumes that the device memory buffers have been
-// pre-allocated by the caller
 hcsparseStatus
-hcsparseSCooMatrixfromFile (hcsparseCooMatrix* cooMatx, const char* filePath, hcsparseControl *control, bool read_explicit_zeroes)
+hcsparseDcsrgmres (hcdenseVector *x,
+                   const hcsparseCsrMatrix *A,
+                   const hcdenseVector *b,
+                   hcsparseSolverControl *solverControl,
+                   hcsparseControl *control)
 {
-    // Check that the file format is matrix market; the only format we can read right now
-    // This is not a complete solution, and fails for directories with file names etc...
-    std::string strPath( filePath );
-    if( strPath.find_last_of( '.' ) != std::string::npos )
+    using T = double;
+
+    if (!hcsparseInitialized)
     {
-        std::string ext = strPath.substr( strPath.find_last_of( '.' ) + 1 );
-        if( ext != "mtx" )
-            return hcsparseInvalid;
-    }
-    else
         return hcsparseInvalid;
+    }
 
-    MatrixMarketReader< float > mm_reader;
-    if( mm_reader.MMReadFormat( filePath, read_explicit_zeroes ) )
+    if (x->values == nullptr || b->values == nullptr)
+    {
         return hcsparseInvalid;
+    }
 
-    cooMatx->num_rows = mm_reader.GetNumRows( );
-    cooMatx->num_cols = mm_reader.GetNumCols( );
-    cooMatx->num_nonzeros = mm_reader.GetNumNonZeroes( );
-
-    Coordinate<float>* coords = mm_reader.GetUnsymCoordinates( );
-
-    std::sort( coords, coords + cooMatx->num_nonzeros, CoordinateCompare< float > );
-
-    float *values = (float*) calloc(cooMatx->num_nonzeros, sizeof(float));
-    int *rowIndices = (int*) calloc(cooMatx->num_nonzeros, sizeof(int));
-    int *colIndices = (int*) calloc(cooMatx->num_nonzeros, sizeof(int));
+    if (solverControl == nullptr)
+    {
+        return hcsparseInvalid;
+    }
 
-    for( int c = 0; c < cooMatx->num_nonzeros; ++c )
+    std::shared_ptr<PreconditionerHandler<T>> preconditioner =
+        solver_preconditioner<T>(A, solverControl, control);
+    if (!preconditioner)
     {
-        rowIndices[ c ] = coords[c].x;
-        colIndices[ c ] = coords[c].y;
-        values[ c ] = coords[c].val;
+        return hcsparseInvalid;
     }
 
-    control->accl_view.copy(values, cooMatx->values, cooMatx->num_nonzeros * sizeof(float));
-    control->accl_view.copy(rowIndices, cooMatx->rowIndices, cooMatx->num_nonzeros * sizeof(int));
-    control->accl_view.copy(colIndices, cooMatx->colIndices, cooMatx->num_nonzeros * sizeof(int));
+    hcsparseSolverWorkspace local;
+    hcsparseSolverWorkspace *workspace = workspace_begin<T>(solverControl, x->num_values, local);
 
-    free(values);
-    free(rowIndices);
-    free(colIndices);
+    hcsparseStatus status = gmres<T>(x, A, b, *preconditioner, solverControl, workspace, control);
 
-    return hcsparseSuccess;
+    workspace_end(workspace, local);
+
+    solverControl->printSummary(status);
+
+    return status;
 }
 
 hcsparseStatus
-hcsparseDCooMatrixfromFile (hcsparseCooMatrix* cooMatx, const char* filePath, hcsparseControl *control, bool read_explicit_zeroes)
+hcsparseScsrbcg (hcdenseMatrix *X,
+                 const hcsparseCsrMatrix *A,
+                 const hcdenseMatrix *B,
+                 hcsparseSolverControl *solverControl,
+                 hcsparseControl *control)
 {
-    // Check that the file format is matrix market; the only format we can read right now
-    // This is not a complete solution, and fails for directories with file names etc...
-    std::string strPath( filePath );
-    if( strPath.find_last_of( '.' ) != std::string::npos )
+    using T = float;
+
+    if (!hcsparseInitialized)
     {
-        std::string ext = strPath.substr( strPath.find_last_of( '.' ) + 1 );
-        if( ext != "mtx" )
-            return hcsparseInvalid;
-    }
-    else
         return hcsparseInvalid;
+    }
 
-    MatrixMarketReader< double > mm_reader;
-    if( mm_reader.MMReadFormat( filePath, read_explicit_zeroes ) )
+    if (X->values == nullptr || B->values == nullptr)
+    {
         return hcsparseInvalid;
+    }
 
-    cooMatx->num_rows = mm_reader.GetNumRows( );
-    cooMatx->num_cols = mm_reader.GetNumCols( );
-    cooMatx->num_nonzeros = mm_reader.GetNumNonZeroes( );
-
-    Coordinate<double>* coords = mm_reader.GetUnsymCoordinates( );
-
-    std::sort( coords, coords + cooMatx->num_nonzeros, CoordinateCompare<double> );
-
-    double *values = (double*) calloc(cooMatx->num_nonzeros, sizeof(double));
-    int *rowIndices = (int*) calloc(cooMatx->num_nonzeros, sizeof(int));
-    int *colIndices = (int*) calloc(cooMatx->num_nonzeros, sizeof(int));
+    if (solverControl == nullptr)
+    {
+        return hcsparseInvalid;
+    }
 
-    for( int c = 0; c < cooMatx->num_nonzeros; ++c )
+    std::shared_ptr<PreconditionerHandler<T>> preconditioner =
+        solver_preconditioner<T>(A, solverControl, control);
+    if (!preconditioner)
     {
-        rowIndices[ c ] = coords[c].x;
-        colIndices[ c ] = coords[c].y;
-        values[ c ] = coords[c].val;
+        return hcsparseInvalid;
     }
 
-    control->accl_view.copy(values, cooMatx->values, cooMatx->num_nonzeros * sizeof(double));
-    control->accl_view.copy(rowIndices, cooMatx->rowIndices, cooMatx->num_nonzeros * sizeof(int));
-    control->accl_view.copy(colIndices, cooMatx->colIndices, cooMatx->num_nonzeros * sizeof(int));
+    hcsparseSolverWorkspace local;
+    hcsparseSolverWorkspace *workspace = workspace_begin<T>(solverControl, X->num_rows, local);
 
-    free(values);
-    free(rowIndices);
-    free(colIndices);
+    hcsparseStatus status = bcg<T>(X, A, B, *preconditioner, solverControl, workspace, control);
 
-    return hcsparseSuccess;
+    workspace_end(workspace, local);
+
+    solverControl->printSummary(status);
+
+    return status;
 }
 
 hcsparseStatus
-hcsparseSCsrMatrixfromFile (hcsparseCsrMatrix* csrMatx, const char* filePath, hcsparseControl *control, bool read_explicit_zeroes)
+hcsparseDcsrbcg (hcdenseMatrix *X,
+                 const hcsparseCsrMatrix *A,
+                 const hcdenseMatrix *B,
+                 hcsparseSolverControl *solverControl,
+                 hcsparseControl *control)
 {
+    using T = double;
 
-    // Check that the file format is matrix market; the only format we can read right now
-    // This is not a complete solution, and fails for directories with file names etc...
-    // TODO: Should we use boost filesystem?
-    std::string strPath( filePath );
-    if( strPath.find_last_of( '.' ) != std::string::npos )
+    if (!hcsparseInitialized)
     {
-        std::string ext = strPath.substr( strPath.find_last_of( '.' ) + 1 );
-        if( ext != "mtx" )
-            return hcsparseInvalid;
-    }
-    else
         return hcsparseInvalid;
+    }
 
-    // Read data from a file on disk into CPU buffers
-    // Data is read natively as COO format with the reader
-    MatrixMarketReader< float > mm_reader;
+    if (X->values == nullptr || B->values == nullptr)
+    {
+        return hcsparseInvalid;
+    }
 
-    // Read header data of input file
-    if( mm_reader.MMReadHeader( filePath ) )
+    if (solverControl == nullptr)
+    {
         return hcsparseInvalid;
-    int header_nnz = mm_reader.GetNumNonZeroes( );
+    }
 
-    if( mm_reader.MMReadFormat( filePath, read_explicit_zeroes ) )
+    std::shared_ptr<PreconditionerHandler<T>> preconditioner =
+        solver_preconditioner<T>(A, solverControl, control);
+    if (!preconditioner)
+    {
         return hcsparseInvalid;
+    }
 
-    // JPA: Shouldn't that just be an assertion check? It seems to me that
-    // the user have to call hcsparseHeaderfromFile before calling this function,
-    // otherwise the whole pCsrMatrix will be broken;
+    hcsparseSolverWorkspace local;
+    hcsparseSolverWorkspace *workspace = workspace_begin<T>(solverControl, X->num_rows, local);
 
-    csrMatx->num_rows = mm_reader.GetNumRows( );
-    csrMatx->num_cols = mm_reader.GetNumCols( );
-    csrMatx->num_nonzeros = mm_reader.GetNumNonZeroes( );
+    hcsparseStatus status = bcg<T>(X, A, B, *preconditioner, solverControl, workspace, control);
 
+    workspace_end(workspace, local);
 
-    Coordinate<float>* coords = mm_reader.GetUnsymCoordinates( );
+    solverControl->printSummary(status);
 
-    std::sort( coords, coords + csrMatx->num_nonzeros, CoordinateCompare< float > );
+    return status;
+}
 
-    float *values;
-    int *rowOffsets, *colIndices;
+// Low precision inner solver of the mixed precision entry points
+typedef hcsparseStatus (*lowPrecisionSolver)(hcdenseVector*, const hcsparseCsrMatrix*,
+                                             const hcdenseVector*, PreconditionerHandler<float>&,
+                                             hcsparseSolverControl*, hcsparseSolverWorkspace*,
+                                             hcsparseControl*);
+
+// Double precision iterative refinement around a single precision solver:
+// A is copied to float once, the preconditioner is built on the copy and
+// every correction equation is solved by solver.
+static hcsparseStatus
+mixed_precision_solve (hcdenseVector *x,
+                       const hcsparseCsrMatrix *A,
+                       const hcdenseVector *b,
+                       hcsparseSolverControl *solverControl,
+                       hcsparseControl *control,
+                       lowPrecisionSolver solver)
+{
+    using T = float;
 
-    if (header_nnz > csrMatx->num_nonzeros)  {
-      values = (float*)calloc(header_nnz, sizeof(float));
-      rowOffsets = (int*)calloc((csrMatx->num_rows)+1, sizeof(int));
-      colIndices = (int*)calloc(header_nnz, sizeof(int));
-    } else {
-      values = (float*)calloc(csrMatx->num_nonzeros, sizeof(float));
-      rowOffsets = (int*)calloc((csrMatx->num_rows)+1, sizeof(int));
-      colIndices = (int*)calloc(csrMatx->num_nonzeros, sizeof(int));
+    if (!hcsparseInitialized)
+    {
+        return hcsparseInvalid;
     }
 
-    int current_row = 0;
-    rowOffsets[ 0 ] = 0;
-    for( int i = 0; i < csrMatx->num_nonzeros; i++ )
+    if (x->values == nullptr || b->values == nullptr)
     {
-        colIndices[ i ] = coords[i].y;
-        values[ i ] = coords[i].val;
-
-        while( coords[i].x >= current_row )
-            rowOffsets[ current_row++ ] = i;
+        return hcsparseInvalid;
     }
-    rowOffsets[ current_row ] = csrMatx->num_nonzeros;
-    while( current_row <= csrMatx->num_rows )
-        rowOffsets[ current_row++ ] = csrMatx->num_nonzeros;
 
-    if (header_nnz > csrMatx->num_nonzeros) {
-      control->accl_view.copy(values, csrMatx->values, sizeof(float) * header_nnz);
-      control->accl_view.copy(rowOffsets, csrMatx->rowOffsets, sizeof(int) * (csrMatx->num_rows+1));
-      control->accl_view.copy(colIndices, csrMatx->colIndices, sizeof(int) * header_nnz);
-    } else {
-      control->accl_view.copy(values, csrMatx->values, sizeof(float) * csrMatx->num_nonzeros);
-      control->accl_view.copy(rowOffsets, csrMatx->rowOffsets, sizeof(int) * (csrMatx->num_rows+1));
-      control->accl_view.copy(colIndices, csrMatx->colIndices, sizeof(int) * csrMatx->num_nonzeros);
+    if (solverControl == nullptr)
+    {
+        return hcsparseInvalid;
     }
 
-    free(values);
-    free(rowOffsets);
-    free(colIndices);
+    hc::accelerator acc = (control->accl_view).get_accelerator();
 
-    return hcsparseSuccess;
-}
+    // same pattern, single precision values
+    hcsparseCsrMatrix A_low = *A;
+    A_low.values = am_alloc(sizeof(float) * std::max(A->num_nonzeros, 1), acc, 0);
+    A_low.offValues = 0;
+    ir_convert<double, float>(A->num_nonzeros, static_cast<const double*>(A->values) + A->offValues,
+                              static_cast<float*>(A_low.values), control);
 
-hcsparseStatus
-hcsparseDCsrMatrixfromFile (hcsparseCsrMatrix* csrMatx, const char* filePath, hcsparseControl *control, bool read_explicit_zeroes)
-{
-    // Check that the file format is matrix market; the only format we can read right now
-    // This is not a complete solution, and fails for directories with file names etc...
-    // TODO: Should we use boost filesystem?
-    std::string strPath( filePath );
-    if( strPath.find_last_of( '.' ) != std::string::npos )
+    // built on the temporary copy, never cached
+    std::shared_ptr<PreconditionerHandler<T>> preconditioner =
+        create_preconditioner<T>(&A_low, solverControl, control);
+    if (!preconditioner)
     {
-        std::string ext = strPath.substr( strPath.find_last_of( '.' ) + 1 );
-        if( ext != "mtx" )
-            return hcsparseInvalid;
-    }
-    else
+        am_free(A_low.values);
         return hcsparseInvalid;
+    }
 
-    // Read data from a file on disk into CPU buffers
-    // Data is read natively as COO format with the reader
-    MatrixMarketReader< double > mm_reader; 
+    hcsparseSolverWorkspace lowWorkspace;
+    lowWorkspace.num_values = x->num_values;
+    lowWorkspace.value_size = sizeof(float);
 
-    // Read header data of input file
-    if( mm_reader.MMReadHeader( filePath ) )
-        return hcsparseInvalid;
-    int header_nnz = mm_reader.GetNumNonZeroes( );
+    auto inner = [&] (const hcdenseVector *r, hcdenseVector *d, hcsparseSolverControl *innerControl)
+    {
+        return solver(d, &A_low, r, *preconditioner, innerControl, &lowWorkspace, control);
+    };
 
-    if( mm_reader.MMReadFormat( filePath, read_explicit_zeroes ) )
-        return hcsparseInvalid;
+    hcsparseSolverWorkspace local;
+    hcsparseSolverWorkspace *workspace = workspace_begin<double>(solverControl, x->num_values, local);
 
-    csrMatx->num_rows = mm_reader.GetNumRows( );
-    csrMatx->num_cols = mm_reader.GetNumCols( );
-    csrMatx->num_nonzeros = mm_reader.GetNumNonZeroes( );
+    hcsparseStatus status = iterative_refinement<double, float>(x, A, b, inner, solverControl,
+                                                                workspace, control);
 
-    Coordinate<double>* coords = mm_reader.GetUnsymCoordinates( );
+    workspace_end(workspace, local);
+    workspace_free(&lowWorkspace);
+    preconditioner.reset();
+    am_free(A_low.values);
 
-    std::sort( coords, coords + csrMatx->num_nonzeros, CoordinateCompare<double> );
+    solverControl->printSummary(status);
 
-    double *values;
-    int *rowOffsets;
-    int *colIndices;
+    return status;
+}
 
-    if (header_nnz > csrMatx->num_nonzeros) {
-      values = (double*)calloc(header_nnz, sizeof(double));
-      rowOffsets = (int*)calloc(csrMatx->num_rows+1, sizeof(int));
-      colIndices = (int*)calloc(header_nnz, sizeof(int));
-    } else {  
-      values = (double*)calloc(csrMatx->num_nonzeros, sizeof(double));
-      rowOffsets = (int*)calloc(csrMatx->num_rows+1, sizeof(int));
-      colIndices = (int*)calloc(csrMatx->num_nonzeros, sizeof(int));
-    }
+hcsparseStatus
+hcsparseDScsrcg (hcdenseVector *x,
+                 const hcsparseCsrMatrix *A,
+                 const hcdenseVector *b,
+                 hcsparseSolverControl *solverControl,
+                 hcsparseControl *control)
+{
+    return mixed_precision_solve(x, A, b, solverControl, control, cg<float, PreconditionerHandler<float>>);
+}
+
+hcsparseStatus
+hcsparseDScsrbicgStab (hcdenseVector *x,
+                       const hcsparseCsrMatrix *A,
+                       const hcdenseVector *b,
+                       hcsparseSolverControl *solverControl,
+                       hcsparseControl *control)
+{
+    return mixed_precision_solve(x, A, b, solverControl, control, bicgStab<float, PreconditionerHandler<float>>);
+}
+
+hcsparseStatus
+hcsparseScsrlobpcg (hcdenseMatrix *X,
+                    hcdenseVector *lambda,
+                    const hcsparseCsrMatrix *A,
+                    EIG_WHICH which,
+                    hcsparseSolverControl *solverControl,
+                    hcsparseControl *control)
+{
+    using T = float;
 
-    int current_row = 0;
-    rowOffsets[ 0 ] = 0;
-    for( int i = 0; i < csrMatx->num_nonzeros; i++ )
+    if (!hcsparseInitialized)
     {
-        colIndices[ i ] = coords[i].y;
-        values[ i ] = coords[i].val;
-
-        while( coords[i].x >= current_row )
-            rowOffsets[ current_row++ ] = i;
+        return hcsparseInvalid;
     }
-    rowOffsets[ current_row ] = csrMatx->num_nonzeros;
-    while( current_row <= csrMatx->num_rows )
-        rowOffsets[ current_row++ ] = csrMatx->num_nonzeros;
 
-    if (header_nnz > csrMatx->num_nonzeros) {
-      control->accl_view.copy(values, csrMatx->values, sizeof(double) * header_nnz);
-      control->accl_view.copy(rowOffsets, csrMatx->rowOffsets, sizeof(int) * (csrMatx->num_rows+1));
-      control->accl_view.copy(colIndices, csrMatx->colIndices, sizeof(int) * header_nnz);
-    } else {
-      control->accl_view.copy(values, csrMatx->values, sizeof(double) * csrMatx->num_nonzeros);
-      control->accl_view.copy(rowOffsets, csrMatx->rowOffsets, sizeof(int) * (csrMatx->num_rows+1));
-      control->accl_view.copy(colIndices, csrMatx->colIndices, sizeof(int) * csrMatx->num_nonzeros);
+    if (X->values == nullptr || lambda->values == nullptr)
+    {
+        return hcsparseInvalid;
     }
 
-    free(values);
-    free(rowOffsets);
-    free(colIndices);
+    if (solverControl == nullptr)
+    {
+        return hcsparseInvalid;
+    }
 
-    return hcsparseSuccess;
-}
+    std::shared_ptr<PreconditionerHandler<T>> preconditioner =
+        solver_preconditioner<T>(A, solverControl, control);
+    if (!preconditioner)
+    {
+        return hcsparseInvalid;
+    }
 
-hcsparseStatus
-hcsparseCsrMetaSize (hcsparseCsrMatrix* csrMatx, hcsparseControl *control)
-{
-    int *rCsrRowOffsets = (int*)calloc(csrMatx->num_rows+1, sizeof(int));
-    control->accl_view.copy(csrMatx->rowOffsets, rCsrRowOffsets, sizeof(int) * (csrMatx->num_rows+1));
+    hcsparseSolverWorkspace local;
+    hcsparseSolverWorkspace *workspace = workspace_begin<T>(solverControl, X->num_rows, local);
 
-    csrMatx->rowBlockSize = ComputeRowBlocksSize( rCsrRowOffsets, csrMatx->num_rows, BLOCKSIZE, BLOCK_MULTIPLIER, ROWS_FOR_VECTOR );
+    hcsparseStatus status = lobpcg<T>(X, lambda, A, which, *preconditioner, solverControl, workspace, control);
 
-    control->accl_view.copy(rCsrRowOffsets, csrMatx->rowOffsets, sizeof(int) * (csrMatx->num_rows+1));
+    workspace_end(workspace, local);
 
-    free(rCsrRowOffsets);
+    solverControl->printSummary(status);
 
-    return hcsparseSuccess;
+    return status;
 }
 
 hcsparseStatus
-hcsparseCsrMetaCompute (hcsparseCsrMatrix* csrMatx, hcsparseControl *control)
+hcsparseDcsrlobpcg (hcdenseMatrix *X,
+                    hcdenseVector *lambda,
+                    const hcsparseCsrMatrix *A,
+                    EIG_WHICH which,
+                    hcsparseSolverControl *solverControl,
+                    hcsparseControl *control)
 {
-    // Check to ensure nRows can fit in 32 bits
-    if( static_cast<ulong>( csrMatx->num_rows ) > static_cast<ulong>( std::pow( 2, ( 64 - ROWBITS ) ) ) )
+    using T = double;
+
+    if (!hcsparseInitialized)
     {
-        printf( "Number of Rows in the Sparse Matrix is greater than what is supported at present ((64-WG_BITS) bits) !" );
         return hcsparseInvalid;
     }
 
-    int *rCsrRowOffsets = (int*)calloc(csrMatx->num_rows+1, sizeof(int));
-    ulong *rRowBlocks = (ulong*)calloc(csrMatx->num_nonzeros, sizeof(ulong));
+    if (X->values == nullptr || lambda->values == nullptr)
+    {
+        return hcsparseInvalid;
+    }
 
-    control->accl_view.copy(csrMatx->rowOffsets, rCsrRowOffsets, sizeof(int) * (csrMatx->num_rows+1));
-    control->accl_view.copy(csrMatx->rowBlocks, rRowBlocks, sizeof(ulong) * csrMatx->num_nonzeros);
+    if (solverControl == nullptr)
+    {
+        return hcsparseInvalid;
+    }
 
-    ComputeRowBlocks(rRowBlocks, csrMatx->rowBlockSize, rCsrRowOffsets, csrMatx->num_rows, BLOCKSIZE, BLOCK_MULTIPLIER, ROWS_FOR_VECTOR, true );
+    std::shared_ptr<PreconditionerHandler<T>> preconditioner =
+        solver_preconditioner<T>(A, solverControl, control);
+    if (!preconditioner)
+    {
+        return hcsparseInvalid;
+    }
 
-    control->accl_view.copy(rCsrRowOffsets, csrMatx->rowOffsets, sizeof(int) * (csrMatx->num_rows+1));
-    control->accl_view.copy(rRowBlocks, csrMatx->rowBlocks, sizeof(ulong) * csrMatx->num_nonzeros);
+    hcsparseSolverWorkspace local;
+    hcsparseSolverWorkspace *workspace = workspace_begin<T>(solverControl, X->num_rows, local);
 
-    free(rCsrRowOffsets);
-    free(rRowBlocks);
+    hcsparseStatus status = lobpcg<T>(X, lambda, A, which, *preconditioner, solverControl, workspace, control);
 
-    return hcsparseSuccess;
+    workspace_end(workspace, local);
+
+    solverControl->printSummary(status);
+
+    return status;
 }
 
 hcsparseStatus
-hcsparseScsrbicgStab (hcdenseVector* x, const hcsparseCsrMatrix *A, const hcdenseVector *b,
-                      hcsparseSolverControl *solverControl, hcsparseControl *control)
+hcsparseScsrlanczos (hcdenseMatrix *X,
+                     hcdenseVector *lambda,
+                     const hcsparseCsrMatrix *A,
+                     EIG_WHICH which,
+                     hcsparseSolverControl *solverControl,
+                     hcsparseControl *control)
 {
     using T = float;
 
@@ -2821,7 +3909,7 @@ hcsparseScsrbicgStab (hcdenseVector* x, const hcsparseCsrMatrix *A, const hcdens
         return hcsparseInvalid;
     }
 
-    if (x->values == nullptr || b->values == nullptr)
+    if (X->values == nullptr || lambda->values == nullptr)
     {
         return hcsparseInvalid;
     }
@@ -2831,21 +3919,12 @@ hcsparseScsrbicgStab (hcdenseVector* x, const hcsparseCsrMatrix *A, const hcdens
         return hcsparseInvalid;
     }
 
-    std::shared_ptr<PreconditionerHandler<T>> preconditioner;
+    hcsparseSolverWorkspace local;
+    hcsparseSolverWorkspace *workspace = workspace_begin<T>(solverControl, X->num_rows, local);
 
-    if (solverControl->preconditioner == DIAGONAL)
-    {
-        preconditioner = std::shared_ptr<PreconditionerHandler<T>>(new DiagonalHandler<T>());
-        // call constructor of preconditioner class
-        preconditioner->notify(A, control);
-    }
-    else
-    {
-        preconditioner = std::shared_ptr<PreconditionerHandler<T>>(new VoidHandler<T>());
-        preconditioner->notify(A, control);
-    }
+    hcsparseStatus status = lanczos<T>(X, lambda, A, which, solverControl, workspace, control);
 
-    hcsparseStatus status = bicgStab<T>(x, A, b, *preconditioner, solverControl, control);
+    workspace_end(workspace, local);
 
     solverControl->printSummary(status);
 
@@ -2853,8 +3932,12 @@ hcsparseScsrbicgStab (hcdenseVector* x, const hcsparseCsrMatrix *A, const hcdens
 }
 
 hcsparseStatus
-hcsparseDcsrbicgStab (hcdenseVector* x, const hcsparseCsrMatrix *A, const hcdenseVector *b,
-                      hcsparseSolverControl *solverControl, hcsparseControl *control)
+hcsparseDcsrlanczos (hcdenseMatrix *X,
+                     hcdenseVector *lambda,
+                     const hcsparseCsrMatrix *A,
+                     EIG_WHICH which,
+                     hcsparseSolverControl *solverControl,
+                     hcsparseControl *control)
 {
     using T = double;
 
@@ -2863,7 +3946,7 @@ hcsparseDcsrbicgStab (hcdenseVector* x, const hcsparseCsrMatrix *A, const hcdens
         return hcsparseInvalid;
     }
 
-    if (x->values == nullptr || b->values == nullptr)
+    if (X->values == nullptr || lambda->values == nullptr)
     {
         return hcsparseInvalid;
     }
@@ -2873,21 +3956,12 @@ hcsparseDcsrbicgStab (hcdenseVector* x, const hcsparseCsrMatrix *A, const hcdens
         return hcsparseInvalid;
     }
 
-    std::shared_ptr<PreconditionerHandler<T>> preconditioner;
+    hcsparseSolverWorkspace local;
+    hcsparseSolverWorkspace *workspace = workspace_begin<T>(solverControl, X->num_rows, local);
 
-    if (solverControl->preconditioner == DIAGONAL)
-    {
-        preconditioner = std::shared_ptr<PreconditionerHandler<T>>(new DiagonalHandler<T>());
-        // call constructor of preconditioner class
-        preconditioner->notify(A, control);
-    }
-    else
-    {
-        preconditioner = std::shared_ptr<PreconditionerHandler<T>>(new VoidHandler<T>());
-        preconditioner->notify(A, control);
-    }
+    hcsparseStatus status = lanczos<T>(X, lambda, A, which, solverControl, workspace, control);
 
-    hcsparseStatus status = bicgStab<T>(x, A, b, *preconditioner, solverControl, control);
+    workspace_end(workspace, local);
 
     solverControl->printSummary(status);
 
@@ -2895,11 +3969,12 @@ hcsparseDcsrbicgStab (hcdenseVector* x, const hcsparseCsrMatrix *A, const hcdens
 }
 
 hcsparseStatus
-hcsparseScsrcg (hcdenseVector *x,
-                const hcsparseCsrMatrix *A,
-                const hcdenseVector *b,
-                hcsparseSolverControl *solverControl,
-                hcsparseControl *control)
+hcsparseScsrpagerank (hcdenseVector *x,
+                      const hcsparseCsrMatrix *M,
+                      const hcdenseVector *teleport,
+                      float damping,
+                      hcsparseSolverControl *solverControl,
+                      hcsparseControl *control)
 {
     using T = float;
 
@@ -2908,7 +3983,7 @@ hcsparseScsrcg (hcdenseVector *x,
         return hcsparseInvalid;
     }
 
-    if (x->values == nullptr || b->values == nullptr)
+    if (x->values == nullptr || (teleport != nullptr && teleport->values == nullptr))
     {
         return hcsparseInvalid;
     }
@@ -2918,21 +3993,12 @@ hcsparseScsrcg (hcdenseVector *x,
         return hcsparseInvalid;
     }
 
-    std::shared_ptr<PreconditionerHandler<T>> preconditioner;
+    hcsparseSolverWorkspace local;
+    hcsparseSolverWorkspace *workspace = workspace_begin<T>(solverControl, x->num_values, local);
 
-    if (solverControl->preconditioner == DIAGONAL)
-    {
-        preconditioner = std::shared_ptr<PreconditionerHandler<T>>(new DiagonalHandler<T>());
-        // call constructor of preconditioner class
-        preconditioner->notify(A, control);
-    }
-    else
-    {
-        preconditioner = std::shared_ptr<PreconditionerHandler<T>>(new VoidHandler<T>());
-        preconditioner->notify(A, control);
-    }
+    hcsparseStatus status = pagerank<T>(x, M, teleport, damping, solverControl, workspace, control);
 
-    hcsparseStatus status = cg<T>(x, A, b, *preconditioner, solverControl, control);
+    workspace_end(workspace, local);
 
     solverControl->printSummary(status);
 
@@ -2940,11 +4006,12 @@ hcsparseScsrcg (hcdenseVector *x,
 }
 
 hcsparseStatus
-hcsparseDcsrcg (hcdenseVector *x,
-                const hcsparseCsrMatrix *A,
-                const hcdenseVector *b,
-                hcsparseSolverControl *solverControl,
-                hcsparseControl *control)
+hcsparseDcsrpagerank (hcdenseVector *x,
+                      const hcsparseCsrMatrix *M,
+                      const hcdenseVector *teleport,
+                      double damping,
+                      hcsparseSolverControl *solverControl,
+                      hcsparseControl *control)
 {
     using T = double;
 
@@ -2953,7 +4020,7 @@ hcsparseDcsrcg (hcdenseVector *x,
         return hcsparseInvalid;
     }
 
-    if (x->values == nullptr || b->values == nullptr)
+    if (x->values == nullptr || (teleport != nullptr && teleport->values == nullptr))
     {
         return hcsparseInvalid;
     }
@@ -2963,21 +4030,12 @@ hcsparseDcsrcg (hcdenseVector *x,
         return hcsparseInvalid;
     }
 
-    std::shared_ptr<PreconditionerHandler<T>> preconditioner;
+    hcsparseSolverWorkspace local;
+    hcsparseSolverWorkspace *workspace = workspace_begin<T>(solverControl, x->num_values, local);
 
-    if (solverControl->preconditioner == DIAGONAL)
-    {
-        preconditioner = std::shared_ptr<PreconditionerHandler<T>>(new DiagonalHandler<T>());
-        // call constructor of preconditioner class
-        preconditioner->notify(A, control);
-    }
-    else
-    {
-        preconditioner = std::shared_ptr<PreconditionerHandler<T>>(new VoidHandler<T>());
-        preconditioner->notify(A, control);
-    }
+    hcsparseStatus status = pagerank<T>(x, M, teleport, damping, solverControl, workspace, control);
 
-    hcsparseStatus status = cg<T>(x, A, b, *preconditioner, solverControl, control);
+    workspace_end(workspace, local);
 
     solverControl->printSummary(status);
 
@@ -3020,6 +4078,42 @@ hcsparseDcoo2csr (const hcsparseCooMatrix* coo,
     return coo2csr<double> (coo, csr, control);
 }
 
+hcsparseStatus
+hcsparseScoo2csrAssemble (const hcsparseCooMatrix* coo,
+                          hcsparseCsrMatrix* csr,
+                          hcsparseControl* control)
+{
+    if (!hcsparseInitialized)
+    {
+        return hcsparseInvalid;
+    }
+
+    if (coo->values == nullptr || csr->values == nullptr)
+    {
+        return hcsparseInvalid;
+    }
+
+    return coo_assemble<float> (coo, csr, control);
+}
+
+hcsparseStatus
+hcsparseDcoo2csrAssemble (const hcsparseCooMatrix* coo,
+                          hcsparseCsrMatrix* csr,
+                          hcsparseControl* control)
+{
+    if (!hcsparseInitialized)
+    {
+        return hcsparseInvalid;
+    }
+
+    if (coo->values == nullptr || csr->values == nullptr)
+    {
+        return hcsparseInvalid;
+    }
+
+    return coo_assemble<double> (coo, csr, control);
+}
+
 hcsparseStatus
 hcsparseScsr2coo (const hcsparseCsrMatrix* csr,
                   hcsparseCooMatrix* coo,
@@ -3148,3 +4242,168 @@ hcsparseScsrSpGemm (const hcsparseCsrMatrix* sparseMatA,
     return csrSpGemm<float> (sparseMatA, sparseMatB, sparseMatC, control);
 }
 
+hcsparseStatus
+hcsparseScsrSpGemmMaskedNnz (const hcsparseCsrMatrix* sparseMatA,
+                             const hcsparseCsrMatrix* sparseMatB,
+                             const hcsparseMask* mask,
+                             int* nnzC,
+                             hcsparseControl* control)
+{
+    if (!hcsparseInitialized)
+    {
+       return hcsparseInvalid;
+    }
+
+    if (nnzC == nullptr)
+    {
+       return hcsparseInvalid;
+    }
+
+    return csrSpGemm_masked<float> (sparseMatA, sparseMatB, mask, nullptr, control, nnzC);
+}
+
+hcsparseStatus
+hcsparseScsrSpGemmMasked (const hcsparseCsrMatrix* sparseMatA,
+                          const hcsparseCsrMatrix* sparseMatB,
+                          const hcsparseMask* mask,
+                          hcsparseCsrMatrix* sparseMatC,
+                          hcsparseControl* control)
+{
+    if (!hcsparseInitialized)
+    {
+       return hcsparseInvalid;
+    }
+
+    if (sparseMatA->values == nullptr || sparseMatB->values == nullptr || sparseMatC->values == nullptr)
+    {
+       return hcsparseInvalid;
+    }
+
+    return csrSpGemm_masked<float> (sparseMatA, sparseMatB, mask, sparseMatC, control);
+}
+
+hcsparseStatus
+hcsparseDcsrSpGemmMaskedNnz (const hcsparseCsrMatrix* sparseMatA,
+                             const hcsparseCsrMatrix* sparseMatB,
+                             const hcsparseMask* mask,
+                             int* nnzC,
+                             hcsparseControl* control)
+{
+    if (!hcsparseInitialized)
+    {
+       return hcsparseInvalid;
+    }
+
+    if (nnzC == nullptr)
+    {
+       return hcsparseInvalid;
+    }
+
+    return csrSpGemm_masked<double> (sparseMatA, sparseMatB, mask, nullptr, control, nnzC);
+}
+
+hcsparseStatus
+hcsparseDcsrSpGemmMasked (const hcsparseCsrMatrix* sparseMatA,
+                          const hcsparseCsrMatrix* sparseMatB,
+                          const hcsparseMask* mask,
+                          hcsparseCsrMatrix* sparseMatC,
+                          hcsparseControl* control)
+{
+    if (!hcsparseInitialized)
+    {
+       return hcsparseInvalid;
+    }
+
+    if (sparseMatA->values == nullptr || sparseMatB->values == nullptr || sparseMatC->values == nullptr)
+    {
+       return hcsparseInvalid;
+    }
+
+    return csrSpGemm_masked<double> (sparseMatA, sparseMatB, mask, sparseMatC, control);
+}
+
+hcsparseStatus
+hcsparseCreateRapInfo (hcsparseRapInfo_t* info)
+{
+    if (info == nullptr)
+    {
+       return hcsparseInvalid;
+    }
+
+    *info = new hcsparseRapInfo();
+
+    return hcsparseSuccess;
+}
+
+hcsparseStatus
+hcsparseDestroyRapInfo (hcsparseRapInfo_t info)
+{
+    delete info;
+
+    return hcsparseSuccess;
+}
+
+hcsparseStatus
+hcsparseXcsrRapSymbolic (const hcsparseCsrMatrix* sparseMatA,
+                         const hcsparseCsrMatrix* sparseMatP,
+                         hcsparseRapInfo_t info,
+                         int* nnzC,
+                         hcsparseControl* control)
+{
+    if (!hcsparseInitialized)
+    {
+       return hcsparseInvalid;
+    }
+
+    if (info == nullptr || nnzC == nullptr)
+    {
+       return hcsparseInvalid;
+    }
+
+    hcsparseStatus status = rap_symbolic (sparseMatA, sparseMatP, info, control);
+    if (status == hcsparseSuccess)
+        *nnzC = info->nnzC;
+
+    return status;
+}
+
+hcsparseStatus
+hcsparseScsrRapNumeric (const hcsparseCsrMatrix* sparseMatA,
+                        const hcsparseCsrMatrix* sparseMatP,
+                        const hcsparseRapInfo_t info,
+                        hcsparseCsrMatrix* sparseMatC,
+                        hcsparseControl* control)
+{
+    if (!hcsparseInitialized)
+    {
+       return hcsparseInvalid;
+    }
+
+    if (info == nullptr || sparseMatA->values == nullptr || sparseMatP->values == nullptr || sparseMatC->values == nullptr)
+    {
+       return hcsparseInvalid;
+    }
+
+    return rap_numeric<float> (sparseMatA, sparseMatP, info, sparseMatC, control);
+}
+
+hcsparseStatus
+hcsparseDcsrRapNumeric (const hcsparseCsrMatrix* sparseMatA,
+                        const hcsparseCsrMatrix* sparseMatP,
+                        const hcsparseRapInfo_t info,
+                        hcsparseCsrMatrix* sparseMatC,
+                        hcsparseControl* control)
+{
+    if (!hcsparseInitialized)
+    {
+       return hcsparseInvalid;
+    }
+
+    if (info == nullptr || sparseMatA->values == nullptr || sparseMatP->values == nullptr || sparseMatC->values == nullptr)
+    {
+       return hcsparseInvalid;
+    }
+
+    return rap_numeric<double> (sparseMatA, sparseMatP, info, sparseMatC, control);
+}
+
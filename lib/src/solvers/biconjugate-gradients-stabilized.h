@@ -3,6 +3,10 @@
 
 #include "hcsparse.h"
 
+// work vectors and scalars used by bicgStab inside a hcsparseSolverWorkspace
+#define BICGSTAB_WORK_VECTORS 9
+#define BICGSTAB_WORK_SCALARS 8
+
 template <typename T, typename PTYPE>
 hcsparseStatus
 bicgStab(hcdenseVector *pX,
@@ -10,6 +14,7 @@ bicgStab(hcdenseVector *pX,
          const hcdenseVector *pB,
          PTYPE& M,
          hcsparseSolverControl* solverControl,
+         hcsparseSolverWorkspace* workspace,
          hcsparseControl* control)
 {
     assert( pA->num_cols == pB->num_values );
@@ -20,40 +25,17 @@ bicgStab(hcdenseVector *pX,
         return hcsparseInvalid;
     }
 
-    hc::accelerator acc = (control->accl_view).get_accelerator();
-
-    T *x = static_cast<T*>(pX->values);
-    T *b = static_cast<T*>(pB->values);
-
     int status;
-    T *norm_b_buff = (T*)calloc(1, sizeof(T));
-    hcsparseScalar norm_b;
-    norm_b.value = am_alloc(sizeof(T)*1, acc, 0);
-    norm_b.offValue = 0;
-
-    //norm of rhs of equation
-    status = Norm1<T>(&norm_b, pB, control);
-    control->accl_view.copy(norm_b.value, norm_b_buff, sizeof(T)*1);
 
-    //norm_b is calculated once
-    T h_norm_b = norm_b_buff[0];
+    //n == number of rows;
+    const auto N = pA->num_cols;
 
-    if (h_norm_b <= std::numeric_limits<T>::min())
+    status = workspace_reserve<T>(workspace, BICGSTAB_WORK_VECTORS, BICGSTAB_WORK_SCALARS, control);
+    if (status != hcsparseSuccess)
     {
-        solverControl->nIters = 0;
-        solverControl->absoluteTolerance = 0.0;
-        solverControl->relativeTolerance = 0.0;
-        //we can either fill the x with zeros or cpy b to x;
-        for (int i = 0; i < pX->num_values; i++)
-            x[i] = b[i];
-
-        return hcsparseSuccess;
+        return hcsparseInvalid;
     }
 
-
-    //n == number of rows;
-    const auto N = pA->num_cols;
-
     hcdenseVector y;
     hcdenseVector p;
     hcdenseVector r;
@@ -64,101 +46,73 @@ bicgStab(hcdenseVector *pX,
     hcdenseVector Ms;
     hcdenseVector AMs;
 
-    y.values = am_alloc(sizeof(T)*N, acc, 0);
-    p.values = am_alloc(sizeof(T)*N, acc, 0);
-    r.values = am_alloc(sizeof(T)*N, acc, 0);
-    r_star.values =am_alloc(sizeof(T)*N, acc, 0);
-    s.values = am_alloc(sizeof(T)*N, acc, 0);
-    Mp.values = am_alloc(sizeof(T)*N, acc, 0);
-    AMp.values = am_alloc(sizeof(T)*N, acc, 0);
-    Ms.values = am_alloc(sizeof(T)*N, acc, 0);
-    AMs.values = am_alloc(sizeof(T)*N, acc, 0);
-
-    y.num_values = N;
-    p.num_values = N;
-    r.num_values = N;
-    r_star.num_values = N;
-    s.num_values = N;
-    Mp.num_values = N;
-    AMp.num_values = N;
-    Ms.num_values = N;
-    AMs.num_values = N;
-
-    y.offValues = 0;
-    p.offValues = 0;
-    r.offValues = 0;
-    r_star.offValues = 0;
-    s.offValues = 0;
-    Mp.offValues = 0;
-    AMp.offValues = 0;
-    Ms.offValues = 0;
-    AMs.offValues = 0;
-
-    T *one_buff = (T*) calloc(1, sizeof(T));
-
-    one_buff[0] = 1;
-    T zero_buff = 1;
+    workspace_vector<T>(workspace, 0, &y);
+    workspace_vector<T>(workspace, 1, &p);
+    workspace_vector<T>(workspace, 2, &r);
+    workspace_vector<T>(workspace, 3, &r_star);
+    workspace_vector<T>(workspace, 4, &s);
+    workspace_vector<T>(workspace, 5, &Mp);
+    workspace_vector<T>(workspace, 6, &AMp);
+    workspace_vector<T>(workspace, 7, &Ms);
+    workspace_vector<T>(workspace, 8, &AMs);
 
     hcsparseScalar one;
     hcsparseScalar zero;
+    hcsparseScalar norm_b;
+    hcsparseScalar norm_r;
+    // <r_star, r> of the current and the next iteration, used alternately
+    hcsparseScalar r_star_r[2];
+    // holders for <r_star, AMp>, <A*M*s, s>, <AMs, AMs> and norm_s
+    hcsparseScalar r_star_AMp;
+    hcsparseScalar AMsS;
+    hcsparseScalar AMsAMs;
+    hcsparseScalar norm_s;
 
-    one.value = am_alloc(sizeof(T)*1, acc, 0);
-    zero.value = am_alloc(sizeof(T)*1, acc, 0);
-    control->accl_view.copy(one_buff, one.value, sizeof(T)*1);
-    control->accl_view.copy(&zero_buff, zero.value, sizeof(T)*1);
+    workspace_constants<T>(workspace, &one, &zero);
+    workspace_scalar<T>(workspace, 0, &norm_b);
+    workspace_scalar<T>(workspace, 1, &norm_r);
+    workspace_scalar<T>(workspace, 2, &r_star_r[0]);
+    workspace_scalar<T>(workspace, 3, &r_star_r[1]);
+    workspace_scalar<T>(workspace, 4, &r_star_AMp);
+    workspace_scalar<T>(workspace, 5, &AMsS);
+    workspace_scalar<T>(workspace, 6, &AMsAMs);
+    workspace_scalar<T>(workspace, 7, &norm_s);
 
-    one.offValue = 0;
-    zero.offValue = 0;
+    const SOLVER_NORM norm = solverControl->residualNorm;
 
-    // y = A * x
-    status = csrmv<T>(&one, pA, pX, &zero, &y, control);
+    //norm of rhs of equation
+    status = fused_blas1_norm<T>(N, fused_nop(), fused_nop(),
+                                 norm, &norm_b, fused_vec<T>(pB),
+                                 fused_nop(), control);
 
-#if 0
-#ifndef NDEBUG
-    float *x_h = (float *)calloc(N, sizeof(T));
-    int *Arow = (int *)calloc(pA->num_rows+1, sizeof(int));
-    int *Acol = (int *)calloc(pA->num_nonzeros, sizeof(int));
-    T *Aval = (T *)calloc(pA->num_nonzeros, sizeof(T));
-    float *y_h = (float *)calloc(N, sizeof(T));
-    control->accl_view.copy(pX->values, x_h, N*sizeof(T));
-    control->accl_view.copy(pA->values, Aval, pA->num_nonzeros*sizeof(T));
-    control->accl_view.copy(pA->rowOffsets, Arow, (pA->num_rows+1)*sizeof(int));
-    control->accl_view.copy(pA->colIndices, Acol, pA->num_nonzeros*sizeof(int));
-    for (int i = 0; i < N ; i++) 
-      std::cout << i << " x_h : " << x_h[i] << std::endl;
-    for (int i = 0; i < pA->num_nonzeros ; i++) 
-      std::cout << i << " val : " << Aval[i] << " col : " << Acol[i] << std::endl;
-#endif
-#endif
+    //norm_b is calculated once
+    T h_norm_b = 0;
+    control->accl_view.copy(norm_b.value, &h_norm_b, sizeof(T)*1);
 
-    // r = b - y
-    status = elementwise_transform<T, EW_MINUS>(&r, pB, &y, control);
+    if (h_norm_b <= std::numeric_limits<T>::min())
+    {
+        solverControl->nIters = 0;
+        solverControl->absoluteTolerance = 0.0;
+        solverControl->relativeTolerance = 0.0;
+        //we can either fill the x with zeros or cpy b to x;
+        control->accl_view.copy(pB->values, pX->values, sizeof(T)*pX->num_values);
 
-#if 0
-#ifndef NDEBUG
-    float *r_h = (float *)calloc(N, sizeof(T));
-    float *B_h = (float *)calloc(N, sizeof(T));
-    control->accl_view.copy(r.values, r_h, N*sizeof(T));
-    control->accl_view.copy(y.values, y_h, N*sizeof(T));
-    control->accl_view.copy(pB->values, B_h, N*sizeof(T));
-    for (int i = 0; i < N ; i++) 
-      std::cout << i << " r_h : " << r_h[i] << " pB : " 
-                << B_h[i] << " y_h : " << y_h[i] << std::endl;
-#endif
-#endif
+        return hcsparseSuccess;
+    }
 
-    T *norm_r_buff = (T*) calloc(1, sizeof(T));
+    // y = A * x
+    status = csrmv<T>(&one, pA, pX, &zero, &y, control);
 
-    hcsparseScalar norm_r;
-    norm_r.value = am_alloc(sizeof(T)*1, acc, 0);
-    norm_r.offValue = 0;
+    // r = b - y
+    status = fused_blas1_norm<T>(N, fused_set(&r, fused_vec<T>(pB) - fused_vec<T>(&y)), fused_nop(),
+                                 norm, &norm_r, fused_vec<T>(&r),
+                                 fused_nop(), control);
 
-    status = Norm1<T>(&norm_r, &r, control);
-    control->accl_view.copy(norm_r.value, norm_r_buff, sizeof(T)*1);
-    T *residuum_buff = (T*) calloc(1, sizeof(T));
-    residuum_buff[0] = (T)(norm_r_buff[0] / norm_b_buff[0]);
+    T h_norm_r = 0;
+    control->accl_view.copy(norm_r.value, &h_norm_r, sizeof(T)*1);
+    T residuum = (T)(h_norm_r / h_norm_b);
 
-    solverControl->initialResidual = residuum_buff[0];
+    solverControl->initialResidual = residuum;
 
 #ifndef NDEBUG
     std::cout << "initial residuum = "
@@ -177,67 +131,21 @@ bicgStab(hcdenseVector *pX,
     //Choose an arbitrary vector r̂0 such that (r̂0, r0) ≠ 0, e.g., r̂0 = r0
     control->accl_view.copy(r.values, r_star.values, sizeof(T)*N);
 
-    // holder for <r_star, r>
-    T *r_star_r_old_buff = (T*) calloc(1, sizeof(T));
-    hcsparseScalar r_star_r_old;
-    r_star_r_old.value = am_alloc(sizeof(T)*1, acc, 0); // &av_r_star_r_old;
-    r_star_r_old.offValue = 0;
-
-    // holder for <r_star, r_{i+1}>
-    T *r_star_r_new_buff = (T*) calloc(1, sizeof(T));
-    hcsparseScalar r_star_r_new;
-    r_star_r_new.value = am_alloc(sizeof(T)*1, acc, 0); //&av_r_star_r_new;
-    r_star_r_new.offValue = 0;
-
-    status = dot<T>(&r_star_r_old, &r_star, &r, control);
-    control->accl_view.copy(r_star_r_old.value, r_star_r_old_buff, sizeof(T)*1);
+    status = dot<T>(&r_star_r[0], &r_star, &r, control);
 
     int iteration = 0;
-    bool converged = false;
-
-    T *alpha_buff = (T*) calloc(1, sizeof(T));
-    T *beta_buff = (T*) calloc(1, sizeof(T));
-    T *omega_buff = (T*) calloc(1, sizeof(T));
-
-    hcsparseScalar alpha;
-    hcsparseScalar beta;
-    hcsparseScalar omega;
-
-    alpha.value = am_alloc(sizeof(T)*1, acc, 0); //&av_alpha;
-    alpha.offValue = 0;
-  
-    beta.value = am_alloc(sizeof(T)*1, acc, 0); //&av_beta;
-    beta.offValue = 0;
-    
-    omega.value = am_alloc(sizeof(T)*1, acc, 0); //&av_omega;
-    omega.offValue = 0;
-
-    // holder for <r_star, AMp>
-    T *r_star_AMp_buff = (T*) calloc(1, sizeof(T));
-    hcsparseScalar r_star_AMp;
-    r_star_AMp.value = am_alloc(sizeof(T)*1, acc, 0); //&av_r_star_AMp;
-    r_star_AMp.offValue = 0;
-
-    // hoder for <A*M*s, s>
-    T *AMsS_buff = (T*) calloc(1, sizeof(T));
-    hcsparseScalar AMsS;
-    AMsS.value = am_alloc(sizeof(T)*1, acc, 0); //&av_AMsS;
-    AMsS.offValue = 0;
-
-    // holder for <AMs, AMs>
-    T *AMsAMs_buff = (T*) calloc(1, sizeof(T));
-    hcsparseScalar AMsAMs;
-    AMsAMs.value = am_alloc(sizeof(T)*1, acc, 0); //&av_AMsAMs;
-    AMsAMs.offValue = 0;
 
-    // holder for norm_s;
-    T *norm_s_buff = (T*) calloc(1, sizeof(T));
-    hcsparseScalar norm_s;
-    norm_s.value = am_alloc(sizeof(T)*1, acc, 0); //&av_norm_s;
-    norm_s.offValue = 0;
+    T h_norm_s = 0;
 
-    while (!converged)
+    // alpha, omega and beta stay on the device: they are evaluated inside
+    // the kernels that use them from the dot products they are made of, and
+    // the host only reads a residual norm when a convergence test is due.
+    while (true)
     {
+        hcsparseScalar *r_star_r_old = &r_star_r[iteration % 2];
+        hcsparseScalar *r_star_r_new = &r_star_r[(iteration + 1) % 2];
+        bool check = solverControl->checkDue(iteration + 1);
+
         //Mp = M*p //apply preconditioner
         M(&p, &Mp, control);
 
@@ -246,25 +154,35 @@ bicgStab(hcdenseVector *pX,
 
         //<r_star, A*M*p>
         status = dot<T>(&r_star_AMp, &r_star, &AMp, control);
-        control->accl_view.copy(r_star_AMp.value, r_star_AMp_buff, sizeof(T)*1);
-
-        alpha_buff[0] = div<T>(r_star_r_old_buff[0], r_star_AMp_buff[0]);
-        control->accl_view.copy(alpha_buff, alpha.value, sizeof(T)*1);
 
-        //s_j = r - alpha*Mp
-        status = axpby<T, EW_MINUS>(&s, &one, &r, &alpha, &AMp, control);
+        // alpha = <r_star, r> / <r_star, A*M*p>
+        auto alpha = fused_scal<T>(r_star_r_old) / fused_scal<T>(&r_star_AMp);
 
-        status = Norm1<T>(&norm_s, &s, control);
-        control->accl_view.copy(norm_s.value, norm_s_buff, sizeof(T)*1);
+        //s_j = r - alpha*AMp; norm_s = |s_j|
+        status = fused_blas1_norm<T>(N,
+                                     fused_set(&s, fused_vec<T>(&r) - alpha * fused_vec<T>(&AMp)),
+                                     fused_nop(),
+                                     norm, &norm_s, fused_vec<T>(&s),
+                                     fused_nop(), control);
 
-        residuum_buff[0] = div<T>(norm_s_buff[0], norm_b_buff[0]);
-
-        if (solverControl->finished(residuum_buff[0]))
+        if (check)
         {
-            solverControl->nIters = iteration;
-            //x = x + alpha * M*p_j;
-            status = axpby<T>(pX, &one, pX, &alpha, &Mp, control);
-            break;
+            control->accl_view.copy(norm_s.value, &h_norm_s, sizeof(T)*1);
+
+            residuum = div<T>(h_norm_s, h_norm_b);
+
+            if (solverControl->converged(residuum))
+            {
+                solverControl->nIters = iteration;
+                //x = x + alpha * M*p_j;
+                status = fused_blas1<T>(N,
+                                        fused_add(pX, alpha * fused_vec<T>(&Mp)),
+                                        fused_nop(),
+                                        fused_nop(),
+                                        fused_nop(),
+                                        control);
+                break;
+            }
         }
 
         //Ms = M*s
@@ -273,98 +191,55 @@ bicgStab(hcdenseVector *pX,
         //AMs = A*Ms
         status = csrmv<T>(&one, pA, &Ms, &zero, &AMs, control);
 
-        status = dot<T>(&AMsS, &AMs, &s, control);
-
-        status = dot<T> (&AMsAMs, &AMs, &AMs, control);
-        control->accl_view.copy(AMsS.value, AMsS_buff, sizeof(T)*1);
-        control->accl_view.copy(AMsAMs.value, AMsAMs_buff, sizeof(T)*1);
-        omega_buff[0] = div(AMsS_buff[0], AMsAMs_buff[0]);
-        control->accl_view.copy(omega_buff, omega.value, sizeof(T)*1);
+        status = fused_blas1<T>(N,
+                                fused_nop(),
+                                fused_nop(),
+                                fused_dot(&AMsS, fused_vec<T>(&AMs), fused_vec<T>(&s)),
+                                fused_dot(&AMsAMs, fused_vec<T>(&AMs), fused_vec<T>(&AMs)),
+                                control);
+
+        // omega = <A*M*s, s> / <A*M*s, A*M*s>
+        auto omega = fused_scal<T>(&AMsS) / fused_scal<T>(&AMsAMs);
+
+        //x = x + alpha*Mp + omega*Ms; r = s - omega * A*M*s;
+        //norm_r = |r| and <r_star, r+1> in one pass
+        status = fused_blas1_norm<T>(N,
+                                     fused_add(pX, alpha * fused_vec<T>(&Mp) +
+                                                   omega * fused_vec<T>(&Ms)),
+                                     fused_set(&r, fused_vec<T>(&s) - omega * fused_vec<T>(&AMs)),
+                                     norm, &norm_r, fused_vec<T>(&r),
+                                     fused_dot(r_star_r_new, fused_vec<T>(&r_star), fused_vec<T>(&r)),
+                                     control);
 
-#ifndef NDEBUG
-        if(omega_buff[0] == 0)
-            std::cout << "omega = 0" ;
-#endif
-
-        //x = x + alpha*Mp + omega*Ms;
-        status = axpy<T>(pX, &alpha, &Mp, pX, control);
+        iteration++;
+        solverControl->nIters = iteration;
 
-        status = axpy<T>(pX, &omega, &Ms, pX, control);
+        if (check)
+        {
+            control->accl_view.copy(norm_r.value, &h_norm_r, sizeof(T)*1);
+            residuum = div<T>(h_norm_r, h_norm_b);
 
-        // r = s - omega * A*M*s
-        status = axpy<T, EW_MINUS>(&r, &omega, &AMs, &s, control);
+            bool finished = solverControl->finished(residuum);
 
-        status = Norm1<T>(&norm_r, &r, control);
-        control->accl_view.copy(norm_r.value, norm_r_buff, sizeof(T)*1);
-        residuum_buff[0] = div<T>(norm_r_buff[0], norm_b_buff[0]);
+            solverControl->print();
 
-        if (solverControl->finished(residuum_buff[0]))
-        {
-            solverControl->nIters = iteration;
-            break;
+            if (finished)
+                break;
         }
 
         //beta = <r_star, r+1> / <r_star, r> * (alpha/omega)
-        status = dot<T>(&r_star_r_new, &r_star, &r, control);
-        control->accl_view.copy(r_star_r_new.value, r_star_r_new_buff, sizeof(T)*1);
-
-        //TODO:: is it the best order?
-        beta_buff[0] = div<T>(r_star_r_new_buff[0], r_star_r_old_buff[0]);
-        beta_buff[0] = multi<T>(beta_buff[0], alpha_buff[0]);
-        beta_buff[0] = div<T>(beta_buff[0], omega_buff[0]);
-        control->accl_view.copy(beta_buff, beta.value, sizeof(T)*1);
-
-        r_star_r_old_buff[0] = r_star_r_new_buff[0];
-        control->accl_view.copy(r_star_r_new.value, r_star_r_old.value, sizeof(T)*1);
+        auto beta = (fused_scal<T>(r_star_r_new) / fused_scal<T>(r_star_r_old)) * (alpha / omega);
 
         //p = r + beta* (p - omega A*M*p);
-        status = axpy<T>(&p, &beta, &p, &r, control); // p = beta * p + r;
-        beta_buff[0] = multi<T>(beta_buff[0], omega_buff[0]);  // (beta*omega)
-        control->accl_view.copy(beta_buff, beta.value, sizeof(T)*1);
-        status = axpy<T,EW_MINUS>(&p, &beta, &AMp, &p, control);  // p = p - beta*omega*AMp;
-
-        iteration++;
-        solverControl->nIters = iteration;
-
-        solverControl->print();
+        status = fused_blas1<T>(N,
+                                fused_set(&p, fused_vec<T>(&r) + beta *
+                                              (fused_vec<T>(&p) - omega * fused_vec<T>(&AMp))),
+                                fused_nop(),
+                                fused_nop(),
+                                fused_nop(),
+                                control);
     }
 
-    am_free(norm_b.value);
-    free(norm_b_buff);
-    am_free(y.values);
-    am_free(p.values);
-    am_free(r.values);
-    am_free(r_star.values);
-    am_free(s.values);
-    am_free(Mp.values);
-    am_free(AMp.values);
-    am_free(Ms.values);
-    am_free(AMs.values);
-    am_free(one.value);
-    am_free(zero.value);
-    free(one_buff);
-    am_free(norm_r.value);
-    free(norm_r_buff);
-    free(residuum_buff);
-    am_free(r_star_r_old.value);
-    free(r_star_r_old_buff);
-    am_free(r_star_r_new.value);
-    free(r_star_r_new_buff);
-    free(alpha_buff);
-    free(beta_buff);
-    free(omega_buff);
-    am_free(alpha.value);
-    am_free(beta.value);
-    am_free(omega.value);
-    am_free(r_star_AMp.value);
-    am_free(AMsS.value);
-    am_free(AMsAMs.value);
-    am_free(norm_s.value);
-    free(r_star_AMp_buff);
-    free(AMsS_buff);
-    free(AMsAMs_buff);
-    free(norm_s_buff);
-
     return hcsparseSuccess;
 }
 
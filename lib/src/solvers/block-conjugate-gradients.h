@@ -0,0 +1,547 @@
+#ifndef _HCSPARSE_SOLVER_BLOCK_CG_H_
+#define _HCSPARSE_SOLVER_BLOCK_CG_H_
+
+#include "hcsparse.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+// right hand sides iterated together, wider blocks are solved in groups
+#define BCG_MAX_COLUMNS 64
+// work blocks of n x s values: R, Z, P and A*P
+#define BCG_WORK_VECTORS 4
+// rows staged in tile memory per step of the Gram kernel
+#define BCG_CHUNK_ROWS 8
+// tiles of the Gram kernel, each one produces a partial s x s product
+#define BCG_GRAM_BLOCKS 64
+// entries of the s x s product accumulated by each thread
+#define BCG_GRAM_PER_THREAD (BCG_MAX_COLUMNS * BCG_MAX_COLUMNS / BLOCK_SIZE)
+
+// Out[:, j] = A * In[:, cols[j]] for the s columns of In (or Out -= A * In
+// when SUB is set). The s threads of a row are neighbours, so every row of
+// A is fetched once per call whatever the number of columns.
+template <typename T, bool SUB>
+void
+bcg_spmm (const hcsparseCsrMatrix* pA,
+          const int s,
+          const T *In,
+          const long ldin,
+          const int *cols,
+          T *Out,
+          const long ldout,
+          hcsparseControl *control)
+{
+    const long n = pA->num_rows;
+    const int *rowOff = static_cast<const int*>(pA->rowOffsets) + pA->offRowOff;
+    const int *colInd = static_cast<const int*>(pA->colIndices) + pA->offColInd;
+    const T *vals = static_cast<const T*>(pA->values) + pA->offValues;
+    const long total = n * s;
+
+    hc::extent<1> grdExt(BLOCK_SIZE * ((total - 1)/BLOCK_SIZE + 1));
+    hc::tiled_extent<1> t_ext = grdExt.tile(BLOCK_SIZE);
+    hc::parallel_for_each(control->accl_view, t_ext, [=] (hc::tiled_index<1>& tidx) [[hc]]
+    {
+        long id = tidx.global[0];
+        if (id < total)
+        {
+            long row = id / s;
+            int j = id % s;
+            const T *in = In + (cols == nullptr ? j : cols[j]) * ldin;
+
+            T sum = 0;
+            for (int p = rowOff[row]; p < rowOff[row + 1]; p++)
+                sum += vals[p] * in[colInd[p]];
+
+            if (SUB)
+                Out[row + j * ldout] -= sum;
+            else
+                Out[row + j * ldout] = sum;
+        }
+    }).wait();
+}
+
+// G[i + j*s] = <U_i, V_j> for the s columns of U and V (stride n). Every
+// tile stages BCG_CHUNK_ROWS rows of both blocks in tile memory and keeps
+// its share of the s x s product in registers; a second kernel sums the
+// per tile products.
+template <typename T>
+void
+bcg_gram (const int s,
+          const T *U,
+          const T *V,
+          const long n,
+          T *G,
+          hcsparseControl *control)
+{
+    const long chunks = (n - 1) / BCG_CHUNK_ROWS + 1;
+    const int NB = chunks < BCG_GRAM_BLOCKS ? (int)chunks : BCG_GRAM_BLOCKS;
+    const int ss = s * s;
+
+    char *scratch = (char*) reduce_get_scratch(sizeof(T) * ss * NB, control);
+    T *partial = (T*) (scratch + REDUCE_PARTIAL_OFFSET);
+
+    hc::extent<1> grdExt(NB * BLOCK_SIZE);
+    hc::tiled_extent<1> t_ext = grdExt.tile(BLOCK_SIZE);
+    hc::parallel_for_each(control->accl_view, t_ext, [=] (hc::tiled_index<1>& tidx) [[hc]]
+    {
+        tile_static T su[BCG_MAX_COLUMNS * BCG_CHUNK_ROWS];
+        tile_static T sv[BCG_MAX_COLUMNS * BCG_CHUNK_ROWS];
+        const int lid = tidx.local[0];
+        const int block = tidx.tile[0];
+        T acc[BCG_GRAM_PER_THREAD];
+
+        for (int q = 0; q < BCG_GRAM_PER_THREAD; q++)
+            acc[q] = 0;
+
+        for (long r0 = (long)block * BCG_CHUNK_ROWS; r0 < n; r0 += (long)NB * BCG_CHUNK_ROWS)
+        {
+            for (int e = lid; e < s * BCG_CHUNK_ROWS; e += BLOCK_SIZE)
+            {
+                int r = e % BCG_CHUNK_ROWS;
+                int c = e / BCG_CHUNK_ROWS;
+                bool in = r0 + r < n;
+                su[e] = in ? U[r0 + r + c * n] : 0;
+                sv[e] = in ? V[r0 + r + c * n] : 0;
+            }
+            tidx.barrier.wait();
+
+            for (int q = 0; q < BCG_GRAM_PER_THREAD; q++)
+            {
+                int p = lid + q * BLOCK_SIZE;
+                if (p < ss)
+                {
+                    const T *u = su + (p % s) * BCG_CHUNK_ROWS;
+                    const T *v = sv + (p / s) * BCG_CHUNK_ROWS;
+                    T sum = 0;
+                    for (int r = 0; r < BCG_CHUNK_ROWS; r++)
+                        sum += u[r] * v[r];
+                    acc[q] += sum;
+                }
+            }
+            tidx.barrier.wait();
+        }
+
+        for (int q = 0; q < BCG_GRAM_PER_THREAD; q++)
+        {
+            int p = lid + q * BLOCK_SIZE;
+            if (p < ss)
+                partial[block * ss + p] = acc[q];
+        }
+    }).wait();
+
+    hc::extent<1> grdExt_sum(BLOCK_SIZE * ((ss - 1)/BLOCK_SIZE + 1));
+    hc::tiled_extent<1> t_ext_sum = grdExt_sum.tile(BLOCK_SIZE);
+    hc::parallel_for_each(control->accl_view, t_ext_sum, [=] (hc::tiled_index<1>& tidx) [[hc]]
+    {
+        int p = tidx.global[0];
+        if (p < ss)
+        {
+            T sum = 0;
+            for (int b = 0; b < NB; b++)
+                sum += partial[b * ss + p];
+            G[p] = sum;
+        }
+    }).wait();
+}
+
+// d[c] = <U_c, U_c> for the s columns of U (stride ldu), two kernels as
+// block_dot
+template <typename T>
+void
+bcg_column_norm2 (const int s,
+                  const T *U,
+                  const long ldu,
+                  const long n,
+                  T *d,
+                  hcsparseControl *control)
+{
+    const int NB = reduce_num_blocks(n);
+
+    char *scratch = (char*) reduce_get_scratch(sizeof(T) * s * NB, control);
+    T *partial = (T*) (scratch + REDUCE_PARTIAL_OFFSET);
+
+    hc::extent<1> grdExt(s * NB * BLOCK_SIZE);
+    hc::tiled_extent<1> t_ext = grdExt.tile(BLOCK_SIZE);
+    hc::parallel_for_each(control->accl_view, t_ext, [=] (hc::tiled_index<1>& tidx) [[hc]]
+    {
+        tile_static T buf_tmp[BLOCK_SIZE];
+        int col = tidx.tile[0] / NB;
+        int block = tidx.tile[0] % NB;
+        const T *u = U + col * ldu;
+        T sum = 0;
+
+        for (long i = block * BLOCK_SIZE + tidx.local[0]; i < n; i += NB * BLOCK_SIZE)
+            sum += u[i] * u[i];
+
+        sum = tile_reduce<T>(sum, buf_tmp, tidx);
+        if (tidx.local[0] == 0)
+            partial[col * NB + block] = sum;
+    }).wait();
+
+    hc::extent<1> grdExt_sum(s * BLOCK_SIZE);
+    hc::tiled_extent<1> t_ext_sum = grdExt_sum.tile(BLOCK_SIZE);
+    hc::parallel_for_each(control->accl_view, t_ext_sum, [=] (hc::tiled_index<1>& tidx) [[hc]]
+    {
+        tile_static T buf_tmp[BLOCK_SIZE];
+        int col = tidx.tile[0];
+        T sum = 0;
+
+        for (int b = tidx.local[0]; b < NB; b += BLOCK_SIZE)
+            sum += partial[col * NB + b];
+
+        sum = tile_reduce<T>(sum, buf_tmp, tidx);
+        if (tidx.local[0] == 0)
+            d[col] = sum;
+    }).wait();
+}
+
+// Y[:, cols[j]] = W[:, j] + sign * (V C)[:, j] for the s columns of Y, V
+// having k columns and C being the k x s column major matrix coef. W is Y
+// itself when it is nullptr and cols the identity when it is nullptr; with
+// ASSIGN set Y = sign * (V C) instead.
+template <typename T, bool ASSIGN = false>
+void
+bcg_update (const long n,
+            const int k,
+            const int s,
+            const T *V,
+            const T *coef,
+            const T *W,
+            const T sign,
+            T *Y,
+            const long ldy,
+            const int *cols,
+            hcsparseControl *control)
+{
+    const long total = n * s;
+
+    hc::extent<1> grdExt(BLOCK_SIZE * ((total - 1)/BLOCK_SIZE + 1));
+    hc::tiled_extent<1> t_ext = grdExt.tile(BLOCK_SIZE);
+    hc::parallel_for_each(control->accl_view, t_ext, [=] (hc::tiled_index<1>& tidx) [[hc]]
+    {
+        long id = tidx.global[0];
+        if (id < total)
+        {
+            int j = id / n;
+            long row = id % n;
+            const T *c = coef + j * k;
+
+            T sum = 0;
+            for (int i = 0; i < k; i++)
+                sum += V[row + i * n] * c[i];
+
+            T *y = Y + row + (cols == nullptr ? j : cols[j]) * ldy;
+            if (ASSIGN)
+                *y = sign * sum;
+            else
+                *y = (W == nullptr ? *y : W[row + j * n]) + sign * sum;
+        }
+    }).wait();
+}
+
+// C = G^{-1} C for the s x s column major G and C, LU with partial
+// pivoting on the host. Rows with a zero pivot give zero coefficients,
+// which drops dependent search directions.
+template <typename T>
+void
+bcg_host_solve (const int s,
+                std::vector<T> G,
+                std::vector<T> &C)
+{
+    for (int k = 0; k < s; k++)
+    {
+        int pk = k;
+        for (int i = k + 1; i < s; i++)
+            if (std::fabs(G[i + k * s]) > std::fabs(G[pk + k * s]))
+                pk = i;
+        if (pk != k)
+        {
+            for (int j = 0; j < s; j++)
+            {
+                std::swap(G[k + j * s], G[pk + j * s]);
+                std::swap(C[k + j * s], C[pk + j * s]);
+            }
+        }
+
+        T d = G[k + k * s];
+        for (int i = k + 1; i < s; i++)
+        {
+            T f = d == 0 ? 0 : G[i + k * s] / d;
+            for (int j = k + 1; j < s; j++)
+                G[i + j * s] -= f * G[k + j * s];
+            for (int j = 0; j < s; j++)
+                C[i + j * s] -= f * C[k + j * s];
+        }
+    }
+
+    for (int j = 0; j < s; j++)
+    {
+        for (int i = s - 1; i >= 0; i--)
+        {
+            T sum = C[i + j * s];
+            for (int k = i + 1; k < s; k++)
+                sum -= G[i + k * s] * C[k + j * s];
+            T d = G[i + i * s];
+            C[i + j * s] = d == 0 ? 0 : sum / d;
+        }
+    }
+}
+
+/*
+ * Block preconditioned CG (O'Leary, 1980) on at most BCG_MAX_COLUMNS right
+ * hand sides, X and B are column major with strides ldx and ldb.
+ * The columns still iterating are kept packed in the first s slots of the
+ * work blocks; a column whose residual meets the tolerance is deflated,
+ * the remaining slots move down and the small matrices shrink with them.
+ */
+template<typename T, typename PTYPE>
+hcsparseStatus
+bcg_columns (T *X,
+             const long ldx,
+             const T *B,
+             const long ldb,
+             const int numRhs,
+             const hcsparseCsrMatrix* pA,
+             PTYPE& M,
+             hcsparseSolverControl *solverControl,
+             hcsparseSolverWorkspace *workspace,
+             hcsparseControl *control)
+{
+    const long N = pA->num_rows;
+    hcsparseStatus status;
+
+    status = workspace_reserve<T>(workspace, BCG_WORK_VECTORS * numRhs,
+                                  2 * numRhs * numRhs + numRhs, control);
+    if (status != hcsparseSuccess)
+    {
+        return hcsparseInvalid;
+    }
+
+    T *R = static_cast<T*>(workspace->vectors);
+    T *Z = R + numRhs * N;
+    T *P = Z + numRhs * N;
+    T *Q = P + numRhs * N;
+
+    hcsparseScalar first;
+    workspace_scalar<T>(workspace, 0, &first);
+    T *coef = static_cast<T*>(first.value);
+    T *gram = coef + numRhs * numRhs;
+    T *norms = gram + numRhs * numRhs;
+
+    // norms of the right hand sides, zero ones are solved by x = 0
+    std::vector<T> h_norm_b(numRhs);
+    bcg_column_norm2<T>(numRhs, B, ldb, N, norms, control);
+    control->accl_view.copy(norms, h_norm_b.data(), sizeof(T) * numRhs);
+
+    std::vector<int> h_cols;
+    std::vector<T> zeros;
+    for (int c = 0; c < numRhs; c++)
+    {
+        h_norm_b[c] = std::sqrt(h_norm_b[c]);
+        if (h_norm_b[c] > 0)
+        {
+            h_cols.push_back(c);
+        }
+        else
+        {
+            zeros.resize(N, 0);
+            control->accl_view.copy(zeros.data(), X + c * ldx, sizeof(T) * N);
+        }
+    }
+
+    solverControl->nIters = 0;
+    solverControl->initialResidual = 0;
+    solverControl->currentResidual = 0;
+
+    int s = h_cols.size();
+    if (s == 0)
+    {
+        return hcsparseSuccess;
+    }
+
+    hc::accelerator acc = (control->accl_view).get_accelerator();
+    int *cols = (int*) am_alloc(sizeof(int) * numRhs, acc, 0);
+    control->accl_view.copy(h_cols.data(), cols, sizeof(int) * s);
+
+    // R = B - A X
+    for (int j = 0; j < s; j++)
+        control->accl_view.copy(B + h_cols[j] * ldb, R + j * N, sizeof(T) * N);
+    bcg_spmm<T, true>(pA, s, X, ldx, cols, R, N, control);
+
+    std::vector<T> h_norm_r(s);
+    std::vector<T> h_initial(numRhs, 0);
+    std::vector<T> h_rz(s * s);
+    std::vector<T> h_coef(s * s);
+    std::vector<T> h_gram(s * s);
+
+    bool first_check = true;
+    int iteration = 0;
+
+    while (true)
+    {
+        if (first_check || solverControl->checkDue(iteration))
+        {
+            // per column residuals, converged columns are deflated
+            bcg_column_norm2<T>(s, R, N, N, norms, control);
+            control->accl_view.copy(norms, h_norm_r.data(), sizeof(T) * s);
+
+            std::vector<int> keep;
+            T current = 0;
+            for (int j = 0; j < s; j++)
+            {
+                int c = h_cols[j];
+                T residuum = div<T>(std::sqrt(h_norm_r[j]), h_norm_b[c]);
+                if (first_check)
+                {
+                    h_initial[c] = residuum;
+                    solverControl->initialResidual =
+                        std::max(solverControl->initialResidual, (double)residuum);
+                }
+                if (residuum > solverControl->relativeTolerance &&
+                    residuum > solverControl->absoluteTolerance * h_initial[c])
+                {
+                    keep.push_back(j);
+                    current = std::max(current, residuum);
+                }
+            }
+            solverControl->currentResidual = current;
+            if (!first_check)
+                solverControl->print();
+
+            if (keep.empty() || iteration >= solverControl->maxIters)
+                break;
+
+            if ((int)keep.size() < s)
+            {
+                int s_new = keep.size();
+                std::vector<int> cols_new(s_new);
+                std::vector<T> rz_new(s_new * s_new);
+                for (int jn = 0; jn < s_new; jn++)
+                {
+                    int j = keep[jn];
+                    cols_new[jn] = h_cols[j];
+                    for (int in = 0; in < s_new; in++)
+                        rz_new[in + jn * s_new] = h_rz[keep[in] + j * s];
+                    if (j != jn)
+                    {
+                        control->accl_view.copy(R + j * N, R + jn * N, sizeof(T) * N);
+                        control->accl_view.copy(P + j * N, P + jn * N, sizeof(T) * N);
+                    }
+                }
+                s = s_new;
+                h_cols = cols_new;
+                h_rz = rz_new;
+                control->accl_view.copy(h_cols.data(), cols, sizeof(int) * s);
+            }
+        }
+
+        // Z = M R, one column at a time through the preconditioner
+        for (int j = 0; j < s; j++)
+        {
+            hcdenseVector r, z;
+            r.values = R + j * N;
+            r.num_values = N;
+            r.offValues = 0;
+            z.values = Z + j * N;
+            z.num_values = N;
+            z.offValues = 0;
+            M(&r, &z, control);
+        }
+
+        bcg_gram<T>(s, R, Z, N, gram, control);
+        h_gram.resize(s * s);
+        control->accl_view.copy(gram, h_gram.data(), sizeof(T) * s * s);
+
+        if (first_check)
+        {
+            // P = Z
+            control->accl_view.copy(Z, P, sizeof(T) * s * N);
+            first_check = false;
+        }
+        else
+        {
+            // beta = (R^T Z)_old^{-1} (R^T Z); P = Z + P beta
+            h_coef = h_gram;
+            bcg_host_solve<T>(s, h_rz, h_coef);
+            control->accl_view.copy(h_coef.data(), coef, sizeof(T) * s * s);
+            bcg_update<T>(N, s, s, P, coef, Z, 1, Q, N, nullptr, control);
+            std::swap(P, Q);
+        }
+        h_rz = h_gram;
+
+        // Q = A P, all columns in one pass over A
+        bcg_spmm<T, false>(pA, s, P, N, nullptr, Q, N, control);
+
+        // alpha = (P^T A P)^{-1} (R^T Z)
+        bcg_gram<T>(s, P, Q, N, gram, control);
+        control->accl_view.copy(gram, h_gram.data(), sizeof(T) * s * s);
+        h_coef = h_rz;
+        bcg_host_solve<T>(s, h_gram, h_coef);
+        control->accl_view.copy(h_coef.data(), coef, sizeof(T) * s * s);
+
+        // X = X + P alpha; R = R - Q alpha
+        bcg_update<T>(N, s, s, P, coef, nullptr, 1, X, ldx, cols, control);
+        bcg_update<T>(N, s, s, Q, coef, nullptr, -1, R, N, nullptr, control);
+
+        iteration++;
+        solverControl->nIters = iteration;
+    }
+
+    am_free(cols);
+
+    return hcsparseSuccess;
+}
+
+// Solves A X = B for all columns of B, BCG_MAX_COLUMNS at a time. The
+// summary in solverControl is the worst over all columns.
+template<typename T, typename PTYPE>
+hcsparseStatus
+bcg (hcdenseMatrix *pX,
+     const hcsparseCsrMatrix* pA,
+     const hcdenseMatrix *pB,
+     PTYPE& M,
+     hcsparseSolverControl *solverControl,
+     hcsparseSolverWorkspace *workspace,
+     hcsparseControl *control)
+{
+    if (pX->major != columnMajor || pB->major != columnMajor ||
+        pA->num_cols != pB->num_rows || pA->num_rows != pX->num_rows ||
+        pX->num_cols != pB->num_cols ||
+        pX->lead_dim < pX->num_rows || pB->lead_dim < pB->num_rows)
+    {
+        return hcsparseInvalid;
+    }
+
+    T *X = static_cast<T*>(pX->values) + pX->offValues;
+    const T *B = static_cast<const T*>(pB->values) + pB->offValues;
+    const long ldx = pX->lead_dim;
+    const long ldb = pB->lead_dim;
+
+    int nIters = 0;
+    double initialResidual = 0;
+    double currentResidual = 0;
+
+    for (size_t c = 0; c < pB->num_cols; c += BCG_MAX_COLUMNS)
+    {
+        int s = std::min((size_t)BCG_MAX_COLUMNS, pB->num_cols - c);
+
+        hcsparseStatus status = bcg_columns<T>(X + c * ldx, ldx, B + c * ldb, ldb, s,
+                                               pA, M, solverControl, workspace, control);
+        if (status != hcsparseSuccess)
+        {
+            return status;
+        }
+
+        nIters = std::max(nIters, solverControl->nIters);
+        initialResidual = std::max(initialResidual, solverControl->initialResidual);
+        currentResidual = std::max(currentResidual, solverControl->currentResidual);
+    }
+
+    solverControl->nIters = nIters;
+    solverControl->initialResidual = initialResidual;
+    solverControl->currentResidual = currentResidual;
+
+    return hcsparseSuccess;
+}
+
+#endif //_HCSPARSE_SOLVER_BLOCK_CG_H_
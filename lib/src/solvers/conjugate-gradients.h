@@ -3,6 +3,10 @@
 
 #include "hcsparse.h"
 
+// work vectors and scalars used by cg inside a hcsparseSolverWorkspace
+#define CG_WORK_VECTORS 4
+#define CG_WORK_SCALARS 5
+
 /*
  * Nice paper describing Conjugate Gradient algorithm can
  * be found here:
@@ -15,6 +19,7 @@ cg (hcdenseVector *pX,
     const hcdenseVector *pB,
     PTYPE& M,
     hcsparseSolverControl *solverControl,
+    hcsparseSolverWorkspace *workspace,
     hcsparseControl *control)
 {
 
@@ -25,24 +30,52 @@ cg (hcdenseVector *pX,
         return hcsparseInvalid;
     }
 
-    hc::accelerator acc = (control->accl_view).get_accelerator();
+    int status;
 
-    T *x = static_cast<T*>(pX->values);
-    T *b = static_cast<T*>(pB->values);
+    const auto N = pA->num_cols;
 
-    int status;
+    status = workspace_reserve<T>(workspace, CG_WORK_VECTORS, CG_WORK_SCALARS, control);
+    if (status != hcsparseSuccess)
+    {
+        return hcsparseInvalid;
+    }
+
+    //helper containers
+    hcdenseVector y;
+    hcdenseVector z;
+    hcdenseVector r;
+    hcdenseVector p;
 
-    T *norm_b_Buff = (T*) calloc(1, sizeof(T));
+    workspace_vector<T>(workspace, 0, &y);
+    workspace_vector<T>(workspace, 1, &z);
+    workspace_vector<T>(workspace, 2, &r);
+    workspace_vector<T>(workspace, 3, &p);
+
+    hcsparseScalar one;
+    hcsparseScalar zero;
     hcsparseScalar norm_b;
-    norm_b.value = am_alloc(sizeof(T)*1, acc, 0);
-    norm_b.offValue = 0;
+    hcsparseScalar norm_r;
+    hcsparseScalar yp;
+    // <r, z> of the current and the previous iteration, used alternately
+    hcsparseScalar rz[2];
+
+    workspace_constants<T>(workspace, &one, &zero);
+    workspace_scalar<T>(workspace, 0, &norm_b);
+    workspace_scalar<T>(workspace, 1, &norm_r);
+    workspace_scalar<T>(workspace, 2, &yp);
+    workspace_scalar<T>(workspace, 3, &rz[0]);
+    workspace_scalar<T>(workspace, 4, &rz[1]);
+
+    const SOLVER_NORM norm = solverControl->residualNorm;
 
     //norm of rhs of equation
-    status = Norm1<T>(&norm_b, pB, control);
-    control->accl_view.copy(norm_b.value, norm_b_Buff, sizeof(T)*1);
+    status = fused_blas1_norm<T>(N, fused_nop(), fused_nop(),
+                                 norm, &norm_b, fused_vec<T>(pB),
+                                 fused_nop(), control);
 
     //norm_b is calculated once
-    T h_norm_b = norm_b_Buff[0];
+    T h_norm_b = 0;
+    control->accl_view.copy(norm_b.value, &h_norm_b, sizeof(T)*1);
 
 #ifndef NDEBUG
     std::cout << "norm_b " << h_norm_b << std::endl;
@@ -54,77 +87,26 @@ cg (hcdenseVector *pX,
         solverControl->absoluteTolerance = 0.0;
         solverControl->relativeTolerance = 0.0;
         //we can either fill the x with zeros or cpy b to x;
-        for (int i = 0; i < pX->num_values; i++)
-            x[i] = b[i];
+        control->accl_view.copy(pB->values, pX->values, sizeof(T)*pX->num_values);
 
         return hcsparseSuccess;
     }
 
-
-    //continuing "normal" execution of cg algorithm
-    const auto N = pA->num_cols;
-
-    //helper containers, all need to be zeroed
-    T *y_Buff = (T*) calloc(N, sizeof(T));
-    T *z_Buff = (T*) calloc(N, sizeof(T));
-    T *r_Buff = (T*) calloc(N, sizeof(T));
-    T *p_Buff = (T*) calloc(N, sizeof(T));
-
-    hcdenseVector y;
-    hcdenseVector z;
-    hcdenseVector r;
-    hcdenseVector p;
-
-    y.values = am_alloc(sizeof(T)*N, acc, 0);
-    z.values = am_alloc(sizeof(T)*N, acc, 0);
-    r.values = am_alloc(sizeof(T)*N, acc, 0);
-    p.values = am_alloc(sizeof(T)*N, acc, 0);
- 
-    y.num_values = N;
-    z.num_values = N;
-    r.num_values = N;
-    p.num_values = N;
-
-    y.offValues = 0;
-    z.offValues = 0;
-    r.offValues = 0;
-    p.offValues = 0;
-
-    T *one_buff = (T*) calloc(1, sizeof(T));
-
-    one_buff[0] = 1;
-
-    hcsparseScalar one;
-    hcsparseScalar zero;
-
-    one.value = am_alloc(sizeof(T)*1, acc, 0);
-    zero.value = am_alloc(sizeof(T)*1, acc, 0);
-    control->accl_view.copy(one_buff, one.value, sizeof(T)*1);
-
-    one.offValue = 0;
-    zero.offValue = 0;
-
     // y = A*x
     status = csrmv<T>(&one, pA, pX, &zero, &y, control);
 
-    status = elementwise_transform<T, EW_MINUS>(&r, pB, &y, control);
+    // r = b - y
+    status = fused_blas1_norm<T>(N, fused_set(&r, fused_vec<T>(pB) - fused_vec<T>(&y)), fused_nop(),
+                                 norm, &norm_r, fused_vec<T>(&r),
+                                 fused_nop(), control);
 
-    T *norm_r_Buff = (T*) calloc(1, sizeof(T));
-
-    hcsparseScalar norm_r;
-    norm_r.value = am_alloc(sizeof(T)*1, acc, 0);
-    norm_r.offValue = 0;
-
-    status = Norm1<T>(&norm_r, &r, control);
-    control->accl_view.copy(norm_r.value, norm_r_Buff, sizeof(T)*1);
-
-    //T residuum = 0;
-    T *residuum_Buff = (T*) calloc(1, sizeof(T));
+    T h_norm_r = 0;
+    control->accl_view.copy(norm_r.value, &h_norm_r, sizeof(T)*1);
 
     //residuum = norm_r[0] / h_norm_b;
-    residuum_Buff[0] = div<T>(norm_r_Buff[0], norm_b_Buff[0]);
+    T residuum = div<T>(h_norm_r, h_norm_b);
 
-    solverControl->initialResidual = residuum_Buff[0];
+    solverControl->initialResidual = residuum;
 #ifndef NDEBUG
         std::cout << "initial residuum = "
                   << solverControl->initialResidual << std::endl;
@@ -141,127 +123,68 @@ cg (hcdenseVector *pX,
     control->accl_view.copy(z.values, p.values, sizeof(T)*N);
 
     //rz = <r, z>, here actually should be conjugate(r)) but we do not support complex type.
-    T *rz_Buff = (T*) calloc(1, sizeof(T));
-
-    hcsparseScalar rz;
-    rz.value = am_alloc(sizeof(T)*1, acc, 0);
-    rz.offValue = 0;
-
-    status = dot<T>(&rz, &r, &z, control);
-    control->accl_view.copy(rz.value, rz_Buff, sizeof(T)*1);
+    status = dot<T>(&rz[0], &r, &z, control);
 
     int iteration = 0;
 
     bool converged = false;
 
-    T *alpha_Buff = (T*) calloc(1, sizeof(T));
-    T *beta_Buff = (T*) calloc(1, sizeof(T));
-    T *yp_Buff = (T*) calloc(1, sizeof(T));
-    T *rz_old_Buff = (T*) calloc(1, sizeof(T));
-
-    hcsparseScalar alpha;
-    hcsparseScalar beta;
-    hcsparseScalar yp;
-    hcsparseScalar rz_old;
-
-    alpha.value = am_alloc(sizeof(T)*1, acc, 0);
-    beta.value = am_alloc(sizeof(T)*1, acc, 0);
-    yp.value = am_alloc(sizeof(T)*1, acc, 0);
-    rz_old.value = am_alloc(sizeof(T)*1, acc, 0);
-
-    alpha.offValue = 0;
-    beta.offValue = 0;
-    yp.offValue = 0;
-    rz_old.offValue = 0;
-
+    // alpha and beta stay on the device: they are evaluated inside the
+    // kernels that use them from the dot products they are made of, and the
+    // host only reads norm_r when a convergence test is due.
     while(!converged)
     {
-        solverControl->nIters = iteration;
+        hcsparseScalar *rz_cur = &rz[iteration % 2];
+        hcsparseScalar *rz_next = &rz[(iteration + 1) % 2];
 
         //y = A*p
         status = csrmv<T>(&one, pA, &p, &zero, &y, control);
 
         status = dot<T>(&yp, &y, &p, control);
-        control->accl_view.copy(yp.value, yp_Buff, sizeof(T)*1);
 
         // alpha = <r,z> / <y,p>
-        //alpha[0] = rz[0] / yp[0];
-        alpha_Buff[0] = div<T>(rz_Buff[0], yp_Buff[0]);
-        control->accl_view.copy(alpha_Buff, alpha.value, sizeof(T)*1);
-
-#ifndef NDEBUG
-            std::cout << "alpha = " << alpha_Buff[0] << std::endl;
-#endif
+        auto alpha = fused_scal<T>(rz_cur) / fused_scal<T>(&yp);
 
-        //x = x + alpha*p
-        status = axpy<T>(pX, &alpha, &p, pX, control);
-
-        //r = r - alpha * y;
-        status = axpy<T, EW_MINUS>(&r, &alpha, &y, &r, control);
+        //x = x + alpha*p; r = r - alpha * y; norm_r = |r| in one pass
+        status = fused_blas1_norm<T>(N,
+                                     fused_add(pX, alpha * fused_vec<T>(&p)),
+                                     fused_sub(&r, alpha * fused_vec<T>(&y)),
+                                     norm, &norm_r, fused_vec<T>(&r),
+                                     fused_nop(), control);
 
         //apply preconditioner z = M*r
         M(&r, &z, control);
 
-        //store old value of rz
-        //improve that by move or swap
-        rz_old_Buff[0] = rz_Buff[0];
-        control->accl_view.copy(rz.value, rz_old.value, sizeof(T)*1);
-
         //rz = <r,z>
-        status = dot<T>(&rz, &r, &z, control);
-        control->accl_view.copy(rz.value, rz_Buff, sizeof(T)*1);
+        status = dot<T>(rz_next, &r, &z, control);
 
         // beta = <r^(i), r^(i)>/<r^(i-1),r^(i-1)> // i: iteration index;
         // beta is ratio of dot product in current iteration compared
-        //beta[0] = rz[0] / rz_old[0];
-        beta_Buff[0] = div<T>(rz_Buff[0], rz_old_Buff[0]);
-#ifndef NDEBUG
-            std::cout << "beta = " << beta_Buff[0] << std::endl;
-#endif
+        auto beta = fused_scal<T>(rz_next) / fused_scal<T>(rz_cur);
 
         //p = z + beta*p;
-        control->accl_view.copy(beta_Buff, beta.value, sizeof(T)*1);
-        status = axpby<T>(&p, &one, &z, &beta, &p, control );
+        status = fused_blas1<T>(N,
+                                fused_set(&p, fused_vec<T>(&z) + beta * fused_vec<T>(&p)),
+                                fused_nop(),
+                                fused_nop(),
+                                fused_nop(),
+                                control);
 
-        //calculate norm of r
-        status = Norm1<T>(&norm_r, &r, control);
-        control->accl_view.copy(norm_r.value, norm_r_Buff, sizeof(T)*1);
+        iteration++;
+        solverControl->nIters = iteration;
 
-        //residuum = norm_r[0] / h_norm_b;
-        residuum_Buff[0] = div<T>(norm_r_Buff[0], norm_b_Buff[0]);
+        if (solverControl->checkDue(iteration))
+        {
+            control->accl_view.copy(norm_r.value, &h_norm_r, sizeof(T)*1);
 
-        iteration++;
-        converged = solverControl->finished(residuum_Buff[0]);
+            //residuum = norm_r[0] / h_norm_b;
+            residuum = div<T>(h_norm_r, h_norm_b);
 
-        solverControl->print();
-    }
+            converged = solverControl->finished(residuum);
 
-    am_free(norm_b.value); 
-    am_free(y.values); 
-    am_free(z.values); 
-    am_free(r.values); 
-    am_free(p.values); 
-    am_free(one.value);
-    am_free(zero.value);
-    am_free(norm_r.value);
-    am_free(rz.value);
-    am_free(alpha.value);
-    am_free(beta.value);
-    am_free(yp.value);
-    am_free(rz_old.value);
-    free(norm_b_Buff);
-    free(y_Buff);
-    free(z_Buff);
-    free(r_Buff);
-    free(p_Buff);
-    free(one_buff);
-    free(norm_r_Buff);
-    free(residuum_Buff);
-    free(rz_Buff);
-    free(alpha_Buff);
-    free(beta_Buff);
-    free(yp_Buff);
-    free(rz_old_Buff);
+            solverControl->print();
+        }
+    }
 
     return hcsparseSuccess;
 }
@@ -0,0 +1,195 @@
+#ifndef _HCSPARSE_DENSE_EIGEN_H_
+#define _HCSPARSE_DENSE_EIGEN_H_
+
+#include "hcsparse.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <vector>
+
+/* Host routines for the small dense Rayleigh-Ritz problems of the sparse
+   eigensolvers. Matrices are column major n x n, n being at most a few
+   dozen, and are processed in double precision whatever the device type.
+*/
+
+// relative pivot below which the Gram matrix of a basis counts as singular
+#define DENSE_EIG_CHOLESKY_TOL 1e-10
+#define DENSE_EIG_JACOBI_SWEEPS 50
+
+// Eigenvalues w (ascending) and eigenvectors V of the symmetric A, cyclic
+// Jacobi rotations. A is destroyed.
+inline void
+dense_sym_eig (const int n,
+               std::vector<double> &A,
+               std::vector<double> &w,
+               std::vector<double> &V)
+{
+    V.assign(n * n, 0);
+    for (int i = 0; i < n; i++)
+        V[i + i * n] = 1;
+
+    for (int sweep = 0; sweep < DENSE_EIG_JACOBI_SWEEPS; sweep++)
+    {
+        double off = 0, diag = 0;
+        for (int j = 0; j < n; j++)
+        {
+            diag += A[j + j * n] * A[j + j * n];
+            for (int i = 0; i < j; i++)
+                off += A[i + j * n] * A[i + j * n];
+        }
+        if (off <= 1e-30 * diag || off == 0)
+            break;
+
+        for (int p = 0; p < n - 1; p++)
+        {
+            for (int q = p + 1; q < n; q++)
+            {
+                double apq = A[p + q * n];
+                if (apq == 0)
+                    continue;
+
+                double theta = (A[q + q * n] - A[p + p * n]) / (2 * apq);
+                double t = (theta >= 0 ? 1 : -1) / (std::fabs(theta) + std::sqrt(theta * theta + 1));
+                double c = 1 / std::sqrt(t * t + 1);
+                double s = t * c;
+
+                for (int k = 0; k < n; k++)
+                {
+                    double akp = A[k + p * n];
+                    double akq = A[k + q * n];
+                    A[k + p * n] = c * akp - s * akq;
+                    A[k + q * n] = s * akp + c * akq;
+                }
+                for (int k = 0; k < n; k++)
+                {
+                    double apk = A[p + k * n];
+                    double aqk = A[q + k * n];
+                    A[p + k * n] = c * apk - s * aqk;
+                    A[q + k * n] = s * apk + c * aqk;
+                }
+                for (int k = 0; k < n; k++)
+                {
+                    double vkp = V[k + p * n];
+                    double vkq = V[k + q * n];
+                    V[k + p * n] = c * vkp - s * vkq;
+                    V[k + q * n] = s * vkp + c * vkq;
+                }
+            }
+        }
+    }
+
+    std::vector<int> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(),
+              [&] (int a, int b) { return A[a + a * n] < A[b + b * n]; });
+
+    std::vector<double> V_sorted(n * n);
+    w.resize(n);
+    for (int j = 0; j < n; j++)
+    {
+        w[j] = A[order[j] + order[j] * n];
+        std::copy(V.begin() + order[j] * n, V.begin() + (order[j] + 1) * n,
+                  V_sorted.begin() + j * n);
+    }
+    V = V_sorted;
+}
+
+// In place lower Cholesky factor of the SPD G; false when a pivot falls
+// below DENSE_EIG_CHOLESKY_TOL times the largest diagonal entry.
+inline bool
+dense_cholesky (const int n,
+                std::vector<double> &G)
+{
+    double dmax = 0;
+    for (int i = 0; i < n; i++)
+        dmax = std::max(dmax, G[i + i * n]);
+
+    for (int j = 0; j < n; j++)
+    {
+        double d = G[j + j * n];
+        for (int k = 0; k < j; k++)
+            d -= G[j + k * n] * G[j + k * n];
+        if (!(d > DENSE_EIG_CHOLESKY_TOL * dmax))
+            return false;
+        d = std::sqrt(d);
+        G[j + j * n] = d;
+
+        for (int i = j + 1; i < n; i++)
+        {
+            double s = G[i + j * n];
+            for (int k = 0; k < j; k++)
+                s -= G[i + k * n] * G[j + k * n];
+            G[i + j * n] = s / d;
+        }
+        for (int i = 0; i < j; i++)
+            G[i + j * n] = 0;
+    }
+    return true;
+}
+
+// H c = w G c for symmetric H and SPD G: with G = L L^T the problem is
+// reduced to L^{-1} H L^{-T} and the eigenvectors mapped back, C = L^{-T} V,
+// so that C^T G C = I. false when G is numerically singular.
+inline bool
+dense_sym_geneig (const int n,
+                  std::vector<double> H,
+                  std::vector<double> G,
+                  std::vector<double> &w,
+                  std::vector<double> &C)
+{
+    if (!dense_cholesky(n, G))
+        return false;
+
+    // H = L^{-1} H, column by column
+    for (int j = 0; j < n; j++)
+        for (int i = 0; i < n; i++)
+        {
+            double s = H[i + j * n];
+            for (int k = 0; k < i; k++)
+                s -= G[i + k * n] * H[k + j * n];
+            H[i + j * n] = s / G[i + i * n];
+        }
+
+    // H = H L^{-T}, row by row
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < n; j++)
+        {
+            double s = H[i + j * n];
+            for (int k = 0; k < j; k++)
+                s -= H[i + k * n] * G[j + k * n];
+            H[i + j * n] = s / G[j + j * n];
+        }
+
+    // symmetrise the rounding errors away
+    for (int j = 0; j < n; j++)
+        for (int i = 0; i < j; i++)
+            H[i + j * n] = H[j + i * n] = (H[i + j * n] + H[j + i * n]) / 2;
+
+    dense_sym_eig(n, H, w, C);
+
+    // C = L^{-T} V
+    for (int j = 0; j < n; j++)
+        for (int i = n - 1; i >= 0; i--)
+        {
+            double s = C[i + j * n];
+            for (int k = i + 1; k < n; k++)
+                s -= G[k + i * n] * C[k + j * n];
+            C[i + j * n] = s / G[i + i * n];
+        }
+
+    return true;
+}
+
+// Columns of the k wanted eigenpairs among the n ascending ones
+inline std::vector<int>
+dense_eig_select (const int n,
+                  const int k,
+                  const EIG_WHICH which)
+{
+    std::vector<int> sel(k);
+    for (int j = 0; j < k; j++)
+        sel[j] = (which == EIG_LARGEST) ? n - 1 - j : j;
+    return sel;
+}
+
+#endif //_HCSPARSE_DENSE_EIGEN_H_
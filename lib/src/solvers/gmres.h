@@ -0,0 +1,337 @@
+#ifndef _HCSPARSE_SOLVER_GMRES_H_
+#define _HCSPARSE_SOLVER_GMRES_H_
+
+#include "hcsparse.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+// scalars used by gmres besides the Hessenberg column and the update
+// coefficients: norm_b and beta
+#define GMRES_WORK_SCALARS 2
+
+// h[c] = <V_c, w> for the first k columns of the column block V (stride n).
+// Every tile reduces a slice of one column into a partial; a second kernel
+// sums the partials of each column.
+template <typename T>
+void
+block_dot (const int k,
+           const T *V,
+           const long n,
+           const T *w,
+           T *h,
+           hcsparseControl *control)
+{
+    const int NB = reduce_num_blocks(n);
+
+    char *scratch = (char*) reduce_get_scratch(sizeof(T) * k * NB, control);
+    T *partial = (T*) (scratch + REDUCE_PARTIAL_OFFSET);
+
+    hc::extent<1> grdExt(k * NB * BLOCK_SIZE);
+    hc::tiled_extent<1> t_ext = grdExt.tile(BLOCK_SIZE);
+    hc::parallel_for_each(control->accl_view, t_ext, [=] (hc::tiled_index<1>& tidx) [[hc]]
+    {
+        tile_static T buf_tmp[BLOCK_SIZE];
+        int col = tidx.tile[0] / NB;
+        int block = tidx.tile[0] % NB;
+        const T *v = V + col * n;
+        T sum = 0;
+
+        for (long i = block * BLOCK_SIZE + tidx.local[0]; i < n; i += NB * BLOCK_SIZE)
+            sum += v[i] * w[i];
+
+        sum = tile_reduce<T>(sum, buf_tmp, tidx);
+        if (tidx.local[0] == 0)
+            partial[col * NB + block] = sum;
+    }).wait();
+
+    hc::extent<1> grdExt_sum(k * BLOCK_SIZE);
+    hc::tiled_extent<1> t_ext_sum = grdExt_sum.tile(BLOCK_SIZE);
+    hc::parallel_for_each(control->accl_view, t_ext_sum, [=] (hc::tiled_index<1>& tidx) [[hc]]
+    {
+        tile_static T buf_tmp[BLOCK_SIZE];
+        int col = tidx.tile[0];
+        T sum = 0;
+
+        for (int b = tidx.local[0]; b < NB; b += BLOCK_SIZE)
+            sum += partial[col * NB + b];
+
+        sum = tile_reduce<T>(sum, buf_tmp, tidx);
+        if (tidx.local[0] == 0)
+            h[col] = sum;
+    }).wait();
+}
+
+// w = w - V[:, 0:k] h[0:k] and h[k] = <w, w> of the result, in one pass.
+template <typename T>
+void
+block_axpy_norm (const int k,
+                 const T *V,
+                 const long n,
+                 T *h,
+                 T *w,
+                 hcsparseControl *control)
+{
+    const int REDUCE_BLOCKS_NUMBER = reduce_num_blocks(n);
+
+    char *scratch = (char*) reduce_get_scratch(sizeof(T) * REDUCE_BLOCKS_NUMBER, control);
+    unsigned int *counter = (unsigned int*) scratch;
+    T *partial = (T*) (scratch + REDUCE_PARTIAL_OFFSET);
+
+    hc::extent<1> grdExt(REDUCE_BLOCKS_NUMBER * BLOCK_SIZE);
+    hc::tiled_extent<1> t_ext = grdExt.tile(BLOCK_SIZE);
+    hc::parallel_for_each(control->accl_view, t_ext, [=] (hc::tiled_index<1>& tidx) [[hc]]
+    {
+        tile_static T buf_tmp[BLOCK_SIZE];
+        tile_static bool is_last;
+        T sum = 0;
+
+        for (long i = tidx.global[0]; i < n; i += REDUCE_BLOCKS_NUMBER * BLOCK_SIZE)
+        {
+            T wi = w[i];
+            for (int c = 0; c < k; c++)
+                wi -= V[c * n + i] * h[c];
+            w[i] = wi;
+            sum += wi * wi;
+        }
+
+        T total;
+        if (tile_reduce_finish<T>(sum, total, buf_tmp, partial, counter,
+                                  REDUCE_BLOCKS_NUMBER, is_last, tidx))
+        {
+            if (tidx.local[0] == 0)
+                h[k] = total;
+        }
+    }).wait();
+}
+
+// u = V[:, 0:k] y[0:k]
+template <typename T>
+void
+block_combine (const int k,
+               const T *V,
+               const long n,
+               const T *y,
+               T *u,
+               hcsparseControl *control)
+{
+    hc::extent<1> grdExt(BLOCK_SIZE * ((n - 1)/BLOCK_SIZE + 1));
+    hc::tiled_extent<1> t_ext = grdExt.tile(BLOCK_SIZE);
+    hc::parallel_for_each(control->accl_view, t_ext, [=] (hc::tiled_index<1>& tidx) [[hc]]
+    {
+        long i = tidx.global[0];
+        if (i < n)
+        {
+            T sum = 0;
+            for (int c = 0; c < k; c++)
+                sum += V[c * n + i] * y[c];
+            u[i] = sum;
+        }
+    }).wait();
+}
+
+/*
+ * Restarted GMRES(m) with right preconditioning, A M^-1 (M x) = b.
+ * The Arnoldi process orthogonalises with classical Gram-Schmidt: the
+ * projections on all previous basis vectors are one batched dot product
+ * and their removal one batched axpy that also yields the new norm. The
+ * Hessenberg column is then read back and the least squares problem is
+ * updated on the host with Givens rotations, which gives the residual norm
+ * of every step for free. GMRES minimises the 2-norm of the residual, so
+ * that is the norm it reports regardless of residualNorm.
+ */
+template<typename T, typename PTYPE>
+hcsparseStatus
+gmres (hcdenseVector *pX,
+       const hcsparseCsrMatrix* pA,
+       const hcdenseVector *pB,
+       PTYPE& M,
+       hcsparseSolverControl *solverControl,
+       hcsparseSolverWorkspace *workspace,
+       hcsparseControl *control)
+{
+    assert( pA->num_cols == pB->num_values );
+    assert( pA->num_rows == pX->num_values );
+    if( ( pA->num_cols != pB->num_values ) || ( pA->num_rows != pX->num_values ) )
+    {
+        return hcsparseInvalid;
+    }
+
+    int status;
+
+    const auto N = pA->num_cols;
+    const int m = std::max(1, std::min(solverControl->restart, (int)N));
+
+    // basis vectors V_0 .. V_m, then u and z for the solution update
+    status = workspace_reserve<T>(workspace, m + 3,
+                                  GMRES_WORK_SCALARS + (m + 1) + m, control);
+    if (status != hcsparseSuccess)
+    {
+        return hcsparseInvalid;
+    }
+
+    T *V = static_cast<T*>(workspace->vectors);
+
+    hcdenseVector u;
+    hcdenseVector z;
+    workspace_vector<T>(workspace, m + 1, &u);
+    workspace_vector<T>(workspace, m + 2, &z);
+
+    hcsparseScalar one;
+    hcsparseScalar zero;
+    hcsparseScalar norm_b;
+    hcsparseScalar beta;
+    hcsparseScalar hcol;
+    hcsparseScalar ycoef;
+
+    workspace_constants<T>(workspace, &one, &zero);
+    workspace_scalar<T>(workspace, 0, &norm_b);
+    workspace_scalar<T>(workspace, 1, &beta);
+    workspace_scalar<T>(workspace, GMRES_WORK_SCALARS, &hcol);
+    workspace_scalar<T>(workspace, GMRES_WORK_SCALARS + m + 1, &ycoef);
+
+    T *d_h = static_cast<T*>(hcol.value);
+
+    //norm of rhs of equation
+    status = fused_blas1<T>(N, fused_nop(), fused_nop(),
+                            fused_norm2(&norm_b, fused_vec<T>(pB)),
+                            fused_nop(), control);
+
+    T h_norm_b = 0;
+    control->accl_view.copy(norm_b.value, &h_norm_b, sizeof(T)*1);
+
+    if (h_norm_b == 0) //special case b is zero so solution is x = 0
+    {
+        solverControl->nIters = 0;
+        solverControl->absoluteTolerance = 0.0;
+        solverControl->relativeTolerance = 0.0;
+        control->accl_view.copy(pB->values, pX->values, sizeof(T)*pX->num_values);
+
+        return hcsparseSuccess;
+    }
+
+    // Hessenberg matrix (column major, m + 1 rows), Givens rotations and
+    // right hand side of the least squares problem
+    std::vector<T> H((m + 1) * m, 0);
+    std::vector<T> cs(m, 0);
+    std::vector<T> sn(m, 0);
+    std::vector<T> g(m + 1, 0);
+    std::vector<T> y(m, 0);
+
+    int iteration = 0;
+    bool converged = false;
+    bool first = true;
+
+    while (!converged)
+    {
+        hcdenseVector v0;
+        workspace_vector<T>(workspace, 0, &v0);
+
+        // V_0 = b - A*x, beta = |V_0|_2
+        status = csrmv<T>(&one, pA, pX, &zero, &u, control);
+        status = fused_blas1<T>(N,
+                                fused_set(&v0, fused_vec<T>(pB) - fused_vec<T>(&u)),
+                                fused_nop(),
+                                fused_norm2(&beta, fused_vec<T>(&v0)),
+                                fused_nop(),
+                                control);
+
+        T h_beta = 0;
+        control->accl_view.copy(beta.value, &h_beta, sizeof(T)*1);
+
+        T residuum = div<T>(h_beta, h_norm_b);
+        if (first)
+        {
+            solverControl->initialResidual = residuum;
+            first = false;
+        }
+
+        if (solverControl->finished(residuum) || h_beta == 0)
+            break;
+
+        status = fused_blas1<T>(N,
+                                fused_set(&v0, fused_const<T>(1 / h_beta) * fused_vec<T>(&v0)),
+                                fused_nop(), fused_nop(), fused_nop(), control);
+
+        std::fill(g.begin(), g.end(), (T)0);
+        g[0] = h_beta;
+
+        int k = 0;
+        while (k < m)
+        {
+            hcdenseVector vk;
+            hcdenseVector w;
+            workspace_vector<T>(workspace, k, &vk);
+            workspace_vector<T>(workspace, k + 1, &w);
+
+            // w = A * M^-1 * V_k
+            M(&vk, &z, control);
+            status = csrmv<T>(&one, pA, &z, &zero, &w, control);
+
+            // h = V^T w; w = w - V h; h[k+1] = |w|^2
+            block_dot<T>(k + 1, V, N, static_cast<T*>(w.values), d_h, control);
+            block_axpy_norm<T>(k + 1, V, N, d_h, static_cast<T*>(w.values), control);
+
+            T *Hk = &H[k * (m + 1)];
+            control->accl_view.copy(d_h, Hk, sizeof(T) * (k + 2));
+            Hk[k + 1] = std::sqrt(Hk[k + 1]);
+            T h_next = Hk[k + 1];
+
+            // apply the previous rotations to the new column
+            for (int i = 0; i < k; i++)
+            {
+                T t = cs[i] * Hk[i] + sn[i] * Hk[i + 1];
+                Hk[i + 1] = -sn[i] * Hk[i] + cs[i] * Hk[i + 1];
+                Hk[i] = t;
+            }
+
+            // and eliminate H(k+1, k)
+            T rho = std::sqrt(Hk[k] * Hk[k] + Hk[k + 1] * Hk[k + 1]);
+            cs[k] = rho == 0 ? 1 : Hk[k] / rho;
+            sn[k] = rho == 0 ? 0 : Hk[k + 1] / rho;
+            Hk[k] = rho;
+            Hk[k + 1] = 0;
+            g[k + 1] = -sn[k] * g[k];
+            g[k] = cs[k] * g[k];
+
+            k++;
+            iteration++;
+            solverControl->nIters = iteration;
+
+            residuum = div<T>(std::abs(g[k]), h_norm_b);
+            converged = solverControl->finished(residuum);
+            solverControl->print();
+
+            // happy breakdown, the Krylov space is invariant
+            if (converged || h_next == 0)
+                break;
+
+            status = fused_blas1<T>(N,
+                                    fused_set(&w, fused_const<T>(1 / h_next) * fused_vec<T>(&w)),
+                                    fused_nop(), fused_nop(), fused_nop(), control);
+        }
+
+        // solve the triangular system H(0:k, 0:k) y = g(0:k)
+        for (int i = k - 1; i >= 0; i--)
+        {
+            T sum = g[i];
+            for (int j = i + 1; j < k; j++)
+                sum -= H[j * (m + 1) + i] * y[j];
+            y[i] = div<T>(sum, H[i * (m + 1) + i]);
+        }
+        control->accl_view.copy(y.data(), ycoef.value, sizeof(T) * k);
+
+        // x = x + M^-1 * V y
+        block_combine<T>(k, V, N, static_cast<T*>(ycoef.value), static_cast<T*>(u.values), control);
+        M(&u, &z, control);
+        status = fused_blas1<T>(N, fused_add(pX, fused_vec<T>(&z)),
+                                fused_nop(), fused_nop(), fused_nop(), control);
+
+        if (iteration >= solverControl->maxIters)
+            break;
+    }
+
+    return hcsparseSuccess;
+}
+
+#endif //_HCSPARSE_SOLVER_GMRES_H_
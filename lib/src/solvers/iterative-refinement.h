@@ -0,0 +1,231 @@
+#ifndef _HCSPARSE_SOLVER_ITERATIVE_REFINEMENT_H_
+#define _HCSPARSE_SOLVER_ITERATIVE_REFINEMENT_H_
+
+#include "hcsparse.h"
+#include <algorithm>
+#include <vector>
+
+// work vectors and scalars of the outer, high precision loop
+#define IR_WORK_VECTORS 2
+#define IR_WORK_SCALARS 2
+// relative residual reduction asked from every low precision inner solve
+#define IR_INNER_TOLERANCE 1e-4
+// the refinement stops once a step reduces the residual by less than this
+#define IR_MIN_REDUCTION 0.9
+
+// out = (Tout) in, used for the matrix values
+template <typename Tin, typename Tout>
+void
+ir_convert (const long n,
+            const Tin *in,
+            Tout *out,
+            hcsparseControl *control)
+{
+    hc::extent<1> grdExt(BLOCK_SIZE * ((n - 1)/BLOCK_SIZE + 1));
+    hc::tiled_extent<1> t_ext = grdExt.tile(BLOCK_SIZE);
+    hc::parallel_for_each(control->accl_view, t_ext, [=] (hc::tiled_index<1>& tidx) [[hc]]
+    {
+        long i = tidx.global[0];
+        if (i < n)
+            out[i] = (Tout) in[i];
+    }).wait();
+}
+
+// low precision right hand side r_low = r / |r| and zero initial guess d_low
+template <typename T, typename Tlow>
+void
+ir_low_residual (const long n,
+                 const T *r,
+                 const T scale,
+                 Tlow *r_low,
+                 Tlow *d_low,
+                 hcsparseControl *control)
+{
+    hc::extent<1> grdExt(BLOCK_SIZE * ((n - 1)/BLOCK_SIZE + 1));
+    hc::tiled_extent<1> t_ext = grdExt.tile(BLOCK_SIZE);
+    hc::parallel_for_each(control->accl_view, t_ext, [=] (hc::tiled_index<1>& tidx) [[hc]]
+    {
+        long i = tidx.global[0];
+        if (i < n)
+        {
+            r_low[i] = (Tlow) (r[i] * scale);
+            d_low[i] = 0;
+        }
+    }).wait();
+}
+
+// x = x + scale * d_low, accumulated in high precision
+template <typename T, typename Tlow>
+void
+ir_correct (const long n,
+            T *x,
+            const T scale,
+            const Tlow *d_low,
+            hcsparseControl *control)
+{
+    hc::extent<1> grdExt(BLOCK_SIZE * ((n - 1)/BLOCK_SIZE + 1));
+    hc::tiled_extent<1> t_ext = grdExt.tile(BLOCK_SIZE);
+    hc::parallel_for_each(control->accl_view, t_ext, [=] (hc::tiled_index<1>& tidx) [[hc]]
+    {
+        long i = tidx.global[0];
+        if (i < n)
+            x[i] += scale * (T) d_low[i];
+    }).wait();
+}
+
+/*
+ * Mixed precision iterative refinement. Residuals r = b - A x and the
+ * updates of x are computed in T; the correction equation A d = r is
+ * solved by inner(r_low, d_low, innerControl), a Krylov solver working on
+ * a Tlow copy of A. The inner solves carry all of the matrix traffic at
+ * the lower precision, while the outer loop keeps the accuracy of T as
+ * long as the inner solver reduces the residual at all.
+ * solverControl->nIters counts the inner iterations of all steps and is
+ * bounded by maxIters.
+ */
+template<typename T, typename Tlow, typename INNER>
+hcsparseStatus
+iterative_refinement (hcdenseVector *pX,
+                      const hcsparseCsrMatrix* pA,
+                      const hcdenseVector *pB,
+                      INNER& inner,
+                      hcsparseSolverControl *solverControl,
+                      hcsparseSolverWorkspace *workspace,
+                      hcsparseControl *control)
+{
+    if( ( pA->num_cols != pB->num_values ) || ( pA->num_rows != pX->num_values ) )
+    {
+        return hcsparseInvalid;
+    }
+
+    hcsparseStatus status;
+
+    const auto N = pA->num_cols;
+
+    status = workspace_reserve<T>(workspace, IR_WORK_VECTORS, IR_WORK_SCALARS, control);
+    if (status != hcsparseSuccess)
+    {
+        return hcsparseInvalid;
+    }
+
+    hcdenseVector y;
+    hcdenseVector r;
+
+    workspace_vector<T>(workspace, 0, &y);
+    workspace_vector<T>(workspace, 1, &r);
+
+    hcsparseScalar one;
+    hcsparseScalar zero;
+    hcsparseScalar norm_b;
+    hcsparseScalar norm_r;
+
+    workspace_constants<T>(workspace, &one, &zero);
+    workspace_scalar<T>(workspace, 0, &norm_b);
+    workspace_scalar<T>(workspace, 1, &norm_r);
+
+    const SOLVER_NORM norm = solverControl->residualNorm;
+
+    status = fused_blas1_norm<T>(N, fused_nop(), fused_nop(),
+                                 norm, &norm_b, fused_vec<T>(pB),
+                                 fused_nop(), control);
+
+    T h_norm_b = 0;
+    control->accl_view.copy(norm_b.value, &h_norm_b, sizeof(T));
+
+    if (h_norm_b == 0) //special case b is zero so solution is x = 0
+    {
+        solverControl->nIters = 0;
+        solverControl->absoluteTolerance = 0.0;
+        solverControl->relativeTolerance = 0.0;
+        control->accl_view.copy(pB->values, pX->values, sizeof(T)*pX->num_values);
+
+        return hcsparseSuccess;
+    }
+
+    // low precision right hand side and correction
+    hc::accelerator acc = (control->accl_view).get_accelerator();
+    hcdenseVector r_low;
+    hcdenseVector d_low;
+
+    r_low.values = am_alloc(sizeof(Tlow) * N, acc, 0);
+    r_low.num_values = N;
+    r_low.offValues = 0;
+    d_low.values = am_alloc(sizeof(Tlow) * N, acc, 0);
+    d_low.num_values = N;
+    d_low.offValues = 0;
+
+    hcsparseSolverControl innerControl;
+    innerControl.preconditioner = solverControl->preconditioner;
+    innerControl.relativeTolerance = IR_INNER_TOLERANCE;
+    innerControl.absoluteTolerance = 0.0;
+    innerControl.printMode = QUIET;
+    innerControl.residualNorm = solverControl->residualNorm;
+    innerControl.checkInterval = solverControl->checkInterval;
+    innerControl.restart = solverControl->restart;
+
+    T *X = static_cast<T*>(pX->values) + pX->offValues;
+    const T *R = static_cast<const T*>(r.values);
+
+    int iterations = 0;
+    int step = 0;
+    T previous = 0;
+
+    solverControl->nIters = 0;
+
+    while (true)
+    {
+        // y = A*x; r = b - y in full precision
+        status = csrmv<T>(&one, pA, pX, &zero, &y, control);
+        status = fused_blas1_norm<T>(N, fused_set(&r, fused_vec<T>(pB) - fused_vec<T>(&y)), fused_nop(),
+                                     norm, &norm_r, fused_vec<T>(&r),
+                                     fused_nop(), control);
+
+        T h_norm_r = 0;
+        control->accl_view.copy(norm_r.value, &h_norm_r, sizeof(T));
+
+        T residuum = div<T>(h_norm_r, h_norm_b);
+
+        if (step == 0)
+        {
+            solverControl->initialResidual = residuum;
+        }
+        else
+        {
+            solverControl->print();
+        }
+
+        if (solverControl->finished(residuum) || h_norm_r == 0 ||
+            (step > 1 && residuum > IR_MIN_REDUCTION * previous))
+        {
+            break;
+        }
+        previous = residuum;
+
+        // A d = r / |r| in low precision, the scaling keeps r inside the
+        // range of Tlow however small it gets
+        ir_low_residual<T, Tlow>(N, R, 1 / h_norm_r, static_cast<Tlow*>(r_low.values),
+                                 static_cast<Tlow*>(d_low.values), control);
+
+        innerControl.nIters = 0;
+        innerControl.maxIters = solverControl->maxIters - iterations;
+
+        status = inner(&r_low, &d_low, &innerControl);
+        if (status != hcsparseSuccess)
+        {
+            break;
+        }
+
+        ir_correct<T, Tlow>(N, X, h_norm_r, static_cast<const Tlow*>(d_low.values), control);
+
+        iterations += std::max(innerControl.nIters, 1);
+        solverControl->nIters = iterations;
+        step++;
+    }
+
+    am_free(r_low.values);
+    am_free(d_low.values);
+
+    return status;
+}
+
+#endif //_HCSPARSE_SOLVER_ITERATIVE_REFINEMENT_H_
@@ -0,0 +1,234 @@
+#ifndef _HCSPARSE_SOLVER_LANCZOS_H_
+#define _HCSPARSE_SOLVER_LANCZOS_H_
+
+#include "hcsparse.h"
+#include "dense-eigen.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+// relative size of the new Lanczos vector below which the Krylov space is
+// taken as invariant
+#define LANCZOS_BREAKDOWN_TOL 1e-12
+
+/*
+ * Thick restart Lanczos (Wu and Simon, 2000) for the k smallest or
+ * largest eigenpairs of the symmetric A. A basis of m = restart vectors
+ * is built with csrmv and full reorthogonalisation (two passes of the
+ * block kernels of gmres); at a restart the Ritz vectors nearest the
+ * wanted end of the spectrum are kept, k + (m - k) / 2 of them, and the
+ * projected matrix becomes arrowhead. The first column of X is the
+ * starting vector, a pseudo random one is used when it is zero; on exit
+ * X holds the Ritz vectors. solverControl->nIters counts products with A.
+ */
+template<typename T>
+hcsparseStatus
+lanczos (hcdenseMatrix *pX,
+         hcdenseVector *pLambda,
+         const hcsparseCsrMatrix* pA,
+         const EIG_WHICH which,
+         hcsparseSolverControl *solverControl,
+         hcsparseSolverWorkspace *workspace,
+         hcsparseControl *control)
+{
+    const long N = pA->num_rows;
+    const int k = pX->num_cols;
+    const int m = std::min((long)std::max(solverControl->restart, 2 * k + 1), N - 1);
+
+    if (pX->major != columnMajor || pA->num_rows != pA->num_cols ||
+        pX->num_rows != N || pX->lead_dim < pX->num_rows ||
+        pLambda->num_values < k || k < 1 || m <= k)
+    {
+        return hcsparseInvalid;
+    }
+
+    hcsparseStatus status;
+
+    // m + 1 basis vectors and room for the kept Ritz vectors
+    status = workspace_reserve<T>(workspace, 2 * m + 1, 3 * m + 2, control);
+    if (status != hcsparseSuccess)
+    {
+        return hcsparseInvalid;
+    }
+
+    T *V = static_cast<T*>(workspace->vectors);
+    T *Ritz = V + (m + 1) * N;
+
+    hcsparseScalar first;
+    workspace_scalar<T>(workspace, 0, &first);
+    T *h1 = static_cast<T*>(first.value);
+    T *h2 = h1 + m + 1;
+    T *y = h2 + m + 1;
+
+    T *userX = static_cast<T*>(pX->values) + pX->offValues;
+    const long ldx = pX->lead_dim;
+
+    // v_0 = x_0 / |x_0|
+    control->accl_view.copy(userX, V, sizeof(T) * N);
+    T h_norm = 0;
+    block_dot<T>(1, V, N, V, h1, control);
+    control->accl_view.copy(h1, &h_norm, sizeof(T));
+    if (h_norm == 0)
+    {
+        std::vector<T> h_v(N);
+        unsigned int seed = 12345;
+        for (long i = 0; i < N; i++)
+        {
+            seed = seed * 1103515245u + 12345u;
+            h_v[i] = (T)((seed >> 16) & 0x7fff) / 0x7fff - (T)0.5;
+        }
+        control->accl_view.copy(h_v.data(), V, sizeof(T) * N);
+        block_dot<T>(1, V, N, V, h1, control);
+        control->accl_view.copy(h1, &h_norm, sizeof(T));
+    }
+
+    hcdenseVector v;
+    v.values = V;
+    v.num_values = N;
+    v.offValues = 0;
+    fused_blas1<T>(N, fused_set(&v, fused_const<T>(1 / std::sqrt(h_norm)) * fused_vec<T>(&v)),
+                   fused_nop(), fused_nop(), fused_nop(), control);
+
+    hcsparseScalar one;
+    hcsparseScalar zero;
+    workspace_constants<T>(workspace, &one, &zero);
+
+    // projected matrix V^T A V
+    std::vector<double> h_T(m * m, 0);
+    std::vector<T> h_h1(m + 1), h_h2(m + 1);
+    std::vector<double> h_w, h_Y;
+    std::vector<int> sel;
+
+    int l = 0;
+    int matvecs = 0;
+    bool first_cycle = true;
+
+    solverControl->nIters = 0;
+
+    while (true)
+    {
+        int m_eff = m;
+        double beta = 0;
+
+        for (int j = l; j < m; j++)
+        {
+            hcdenseVector vj, w;
+            vj.values = V + j * N;
+            vj.num_values = N;
+            vj.offValues = 0;
+            w.values = V + (j + 1) * N;
+            w.num_values = N;
+            w.offValues = 0;
+
+            csrmv<T>(&one, pA, &vj, &zero, &w, control);
+            matvecs++;
+
+            // two passes of classical Gram-Schmidt against v_0 .. v_j
+            block_dot<T>(j + 1, V, N, V + (j + 1) * N, h1, control);
+            block_axpy_norm<T>(j + 1, V, N, h1, V + (j + 1) * N, control);
+            block_dot<T>(j + 1, V, N, V + (j + 1) * N, h2, control);
+            block_axpy_norm<T>(j + 1, V, N, h2, V + (j + 1) * N, control);
+
+            control->accl_view.copy(h1, h_h1.data(), sizeof(T) * (j + 1));
+            control->accl_view.copy(h2, h_h2.data(), sizeof(T) * (j + 2));
+
+            for (int i = 0; i <= j; i++)
+                h_T[i + j * m] = h_T[j + i * m] = (double)h_h1[i] + (double)h_h2[i];
+
+            double scale = 0;
+            for (int i = 0; i <= j; i++)
+                scale = std::max(scale, std::fabs(h_T[i + j * m]));
+
+            beta = std::sqrt(std::max((double)h_h2[j + 1], 0.0));
+            if (beta <= LANCZOS_BREAKDOWN_TOL * scale)
+            {
+                m_eff = j + 1;
+                beta = 0;
+                break;
+            }
+
+            fused_blas1<T>(N, fused_set(&w, fused_const<T>(1 / beta) * fused_vec<T>(&w)),
+                           fused_nop(), fused_nop(), fused_nop(), control);
+        }
+
+        if (m_eff < k)
+        {
+            // the starting vector lies in an invariant space smaller than k
+            return hcsparseInvalid;
+        }
+
+        // Ritz pairs of the projected matrix
+        std::vector<double> T_eff(m_eff * m_eff);
+        for (int j = 0; j < m_eff; j++)
+            for (int i = 0; i < m_eff; i++)
+                T_eff[i + j * m_eff] = h_T[i + j * m];
+        dense_sym_eig(m_eff, T_eff, h_w, h_Y);
+
+        sel = dense_eig_select(m_eff, k, which);
+
+        // |A x - theta x| = beta * |last component of the Ritz vector|
+        bool converged = true;
+        double residual = 0;
+        for (int i = 0; i < k; i++)
+        {
+            double r = beta * std::fabs(h_Y[m_eff - 1 + sel[i] * m_eff]);
+            residual = std::max(residual, r);
+            if (r > std::max(solverControl->relativeTolerance * std::fabs(h_w[sel[i]]),
+                             solverControl->absoluteTolerance))
+                converged = false;
+        }
+
+        if (first_cycle)
+            solverControl->initialResidual = residual;
+        first_cycle = false;
+        solverControl->currentResidual = residual;
+        solverControl->nIters = matvecs;
+        solverControl->print();
+
+        if (converged || m_eff < m || matvecs >= solverControl->maxIters)
+        {
+            std::vector<T> h_y(m_eff);
+            std::vector<T> h_lambda(k);
+            for (int i = 0; i < k; i++)
+            {
+                for (int r = 0; r < m_eff; r++)
+                    h_y[r] = (T) h_Y[r + sel[i] * m_eff];
+                control->accl_view.copy(h_y.data(), y, sizeof(T) * m_eff);
+                block_combine<T>(m_eff, V, N, y, userX + i * ldx, control);
+                h_lambda[i] = (T) h_w[sel[i]];
+            }
+            control->accl_view.copy(h_lambda.data(),
+                                    static_cast<T*>(pLambda->values) + pLambda->offValues,
+                                    sizeof(T) * k);
+            break;
+        }
+
+        // thick restart: keep the Ritz vectors nearest the wanted end,
+        // followed by the last Lanczos vector
+        int l_new = std::min(k + (m - k) / 2, m - 1);
+        std::vector<int> keep = dense_eig_select(m, l_new, which);
+
+        std::vector<T> h_y(m);
+        for (int i = 0; i < l_new; i++)
+        {
+            for (int r = 0; r < m; r++)
+                h_y[r] = (T) h_Y[r + keep[i] * m];
+            control->accl_view.copy(h_y.data(), y, sizeof(T) * m);
+            block_combine<T>(m, V, N, y, Ritz + i * N, control);
+        }
+        control->accl_view.copy(Ritz, V, sizeof(T) * l_new * N);
+        control->accl_view.copy(V + m * N, V + l_new * N, sizeof(T) * N);
+
+        std::fill(h_T.begin(), h_T.end(), 0);
+        for (int i = 0; i < l_new; i++)
+        {
+            h_T[i + i * m] = h_w[keep[i]];
+            h_T[i + l_new * m] = h_T[l_new + i * m] = beta * h_Y[m - 1 + keep[i] * m];
+        }
+        l = l_new;
+    }
+
+    return hcsparseSuccess;
+}
+
+#endif //_HCSPARSE_SOLVER_LANCZOS_H_
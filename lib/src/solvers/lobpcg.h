@@ -0,0 +1,249 @@
+#ifndef _HCSPARSE_SOLVER_LOBPCG_H_
+#define _HCSPARSE_SOLVER_LOBPCG_H_
+
+#include "hcsparse.h"
+#include "dense-eigen.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+// largest block of eigenvectors: the basis [X W P] has to fit into one
+// block of the bcg kernels
+#define LOBPCG_MAX_BLOCK (BCG_MAX_COLUMNS / 3)
+// n x k work blocks: the basis [X W P], its image [AX AW AP] and four
+// blocks for the updated X, AX, P and AP
+#define LOBPCG_WORK_BLOCKS 10
+// scalars: the 3k x 3k Gram matrix, the 3k x k and 2k x k update
+// coefficients and the k residual norms
+#define LOBPCG_WORK_SCALARS(k) (14 * (k) * (k) + (k))
+
+// Gram matrix of s columns copied to the host in double precision
+template <typename T>
+void
+lobpcg_host_gram (const int s,
+                  const T *U,
+                  const T *V,
+                  const long n,
+                  T *d_gram,
+                  std::vector<double> &h_gram,
+                  hcsparseControl *control)
+{
+    std::vector<T> h(s * s);
+    bcg_gram<T>(s, U, V, n, d_gram, control);
+    control->accl_view.copy(d_gram, h.data(), sizeof(T) * s * s);
+    h_gram.assign(h.begin(), h.end());
+}
+
+// Uploads the rows r0.. r0 + rows of the columns sel of the column major C
+// (leading dimension ldc) as a rows x sel.size() matrix
+template <typename T>
+void
+lobpcg_upload_coef (const std::vector<double> &C,
+                    const int ldc,
+                    const int r0,
+                    const int rows,
+                    const std::vector<int> &sel,
+                    T *d_coef,
+                    hcsparseControl *control)
+{
+    std::vector<T> h(rows * sel.size());
+    for (size_t j = 0; j < sel.size(); j++)
+        for (int i = 0; i < rows; i++)
+            h[i + j * rows] = (T) C[r0 + i + sel[j] * ldc];
+    control->accl_view.copy(h.data(), d_coef, sizeof(T) * h.size());
+}
+
+/*
+ * Locally optimal block preconditioned conjugate gradients (Knyazev, 2001)
+ * for the k smallest or largest eigenpairs of the symmetric A. Every
+ * iteration applies A to the block of preconditioned residuals W in one
+ * pass and solves the Rayleigh-Ritz problem of the basis [X W P] on the
+ * host; when the basis becomes linearly dependent P is dropped for that
+ * step. On entry the k columns of X are the initial guess.
+ */
+template<typename T, typename PTYPE>
+hcsparseStatus
+lobpcg (hcdenseMatrix *pX,
+        hcdenseVector *pLambda,
+        const hcsparseCsrMatrix* pA,
+        const EIG_WHICH which,
+        PTYPE& M,
+        hcsparseSolverControl *solverControl,
+        hcsparseSolverWorkspace *workspace,
+        hcsparseControl *control)
+{
+    const long N = pA->num_rows;
+    const int k = pX->num_cols;
+
+    if (pX->major != columnMajor || pA->num_rows != pA->num_cols ||
+        pX->num_rows != N || pX->lead_dim < pX->num_rows ||
+        pLambda->num_values < k || k < 1 || k > LOBPCG_MAX_BLOCK || N < 3 * k)
+    {
+        return hcsparseInvalid;
+    }
+
+    hcsparseStatus status;
+
+    status = workspace_reserve<T>(workspace, LOBPCG_WORK_BLOCKS * k,
+                                  LOBPCG_WORK_SCALARS(k), control);
+    if (status != hcsparseSuccess)
+    {
+        return hcsparseInvalid;
+    }
+
+    T *S = static_cast<T*>(workspace->vectors);
+    T *AS = S + 3 * k * N;
+    T *Xn = AS + 3 * k * N;
+    T *AXn = Xn + k * N;
+    T *Pn = AXn + k * N;
+    T *APn = Pn + k * N;
+
+    T *X = S;
+    T *W = S + k * N;
+    T *AX = AS;
+    T *AW = AS + k * N;
+
+    hcsparseScalar first;
+    workspace_scalar<T>(workspace, 0, &first);
+    T *gram = static_cast<T*>(first.value);
+    T *coef = gram + 9 * k * k;
+    T *coef_p = coef + 3 * k * k;
+    T *norms = coef_p + 2 * k * k;
+
+    T *userX = static_cast<T*>(pX->values) + pX->offValues;
+    const long ldx = pX->lead_dim;
+
+    for (int j = 0; j < k; j++)
+        control->accl_view.copy(userX + j * ldx, X + j * N, sizeof(T) * N);
+
+    // Rayleigh-Ritz on the initial block
+    std::vector<double> h_G, h_H, h_w, h_C;
+    bcg_spmm<T, false>(pA, k, X, N, nullptr, AX, N, control);
+    lobpcg_host_gram<T>(k, X, X, N, gram, h_G, control);
+    lobpcg_host_gram<T>(k, X, AX, N, gram, h_H, control);
+    if (!dense_sym_geneig(k, h_H, h_G, h_w, h_C))
+    {
+        return hcsparseInvalid;
+    }
+
+    std::vector<int> sel = dense_eig_select(k, k, which);
+
+    lobpcg_upload_coef<T>(h_C, k, 0, k, sel, coef, control);
+    bcg_update<T, true>(N, k, k, X, coef, nullptr, 1, Xn, N, nullptr, control);
+    bcg_update<T, true>(N, k, k, AX, coef, nullptr, 1, AXn, N, nullptr, control);
+    control->accl_view.copy(Xn, X, sizeof(T) * k * N);
+    control->accl_view.copy(AXn, AX, sizeof(T) * k * N);
+
+    std::vector<T> h_lambda(k);
+    for (int j = 0; j < k; j++)
+        h_lambda[j] = h_w[sel[j]];
+
+    std::vector<T> h_norms(k);
+    bool has_p = false;
+    int iteration = 0;
+
+    solverControl->nIters = 0;
+
+    while (true)
+    {
+        // R = AX - X diag(lambda), kept in Xn until it is preconditioned
+        std::vector<T> h_diag(k * k, 0);
+        for (int j = 0; j < k; j++)
+            h_diag[j + j * k] = h_lambda[j];
+        control->accl_view.copy(h_diag.data(), coef, sizeof(T) * k * k);
+        bcg_update<T>(N, k, k, X, coef, AX, -1, Xn, N, nullptr, control);
+
+        bcg_column_norm2<T>(k, Xn, N, N, norms, control);
+        control->accl_view.copy(norms, h_norms.data(), sizeof(T) * k);
+
+        // an eigenpair has converged once |A x - lambda x| <=
+        // max(relativeTolerance * |lambda|, absoluteTolerance)
+        bool converged = true;
+        double residual = 0;
+        for (int j = 0; j < k; j++)
+        {
+            double r = std::sqrt((double)h_norms[j]);
+            residual = std::max(residual, r);
+            if (r > std::max(solverControl->relativeTolerance * std::fabs((double)h_lambda[j]),
+                             solverControl->absoluteTolerance))
+                converged = false;
+        }
+
+        if (iteration == 0)
+            solverControl->initialResidual = residual;
+        solverControl->currentResidual = residual;
+        solverControl->print();
+
+        if (converged || iteration >= solverControl->maxIters)
+            break;
+
+        // W = M R, AW = A W
+        for (int j = 0; j < k; j++)
+        {
+            hcdenseVector r, w;
+            r.values = Xn + j * N;
+            r.num_values = N;
+            r.offValues = 0;
+            w.values = W + j * N;
+            w.num_values = N;
+            w.offValues = 0;
+            M(&r, &w, control);
+        }
+        bcg_spmm<T, false>(pA, k, W, N, nullptr, AW, N, control);
+
+        // Rayleigh-Ritz on [X W P], or on [X W] when P makes it singular
+        int s = has_p ? 3 * k : 2 * k;
+        lobpcg_host_gram<T>(s, S, S, N, gram, h_G, control);
+        lobpcg_host_gram<T>(s, S, AS, N, gram, h_H, control);
+
+        bool solved = dense_sym_geneig(s, h_H, h_G, h_w, h_C);
+        if (!solved && has_p)
+        {
+            std::vector<double> G2(4 * k * k), H2(4 * k * k);
+            for (int j = 0; j < 2 * k; j++)
+                for (int i = 0; i < 2 * k; i++)
+                {
+                    G2[i + j * 2 * k] = h_G[i + j * s];
+                    H2[i + j * 2 * k] = h_H[i + j * s];
+                }
+            s = 2 * k;
+            solved = dense_sym_geneig(s, H2, G2, h_w, h_C);
+        }
+        if (!solved)
+        {
+            // W is in the span of X: nothing left to improve
+            break;
+        }
+
+        sel = dense_eig_select(s, k, which);
+        for (int j = 0; j < k; j++)
+            h_lambda[j] = h_w[sel[j]];
+
+        // X = [X W P] C, P = [W P] C(k:, :) and the same for their images
+        lobpcg_upload_coef<T>(h_C, s, 0, s, sel, coef, control);
+        lobpcg_upload_coef<T>(h_C, s, k, s - k, sel, coef_p, control);
+
+        bcg_update<T, true>(N, s, k, S, coef, nullptr, 1, Xn, N, nullptr, control);
+        bcg_update<T, true>(N, s, k, AS, coef, nullptr, 1, AXn, N, nullptr, control);
+        bcg_update<T, true>(N, s - k, k, W, coef_p, nullptr, 1, Pn, N, nullptr, control);
+        bcg_update<T, true>(N, s - k, k, AW, coef_p, nullptr, 1, APn, N, nullptr, control);
+
+        control->accl_view.copy(Xn, X, sizeof(T) * k * N);
+        control->accl_view.copy(AXn, AX, sizeof(T) * k * N);
+        control->accl_view.copy(Pn, S + 2 * k * N, sizeof(T) * k * N);
+        control->accl_view.copy(APn, AS + 2 * k * N, sizeof(T) * k * N);
+        has_p = true;
+
+        iteration++;
+        solverControl->nIters = iteration;
+    }
+
+    for (int j = 0; j < k; j++)
+        control->accl_view.copy(X + j * N, userX + j * ldx, sizeof(T) * N);
+    control->accl_view.copy(h_lambda.data(), static_cast<T*>(pLambda->values) + pLambda->offValues,
+                            sizeof(T) * k);
+
+    return hcsparseSuccess;
+}
+
+#endif //_HCSPARSE_SOLVER_LOBPCG_H_
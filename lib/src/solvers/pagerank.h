@@ -0,0 +1,325 @@
+#ifndef _HCSPARSE_SOLVER_PAGERANK_H_
+#define _HCSPARSE_SOLVER_PAGERANK_H_
+
+#include "hcsparse.h"
+
+// work vectors: the second rank buffer and the dangling node indicator
+#define PAGERANK_WORK_VECTORS 2
+// scalars: dangling mass of both rank buffers and the last L1 difference
+#define PAGERANK_WORK_SCALARS 3
+
+// d[j] = 1 for the columns j of M without entries, the dangling nodes
+template <typename T>
+void
+pagerank_dangling (const hcsparseCsrMatrix* pM,
+                   hcdenseVector *d,
+                   hcsparseControl *control)
+{
+    const long nnz = pM->num_nonzeros;
+    const int *colInd = static_cast<const int*>(pM->colIndices) + pM->offColInd;
+    T *avD = static_cast<T*>(d->values) + d->offValues;
+
+    fused_blas1<T>(d->num_values, fused_set(d, fused_const<T>(1)), fused_nop(),
+                   fused_nop(), fused_nop(), control);
+
+    if (nnz == 0)
+        return;
+
+    hc::extent<1> grdExt(BLOCK_SIZE * ((nnz - 1)/BLOCK_SIZE + 1));
+    hc::tiled_extent<1> t_ext = grdExt.tile(BLOCK_SIZE);
+    hc::parallel_for_each(control->accl_view, t_ext, [=] (hc::tiled_index<1>& tidx) [[hc]]
+    {
+        long p = tidx.global[0];
+        if (p < nnz)
+            avD[colInd[p]] = 0;
+    }).wait();
+}
+
+// One power iteration y = damping * M x + (damping * dangling + 1 - damping) v
+// with its epilogue: the same pass accumulates the dangling mass of y and
+// |y - x|_1, and the last tile stores both and raises *done when the
+// difference meets tol. Once *done is set further launches return at once,
+// so the host only needs to look at it every few iterations.
+// SUB lanes share a row as in csrmv_semiring_kernel, the tiles move through
+// the rows in lockstep and lane 0 of each row carries its terms of the
+// epilogue sums. v is the uniform vector 1/n when it is nullptr.
+template <typename T, int SUB>
+void
+pagerank_iteration_kernel (const long n,
+                           const int *rowOff,
+                           const int *colInd,
+                           const T *vals,
+                           const T damping,
+                           const T *v,
+                           const T *isDangling,
+                           const T *x,
+                           T *y,
+                           const T *danglingIn,
+                           T *danglingOut,
+                           T *diff,
+                           const T tol,
+                           const int iteration,
+                           int *done,
+                           hcsparseControl *control)
+{
+    const T uniform = (T)1 / n;
+
+    const int REDUCE_BLOCKS_NUMBER = reduce_num_blocks(n * SUB);
+
+    char *scratch = (char*) reduce_get_scratch(2 * sizeof(T) * REDUCE_BLOCKS_NUMBER, control);
+    unsigned int *counter = (unsigned int*) scratch;
+    T *partial = (T*) (scratch + REDUCE_PARTIAL_OFFSET);
+
+    hc::extent<1> grdExt(REDUCE_BLOCKS_NUMBER * BLOCK_SIZE);
+    hc::tiled_extent<1> t_ext = grdExt.tile(BLOCK_SIZE);
+    hc::parallel_for_each(control->accl_view, t_ext, [=] (hc::tiled_index<1>& tidx) [[hc]]
+    {
+        tile_static T buf_tmp[BLOCK_SIZE];
+        tile_static bool is_last;
+
+        if (*done)
+            return;
+
+        int lid = tidx.local[0];
+        const int thread_lane = lid & (SUB - 1);
+        const long num_vectors = (long)REDUCE_BLOCKS_NUMBER * (BLOCK_SIZE / SUB);
+        const T teleport = damping * (*danglingIn) + (1 - damping);
+        T sum_dangling = 0;
+        T sum_diff = 0;
+
+        for (long base = (long)tidx.tile[0] * (BLOCK_SIZE / SUB); base < n; base += num_vectors)
+        {
+            const long row = base + lid / SUB;
+
+            T sum = 0;
+            if (row < n)
+            {
+                for (int p = rowOff[row] + thread_lane; p < rowOff[row + 1]; p += SUB)
+                    sum += vals[p] * x[colInd[p]];
+            }
+
+            buf_tmp[lid] = sum;
+            for (int i = SUB >> 1; i > 0; i >>= 1)
+            {
+                tidx.barrier.wait();
+                if (thread_lane < i)
+                    sum += buf_tmp[lid + i];
+                tidx.barrier.wait();
+                buf_tmp[lid] = sum;
+            }
+
+            if (thread_lane == 0 && row < n)
+            {
+                T yi = damping * sum + teleport * (v == nullptr ? uniform : v[row]);
+                y[row] = yi;
+
+                sum_dangling += isDangling[row] * yi;
+                T d = yi - x[row];
+                sum_diff += d < 0 ? -d : d;
+            }
+
+            tidx.barrier.wait();
+        }
+
+        sum_dangling = tile_reduce<T>(sum_dangling, buf_tmp, tidx);
+        sum_diff = tile_reduce<T>(sum_diff, buf_tmp, tidx);
+        if (lid == 0)
+        {
+            partial[tidx.tile[0]] = sum_dangling;
+            partial[REDUCE_BLOCKS_NUMBER + tidx.tile[0]] = sum_diff;
+        }
+        tidx.barrier.wait_with_global_memory_fence();
+
+        if (lid == 0)
+            is_last = (hc::atomic_fetch_inc(counter) == (unsigned int)(REDUCE_BLOCKS_NUMBER - 1));
+        tidx.barrier.wait_with_global_memory_fence();
+
+        if (!is_last)
+            return;
+
+        T acc0 = 0;
+        T acc1 = 0;
+        for (int i = lid; i < REDUCE_BLOCKS_NUMBER; i += BLOCK_SIZE)
+        {
+            acc0 += partial[i];
+            acc1 += partial[REDUCE_BLOCKS_NUMBER + i];
+        }
+        acc0 = tile_reduce<T>(acc0, buf_tmp, tidx);
+        acc1 = tile_reduce<T>(acc1, buf_tmp, tidx);
+
+        if (lid == 0)
+        {
+            *danglingOut = acc0;
+            *diff = acc1;
+            if (acc1 <= tol)
+                *done = iteration + 1;
+            *counter = 0;
+        }
+    }).wait();
+}
+
+// Lanes per row from the average row length of M, as csrmv_semiring picks
+// them: a power of two, at least 2 and at most a wavefront
+template <typename T>
+void
+pagerank_iteration (const hcsparseCsrMatrix* pM,
+                    const T damping,
+                    const T *v,
+                    const T *isDangling,
+                    const T *x,
+                    T *y,
+                    const T *danglingIn,
+                    T *danglingOut,
+                    T *diff,
+                    const T tol,
+                    const int iteration,
+                    int *done,
+                    hcsparseControl *control)
+{
+    const long n = pM->num_rows;
+    const int *rowOff = static_cast<const int*>(pM->rowOffsets) + pM->offRowOff;
+    const int *colInd = static_cast<const int*>(pM->colIndices) + pM->offColInd;
+    const T *vals = static_cast<const T*>(pM->values) + pM->offValues;
+    const uint nnz_per_row = pM->nnz_per_row();
+
+    int sub = 2;
+    while (sub < 64 && sub < (int)nnz_per_row)
+        sub <<= 1;
+
+    switch (sub)
+    {
+    case 2:
+        pagerank_iteration_kernel<T, 2>(n, rowOff, colInd, vals, damping, v, isDangling, x, y,
+                                        danglingIn, danglingOut, diff, tol, iteration, done, control);
+        break;
+    case 4:
+        pagerank_iteration_kernel<T, 4>(n, rowOff, colInd, vals, damping, v, isDangling, x, y,
+                                        danglingIn, danglingOut, diff, tol, iteration, done, control);
+        break;
+    case 8:
+        pagerank_iteration_kernel<T, 8>(n, rowOff, colInd, vals, damping, v, isDangling, x, y,
+                                        danglingIn, danglingOut, diff, tol, iteration, done, control);
+        break;
+    case 16:
+        pagerank_iteration_kernel<T, 16>(n, rowOff, colInd, vals, damping, v, isDangling, x, y,
+                                         danglingIn, danglingOut, diff, tol, iteration, done, control);
+        break;
+    case 32:
+        pagerank_iteration_kernel<T, 32>(n, rowOff, colInd, vals, damping, v, isDangling, x, y,
+                                         danglingIn, danglingOut, diff, tol, iteration, done, control);
+        break;
+    default:
+        pagerank_iteration_kernel<T, 64>(n, rowOff, colInd, vals, damping, v, isDangling, x, y,
+                                         danglingIn, danglingOut, diff, tol, iteration, done, control);
+        break;
+    }
+}
+
+/*
+ * PageRank by power iteration on the column stochastic transition matrix
+ * M, M(i, j) = 1 / outdegree(j) for every link j -> i; nodes without out
+ * links are the empty columns of M and spread their rank following the
+ * teleport vector v (uniform when pV is nullptr), which should sum to one.
+ * Starting from x = v, every iteration is a single kernel. The iteration
+ * stops when |x_{k+1} - x_k|_1 <= relativeTolerance; the test runs on the
+ * device and the host reads its result every checkInterval iterations.
+ */
+template<typename T>
+hcsparseStatus
+pagerank (hcdenseVector *pX,
+          const hcsparseCsrMatrix* pM,
+          const hcdenseVector *pV,
+          const T damping,
+          hcsparseSolverControl *solverControl,
+          hcsparseSolverWorkspace *workspace,
+          hcsparseControl *control)
+{
+    if (pM->num_rows != pM->num_cols || pM->num_rows != pX->num_values ||
+        (pV != nullptr && pV->num_values != pX->num_values) ||
+        damping < 0 || damping >= 1)
+    {
+        return hcsparseInvalid;
+    }
+
+    hcsparseStatus status;
+
+    const auto N = pM->num_rows;
+
+    status = workspace_reserve<T>(workspace, PAGERANK_WORK_VECTORS, PAGERANK_WORK_SCALARS, control);
+    if (status != hcsparseSuccess)
+    {
+        return hcsparseInvalid;
+    }
+
+    hcdenseVector x_alt;
+    hcdenseVector d;
+
+    workspace_vector<T>(workspace, 0, &x_alt);
+    workspace_vector<T>(workspace, 1, &d);
+
+    hcsparseScalar dangling[2];
+    hcsparseScalar diff;
+
+    workspace_scalar<T>(workspace, 0, &dangling[0]);
+    workspace_scalar<T>(workspace, 1, &dangling[1]);
+    workspace_scalar<T>(workspace, 2, &diff);
+
+    pagerank_dangling<T>(pM, &d, control);
+
+    // x = v, dangling[0] = <d, x>
+    if (pV != nullptr)
+        status = fused_blas1<T>(N, fused_set(pX, fused_vec<T>(pV)), fused_nop(),
+                                fused_dot(&dangling[0], fused_vec<T>(&d), fused_vec<T>(pX)),
+                                fused_nop(), control);
+    else
+        status = fused_blas1<T>(N, fused_set(pX, fused_const<T>((T)1 / N)), fused_nop(),
+                                fused_dot(&dangling[0], fused_vec<T>(&d), fused_vec<T>(pX)),
+                                fused_nop(), control);
+
+    hc::accelerator acc = (control->accl_view).get_accelerator();
+    int *done = (int*) am_alloc(sizeof(int), acc, 0);
+    int h_done = 0;
+    control->accl_view.copy(&h_done, done, sizeof(int));
+
+    T *buffers[2] = { static_cast<T*>(pX->values) + pX->offValues,
+                      static_cast<T*>(x_alt.values) };
+    const T *v = pV == nullptr ? nullptr : static_cast<const T*>(pV->values) + pV->offValues;
+    const T *isDangling = static_cast<const T*>(d.values);
+    const T tol = solverControl->relativeTolerance;
+
+    int iteration = 0;
+    while (iteration < solverControl->maxIters)
+    {
+        int p = iteration % 2;
+        pagerank_iteration<T>(pM, damping, v, isDangling, buffers[p], buffers[1 - p],
+                              static_cast<T*>(dangling[p].value),
+                              static_cast<T*>(dangling[1 - p].value),
+                              static_cast<T*>(diff.value), tol, iteration, done, control);
+        iteration++;
+
+        if (solverControl->checkDue(iteration))
+        {
+            control->accl_view.copy(done, &h_done, sizeof(int));
+            if (h_done)
+                break;
+        }
+    }
+
+    // iterations actually run; the rank is in the buffer they ended on
+    int completed = h_done ? h_done : iteration;
+    if (completed % 2 == 1)
+        control->accl_view.copy(buffers[1], buffers[0], sizeof(T) * N);
+
+    T h_diff = 0;
+    if (completed > 0)
+        control->accl_view.copy(diff.value, &h_diff, sizeof(T));
+
+    solverControl->nIters = completed;
+    solverControl->currentResidual = h_diff;
+
+    am_free(done);
+
+    return hcsparseSuccess;
+}
+
+#endif //_HCSPARSE_SOLVER_PAGERANK_H_
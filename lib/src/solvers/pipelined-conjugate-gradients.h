@@ -0,0 +1,343 @@
+#ifndef _HCSPARSE_SOLVER_PIPECG_H_
+#define _HCSPARSE_SOLVER_PIPECG_H_
+
+#include "hcsparse.h"
+
+// work vectors and scalars used by pipecg inside a hcsparseSolverWorkspace
+#define PIPECG_WORK_VECTORS 9
+#define PIPECG_WORK_SCALARS (2 + 2 * PIPECG_COEFFS)
+
+// Recurrence coefficients of one iteration. Two sets are used alternately:
+// the current one holds gamma_i and delta_i, the other one gamma_{i-1} and
+// alpha_{i-1} and receives gamma_{i+1} and delta_{i+1}.
+#define PIPECG_GAMMA 0
+#define PIPECG_DELTA 1
+#define PIPECG_ALPHA 2
+#define PIPECG_COEFFS 3
+
+/*
+ * All vector recurrences of one pipelined CG iteration followed by the
+ * reductions of the next one, in a single kernel:
+ *
+ *   z = n + beta*z   q = m + beta*q   s = w + beta*s   p = u + beta*p
+ *   x = x + alpha*p  r = r - alpha*s  u = u - alpha*q  w = w - alpha*z
+ *   gamma = <r, u>   delta = <w, u>   norm_r = |r|
+ *
+ * alpha and beta are derived by every thread from the coefficient sets, so
+ * nothing goes through the host.
+ */
+template <typename T, ReduceOperator NORM_OP, ReduceOperator NORM_F>
+void pipecg_update (const long size,
+                    const bool first,
+                    T *cur,
+                    T *prev,
+                    T *norm_r,
+                    T *x,
+                    T *r,
+                    T *u,
+                    T *w,
+                    T *p,
+                    T *s,
+                    T *q,
+                    T *z,
+                    const T *m,
+                    const T *n,
+                    hcsparseControl *control)
+{
+    const int REDUCE_BLOCKS_NUMBER = reduce_num_blocks(size);
+
+    char *scratch = (char*) reduce_get_scratch(3 * sizeof(T) * REDUCE_BLOCKS_NUMBER, control);
+    unsigned int *counter = (unsigned int*) scratch;
+    T *partial = (T*) (scratch + REDUCE_PARTIAL_OFFSET);
+
+    hc::extent<1> grdExt(REDUCE_BLOCKS_NUMBER * BLOCK_SIZE);
+    hc::tiled_extent<1> t_ext = grdExt.tile(BLOCK_SIZE);
+    hc::parallel_for_each(control->accl_view, t_ext, [=] (hc::tiled_index<1>& tidx) [[hc]]
+    {
+        tile_static T buf_tmp[BLOCK_SIZE];
+        tile_static bool is_last;
+        int lid = tidx.local[0];
+
+        T gamma = cur[PIPECG_GAMMA];
+        T delta = cur[PIPECG_DELTA];
+        T alpha, beta;
+        if (first)
+        {
+            beta = 0;
+            alpha = div<T>(gamma, delta);
+        }
+        else
+        {
+            beta = div<T>(gamma, prev[PIPECG_GAMMA]);
+            alpha = div<T>(gamma, delta - div<T>(beta * gamma, prev[PIPECG_ALPHA]));
+        }
+
+        T g = 0;
+        T d = 0;
+        T nr = 0;
+
+        long i = tidx.global[0];
+        while (i < size)
+        {
+            T zi = first ? n[i] : n[i] + beta * z[i];
+            T qi = first ? m[i] : m[i] + beta * q[i];
+            T si = first ? w[i] : w[i] + beta * s[i];
+            T pi = first ? u[i] : u[i] + beta * p[i];
+            T ri = r[i] - alpha * si;
+            T ui = u[i] - alpha * qi;
+            T wi = w[i] - alpha * zi;
+
+            z[i] = zi;
+            q[i] = qi;
+            s[i] = si;
+            p[i] = pi;
+            x[i] += alpha * pi;
+            r[i] = ri;
+            u[i] = ui;
+            w[i] = wi;
+
+            g += ri * ui;
+            d += wi * ui;
+            nr = reduceOperation<T, NORM_OP>(nr, ri);
+
+            i += REDUCE_BLOCKS_NUMBER * BLOCK_SIZE;
+        }
+
+        g = tile_reduce<T>(g, buf_tmp, tidx);
+        d = tile_reduce<T>(d, buf_tmp, tidx);
+        nr = tile_reduce<T, NORM_OP>(nr, buf_tmp, tidx);
+        if (lid == 0)
+        {
+            partial[tidx.tile[0]] = g;
+            partial[REDUCE_BLOCKS_NUMBER + tidx.tile[0]] = d;
+            partial[2 * REDUCE_BLOCKS_NUMBER + tidx.tile[0]] = nr;
+        }
+        tidx.barrier.wait_with_global_memory_fence();
+
+        if (lid == 0)
+            is_last = (hc::atomic_fetch_inc(counter) == (unsigned int)(REDUCE_BLOCKS_NUMBER - 1));
+        tidx.barrier.wait_with_global_memory_fence();
+
+        if (!is_last)
+            return;
+
+        // every other tile is past its reads of cur and prev at this point
+        g = 0;
+        d = 0;
+        nr = 0;
+        for (int j = lid; j < REDUCE_BLOCKS_NUMBER; j += BLOCK_SIZE)
+        {
+            g += partial[j];
+            d += partial[REDUCE_BLOCKS_NUMBER + j];
+            nr = reduceCombine<T, NORM_OP>(nr, partial[2 * REDUCE_BLOCKS_NUMBER + j]);
+        }
+        g = tile_reduce<T>(g, buf_tmp, tidx);
+        d = tile_reduce<T>(d, buf_tmp, tidx);
+        nr = tile_reduce<T, NORM_OP>(nr, buf_tmp, tidx);
+
+        if (lid == 0)
+        {
+            cur[PIPECG_ALPHA] = alpha;
+            prev[PIPECG_GAMMA] = g;
+            prev[PIPECG_DELTA] = d;
+            *norm_r = reduceOperation<T, NORM_F>(nr);
+            *counter = 0;
+        }
+    }).wait();
+}
+
+template <typename T>
+void pipecg_update (const SOLVER_NORM norm,
+                    const long size,
+                    const bool first,
+                    T *cur,
+                    T *prev,
+                    T *norm_r,
+                    T *x, T *r, T *u, T *w,
+                    T *p, T *s, T *q, T *z,
+                    const T *m, const T *n,
+                    hcsparseControl *control)
+{
+    switch (norm)
+    {
+    case NORM_L1:
+        pipecg_update<T, RO_FABS, RO_DUMMY>(size, first, cur, prev, norm_r,
+                                            x, r, u, w, p, s, q, z, m, n, control);
+        break;
+    case NORM_LINF:
+        pipecg_update<T, RO_FMAX, RO_DUMMY>(size, first, cur, prev, norm_r,
+                                            x, r, u, w, p, s, q, z, m, n, control);
+        break;
+    default:
+        pipecg_update<T, RO_SQR, RO_SQRT>(size, first, cur, prev, norm_r,
+                                          x, r, u, w, p, s, q, z, m, n, control);
+        break;
+    }
+}
+
+/*
+ * Pipelined preconditioned conjugate gradients after
+ * P. Ghysels, W. Vanroose, "Hiding global synchronization latency in the
+ * preconditioned Conjugate Gradient algorithm", Parallel Computing 40 (2014).
+ * The recurrences are arranged so that each iteration has a single global
+ * reduction, which is fused with the vector updates, and the preconditioner
+ * and SpMV of the iteration do not depend on it.
+ */
+template<typename T, typename PTYPE>
+hcsparseStatus
+pipecg (hcdenseVector *pX,
+        const hcsparseCsrMatrix* pA,
+        const hcdenseVector *pB,
+        PTYPE& M,
+        hcsparseSolverControl *solverControl,
+        hcsparseSolverWorkspace *workspace,
+        hcsparseControl *control)
+{
+    assert( pA->num_cols == pB->num_values );
+    assert( pA->num_rows == pX->num_values );
+    if( ( pA->num_cols != pB->num_values ) || ( pA->num_rows != pX->num_values ) )
+    {
+        return hcsparseInvalid;
+    }
+
+    int status;
+
+    const auto N = pA->num_cols;
+
+    status = workspace_reserve<T>(workspace, PIPECG_WORK_VECTORS, PIPECG_WORK_SCALARS, control);
+    if (status != hcsparseSuccess)
+    {
+        return hcsparseInvalid;
+    }
+
+    hcdenseVector r, u, w, m, n, z, q, s, p;
+
+    workspace_vector<T>(workspace, 0, &r);
+    workspace_vector<T>(workspace, 1, &u);
+    workspace_vector<T>(workspace, 2, &w);
+    workspace_vector<T>(workspace, 3, &m);
+    workspace_vector<T>(workspace, 4, &n);
+    workspace_vector<T>(workspace, 5, &z);
+    workspace_vector<T>(workspace, 6, &q);
+    workspace_vector<T>(workspace, 7, &s);
+    workspace_vector<T>(workspace, 8, &p);
+
+    hcsparseScalar one;
+    hcsparseScalar zero;
+    hcsparseScalar norm_b;
+    hcsparseScalar norm_r;
+    hcsparseScalar coeffs;
+
+    workspace_constants<T>(workspace, &one, &zero);
+    workspace_scalar<T>(workspace, 0, &norm_b);
+    workspace_scalar<T>(workspace, 1, &norm_r);
+    workspace_scalar<T>(workspace, 2, &coeffs);
+
+    T *coeff_sets[2];
+    coeff_sets[0] = static_cast<T*>(coeffs.value);
+    coeff_sets[1] = coeff_sets[0] + PIPECG_COEFFS;
+
+    hcsparseScalar gamma0;
+    hcsparseScalar delta0;
+    gamma0.value = coeff_sets[0] + PIPECG_GAMMA;
+    gamma0.offValue = 0;
+    delta0.value = coeff_sets[0] + PIPECG_DELTA;
+    delta0.offValue = 0;
+
+    const SOLVER_NORM norm = solverControl->residualNorm;
+
+    //norm of rhs of equation
+    status = fused_blas1_norm<T>(N, fused_nop(), fused_nop(),
+                                 norm, &norm_b, fused_vec<T>(pB),
+                                 fused_nop(), control);
+
+    T h_norm_b = 0;
+    control->accl_view.copy(norm_b.value, &h_norm_b, sizeof(T)*1);
+
+    if (h_norm_b == 0) //special case b is zero so solution is x = 0
+    {
+        solverControl->nIters = 0;
+        solverControl->absoluteTolerance = 0.0;
+        solverControl->relativeTolerance = 0.0;
+        control->accl_view.copy(pB->values, pX->values, sizeof(T)*pX->num_values);
+
+        return hcsparseSuccess;
+    }
+
+    // r = b - A*x, m is free until the loop starts
+    status = csrmv<T>(&one, pA, pX, &zero, &m, control);
+
+    status = fused_blas1_norm<T>(N, fused_set(&r, fused_vec<T>(pB) - fused_vec<T>(&m)), fused_nop(),
+                                 norm, &norm_r, fused_vec<T>(&r),
+                                 fused_nop(), control);
+
+    T h_norm_r = 0;
+    control->accl_view.copy(norm_r.value, &h_norm_r, sizeof(T)*1);
+
+    T residuum = div<T>(h_norm_r, h_norm_b);
+
+    solverControl->initialResidual = residuum;
+    if (solverControl->finished(solverControl->initialResidual))
+    {
+        solverControl->nIters = 0;
+        return hcsparseSuccess;
+    }
+
+    // u = M*r, w = A*u, gamma = <r, u>, delta = <w, u>
+    M(&r, &u, control);
+    status = csrmv<T>(&one, pA, &u, &zero, &w, control);
+
+    status = fused_blas1<T>(N,
+                            fused_nop(),
+                            fused_nop(),
+                            fused_dot(&gamma0, fused_vec<T>(&r), fused_vec<T>(&u)),
+                            fused_dot(&delta0, fused_vec<T>(&w), fused_vec<T>(&u)),
+                            control);
+
+    T *x = static_cast<T*>(pX->values) + pX->offValues;
+
+    int iteration = 0;
+    bool converged = false;
+
+    while (!converged)
+    {
+        T *cur = coeff_sets[iteration % 2];
+        T *prev = coeff_sets[(iteration + 1) % 2];
+
+        // m = M*w, n = A*m; independent of this iteration's reduction
+        M(&w, &m, control);
+        status = csrmv<T>(&one, pA, &m, &zero, &n, control);
+
+        pipecg_update<T>(norm, N, iteration == 0, cur, prev,
+                         static_cast<T*>(norm_r.value),
+                         x,
+                         static_cast<T*>(r.values),
+                         static_cast<T*>(u.values),
+                         static_cast<T*>(w.values),
+                         static_cast<T*>(p.values),
+                         static_cast<T*>(s.values),
+                         static_cast<T*>(q.values),
+                         static_cast<T*>(z.values),
+                         static_cast<const T*>(m.values),
+                         static_cast<const T*>(n.values),
+                         control);
+
+        iteration++;
+        solverControl->nIters = iteration;
+
+        if (solverControl->checkDue(iteration))
+        {
+            control->accl_view.copy(norm_r.value, &h_norm_r, sizeof(T)*1);
+
+            residuum = div<T>(h_norm_r, h_norm_b);
+
+            converged = solverControl->finished(residuum);
+
+            solverControl->print();
+        }
+    }
+
+    return hcsparseSuccess;
+}
+
+#endif //_HCSPARSE_SOLVER_PIPECG_H_
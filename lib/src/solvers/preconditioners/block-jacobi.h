@@ -0,0 +1,311 @@
+#ifndef _HCSPARSE_PREC_BLOCK_JACOBI_H_
+#define _HCSPARSE_PREC_BLOCK_JACOBI_H_
+
+#include "preconditioner.h"
+#include "preconditioner_utils.h"
+#include <algorithm>
+#include <vector>
+
+/* Block-Jacobi preconditioner: P = blockdiag(A_11, ..., A_kk).
+   The diagonal blocks are either of a fixed size or given by a partition
+   of the rows, they are copied out of A into small dense matrices and all
+   inverted by one batched kernel, one thread per block. Applying the
+   preconditioner is then a batched dense matrix vector product with one
+   thread per row, as parallel as the scalar DiagonalPreconditioner.
+*/
+
+// largest supported diagonal block
+#define BLOCK_JACOBI_MAX_SIZE 32
+
+// A row partition starts at 0, ends at num_rows (when known, >= 0) and
+// has no empty block
+inline bool
+block_jacobi_valid_offsets (const int* blockOffsets,
+                            int numBlocks,
+                            int num_rows)
+{
+    if (blockOffsets == nullptr || numBlocks < 1 || blockOffsets[0] != 0)
+        return false;
+
+    for (int b = 0; b < numBlocks; b++)
+        if (blockOffsets[b + 1] <= blockOffsets[b])
+            return false;
+
+    return num_rows < 0 || blockOffsets[numBlocks] == num_rows;
+}
+
+template<typename T>
+class BlockJacobiPreconditioner
+{
+public:
+    // blockOffsets (host, numBlocks + 1 entries) partitions the rows, see
+    // block_jacobi_valid_offsets; when it is nullptr the rows are cut into
+    // blocks of blockSize
+    BlockJacobiPreconditioner(const hcsparseCsrMatrix* A,
+                              int blockSize,
+                              const int* blockOffsets,
+                              int numBlocks,
+                              hcsparseControl* control)
+    {
+        int n = A->num_rows;
+        hc::accelerator acc = (control->accl_view).get_accelerator();
+
+        std::vector<int> h_blockPtr;
+        if (blockOffsets != nullptr && numBlocks > 0)
+        {
+            h_blockPtr.assign(blockOffsets, blockOffsets + numBlocks + 1);
+        }
+        else
+        {
+            int bs = std::max(1, std::min(blockSize, BLOCK_JACOBI_MAX_SIZE));
+            for (int i = 0; i < n; i += bs)
+                h_blockPtr.push_back(i);
+            h_blockPtr.push_back(n);
+        }
+        num_blocks = h_blockPtr.size() - 1;
+
+        // block of every row and the start of every dense block
+        std::vector<int> h_rowBlock(n, 0);
+        std::vector<int> h_valPtr(num_blocks + 1, 0);
+        for (int b = 0; b < num_blocks; b++)
+        {
+            int size = std::min(h_blockPtr[b + 1] - h_blockPtr[b], BLOCK_JACOBI_MAX_SIZE);
+            // oversized blocks are cut, the remaining rows form the next block
+            if (h_blockPtr[b] + size < h_blockPtr[b + 1])
+            {
+                h_blockPtr.insert(h_blockPtr.begin() + b + 1, h_blockPtr[b] + size);
+                h_valPtr.push_back(0);
+                num_blocks++;
+            }
+            for (int i = h_blockPtr[b]; i < h_blockPtr[b + 1]; i++)
+                h_rowBlock[i] = b;
+            h_valPtr[b + 1] = h_valPtr[b] + size * size;
+        }
+        int num_block_values = h_valPtr[num_blocks];
+
+        blockPtr = (int*) am_alloc(sizeof(int) * (num_blocks + 1), acc, 0);
+        rowBlock = (int*) am_alloc(sizeof(int) * std::max(n, 1), acc, 0);
+        valPtr = (int*) am_alloc(sizeof(int) * (num_blocks + 1), acc, 0);
+        invBlocks = (T*) am_alloc(sizeof(T) * std::max(num_block_values, 1), acc, 0);
+        T *luBlocks = (T*) am_alloc(sizeof(T) * std::max(num_block_values, 1), acc, 0);
+
+        control->accl_view.copy(h_blockPtr.data(), blockPtr, sizeof(int) * (num_blocks + 1));
+        control->accl_view.copy(h_rowBlock.data(), rowBlock, sizeof(int) * n);
+        control->accl_view.copy(h_valPtr.data(), valPtr, sizeof(int) * (num_blocks + 1));
+
+        std::vector<T> zeros(num_block_values, 0);
+        control->accl_view.copy(zeros.data(), luBlocks, sizeof(T) * num_block_values);
+
+        extract_blocks(A, luBlocks, control);
+        invert_blocks(luBlocks, control);
+
+        am_free(luBlocks);
+        num_rows = n;
+    }
+
+    // apply preconditioner y = P^{-1} x
+    void operator ()(const hcdenseVector *x,
+                     hcdenseVector *y,
+                     hcsparseControl* control)
+    {
+        const int n = num_rows;
+        const int *bPtr = blockPtr;
+        const int *rBlock = rowBlock;
+        const int *vPtr = valPtr;
+        const T *inv = invBlocks;
+        const T *avX = static_cast<const T*>(x->values) + x->offValues;
+        T *avY = static_cast<T*>(y->values) + y->offValues;
+
+        hc::extent<1> grdExt(GROUP_SIZE * ((n - 1)/GROUP_SIZE + 1));
+        hc::tiled_extent<1> t_ext = grdExt.tile(GROUP_SIZE);
+        hc::parallel_for_each(control->accl_view, t_ext, [=] (hc::tiled_index<1>& tidx) [[hc]]
+        {
+            int row = tidx.global[0];
+            if (row < n)
+            {
+                int b = rBlock[row];
+                int start = bPtr[b];
+                int size = bPtr[b + 1] - start;
+                const T *r = inv + vPtr[b] + (row - start) * size;
+
+                T sum = 0;
+                for (int j = 0; j < size; j++)
+                    sum += r[j] * avX[start + j];
+                avY[row] = sum;
+            }
+        }).wait();
+    }
+
+    ~BlockJacobiPreconditioner()
+    {
+        am_free(blockPtr);
+        am_free(rowBlock);
+        am_free(valPtr);
+        am_free(invBlocks);
+    }
+
+private:
+    // copies the entries of A inside the diagonal blocks, one thread per row
+    void extract_blocks(const hcsparseCsrMatrix* A,
+                        T *blocks,
+                        hcsparseControl* control)
+    {
+        const int n = A->num_rows;
+        const int *rowOff = static_cast<const int*>(A->rowOffsets);
+        const int *colInd = static_cast<const int*>(A->colIndices);
+        const T *vals = static_cast<const T*>(A->values);
+        const int *bPtr = blockPtr;
+        const int *rBlock = rowBlock;
+        const int *vPtr = valPtr;
+
+        hc::extent<1> grdExt(GROUP_SIZE * ((n - 1)/GROUP_SIZE + 1));
+        hc::tiled_extent<1> t_ext = grdExt.tile(GROUP_SIZE);
+        hc::parallel_for_each(control->accl_view, t_ext, [=] (hc::tiled_index<1>& tidx) [[hc]]
+        {
+            int row = tidx.global[0];
+            if (row < n)
+            {
+                int b = rBlock[row];
+                int start = bPtr[b];
+                int end = bPtr[b + 1];
+                int size = end - start;
+                T *r = blocks + vPtr[b] + (row - start) * size;
+
+                for (int p = rowOff[row]; p < rowOff[row + 1]; p++)
+                {
+                    int col = colInd[p];
+                    if (col >= start && col < end)
+                        r[col - start] = vals[p];
+                }
+            }
+        }).wait();
+    }
+
+    // LU with partial pivoting of every block followed by the solves for
+    // the columns of the identity; one thread per block. Singular pivots
+    // leave the corresponding entries zero.
+    void invert_blocks(T *lu,
+                       hcsparseControl* control)
+    {
+        const int nb = num_blocks;
+        const int *bPtr = blockPtr;
+        const int *vPtr = valPtr;
+        T *inv = invBlocks;
+
+        hc::extent<1> grdExt(GROUP_SIZE * ((nb - 1)/GROUP_SIZE + 1));
+        hc::tiled_extent<1> t_ext = grdExt.tile(GROUP_SIZE);
+        hc::parallel_for_each(control->accl_view, t_ext, [=] (hc::tiled_index<1>& tidx) [[hc]]
+        {
+            int b = tidx.global[0];
+            if (b < nb)
+            {
+                int s = bPtr[b + 1] - bPtr[b];
+                T *a = lu + vPtr[b];
+                T *ai = inv + vPtr[b];
+                int piv[BLOCK_JACOBI_MAX_SIZE];
+
+                for (int k = 0; k < s; k++)
+                {
+                    int pk = k;
+                    T pmax = a[k * s + k] < 0 ? -a[k * s + k] : a[k * s + k];
+                    for (int i = k + 1; i < s; i++)
+                    {
+                        T v = a[i * s + k] < 0 ? -a[i * s + k] : a[i * s + k];
+                        if (v > pmax)
+                        {
+                            pmax = v;
+                            pk = i;
+                        }
+                    }
+                    piv[k] = pk;
+                    if (pk != k)
+                    {
+                        for (int j = 0; j < s; j++)
+                        {
+                            T t = a[k * s + j];
+                            a[k * s + j] = a[pk * s + j];
+                            a[pk * s + j] = t;
+                        }
+                    }
+
+                    T d = a[k * s + k];
+                    for (int i = k + 1; i < s; i++)
+                    {
+                        T f = d == 0 ? 0 : a[i * s + k] / d;
+                        a[i * s + k] = f;
+                        for (int j = k + 1; j < s; j++)
+                            a[i * s + j] -= f * a[k * s + j];
+                    }
+                }
+
+                // column c of the inverse solves L U x = P e_c
+                for (int c = 0; c < s; c++)
+                {
+                    for (int i = 0; i < s; i++)
+                        ai[i * s + c] = i == c ? 1 : 0;
+                    for (int k = 0; k < s; k++)
+                    {
+                        T t = ai[k * s + c];
+                        ai[k * s + c] = ai[piv[k] * s + c];
+                        ai[piv[k] * s + c] = t;
+                    }
+                    for (int i = 0; i < s; i++)
+                        for (int j = 0; j < i; j++)
+                            ai[i * s + c] -= a[i * s + j] * ai[j * s + c];
+                    for (int i = s - 1; i >= 0; i--)
+                    {
+                        for (int j = i + 1; j < s; j++)
+                            ai[i * s + c] -= a[i * s + j] * ai[j * s + c];
+                        T d = a[i * s + i];
+                        ai[i * s + c] = d == 0 ? 0 : ai[i * s + c] / d;
+                    }
+                }
+            }
+        }).wait();
+    }
+
+    int num_rows;
+    int num_blocks;
+
+    // first row of every block, numBlocks + 1 entries
+    int *blockPtr;
+    // block of every row
+    int *rowBlock;
+    // start of every inverted block in invBlocks, row major
+    int *valPtr;
+    T *invBlocks;
+};
+
+
+template<typename T>
+class BlockJacobiHandler : public PreconditionerHandler<T>
+{
+public:
+
+    using BlockJacobi = BlockJacobiPreconditioner<T>;
+
+    BlockJacobiHandler(int blockSize, const int* blockOffsets, int numBlocks)
+        : blockSize(blockSize), blockOffsets(blockOffsets), numBlocks(numBlocks)
+    {
+    }
+
+    void operator()(const hcdenseVector *x,
+                    hcdenseVector *y,
+                    hcsparseControl* control)
+    {
+        (*block_jacobi)(x, y, control);
+    }
+
+    void notify(const hcsparseCsrMatrix* pA, hcsparseControl* control)
+    {
+        block_jacobi = std::make_shared<BlockJacobi>(pA, blockSize, blockOffsets, numBlocks, control);
+    }
+
+private:
+    int blockSize;
+    const int* blockOffsets;
+    int numBlocks;
+    std::shared_ptr<BlockJacobi> block_jacobi;
+};
+
+#endif //_HCSPARSE_PREC_BLOCK_JACOBI_H_
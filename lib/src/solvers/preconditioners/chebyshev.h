@@ -0,0 +1,247 @@
+#ifndef _HCSPARSE_PREC_CHEBYSHEV_H_
+#define _HCSPARSE_PREC_CHEBYSHEV_H_
+
+#include "preconditioner.h"
+#include "preconditioner_utils.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+/* Chebyshev polynomial preconditioner for the Jacobi scaled system
+   D^{-1} A y = D^{-1} x. A fixed number of Chebyshev iterations damps the
+   error on the interval [lambda_max / ratio, lambda_max] of the spectrum
+   of D^{-1} A, lambda_max being estimated by a few power iterations when
+   the preconditioner is created. Every step is one csrmv and one fused
+   vector update, with no sequential dependencies between rows.
+   The same polynomial serves as smoother inside the AMG cycle, where the
+   upper part of the spectrum is all that has to be damped.
+*/
+
+#define CHEBYSHEV_DEGREE 3
+#define CHEBYSHEV_EIG_RATIO 30.0
+#define CHEBYSHEV_POWER_ITERATIONS 10
+// lambda_max estimates from the power method are low, widen them a bit
+#define CHEBYSHEV_BOUND_SAFETY 1.1
+
+template<typename T>
+class ChebyshevPolynomial
+{
+public:
+    // A and invDiag are borrowed and have to outlive the polynomial
+    ChebyshevPolynomial(const hcsparseCsrMatrix* A,
+                        const hcdenseVector* invDiag,
+                        int degree,
+                        hcsparseControl* control) : A(A), invDiag(invDiag), degree(degree)
+    {
+        hc::accelerator acc = (control->accl_view).get_accelerator();
+        int n = A->num_rows;
+
+        T h_scalars[3] = { 1, 0, 0 };
+        scalars = (T*) am_alloc(sizeof(T) * 3, acc, 0);
+        control->accl_view.copy(h_scalars, scalars, sizeof(T) * 3);
+        one.value = scalars;
+        one.offValue = 0;
+        zero.value = scalars + 1;
+        zero.offValue = 0;
+        norm.value = scalars + 2;
+        norm.offValue = 0;
+
+        d.values = am_alloc(sizeof(T) * std::max(n, 1), acc, 0);
+        d.num_values = n;
+        d.offValues = 0;
+        r.values = am_alloc(sizeof(T) * std::max(n, 1), acc, 0);
+        r.num_values = n;
+        r.offValues = 0;
+
+        lambda_max = estimate_lambda_max(control) * CHEBYSHEV_BOUND_SAFETY;
+        lambda_min = lambda_max / CHEBYSHEV_EIG_RATIO;
+    }
+
+    // degree Chebyshev steps for A x = b, from x = 0 when zero_guess is set
+    void apply(const hcdenseVector *b,
+               hcdenseVector *x,
+               bool zero_guess,
+               hcsparseControl* control)
+    {
+        const int n = A->num_rows;
+        const T theta = (lambda_max + lambda_min) / 2;
+        const T delta = (lambda_max - lambda_min) / 2;
+        const T sigma = theta / delta;
+        T rho = 1 / sigma;
+
+        // no usable spectral bound, e.g. a zero matrix: a zero guess falls
+        // back to one Jacobi step, so x never keeps stale workspace
+        if (lambda_max <= 0)
+        {
+            if (zero_guess)
+                fused_blas1<T>(n, fused_set(x, fused_vec<T>(invDiag) * fused_vec<T>(b)),
+                               fused_nop(), fused_nop(), fused_nop(), control);
+            return;
+        }
+
+        if (zero_guess)
+        {
+            fused_blas1<T>(n,
+                           fused_set(&d, fused_const<T>(1 / theta) * fused_vec<T>(invDiag) * fused_vec<T>(b)),
+                           fused_set(x, fused_vec<T>(&d)),
+                           fused_nop(), fused_nop(), control);
+        }
+        else
+        {
+            csrmv<T>(&one, A, x, &zero, &r, control);
+            fused_blas1<T>(n,
+                           fused_set(&d, fused_const<T>(1 / theta) * fused_vec<T>(invDiag) *
+                                         (fused_vec<T>(b) - fused_vec<T>(&r))),
+                           fused_add(x, fused_vec<T>(&d)),
+                           fused_nop(), fused_nop(), control);
+        }
+
+        for (int k = 1; k < degree; k++)
+        {
+            T rho_new = 1 / (2 * sigma - rho);
+
+            // d = rho_new * rho * d + 2 rho_new / delta * D^{-1} (b - A x); x = x + d
+            csrmv<T>(&one, A, x, &zero, &r, control);
+            fused_blas1<T>(n,
+                           fused_set(&d, fused_const<T>(rho_new * rho) * fused_vec<T>(&d) +
+                                         fused_const<T>(2 * rho_new / delta) * fused_vec<T>(invDiag) *
+                                         (fused_vec<T>(b) - fused_vec<T>(&r))),
+                           fused_add(x, fused_vec<T>(&d)),
+                           fused_nop(), fused_nop(), control);
+
+            rho = rho_new;
+        }
+    }
+
+    ~ChebyshevPolynomial()
+    {
+        am_free(d.values);
+        am_free(r.values);
+        am_free(scalars);
+    }
+
+private:
+    // power iterations on D^{-1} A
+    T estimate_lambda_max(hcsparseControl* control)
+    {
+        const int n = A->num_rows;
+
+        // deterministic pseudo random start, the constant vector is often
+        // close to an eigenvector of the smallest eigenvalue
+        std::vector<T> h_v(n);
+        unsigned int seed = 12345;
+        for (int i = 0; i < n; i++)
+        {
+            seed = seed * 1103515245u + 12345u;
+            h_v[i] = (T)((seed >> 16) & 0x7fff) / 0x7fff + (T)0.5;
+        }
+        control->accl_view.copy(h_v.data(), d.values, sizeof(T) * n);
+
+        fused_blas1<T>(n, fused_nop(), fused_nop(), fused_norm2(&norm, fused_vec<T>(&d)),
+                       fused_nop(), control);
+
+        T h_norm = 0;
+        control->accl_view.copy(norm.value, &h_norm, sizeof(T));
+
+        T lambda = 0;
+        for (int k = 0; k < CHEBYSHEV_POWER_ITERATIONS && h_norm > 0; k++)
+        {
+            // d = D^{-1} A d / |d|, lambda = |D^{-1} A d| / |d|
+            csrmv<T>(&one, A, &d, &zero, &r, control);
+            fused_blas1<T>(n,
+                           fused_set(&d, fused_const<T>(1 / h_norm) * fused_vec<T>(invDiag) * fused_vec<T>(&r)),
+                           fused_nop(),
+                           fused_norm2(&norm, fused_vec<T>(&d)),
+                           fused_nop(), control);
+
+            control->accl_view.copy(norm.value, &h_norm, sizeof(T));
+            lambda = h_norm;
+        }
+
+        return lambda;
+    }
+
+    const hcsparseCsrMatrix* A;
+    const hcdenseVector* invDiag;
+    int degree;
+
+    T lambda_min;
+    T lambda_max;
+
+    // search direction and A*x
+    hcdenseVector d;
+    hcdenseVector r;
+
+    T *scalars;
+    hcsparseScalar one;
+    hcsparseScalar zero;
+    hcsparseScalar norm;
+};
+
+template<typename T>
+class ChebyshevPreconditioner
+{
+public:
+    ChebyshevPreconditioner(const hcsparseCsrMatrix* A,
+                            hcsparseControl* control)
+    {
+        int size = A->num_rows;
+        hc::accelerator acc = (control->accl_view).get_accelerator();
+
+        invDiag_A.values = am_alloc(sizeof(T) * std::max(size, 1), acc, 0);
+        invDiag_A.num_values = size;
+        invDiag_A.offValues = 0;
+
+        extract_diagonal<T, true>(&invDiag_A, A, control);
+
+        polynomial = std::make_shared<ChebyshevPolynomial<T>>(A, &invDiag_A, CHEBYSHEV_DEGREE, control);
+    }
+
+    // apply preconditioner y = p(A) x
+    void operator ()(const hcdenseVector *x,
+                     hcdenseVector *y,
+                     hcsparseControl* control)
+    {
+        polynomial->apply(x, y, true, control);
+    }
+
+    ~ChebyshevPreconditioner()
+    {
+        polynomial.reset();
+        am_free(invDiag_A.values);
+    }
+
+private:
+    hcdenseVector invDiag_A;
+    std::shared_ptr<ChebyshevPolynomial<T>> polynomial;
+};
+
+
+template<typename T>
+class ChebyshevHandler : public PreconditionerHandler<T>
+{
+public:
+
+    using Chebyshev = ChebyshevPreconditioner<T>;
+
+    ChebyshevHandler()
+    {
+    }
+
+    void operator()(const hcdenseVector *x,
+                    hcdenseVector *y,
+                    hcsparseControl* control)
+    {
+        (*chebyshev)(x, y, control);
+    }
+
+    void notify(const hcsparseCsrMatrix* pA, hcsparseControl* control)
+    {
+        chebyshev = std::make_shared<Chebyshev>(pA, control);
+    }
+
+private:
+    std::shared_ptr<Chebyshev> chebyshev;
+};
+
+#endif //_HCSPARSE_PREC_CHEBYSHEV_H_
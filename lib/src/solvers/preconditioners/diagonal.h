@@ -22,8 +22,6 @@ public:
                            hcsparseControl* control)
     {
 
-        int status;
-
         int size = std::min(A->num_rows, A->num_cols);
         hc::accelerator acc = (control->accl_view).get_accelerator();
         
@@ -32,12 +30,18 @@ public:
         invDiag_A.num_values = size;
         invDiag_A.offValues = 0;
 
+        update(A, control);
+    }
+
+    // new values of A on the same pattern: the buffers are kept
+    void update(const hcsparseCsrMatrix* A,
+                hcsparseControl* control)
+    {
         // extract inverse diagonal from matrix A and store it in invDiag_A
         // easy to check with poisson matrix;
-        status = extract_diagonal<T, true>(&invDiag_A, A, control);
+        extract_diagonal<T, true>(&invDiag_A, A, control);
 
-        T *avInvDiag = static_cast<T *>(invDiag_A.values);         
-        control->accl_view.copy(invDiag_A.values, invBuff, sizeof(T)*size);
+        control->accl_view.copy(invDiag_A.values, invBuff, sizeof(T)*invDiag_A.num_values);
     }
 
     // apply preconditioner
@@ -56,6 +60,7 @@ public:
     ~DiagonalPreconditioner()
     {
         free(invBuff);
+        am_free(invDiag_A.values);
     }
 
 private:
@@ -88,6 +93,11 @@ public:
         diagonal = std::make_shared<Diag>(pA, control);
     }
 
+    void refresh(const hcsparseCsrMatrix* pA, hcsparseControl* control)
+    {
+        diagonal->update(pA, control);
+    }
+
 private:
     std::shared_ptr<Diag> diagonal;
 };
@@ -0,0 +1,202 @@
+#ifndef _HCSPARSE_PREC_ILU0_H_
+#define _HCSPARSE_PREC_ILU0_H_
+
+#include "preconditioner.h"
+#include "preconditioner_utils.h"
+#include "../../blas2/csrsv-levels.h"
+
+/* Incomplete LU factorization with zero fill-in, ILU(0):
+   A ~ L*U where L (unit lower) and U (upper) keep the sparsity pattern of A
+   and are stored together in one copy of the CSR values.
+   Applying the preconditioner y = U^{-1} L^{-1} x takes two sparse triangular
+   solves. Both the factorization and the solves are run level by level with
+   the level schedules built once in the constructor, every row of a level
+   in parallel. The column indices of each row of A have to be sorted.
+   New values of A on the same pattern are refactorized with the schedules
+   and diagonal positions kept.
+*/
+
+template<typename T>
+class IncompleteLUPreconditioner
+{
+public:
+    IncompleteLUPreconditioner(const hcsparseCsrMatrix* A,
+                               hcsparseControl* control)
+    {
+        num_rows = A->num_rows;
+        int nnz = A->num_nonzeros;
+        hc::accelerator acc = (control->accl_view).get_accelerator();
+
+        int *h_rowOffsets = (int*) calloc(num_rows + 1, sizeof(int));
+        int *h_colIndices = (int*) calloc(nnz, sizeof(int));
+        int *h_diagPos = (int*) calloc(num_rows, sizeof(int));
+
+        control->accl_view.copy(A->rowOffsets, h_rowOffsets, sizeof(int) * (num_rows + 1));
+        control->accl_view.copy(A->colIndices, h_colIndices, sizeof(int) * nnz);
+
+        for (int i = 0; i < num_rows; i++)
+        {
+            h_diagPos[i] = -1;
+            for (int p = h_rowOffsets[i]; p < h_rowOffsets[i + 1]; p++)
+            {
+                if (h_colIndices[p] == i)
+                {
+                    h_diagPos[i] = p;
+                    break;
+                }
+            }
+        }
+
+        // the factors share the pattern of A, only the values are copied
+        rowOffsets = static_cast<int*>(A->rowOffsets);
+        colIndices = static_cast<int*>(A->colIndices);
+        values = (T*) am_alloc(sizeof(T) * nnz, acc, 0);
+        diagPos = (int*) am_alloc(sizeof(int) * num_rows, acc, 0);
+
+        control->accl_view.copy(A->values, values, sizeof(T) * nnz);
+        control->accl_view.copy(h_diagPos, diagPos, sizeof(int) * num_rows);
+
+        level_schedule_build<true>(&lower, num_rows, h_rowOffsets, h_colIndices, control);
+        level_schedule_build<false>(&upper, num_rows, h_rowOffsets, h_colIndices, control);
+
+        free(h_rowOffsets);
+        free(h_colIndices);
+        free(h_diagPos);
+
+        factorize(control);
+    }
+
+    // factorize new values of A, its pattern being the one analysed
+    void refactor(const hcsparseCsrMatrix* A,
+                  hcsparseControl* control)
+    {
+        control->accl_view.copy(A->values, values, sizeof(T) * A->num_nonzeros);
+
+        factorize(control);
+    }
+
+    // apply preconditioner y = U^{-1} L^{-1} x
+    void operator ()(const hcdenseVector *x,
+                     hcdenseVector *y,
+                     hcsparseControl* control)
+    {
+        T *avX = static_cast<T*>(x->values) + x->offValues;
+        T *avY = static_cast<T*>(y->values) + y->offValues;
+
+        level_triangular_solve<T, true, true>(&lower, nullptr, rowOffsets, colIndices, values,
+                                              avX, num_rows, avY, num_rows, 1, control);
+        level_triangular_solve<T, false, false>(&upper, nullptr, rowOffsets, colIndices, values,
+                                                avY, num_rows, avY, num_rows, 1, control);
+    }
+
+    ~IncompleteLUPreconditioner()
+    {
+        level_schedule_free(&lower);
+        level_schedule_free(&upper);
+        am_free(values);
+        am_free(diagPos);
+    }
+
+private:
+    // IKJ variant of ILU(0). Row i only reads the final values of the rows
+    // k < i it references, which are exactly the rows of earlier levels of
+    // the lower triangular schedule.
+    void factorize(hcsparseControl* control)
+    {
+        const int *rows = lower.rows;
+        const int *rowOff = rowOffsets;
+        const int *colInd = colIndices;
+        const int *diag = diagPos;
+        T *vals = values;
+
+        for (int l = 0; l < lower.num_levels; l++)
+        {
+            const int first = lower.level_ptr[l];
+            const int count = lower.level_ptr[l + 1] - first;
+
+            hc::extent<1> grdExt(GROUP_SIZE * ((count - 1)/GROUP_SIZE + 1));
+            hc::tiled_extent<1> t_ext = grdExt.tile(GROUP_SIZE);
+            hc::parallel_for_each(control->accl_view, t_ext, [=] (hc::tiled_index<1>& tidx) [[hc]]
+            {
+                int gid = tidx.global[0];
+                if (gid < count)
+                {
+                    int i = rows[first + gid];
+                    int row_end = rowOff[i + 1];
+
+                    for (int p = rowOff[i]; p < row_end && colInd[p] < i; p++)
+                    {
+                        int k = colInd[p];
+                        T pivot = diag[k] < 0 ? 0 : vals[diag[k]];
+                        T a_ik = div<T>(vals[p], pivot);
+                        vals[p] = a_ik;
+
+                        // a_ij -= a_ik * a_kj for the j > k present in row i;
+                        // both rows are sorted so this is a merge
+                        int q = p + 1;
+                        for (int r = diag[k] + 1; diag[k] >= 0 && r < rowOff[k + 1]; r++)
+                        {
+                            int j = colInd[r];
+                            while (q < row_end && colInd[q] < j)
+                                q++;
+                            if (q == row_end)
+                                break;
+                            if (colInd[q] == j)
+                                vals[q] -= a_ik * vals[r];
+                        }
+                    }
+                }
+            }).wait();
+        }
+    }
+
+    int num_rows;
+
+    // pattern of A, shared with the matrix
+    int *rowOffsets;
+    int *colIndices;
+
+    // L (strictly lower part, unit diagonal implied) and U values
+    T *values;
+
+    // position of the diagonal entry of every row, -1 if missing
+    int *diagPos;
+
+    levelSchedule lower;
+    levelSchedule upper;
+};
+
+
+template<typename T>
+class IncompleteLUHandler : public PreconditionerHandler<T>
+{
+public:
+
+    using ILU0 = IncompleteLUPreconditioner<T>;
+
+    IncompleteLUHandler()
+    {
+    }
+
+    void operator()(const hcdenseVector *x,
+                    hcdenseVector *y,
+                    hcsparseControl* control)
+    {
+        (*ilu)(x, y, control);
+    }
+
+    void notify(const hcsparseCsrMatrix* pA, hcsparseControl* control)
+    {
+        ilu = std::make_shared<ILU0>(pA, control);
+    }
+
+    void refresh(const hcsparseCsrMatrix* pA, hcsparseControl* control)
+    {
+        ilu->refactor(pA, control);
+    }
+
+private:
+    std::shared_ptr<ILU0> ilu;
+};
+
+#endif //_HCSPARSE_PREC_ILU0_H_
@@ -54,6 +54,14 @@ public:
 
     virtual void notify(const hcsparseCsrMatrix* pA,
                         hcsparseControl* control) = 0;
+
+    // the values of the matrix seen by notify changed but not its pattern;
+    // handlers with an analysis of the pattern override this to keep it
+    virtual void refresh(const hcsparseCsrMatrix* pA,
+                         hcsparseControl* control)
+    {
+        notify(pA, control);
+    }
 };
 
 #endif //_HCSPARSE_PRECONDITIONER_H_
@@ -0,0 +1,634 @@
+#ifndef _HCSPARSE_PREC_SMOOTHED_AGGREGATION_H_
+#define _HCSPARSE_PREC_SMOOTHED_AGGREGATION_H_
+
+#include "preconditioner.h"
+#include "preconditioner_utils.h"
+#include "chebyshev.h"
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+/* Smoothed aggregation algebraic multigrid (Vanek, Mandel, Brezina).
+   Every level groups strongly connected unknowns into aggregates; the
+   tentative prolongator interpolates the constant vector piecewise over
+   the aggregates and is smoothed by one damped Jacobi step on the filtered
+   matrix, P = (I - omega D_F^{-1} A_F) P_tent. The coarse matrix is the
+   Galerkin product P^T A P, formed by rap_symbolic and rap_numeric
+   without building A P; R = P^T is only kept for the restriction.
+   The preconditioner applies one V-cycle with Chebyshev or damped Jacobi
+   smoothing (csrmv and fused vector updates) and a dense direct solve on
+   the coarsest level; when coarsening stops early, above AMG_COARSE_SIZE
+   rows, the coarsest level is only smoothed instead. The cycle is symmetric, so it can be used with cg().
+   Aggregation works on host copies of the level matrices, it is done once
+   when the handler is notified.
+*/
+
+// |a_ij| >= theta * sqrt(|a_ii a_jj|) makes j a strong neighbour of i
+#define AMG_STRENGTH_THRESHOLD 0.08
+#define AMG_MAX_LEVELS 10
+// levels with at most this many rows are solved directly
+#define AMG_COARSE_SIZE 256
+// sweeps on a coarsest level too large for the direct solve
+#define AMG_COARSE_SWEEPS 4
+
+#define AMG_SMOOTHER_JACOBI 0
+#define AMG_SMOOTHER_CHEBYSHEV 1
+#ifndef AMG_SMOOTHER
+#define AMG_SMOOTHER AMG_SMOOTHER_CHEBYSHEV
+#endif
+
+#define AMG_JACOBI_WEIGHT (2.0/3.0)
+#define AMG_CHEBYSHEV_DEGREE 2
+// Jacobi sweeps, or Chebyshev polynomials, before and after the coarse correction
+#define AMG_PRE_SWEEPS 1
+#define AMG_POST_SWEEPS 1
+
+template <typename T>
+struct amgHostCsr
+{
+    int num_rows;
+    int num_cols;
+    std::vector<int> rowOffsets;
+    std::vector<int> colIndices;
+    std::vector<T> values;
+};
+
+template <typename T>
+void
+amg_to_host (const hcsparseCsrMatrix *A,
+             amgHostCsr<T> &h,
+             hcsparseControl *control)
+{
+    h.num_rows = A->num_rows;
+    h.num_cols = A->num_cols;
+    h.rowOffsets.resize(A->num_rows + 1);
+    control->accl_view.copy(A->rowOffsets, h.rowOffsets.data(), sizeof(int) * (A->num_rows + 1));
+
+    int nnz = h.rowOffsets[A->num_rows];
+    h.colIndices.resize(nnz);
+    h.values.resize(nnz);
+    control->accl_view.copy(A->colIndices, h.colIndices.data(), sizeof(int) * nnz);
+    control->accl_view.copy(A->values, h.values.data(), sizeof(T) * nnz);
+}
+
+inline void
+amg_alloc_csr (hcsparseCsrMatrix *A,
+               int num_rows, int num_cols, int nnz,
+               size_t value_size,
+               hcsparseControl *control)
+{
+    hc::accelerator acc = (control->accl_view).get_accelerator();
+
+    A->clear();
+    A->offValues = 0;
+    A->offColInd = 0;
+    A->offRowOff = 0;
+    A->offRowBlocks = 0;
+    A->num_rows = num_rows;
+    A->num_cols = num_cols;
+    A->num_nonzeros = nnz;
+    A->rowOffsets = am_alloc(sizeof(int) * (num_rows + 1), acc, 0);
+    A->colIndices = am_alloc(sizeof(int) * std::max(nnz, 1), acc, 0);
+    A->values = am_alloc(value_size * std::max(nnz, 1), acc, 0);
+}
+
+inline void
+amg_free_csr (hcsparseCsrMatrix *A)
+{
+    if (A->rowOffsets != nullptr)
+        am_free(A->rowOffsets);
+    if (A->colIndices != nullptr)
+        am_free(A->colIndices);
+    if (A->values != nullptr)
+        am_free(A->values);
+    A->clear();
+}
+
+template <typename T>
+void
+amg_to_device (const amgHostCsr<T> &h,
+               hcsparseCsrMatrix *A,
+               hcsparseControl *control)
+{
+    int nnz = h.rowOffsets[h.num_rows];
+    amg_alloc_csr(A, h.num_rows, h.num_cols, nnz, sizeof(T), control);
+
+    control->accl_view.copy(h.rowOffsets.data(), A->rowOffsets, sizeof(int) * (h.num_rows + 1));
+    control->accl_view.copy(h.colIndices.data(), A->colIndices, sizeof(int) * nnz);
+    control->accl_view.copy(h.values.data(), A->values, sizeof(T) * nnz);
+}
+
+template <typename T>
+void
+amg_transpose (const amgHostCsr<T> &A,
+               amgHostCsr<T> &At)
+{
+    int nnz = A.rowOffsets[A.num_rows];
+
+    At.num_rows = A.num_cols;
+    At.num_cols = A.num_rows;
+    At.rowOffsets.assign(A.num_cols + 1, 0);
+    At.colIndices.resize(nnz);
+    At.values.resize(nnz);
+
+    for (int p = 0; p < nnz; p++)
+        At.rowOffsets[A.colIndices[p] + 1]++;
+    for (int i = 0; i < A.num_cols; i++)
+        At.rowOffsets[i + 1] += At.rowOffsets[i];
+
+    // rows of A are visited in order, so every row of At comes out sorted
+    std::vector<int> next(At.rowOffsets.begin(), At.rowOffsets.end() - 1);
+    for (int i = 0; i < A.num_rows; i++)
+    {
+        for (int p = A.rowOffsets[i]; p < A.rowOffsets[i + 1]; p++)
+        {
+            int q = next[A.colIndices[p]]++;
+            At.colIndices[q] = i;
+            At.values[q] = A.values[p];
+        }
+    }
+}
+
+// Builds the smoothed prolongator of A, returns the number of aggregates
+template <typename T>
+int
+amg_prolongator (const amgHostCsr<T> &A,
+                 amgHostCsr<T> &P)
+{
+    const int n = A.num_rows;
+    const std::vector<int> &rowOff = A.rowOffsets;
+    const std::vector<int> &colInd = A.colIndices;
+    const std::vector<T> &val = A.values;
+
+    std::vector<T> diag(n, 0);
+    for (int i = 0; i < n; i++)
+        for (int p = rowOff[i]; p < rowOff[i + 1]; p++)
+            if (colInd[p] == i)
+                diag[i] = val[p];
+
+    // strength of connection
+    std::vector<char> strong(colInd.size(), 0);
+    for (int i = 0; i < n; i++)
+    {
+        for (int p = rowOff[i]; p < rowOff[i + 1]; p++)
+        {
+            int j = colInd[p];
+            if (j != i && std::abs(val[p]) >=
+                AMG_STRENGTH_THRESHOLD * std::sqrt(std::abs(diag[i] * diag[j])))
+                strong[p] = 1;
+        }
+    }
+
+    // aggregation: 1. whole neighbourhoods that are still free,
+    // 2. attach leftovers to a neighbouring aggregate of pass 1,
+    // 3. group what remains with its free neighbours
+    std::vector<int> agg(n, -1);
+    int nc = 0;
+
+    for (int i = 0; i < n; i++)
+    {
+        if (agg[i] != -1)
+            continue;
+
+        bool free = true;
+        for (int p = rowOff[i]; p < rowOff[i + 1] && free; p++)
+            if (strong[p] && agg[colInd[p]] != -1)
+                free = false;
+        if (!free)
+            continue;
+
+        agg[i] = nc;
+        for (int p = rowOff[i]; p < rowOff[i + 1]; p++)
+            if (strong[p])
+                agg[colInd[p]] = nc;
+        nc++;
+    }
+
+    std::vector<int> agg1 = agg;
+    for (int i = 0; i < n; i++)
+    {
+        if (agg[i] != -1)
+            continue;
+        for (int p = rowOff[i]; p < rowOff[i + 1]; p++)
+        {
+            if (strong[p] && agg1[colInd[p]] != -1)
+            {
+                agg[i] = agg1[colInd[p]];
+                break;
+            }
+        }
+    }
+
+    for (int i = 0; i < n; i++)
+    {
+        if (agg[i] != -1)
+            continue;
+        agg[i] = nc;
+        for (int p = rowOff[i]; p < rowOff[i + 1]; p++)
+            if (strong[p] && agg[colInd[p]] == -1)
+                agg[colInd[p]] = nc;
+        nc++;
+    }
+
+    // tentative prolongator, the normalised constant over every aggregate
+    std::vector<int> agg_size(nc, 0);
+    for (int i = 0; i < n; i++)
+        agg_size[agg[i]]++;
+
+    std::vector<T> tent(n);
+    for (int i = 0; i < n; i++)
+        tent[i] = 1 / std::sqrt((T)agg_size[agg[i]]);
+
+    // filtered matrix: weak connections are lumped into the diagonal
+    std::vector<T> diagF = diag;
+    for (int i = 0; i < n; i++)
+        for (int p = rowOff[i]; p < rowOff[i + 1]; p++)
+            if (colInd[p] != i && !strong[p])
+                diagF[i] += val[p];
+
+    // omega = 4/3 / rho(D_F^{-1} A_F), rho bounded by Gershgorin
+    T rho = 0;
+    for (int i = 0; i < n; i++)
+    {
+        if (diagF[i] == 0)
+            continue;
+        T sum = std::abs(diagF[i]);
+        for (int p = rowOff[i]; p < rowOff[i + 1]; p++)
+            if (strong[p])
+                sum += std::abs(val[p]);
+        rho = std::max(rho, sum / std::abs(diagF[i]));
+    }
+    T omega = rho > 0 ? (T)(4.0 / 3.0) / rho : 0;
+
+    // P = (I - omega D_F^{-1} A_F) P_tent
+    P.num_rows = n;
+    P.num_cols = nc;
+    P.rowOffsets.assign(n + 1, 0);
+    P.colIndices.clear();
+    P.values.clear();
+
+    std::vector<std::pair<int, T>> row;
+    for (int i = 0; i < n; i++)
+    {
+        T f = diagF[i] == 0 ? 0 : omega / diagF[i];
+
+        row.clear();
+        row.push_back(std::make_pair(agg[i], tent[i] - f * diagF[i] * tent[i]));
+        for (int p = rowOff[i]; p < rowOff[i + 1]; p++)
+            if (strong[p])
+                row.push_back(std::make_pair(agg[colInd[p]], -f * val[p] * tent[colInd[p]]));
+
+        std::sort(row.begin(), row.end(),
+                  [](const std::pair<int, T> &a, const std::pair<int, T> &b) { return a.first < b.first; });
+
+        for (size_t k = 0; k < row.size(); k++)
+        {
+            if (k > 0 && row[k].first == row[k - 1].first)
+            {
+                P.values.back() += row[k].second;
+                continue;
+            }
+            P.colIndices.push_back(row[k].first);
+            P.values.push_back(row[k].second);
+        }
+        P.rowOffsets[i + 1] = P.colIndices.size();
+    }
+
+    return nc;
+}
+
+template <typename T>
+struct amgLevel
+{
+    // operator of the level, not owned on the finest level
+    hcsparseCsrMatrix A;
+
+    // interpolation from the next coarser level and its transpose
+    hcsparseCsrMatrix P;
+    hcsparseCsrMatrix R;
+
+    hcdenseVector invDiag;
+
+    // right hand side and solution, not used on the finest level
+    hcdenseVector x;
+    hcdenseVector b;
+
+    // residual
+    hcdenseVector r;
+
+    // Chebyshev smoother, absent on the coarsest level
+    std::shared_ptr<ChebyshevPolynomial<T>> smoother;
+};
+
+template<typename T>
+class SmoothedAggregationPreconditioner
+{
+public:
+    SmoothedAggregationPreconditioner(const hcsparseCsrMatrix* A,
+                                      hcsparseControl* control)
+    {
+        hc::accelerator acc = (control->accl_view).get_accelerator();
+
+        // one and zero for csrmv
+        T h_scalars[2] = { 1, 0 };
+        scalars = (T*) am_alloc(sizeof(T) * 2, acc, 0);
+        control->accl_view.copy(h_scalars, scalars, sizeof(T) * 2);
+        one.value = scalars;
+        one.offValue = 0;
+        zero.value = scalars + 1;
+        zero.offValue = 0;
+
+        amgLevel<T> finest;
+        finest.A = *A;
+        finest.P.clear();
+        finest.R.clear();
+        levels.push_back(finest);
+
+        amgHostCsr<T> hA;
+        amg_to_host<T>(A, hA, control);
+
+        while (hA.num_rows > AMG_COARSE_SIZE && levels.size() < AMG_MAX_LEVELS)
+        {
+            amgHostCsr<T> hP;
+            amgHostCsr<T> hR;
+
+            int nc = amg_prolongator<T>(hA, hP);
+            if (nc == 0 || nc >= hA.num_rows)
+                break;
+            amg_transpose<T>(hP, hR);
+
+            amgLevel<T> &fine = levels.back();
+            amg_to_device<T>(hP, &fine.P, control);
+            amg_to_device<T>(hR, &fine.R, control);
+
+            // Galerkin coarse operator P^T*A*P
+            amgLevel<T> coarse;
+            coarse.P.clear();
+            coarse.R.clear();
+
+            hcsparseRapInfo rap;
+            rap_symbolic(&fine.A, &fine.P, &rap, control);
+            amg_alloc_csr(&coarse.A, nc, nc, rap.nnzC, sizeof(T), control);
+            rap_numeric<T>(&fine.A, &fine.P, &rap, &coarse.A, control);
+
+            levels.push_back(coarse);
+            amg_to_host<T>(&levels.back().A, hA, control);
+        }
+
+        // aggregation stalled or ran out of levels: a dense factorization
+        // of the remaining matrix could be as large as the fine one
+        direct = hA.num_rows <= AMG_COARSE_SIZE;
+
+        for (size_t l = 0; l < levels.size(); l++)
+        {
+            amgLevel<T> &L = levels[l];
+            int n = L.A.num_rows;
+
+            alloc_vector(&L.invDiag, n, control);
+            alloc_vector(&L.r, n, control);
+            if (l > 0)
+            {
+                alloc_vector(&L.x, n, control);
+                alloc_vector(&L.b, n, control);
+            }
+            else
+            {
+                L.x.clear();
+                L.b.clear();
+            }
+
+            extract_diagonal<T, true>(&L.invDiag, &L.A, control);
+
+            // the levels do not move any more, the smoother may point into them
+            if (AMG_SMOOTHER == AMG_SMOOTHER_CHEBYSHEV && (l + 1 < levels.size() || !direct))
+                L.smoother = std::make_shared<ChebyshevPolynomial<T>>(&L.A, &L.invDiag,
+                                                                      AMG_CHEBYSHEV_DEGREE, control);
+        }
+
+        if (direct)
+            factorize_coarse(hA);
+    }
+
+    // apply preconditioner, one V-cycle for A y = x
+    void operator ()(const hcdenseVector *x,
+                     hcdenseVector *y,
+                     hcsparseControl* control)
+    {
+        cycle(0, x, y, control);
+    }
+
+    ~SmoothedAggregationPreconditioner()
+    {
+        for (size_t l = 0; l < levels.size(); l++)
+        {
+            amgLevel<T> &L = levels[l];
+            L.smoother.reset();
+            if (l > 0)
+            {
+                amg_free_csr(&L.A);
+                am_free(L.x.values);
+                am_free(L.b.values);
+            }
+            amg_free_csr(&L.P);
+            amg_free_csr(&L.R);
+            am_free(L.invDiag.values);
+            am_free(L.r.values);
+        }
+        am_free(scalars);
+    }
+
+private:
+    void alloc_vector(hcdenseVector *v, int n, hcsparseControl* control)
+    {
+        hc::accelerator acc = (control->accl_view).get_accelerator();
+        v->values = am_alloc(sizeof(T) * std::max(n, 1), acc, 0);
+        v->num_values = n;
+        v->offValues = 0;
+    }
+
+    void smooth(amgLevel<T> &L,
+                const hcdenseVector *b,
+                hcdenseVector *x,
+                bool zero_guess,
+                hcsparseControl* control)
+    {
+        if (L.smoother)
+        {
+            L.smoother->apply(b, x, zero_guess, control);
+        }
+        else if (zero_guess)
+        {
+            fused_blas1<T>(L.A.num_rows,
+                           fused_set(x, fused_const<T>(AMG_JACOBI_WEIGHT) *
+                                        fused_vec<T>(&L.invDiag) * fused_vec<T>(b)),
+                           fused_nop(), fused_nop(), fused_nop(), control);
+        }
+        else
+        {
+            jacobi(L, b, x, control);
+        }
+    }
+
+    // x = x + w D^{-1} (b - A x)
+    void jacobi(amgLevel<T> &L,
+                const hcdenseVector *b,
+                hcdenseVector *x,
+                hcsparseControl* control)
+    {
+        csrmv<T>(&one, &L.A, x, &zero, &L.r, control);
+        fused_blas1<T>(L.A.num_rows,
+                       fused_set(x, fused_vec<T>(x) + fused_const<T>(AMG_JACOBI_WEIGHT) *
+                                    fused_vec<T>(&L.invDiag) * (fused_vec<T>(b) - fused_vec<T>(&L.r))),
+                       fused_nop(), fused_nop(), fused_nop(), control);
+    }
+
+    void cycle(size_t l,
+               const hcdenseVector *b,
+               hcdenseVector *x,
+               hcsparseControl* control)
+    {
+        amgLevel<T> &L = levels[l];
+        const int n = L.A.num_rows;
+
+        if (l + 1 == levels.size())
+        {
+            if (direct)
+            {
+                solve_coarse(b, x, control);
+            }
+            else
+            {
+                for (int s = 0; s < AMG_COARSE_SWEEPS; s++)
+                    smooth(L, b, x, s == 0, control);
+            }
+            return;
+        }
+
+        amgLevel<T> &C = levels[l + 1];
+
+        // first sweep from a zero initial guess
+        for (int s = 0; s < AMG_PRE_SWEEPS; s++)
+            smooth(L, b, x, s == 0, control);
+
+        // restrict the residual
+        csrmv<T>(&one, &L.A, x, &zero, &L.r, control);
+        fused_blas1<T>(n, fused_set(&L.r, fused_vec<T>(b) - fused_vec<T>(&L.r)),
+                       fused_nop(), fused_nop(), fused_nop(), control);
+        csrmv<T>(&one, &L.R, &L.r, &zero, &C.b, control);
+
+        cycle(l + 1, &C.b, &C.x, control);
+
+        // x = x + P x_c
+        csrmv<T>(&one, &L.P, &C.x, &one, x, control);
+
+        for (int s = 0; s < AMG_POST_SWEEPS; s++)
+            smooth(L, b, x, false, control);
+    }
+
+    // dense LU with partial pivoting of the coarsest matrix
+    void factorize_coarse(const amgHostCsr<T> &hA)
+    {
+        const int n = hA.num_rows;
+
+        lu.assign((size_t)n * n, 0);
+        piv.resize(n);
+        coarse_rhs.resize(n);
+
+        for (int i = 0; i < n; i++)
+            for (int p = hA.rowOffsets[i]; p < hA.rowOffsets[i + 1]; p++)
+                lu[(size_t)i * n + hA.colIndices[p]] += hA.values[p];
+
+        for (int k = 0; k < n; k++)
+        {
+            int pk = k;
+            for (int i = k + 1; i < n; i++)
+                if (std::abs(lu[(size_t)i * n + k]) > std::abs(lu[(size_t)pk * n + k]))
+                    pk = i;
+            piv[k] = pk;
+            if (pk != k)
+                for (int j = 0; j < n; j++)
+                    std::swap(lu[(size_t)k * n + j], lu[(size_t)pk * n + j]);
+
+            T d = lu[(size_t)k * n + k];
+            if (d == 0)
+                continue;
+            for (int i = k + 1; i < n; i++)
+            {
+                T f = lu[(size_t)i * n + k] / d;
+                lu[(size_t)i * n + k] = f;
+                for (int j = k + 1; j < n; j++)
+                    lu[(size_t)i * n + j] -= f * lu[(size_t)k * n + j];
+            }
+        }
+    }
+
+    void solve_coarse(const hcdenseVector *b,
+                      hcdenseVector *x,
+                      hcsparseControl* control)
+    {
+        const int n = piv.size();
+        std::vector<T> &y = coarse_rhs;
+
+        control->accl_view.copy(b->values, y.data(), sizeof(T) * n);
+
+        for (int k = 0; k < n; k++)
+            std::swap(y[k], y[piv[k]]);
+        for (int i = 0; i < n; i++)
+            for (int j = 0; j < i; j++)
+                y[i] -= lu[(size_t)i * n + j] * y[j];
+        for (int i = n - 1; i >= 0; i--)
+        {
+            for (int j = i + 1; j < n; j++)
+                y[i] -= lu[(size_t)i * n + j] * y[j];
+            T d = lu[(size_t)i * n + i];
+            y[i] = d == 0 ? 0 : y[i] / d;
+        }
+
+        control->accl_view.copy(y.data(), x->values, sizeof(T) * n);
+    }
+
+    std::vector<amgLevel<T>> levels;
+
+    T *scalars;
+    hcsparseScalar one;
+    hcsparseScalar zero;
+
+    // coarsest level solved by the factors below, otherwise smoothed
+    bool direct;
+
+    // coarsest level factors (host)
+    std::vector<T> lu;
+    std::vector<int> piv;
+    std::vector<T> coarse_rhs;
+};
+
+
+template<typename T>
+class SmoothedAggregationHandler : public PreconditionerHandler<T>
+{
+public:
+
+    using AMG = SmoothedAggregationPreconditioner<T>;
+
+    SmoothedAggregationHandler()
+    {
+    }
+
+    void operator()(const hcdenseVector *x,
+                    hcdenseVector *y,
+                    hcsparseControl* control)
+    {
+        (*amg)(x, y, control);
+    }
+
+    void notify(const hcsparseCsrMatrix* pA, hcsparseControl* control)
+    {
+        amg = std::make_shared<AMG>(pA, control);
+    }
+
+private:
+    std::shared_ptr<AMG> amg;
+};
+
+#endif //_HCSPARSE_PREC_SMOOTHED_AGGREGATION_H_
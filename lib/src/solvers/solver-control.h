@@ -1,5 +1,6 @@
 #include "hcsparse.h"
 #include "preconditioners/diagonal.h"
+#include "preconditioners/block-jacobi.h"
 
 hcsparseSolverControl*
 hcsparseCreateSolverControl(PRECONDITIONER precond, int maxIters,
@@ -79,3 +80,105 @@ hcsparseSolverPrintMode(hcsparseSolverControl *solverControl, PRINT_MODE mode)
 
     return hcsparseSuccess;
 }
+
+hcsparseStatus
+hcsparseSetSolverConvergence(hcsparseSolverControl *solverControl,
+                             SOLVER_NORM norm, int checkInterval)
+{
+    if (solverControl == nullptr || checkInterval < 1)
+    {
+        return hcsparseInvalid;
+    }
+
+    solverControl->residualNorm = norm;
+    solverControl->checkInterval = checkInterval;
+
+    return hcsparseSuccess;
+}
+
+hcsparseStatus
+hcsparseSetSolverRestart(hcsparseSolverControl *solverControl, int restart)
+{
+    if (solverControl == nullptr || restart < 1)
+    {
+        return hcsparseInvalid;
+    }
+
+    solverControl->restart = restart;
+
+    return hcsparseSuccess;
+}
+
+hcsparseStatus
+hcsparseSetSolverBlocks(hcsparseSolverControl *solverControl, int blockSize,
+                        const int *blockOffsets, int numBlocks)
+{
+    if (solverControl == nullptr)
+    {
+        return hcsparseInvalid;
+    }
+
+    if (blockOffsets == nullptr ? blockSize < 1 : !block_jacobi_valid_offsets(blockOffsets, numBlocks, -1))
+    {
+        return hcsparseInvalid;
+    }
+
+    solverControl->blockSize = blockSize;
+    solverControl->blockOffsets = blockOffsets;
+    solverControl->numBlocks = blockOffsets == nullptr ? 0 : numBlocks;
+
+    // a cached block Jacobi preconditioner has the old blocks
+    solverControl->precondCache.reset();
+
+    return hcsparseSuccess;
+}
+
+hcsparseSolverWorkspace*
+hcsparseCreateSolverWorkspace(int numValues, size_t valueSize)
+{
+    if (numValues <= 0 ||
+        (valueSize != sizeof(float) && valueSize != sizeof(double)))
+    {
+        return nullptr;
+    }
+
+    hcsparseSolverWorkspace *workspace = new hcsparseSolverWorkspace();
+
+    workspace->num_values = numValues;
+    workspace->value_size = valueSize;
+
+    return workspace;
+}
+
+hcsparseStatus
+hcsparseReleaseSolverWorkspace(hcsparseSolverWorkspace *workspace)
+{
+    if (workspace == nullptr)
+    {
+        return hcsparseInvalid;
+    }
+
+    if (workspace->vectors != nullptr)
+        am_free(workspace->vectors);
+    if (workspace->scalars != nullptr)
+        am_free(workspace->scalars);
+
+    delete workspace;
+
+    return hcsparseSuccess;
+}
+
+// attach a workspace to the solver control; nullptr detaches it
+hcsparseStatus
+hcsparseSetSolverWorkspace(hcsparseSolverControl *solverControl,
+                           hcsparseSolverWorkspace *workspace)
+{
+    if (solverControl == nullptr)
+    {
+        return hcsparseInvalid;
+    }
+
+    solverControl->workspace = workspace;
+
+    return hcsparseSuccess;
+}
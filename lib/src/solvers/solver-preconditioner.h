@@ -0,0 +1,118 @@
+#ifndef _HCSPARSE_SOLVER_PRECONDITIONER_H_
+#define _HCSPARSE_SOLVER_PRECONDITIONER_H_
+
+#include "hcsparse.h"
+#include "preconditioners/preconditioner.h"
+#include "preconditioners/diagonal.h"
+#include "preconditioners/void.h"
+#include "preconditioners/ilu0.h"
+#include "preconditioners/chebyshev.h"
+#include "preconditioners/smoothed-aggregation.h"
+#include "preconditioners/block-jacobi.h"
+
+// New handler of the preconditioner selected in solverControl, notified of
+// A; nullptr when its settings do not fit A. This is the only place the
+// solvers construct preconditioners: a new one is one more case here.
+template<typename T>
+std::shared_ptr<PreconditionerHandler<T>>
+create_preconditioner (const hcsparseCsrMatrix* A,
+                       hcsparseSolverControl* solverControl,
+                       hcsparseControl* control)
+{
+    std::shared_ptr<PreconditionerHandler<T>> preconditioner;
+
+    switch (solverControl->preconditioner)
+    {
+    case DIAGONAL:
+        preconditioner = std::shared_ptr<PreconditionerHandler<T>>(new DiagonalHandler<T>());
+        break;
+    case ILU0:
+        preconditioner = std::shared_ptr<PreconditionerHandler<T>>(new IncompleteLUHandler<T>());
+        break;
+    case AMG:
+        preconditioner = std::shared_ptr<PreconditionerHandler<T>>(new SmoothedAggregationHandler<T>());
+        break;
+    case CHEBYSHEV:
+        preconditioner = std::shared_ptr<PreconditionerHandler<T>>(new ChebyshevHandler<T>());
+        break;
+    case BLOCK_JACOBI:
+        if (solverControl->blockOffsets != nullptr &&
+            !block_jacobi_valid_offsets(solverControl->blockOffsets, solverControl->numBlocks, A->num_rows))
+        {
+            return preconditioner;
+        }
+        preconditioner = std::shared_ptr<PreconditionerHandler<T>>(
+                             new BlockJacobiHandler<T>(solverControl->blockSize,
+                                                       solverControl->blockOffsets,
+                                                       solverControl->numBlocks));
+        break;
+    default:
+        preconditioner = std::shared_ptr<PreconditionerHandler<T>>(new VoidHandler<T>());
+        break;
+    }
+
+    // call constructor of preconditioner class
+    preconditioner->notify(A, control);
+
+    return preconditioner;
+}
+
+/*
+ * Preconditioner of a solve with A. For a tracked matrix (see
+ * hcsparseCsrStructureChanged) the handler is kept in solverControl and
+ * reused by the next solve with the same matrix and preconditioner type:
+ * as is while the versions of A are unchanged, refreshed when only its
+ * values changed, which keeps the analysis of the pattern (level schedules
+ * of ILU(0), buffers of the diagonal), and rebuilt when its pattern
+ * changed.
+ */
+template<typename T>
+std::shared_ptr<PreconditionerHandler<T>>
+solver_preconditioner (const hcsparseCsrMatrix* A,
+                       hcsparseSolverControl* solverControl,
+                       hcsparseControl* control)
+{
+    if (!A->structureTracked())
+    {
+        return create_preconditioner<T>(A, solverControl, control);
+    }
+
+    if (solverControl->precondCache != nullptr &&
+        solverControl->precondMatrix == A &&
+        solverControl->precondType == solverControl->preconditioner &&
+        solverControl->precondValueSize == sizeof(T) &&
+        solverControl->precondStructure == A->structureVersion)
+    {
+        std::shared_ptr<PreconditionerHandler<T>> preconditioner =
+            std::static_pointer_cast<PreconditionerHandler<T>>(solverControl->precondCache);
+
+        if (solverControl->precondValues != A->valuesVersion)
+        {
+            preconditioner->refresh(A, control);
+            solverControl->precondValues = A->valuesVersion;
+        }
+
+        return preconditioner;
+    }
+
+    // drop the old one first, its device memory is not needed any more
+    solverControl->precondCache.reset();
+
+    std::shared_ptr<PreconditionerHandler<T>> preconditioner =
+        create_preconditioner<T>(A, solverControl, control);
+    if (!preconditioner)
+    {
+        return preconditioner;
+    }
+
+    solverControl->precondCache = preconditioner;
+    solverControl->precondMatrix = A;
+    solverControl->precondType = solverControl->preconditioner;
+    solverControl->precondValueSize = sizeof(T);
+    solverControl->precondStructure = A->structureVersion;
+    solverControl->precondValues = A->valuesVersion;
+
+    return preconditioner;
+}
+
+#endif //_HCSPARSE_SOLVER_PRECONDITIONER_H_
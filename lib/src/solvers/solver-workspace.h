@@ -0,0 +1,126 @@
+#ifndef _HCSPARSE_SOLVER_WORKSPACE_H_
+#define _HCSPARSE_SOLVER_WORKSPACE_H_
+
+#include "hcsparse.h"
+
+// The first scalars of every workspace hold the constants one and zero; the
+// solvers' own scalars follow them.
+#define SOLVER_WORKSPACE_CONSTANTS 2
+
+// Makes sure ws holds at least num_vectors work vectors and num_scalars
+// scalars of type T. Storage only grows, so after the first solve repeated
+// solves with the same workspace do not allocate.
+template <typename T>
+hcsparseStatus
+workspace_reserve (hcsparseSolverWorkspace *ws,
+                   int num_vectors,
+                   int num_scalars,
+                   hcsparseControl *control)
+{
+    if (ws->value_size != sizeof(T))
+        return hcsparseInvalid;
+
+    hc::accelerator acc = (control->accl_view).get_accelerator();
+
+    if (num_vectors > ws->num_vectors)
+    {
+        if (ws->vectors != nullptr)
+            am_free(ws->vectors);
+        ws->vectors = am_alloc(sizeof(T) * num_vectors * (size_t)ws->num_values, acc, 0);
+        ws->num_vectors = num_vectors;
+    }
+
+    num_scalars += SOLVER_WORKSPACE_CONSTANTS;
+    if (num_scalars > ws->num_scalars)
+    {
+        if (ws->scalars != nullptr)
+            am_free(ws->scalars);
+        ws->scalars = am_alloc(sizeof(T) * num_scalars, acc, 0);
+        ws->num_scalars = num_scalars;
+
+        T *h_scalars = (T*) calloc(num_scalars, sizeof(T));
+        h_scalars[0] = 1;
+        control->accl_view.copy(h_scalars, ws->scalars, sizeof(T) * num_scalars);
+        free(h_scalars);
+    }
+
+    if (ws->vectors == nullptr || ws->scalars == nullptr)
+        return hcsparseInvalid;
+
+    return hcsparseSuccess;
+}
+
+template <typename T>
+void
+workspace_vector (hcsparseSolverWorkspace *ws,
+                  int i,
+                  hcdenseVector *v)
+{
+    v->values = static_cast<T*>(ws->vectors) + (size_t)i * ws->num_values;
+    v->num_values = ws->num_values;
+    v->offValues = 0;
+}
+
+template <typename T>
+void
+workspace_scalar (hcsparseSolverWorkspace *ws,
+                  int i,
+                  hcsparseScalar *s)
+{
+    s->value = static_cast<T*>(ws->scalars) + SOLVER_WORKSPACE_CONSTANTS + i;
+    s->offValue = 0;
+}
+
+template <typename T>
+void
+workspace_constants (hcsparseSolverWorkspace *ws,
+                     hcsparseScalar *one,
+                     hcsparseScalar *zero)
+{
+    one->value = static_cast<T*>(ws->scalars);
+    one->offValue = 0;
+    zero->value = static_cast<T*>(ws->scalars) + 1;
+    zero->offValue = 0;
+}
+
+inline void
+workspace_free (hcsparseSolverWorkspace *ws)
+{
+    if (ws->vectors != nullptr)
+        am_free(ws->vectors);
+    if (ws->scalars != nullptr)
+        am_free(ws->scalars);
+    ws->vectors = nullptr;
+    ws->scalars = nullptr;
+    ws->num_vectors = 0;
+    ws->num_scalars = 0;
+}
+
+// Returns the workspace attached to solverControl when it fits a system of
+// n values of type T, otherwise initialises local for a one-off solve.
+// Pair with workspace_end.
+template <typename T>
+hcsparseSolverWorkspace*
+workspace_begin (hcsparseSolverControl *solverControl,
+                 int n,
+                 hcsparseSolverWorkspace &local)
+{
+    hcsparseSolverWorkspace *ws = solverControl->workspace;
+
+    if (ws != nullptr && ws->num_values == n && ws->value_size == sizeof(T))
+        return ws;
+
+    local.num_values = n;
+    local.value_size = sizeof(T);
+    return &local;
+}
+
+inline void
+workspace_end (hcsparseSolverWorkspace *ws,
+               hcsparseSolverWorkspace &local)
+{
+    if (ws == &local)
+        workspace_free(&local);
+}
+
+#endif //_HCSPARSE_SOLVER_WORKSPACE_H_
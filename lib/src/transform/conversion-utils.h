@@ -3,7 +3,11 @@
 #define WAVE_SIZE 64
 #define GROUP_SIZE 256
 
-template <typename T>
+// Compresses sorted row indices into num_rows+1 row offsets. BASE is the
+// index base of both the input indices and the output offsets; the counts
+// are accumulated one slot to the right of a leading BASE so a single
+// inclusive scan produces base-adjusted offsets.
+template <typename T, int BASE = 0>
 hcsparseStatus
 indices_to_offsets (const int num_rows,
                     const int size,
@@ -17,71 +21,31 @@ indices_to_offsets (const int num_rows,
 
     for (int i = 0; i < num_rows+1; i++)
         values[i] = 0;
+    values[0] = BASE;
 
     T *av_values = (T*) am_alloc((num_rows+1) * sizeof(T), acc, 0);
 
     control->accl_view.copy(values, av_values, (num_rows+1) * sizeof(T));
 
-    int global_work_size = ((size + GROUP_SIZE - 1)/GROUP_SIZE) * GROUP_SIZE;
-
-    hc::extent<1> grdExt(global_work_size);
-    hc::tiled_extent<1> t_ext = grdExt.tile(GROUP_SIZE);
-
-    hc::parallel_for_each(control->accl_view, t_ext, [=] (hc::tiled_index<1> &tidx) [[hc]]
+    if (size > 0)
     {
-        int global_id = tidx.global[0];
-        if (global_id < size)
-        {
-            int *a = &av_values[av_cooIndices[global_id]];
-            hc::atomic_fetch_inc(a);
-        }
-    }).wait();
+        int global_work_size = ((size + GROUP_SIZE - 1)/GROUP_SIZE) * GROUP_SIZE;
 
-    exclusive_scan<T, EW_PLUS> (num_rows+1, av_csrOffsets, av_values, control);
+        hc::extent<1> grdExt(global_work_size);
+        hc::tiled_extent<1> t_ext = grdExt.tile(GROUP_SIZE);
 
-    control->accl_view.wait();
-
-    free(values);
-    am_free(av_values);
-
-    return hcsparseSuccess;
-}
-
-template <typename T>
-hcsparseStatus
-indices_to_offsets_oneBase (const int num_rows,
-                            const int size,
-                            T *av_csrOffsets,
-                            const T *av_cooIndices,
-                            hcsparseControl* control)
-{
-    hc::accelerator acc = (control->accl_view).get_accelerator();
-
-    T *values = (T*) calloc (num_rows, sizeof(T));
-
-    for (int i = 0; i < num_rows; i++)
-        values[i] = 0;
-
-    T *av_values = (T*) am_alloc(num_rows * sizeof(T), acc, 0);
-
-    control->accl_view.copy(values, av_values, num_rows * sizeof(T));
-
-    int global_work_size = ((size + GROUP_SIZE - 1)/GROUP_SIZE) * GROUP_SIZE;
-
-    hc::extent<1> grdExt(global_work_size);
-    hc::tiled_extent<1> t_ext = grdExt.tile(GROUP_SIZE);
-
-    hc::parallel_for_each(control->accl_view, t_ext, [=] (hc::tiled_index<1> &tidx) [[hc]]
-    {
-        int global_id = tidx.global[0];
-        if (global_id < size)
+        hc::parallel_for_each(control->accl_view, t_ext, [=] (hc::tiled_index<1> &tidx) [[hc]]
         {
-            int *a = &av_values[av_cooIndices[global_id]-1];
-            hc::atomic_fetch_inc(a);
-        }
-    }).wait();
+            int global_id = tidx.global[0];
+            if (global_id < size)
+            {
+                int *a = &av_values[av_cooIndices[global_id] - BASE + 1];
+                hc::atomic_fetch_inc(a);
+            }
+        }).wait();
+    }
 
-    exclusive_scan<T, EW_PLUS> (num_rows, av_csrOffsets, av_values, control);
+    inclusive_scan<T, EW_PLUS> (num_rows+1, av_csrOffsets, av_values, control);
 
     control->accl_view.wait();
 
@@ -91,7 +55,7 @@ indices_to_offsets_oneBase (const int num_rows,
     return hcsparseSuccess;
 }
 
-template <typename T>
+template <typename T, int BASE = 0>
 hcsparseStatus
 offsets_to_indices (const int num_rows,
                     const int size,
@@ -133,10 +97,10 @@ offsets_to_indices (const int num_rows,
         const int num_vectors = grdExt[0] / subwave_size;
         for(int row = vector_id; row < num_rows; row += num_vectors)
         {
-            const int row_start = av_csrOffsets[row];
-            const int row_end   = av_csrOffsets[row+1];
+            const int row_start = av_csrOffsets[row] - BASE;
+            const int row_end   = av_csrOffsets[row+1] - BASE;
             for(int j = row_start + thread_lane; j < row_end; j += subwave_size)
-                av_cooIndices[j] = row;
+                av_cooIndices[j] = row + BASE;
         }
     }).wait();
 
@@ -0,0 +1,91 @@
+#include "hcsparse.h"
+
+#define BLOCK_SIZE 256
+
+// Builds canonical CSR from unsorted COO triplets that may contain repeated
+// (row, col) entries. Triplets are sorted on a combined 64 bit (row, col) key,
+// duplicates are summed with reduce_by_key and the row indices of the
+// surviving entries are compressed into offsets.
+// csr->values and csr->colIndices must hold at least coo->num_nonzeros
+// entries; csr->num_nonzeros is set to the number of distinct entries.
+template <typename T>
+hcsparseStatus
+coo_assemble (const hcsparseCooMatrix* coo,
+              hcsparseCsrMatrix* csr,
+              hcsparseControl* control)
+{
+    hc::accelerator acc = (control->accl_view).get_accelerator();
+
+    int size = coo->num_nonzeros;
+    ulong num_cols = coo->num_cols;
+
+    const int *coo_rowIndices = static_cast<const int*>(coo->rowIndices);
+    const int *coo_colIndices = static_cast<const int*>(coo->colIndices);
+    const T *coo_values = static_cast<const T*>(coo->values);
+
+    int *csr_rowOffsets = static_cast<int*>(csr->rowOffsets);
+    int *csr_colIndices = static_cast<int*>(csr->colIndices);
+    T *csr_values = static_cast<T*>(csr->values);
+
+    csr->num_rows = coo->num_rows;
+    csr->num_cols = coo->num_cols;
+
+    if (size == 0)
+    {
+        int num_offsets = csr->num_rows + 1;
+        hc::extent<1> grdExt_off(BLOCK_SIZE * ((num_offsets - 1)/BLOCK_SIZE + 1));
+        hc::tiled_extent<1> t_ext_off = grdExt_off.tile(BLOCK_SIZE);
+        hc::parallel_for_each(control->accl_view, t_ext_off, [=] (hc::tiled_index<1> &tidx) [[hc]]
+        {
+            int i = tidx.global[0];
+            if (i < num_offsets)
+                csr_rowOffsets[i] = 0;
+        }).wait();
+        csr->num_nonzeros = 0;
+        return hcsparseSuccess;
+    }
+
+    ulong *keys = (ulong*) am_alloc(size * sizeof(ulong), acc, 0);
+    T *values = (T*) am_alloc(size * sizeof(T), acc, 0);
+    ulong *uniqueKeys = (ulong*) am_alloc(size * sizeof(ulong), acc, 0);
+    int *rowIndices = (int*) am_alloc(size * sizeof(int), acc, 0);
+
+    hc::extent<1> grdExt(BLOCK_SIZE * ((size - 1)/BLOCK_SIZE + 1));
+    hc::tiled_extent<1> t_ext = grdExt.tile(BLOCK_SIZE);
+    hc::parallel_for_each(control->accl_view, t_ext, [=] (hc::tiled_index<1> &tidx) [[hc]]
+    {
+        int i = tidx.global[0];
+        if (i < size)
+        {
+            keys[i] = (ulong)coo_rowIndices[i] * num_cols + (ulong)coo_colIndices[i];
+            values[i] = coo_values[i];
+        }
+    }).wait();
+
+    sort_by_key<ulong, T> (size, keys, values, control);
+
+    int num_unique = 0;
+    reduce_by_key<ulong, T> (size, uniqueKeys, csr_values, keys, values, &num_unique, control);
+
+    hc::parallel_for_each(control->accl_view, t_ext, [=] (hc::tiled_index<1> &tidx) [[hc]]
+    {
+        int i = tidx.global[0];
+        if (i < num_unique)
+        {
+            ulong key = uniqueKeys[i];
+            rowIndices[i] = (int)(key / num_cols);
+            csr_colIndices[i] = (int)(key % num_cols);
+        }
+    }).wait();
+
+    csr->num_nonzeros = num_unique;
+
+    hcsparseStatus status = indices_to_offsets<int> (csr->num_rows, num_unique, csr_rowOffsets, rowIndices, control);
+
+    am_free(keys);
+    am_free(values);
+    am_free(uniqueKeys);
+    am_free(rowIndices);
+
+    return status;
+}
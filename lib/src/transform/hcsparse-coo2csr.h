@@ -43,7 +43,7 @@ coo2csr (const hcsparseCooMatrix* coo,
     T *csr_values = static_cast<T*>(csr->values);
 
     int size = coo->num_nonzeros;
-    int num_rows = coo->num_rows + 1;
+    int num_rows = coo->num_rows;
  
     coo2csr_kernel<T> (coo_colIndices, coo_values, csr_colIndices, csr_values, size, control);
 
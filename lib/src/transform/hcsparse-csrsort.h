@@ -0,0 +1,278 @@
+#include "hcsparse.h"
+
+#define BLOCK_SIZE 256
+
+// Rows up to CSRSORT_SHORT_ROW entries are insertion sorted by a single
+// thread, rows up to CSRSORT_TILE_ROW entries are bitonic sorted by one tile
+// in tile_static memory and longer rows go all together through one global
+// sort_by_key.
+#define CSRSORT_SHORT_ROW 32
+#define CSRSORT_TILE_ROW (BLOCK_SIZE * 2)
+
+// Sorts the column indices of every row of a CSR matrix in ascending order.
+// perm is permuted along with the columns; it is usually initialised to the
+// identity so that on return perm[j] is the original position of entry j.
+template <int BASE>
+hcsparseStatus
+csrsort (hcsparseControl* control,
+         const int m,
+         const int nnz,
+         const int *csrRowPtr,
+         int *csrColInd,
+         int *perm)
+{
+    hc::accelerator acc = (control->accl_view).get_accelerator();
+
+    if (m == 0 || nnz == 0)
+        return hcsparseSuccess;
+
+    // [0] number of tile rows, [1] number of long rows
+    int *counters = (int*) am_alloc(2 * sizeof(int), acc, 0);
+    int *tileRows = (int*) am_alloc(m * sizeof(int), acc, 0);
+    int *longRows = (int*) am_alloc(m * sizeof(int), acc, 0);
+
+    int h_counters[2] = {0, 0};
+    control->accl_view.copy(h_counters, counters, 2 * sizeof(int));
+
+    hc::extent<1> grdExt(BLOCK_SIZE * ((m - 1)/BLOCK_SIZE + 1));
+    hc::tiled_extent<1> t_ext = grdExt.tile(BLOCK_SIZE);
+    hc::parallel_for_each(control->accl_view, t_ext, [=] (hc::tiled_index<1> &tidx) [[hc]]
+    {
+        int row = tidx.global[0];
+        if (row >= m)
+            return;
+
+        int start = csrRowPtr[row] - BASE;
+        int end = csrRowPtr[row + 1] - BASE;
+        int len = end - start;
+
+        if (len > CSRSORT_TILE_ROW)
+        {
+            longRows[hc::atomic_fetch_inc(&counters[1])] = row;
+        }
+        else if (len > CSRSORT_SHORT_ROW)
+        {
+            tileRows[hc::atomic_fetch_inc(&counters[0])] = row;
+        }
+        else
+        {
+            for (int i = start + 1; i < end; i++)
+            {
+                int col = csrColInd[i];
+                int p = perm[i];
+                int j = i - 1;
+                while (j >= start && csrColInd[j] > col)
+                {
+                    csrColInd[j + 1] = csrColInd[j];
+                    perm[j + 1] = perm[j];
+                    j--;
+                }
+                csrColInd[j + 1] = col;
+                perm[j + 1] = p;
+            }
+        }
+    }).wait();
+
+    control->accl_view.copy(counters, h_counters, 2 * sizeof(int));
+
+    int numTileRows = h_counters[0];
+    int numLongRows = h_counters[1];
+
+    if (numTileRows > 0)
+    {
+        hc::extent<1> grdExt_tile(BLOCK_SIZE * numTileRows);
+        hc::tiled_extent<1> t_ext_tile = grdExt_tile.tile(BLOCK_SIZE);
+        hc::parallel_for_each(control->accl_view, t_ext_tile, [=] (hc::tiled_index<1> &tidx) [[hc]]
+        {
+            tile_static int ldsCols[CSRSORT_TILE_ROW];
+            tile_static int ldsPerm[CSRSORT_TILE_ROW];
+            int locId = tidx.local[0];
+            int row = tileRows[tidx.tile[0]];
+            int start = csrRowPtr[row] - BASE;
+            int len = csrRowPtr[row + 1] - BASE - start;
+
+            for (int i = locId; i < CSRSORT_TILE_ROW; i += BLOCK_SIZE)
+            {
+                ldsCols[i] = i < len ? csrColInd[start + i] : std::numeric_limits<int>::max();
+                ldsPerm[i] = i < len ? perm[start + i] : 0;
+            }
+            tidx.barrier.wait();
+
+            for (int k = 2; k <= CSRSORT_TILE_ROW; k <<= 1)
+            {
+                for (int j = k >> 1; j > 0; j >>= 1)
+                {
+                    int i = 2 * j * (locId / j) + (locId & (j - 1));
+                    bool ascending = (i & k) == 0;
+                    int a = ldsCols[i];
+                    int b = ldsCols[i + j];
+                    if ((a > b) == ascending && a != b)
+                    {
+                        int t = ldsPerm[i];
+                        ldsCols[i] = b;
+                        ldsCols[i + j] = a;
+                        ldsPerm[i] = ldsPerm[i + j];
+                        ldsPerm[i + j] = t;
+                    }
+                    tidx.barrier.wait();
+                }
+            }
+
+            for (int i = locId; i < len; i += BLOCK_SIZE)
+            {
+                csrColInd[start + i] = ldsCols[i];
+                perm[start + i] = ldsPerm[i];
+            }
+        }).wait();
+    }
+
+    if (numLongRows > 0)
+    {
+        // all long rows are sorted together by one sort_by_key on the key
+        // (long row, column), which keeps every row in its own segment
+        int *lens = (int*) am_alloc(numLongRows * sizeof(int), acc, 0);
+        int *starts = (int*) am_alloc(numLongRows * sizeof(int), acc, 0);
+        int *segOff = (int*) am_alloc(numLongRows * sizeof(int), acc, 0);
+
+        hc::extent<1> grdExt_long(BLOCK_SIZE * ((numLongRows - 1)/BLOCK_SIZE + 1));
+        hc::tiled_extent<1> t_ext_long = grdExt_long.tile(BLOCK_SIZE);
+        hc::parallel_for_each(control->accl_view, t_ext_long, [=] (hc::tiled_index<1> &tidx) [[hc]]
+        {
+            int r = tidx.global[0];
+            if (r < numLongRows)
+            {
+                int row = longRows[r];
+                starts[r] = csrRowPtr[row] - BASE;
+                lens[r] = csrRowPtr[row + 1] - csrRowPtr[row];
+            }
+        }).wait();
+
+        exclusive_scan<int, EW_PLUS> (numLongRows, segOff, lens, control);
+
+        int last[2];
+        control->accl_view.copy(segOff + (numLongRows - 1), &last[0], sizeof(int));
+        control->accl_view.copy(lens + (numLongRows - 1), &last[1], sizeof(int));
+        const int total = last[0] + last[1];
+
+        ulong *keys = (ulong*) am_alloc(total * sizeof(ulong), acc, 0);
+        int *vals = (int*) am_alloc(total * sizeof(int), acc, 0);
+
+        hc::extent<1> grdExt_ent(BLOCK_SIZE * ((total - 1)/BLOCK_SIZE + 1));
+        hc::tiled_extent<1> t_ext_ent = grdExt_ent.tile(BLOCK_SIZE);
+
+        hc::parallel_for_each(control->accl_view, t_ext_ent, [=] (hc::tiled_index<1> &tidx) [[hc]]
+        {
+            int t = tidx.global[0];
+            if (t < total)
+            {
+                // segment of the entry: the last r with segOff[r] <= t
+                int lo = 0;
+                int hi = numLongRows - 1;
+                while (lo < hi)
+                {
+                    int mid = (lo + hi + 1) / 2;
+                    if (segOff[mid] <= t)
+                        lo = mid;
+                    else
+                        hi = mid - 1;
+                }
+                int r = lo;
+                int pos = starts[r] + t - segOff[r];
+                keys[t] = ((ulong)r << 32) | (ulong)(unsigned int)csrColInd[pos];
+                vals[t] = perm[pos];
+            }
+        }).wait();
+
+        sort_by_key<ulong, int> (total, keys, vals, control);
+
+        hc::parallel_for_each(control->accl_view, t_ext_ent, [=] (hc::tiled_index<1> &tidx) [[hc]]
+        {
+            int t = tidx.global[0];
+            if (t < total)
+            {
+                int r = (int)(keys[t] >> 32);
+                int pos = starts[r] + t - segOff[r];
+                csrColInd[pos] = (int)(keys[t] & 0xffffffff);
+                perm[pos] = vals[t];
+            }
+        }).wait();
+
+        am_free(lens);
+        am_free(starts);
+        am_free(segOff);
+        am_free(keys);
+        am_free(vals);
+    }
+
+    am_free(counters);
+    am_free(tileRows);
+    am_free(longRows);
+
+    return hcsparseSuccess;
+}
+
+template <int BASE>
+hcsparseStatus
+csrsort (hcsparseControl* control,
+         const int m,
+         const int nnz,
+         const int *csrRowPtr,
+         int *csrColInd)
+{
+    hc::accelerator acc = (control->accl_view).get_accelerator();
+
+    if (m == 0 || nnz == 0)
+        return hcsparseSuccess;
+
+    int *perm = (int*) am_alloc(nnz * sizeof(int), acc, 0);
+
+    hcsparseStatus status = csrsort<BASE> (control, m, nnz, csrRowPtr, csrColInd, perm);
+
+    am_free(perm);
+
+    return status;
+}
+
+template <typename T>
+hcsparseStatus
+gather (hcsparseControl* control,
+        const int nnz,
+        const T *y,
+        T *xVal,
+        const int *xInd,
+        const int base)
+{
+    if (nnz == 0)
+        return hcsparseSuccess;
+
+    hc::extent<1> grdExt(BLOCK_SIZE * ((nnz - 1)/BLOCK_SIZE + 1));
+    hc::tiled_extent<1> t_ext = grdExt.tile(BLOCK_SIZE);
+    hc::parallel_for_each(control->accl_view, t_ext, [=] (hc::tiled_index<1> &tidx) [[hc]]
+    {
+        int i = tidx.global[0];
+        if (i < nnz)
+            xVal[i] = y[xInd[i] - base];
+    }).wait();
+
+    return hcsparseSuccess;
+}
+
+inline hcsparseStatus
+identity_permutation (hcsparseControl* control,
+                      const int n,
+                      int *p)
+{
+    if (n == 0)
+        return hcsparseSuccess;
+
+    hc::extent<1> grdExt(BLOCK_SIZE * ((n - 1)/BLOCK_SIZE + 1));
+    hc::tiled_extent<1> t_ext = grdExt.tile(BLOCK_SIZE);
+    hc::parallel_for_each(control->accl_view, t_ext, [=] (hc::tiled_index<1> &tidx) [[hc]]
+    {
+        int i = tidx.global[0];
+        if (i < n)
+            p[i] = i;
+    }).wait();
+
+    return hcsparseSuccess;
+}
@@ -1,263 +1,333 @@
 #include "hcsparse.h"
+#include <atomic>
 
 #define BLOCK_SIZE 256
 
-template <typename T, ElementWiseOperator OP>
-hcsparseStatus
-scan (int size,
-      T *output,
-      const T *input,
-      hcsparseControl* control,
-      int exclusive)
+// Every thread scans SCAN_ITEMS_PER_THREAD consecutive elements, so one tile
+// covers SCAN_TILE_ITEMS elements of the input.
+#define SCAN_ITEMS_PER_THREAD 4
+#define SCAN_TILE_ITEMS (BLOCK_SIZE * SCAN_ITEMS_PER_THREAD)
+
+// Tile status word used by the decoupled look-back: bits 0-1 hold the state,
+// bit 2 is set when the tile contains a segment head and the remaining bits
+// carry the epoch of the scan that published it.
+#define SCAN_STATUS_AGGREGATE 1
+#define SCAN_STATUS_PREFIX 2
+#define SCAN_STATUS_MASK 3
+#define SCAN_STATUS_HEAD 4
+#define SCAN_EPOCH_SHIFT 3
+#define SCAN_MAX_EPOCH (1u << 28)
+
+// Device scratch shared by all scans: a tile ticket counter followed by the
+// tile status words, aggregates and inclusive prefixes. It only ever grows,
+// and status words left over from earlier scans are told apart by their
+// epoch, so it does not need clearing between calls.
+typedef struct scanScratch_
 {
-    hc::accelerator acc = (control->accl_view).get_accelerator();
+    void *buffer;
+    size_t bytes;
+    unsigned int epoch;
+    unsigned int tickets;
+} scanScratch;
 
-    int numElementsRUP = size;
-    int modWgSize = (numElementsRUP & ((BLOCK_SIZE*2)-1));
+static scanScratch scan_scratch = { nullptr, 0, 0, 0 };
 
-    if( modWgSize )
+inline void*
+scan_get_scratch (size_t bytes,
+                  unsigned int num_tiles,
+                  unsigned int &epoch,
+                  unsigned int &ticket_base,
+                  hcsparseControl* control)
+{
+    bool reset = false;
+
+    if (bytes > scan_scratch.bytes)
     {
-        numElementsRUP &= ~modWgSize;
-        numElementsRUP += (BLOCK_SIZE*2);
+        hc::accelerator acc = (control->accl_view).get_accelerator();
+        if (scan_scratch.buffer != nullptr)
+            am_free(scan_scratch.buffer);
+        scan_scratch.buffer = am_alloc(bytes, acc, 0);
+        scan_scratch.bytes = bytes;
+        reset = true;
     }
 
-    //2 element per work item
-    int numWorkGroupsK0 = numElementsRUP / (BLOCK_SIZE*2);
-
-    int sizeScanBuff = numWorkGroupsK0;
+    if (scan_scratch.epoch + 1 >= SCAN_MAX_EPOCH ||
+        scan_scratch.tickets > std::numeric_limits<unsigned int>::max() - num_tiles)
+    {
+        reset = true;
+    }
 
-    modWgSize = (sizeScanBuff & ((BLOCK_SIZE*2)-1));
-    if( modWgSize )
+    if (reset)
     {
-        sizeScanBuff &= ~modWgSize;
-        sizeScanBuff += (BLOCK_SIZE*2);
+        char *zeros = (char*) calloc(scan_scratch.bytes, 1);
+        control->accl_view.copy(zeros, scan_scratch.buffer, scan_scratch.bytes);
+        free(zeros);
+        scan_scratch.epoch = 0;
+        scan_scratch.tickets = 0;
     }
 
-    T *preSumArray = (T*) am_alloc(sizeScanBuff * sizeof(T), acc, 0);
-    T *preSumArray1 = (T*) am_alloc(sizeScanBuff * sizeof(T), acc, 0);
-    T *postSumArray = (T*) am_alloc(sizeScanBuff * sizeof(T), acc, 0);
+    scan_scratch.epoch++;
+    epoch = scan_scratch.epoch;
+    ticket_base = scan_scratch.tickets;
+    scan_scratch.tickets += num_tiles;
 
-    T identity = 0;
+    return scan_scratch.buffer;
+}
 
-    //scan in blocks
+inline void
+scan_release_scratch ()
+{
+    if (scan_scratch.buffer != nullptr)
+        am_free(scan_scratch.buffer);
+    scan_scratch.buffer = nullptr;
+    scan_scratch.bytes = 0;
+    scan_scratch.epoch = 0;
+    scan_scratch.tickets = 0;
+}
 
-    hc::extent<1> grdExt_numElm(numElementsRUP/2);
-    hc::tiled_extent<1> t_ext_numElm = grdExt_numElm.tile(BLOCK_SIZE);
+template <typename T, ElementWiseOperator OP>
+T
+scan_identity ()
+{
+    if (OP == EW_MULTIPLY)
+        return (T)1;
+    else if (OP == EW_MIN)
+        return std::numeric_limits<T>::max();
+    else if (OP == EW_MAX)
+        return std::numeric_limits<T>::lowest();
+    else
+        return (T)0;
+}
+
+// The scans below run any associative operator given as a type with a
+// static apply(a, b); this one wraps the elementwise operators.
+template <typename T, ElementWiseOperator OP>
+struct scan_operator
+{
+    static T apply(T a, T b) __attribute__((hc, cpu)) { return operation<T, OP>(a, b); }
+};
+
+// Single pass scan with decoupled look-back. Tiles take a ticket in launch
+// order, scan their SCAN_TILE_ITEMS elements, publish the tile aggregate and
+// then fold the aggregates or inclusive prefixes of their predecessors until
+// an inclusive prefix is found. When SEGMENTED is set, heads[i] != 0 starts a
+// new segment at i and the look-back stops at the first tile holding a head.
+// output may alias input; identity is the identity of OPF::apply.
+template <typename T, typename OPF, bool SEGMENTED>
+hcsparseStatus
+scan_lookback_by (int size,
+                  T *output,
+                  const T *input,
+                  const int *heads,
+                  const T identity,
+                  hcsparseControl* control,
+                  int exclusive)
+{
+    if (size <= 0)
+        return hcsparseSuccess;
+
+    unsigned int num_tiles = (size - 1) / SCAN_TILE_ITEMS + 1;
 
-    hc::parallel_for_each(control->accl_view, t_ext_numElm, [=] (hc::tiled_index<1> &tidx) [[hc]]
+    size_t statusBytes = ((sizeof(unsigned int) * (num_tiles + 1) + 15) / 16) * 16;
+    size_t bytes = statusBytes + 2 * num_tiles * sizeof(T);
+
+    unsigned int epoch, ticket_base;
+    char *scratch = (char*) scan_get_scratch(bytes, num_tiles, epoch, ticket_base, control);
+
+    unsigned int *counter = (unsigned int*) scratch;
+    unsigned int *status = counter + 1;
+    T *aggregates = (T*) (scratch + statusBytes);
+    T *prefixes = aggregates + num_tiles;
+
+    const unsigned int tag = epoch << SCAN_EPOCH_SHIFT;
+
+    hc::extent<1> grdExt(num_tiles * BLOCK_SIZE);
+    hc::tiled_extent<1> t_ext = grdExt.tile(BLOCK_SIZE);
+
+    hc::parallel_for_each(control->accl_view, t_ext, [=] (hc::tiled_index<1> &tidx) [[hc]]
     {
-        tile_static T lds[BLOCK_SIZE*2];
-        size_t gloId = tidx.global[0];
-        size_t groId = tidx.tile[0];
-        size_t locId = tidx.local[0];
-        size_t wgSize = tidx.tile_dim[0];
-        wgSize *=2;
-        size_t offset = 1;
-        // load input into shared memory
-        if(groId * wgSize + locId < size)
-            lds[locId] = input[groId * wgSize + locId];
-        else
-            lds[locId] = 0;//input_ptr[vecSize - 1];
-        if(groId * wgSize + locId + (wgSize / 2) < size)
-            lds[locId + (wgSize / 2)] = input[groId * wgSize + locId + (wgSize / 2)];
-        else
-            lds[locId + (wgSize / 2)] = 0;
-        // Exclusive case
-        if(exclusive == 1 && gloId == 0)
-        {
-            T start_val = input[0];
-            lds[locId] = operation<T, OP>(identity, start_val);
-        }
-        for (size_t start = wgSize>>1; start > 0; start >>= 1)
-        {
-            tidx.barrier.wait();
-            if (locId < start)
-            {
-                size_t temp1 = offset*(2*locId+1)-1;
-                size_t temp2 = offset*(2*locId+2)-1;
-                T y = lds[temp2];
-                T y1 =lds[temp1];
-                lds[temp2] = operation<T, OP>(y, y1);
-            }
-            offset *= 2;
-        }
-        tidx.barrier.wait();
+        tile_static T ldsVals[SCAN_TILE_ITEMS];
+        tile_static int ldsHeads[SEGMENTED ? SCAN_TILE_ITEMS : 1];
+        tile_static T ldsScan[BLOCK_SIZE];
+        tile_static int ldsScanHead[BLOCK_SIZE];
+        tile_static unsigned int ldsTile;
+        tile_static T ldsPrefix;
+
+        int locId = tidx.local[0];
+
         if (locId == 0)
-        {
-            preSumArray[ groId ] = lds[wgSize -1];
-            preSumArray1[ groId ] = lds[wgSize/2 -1];
-        }
-    }).wait();
+            ldsTile = hc::atomic_fetch_inc(counter) - ticket_base;
+        tidx.barrier.wait();
 
-    T workPerThread = sizeScanBuff / BLOCK_SIZE;
+        unsigned int tile = ldsTile;
+        int base = tile * SCAN_TILE_ITEMS;
 
-    hc::extent<1> grdExt_block(BLOCK_SIZE);
-    hc::tiled_extent<1> t_ext_block = grdExt_block.tile(BLOCK_SIZE);
+        // striped loads keep the global reads coalesced
+        for (int k = 0; k < SCAN_ITEMS_PER_THREAD; k++)
+        {
+            int i = k * BLOCK_SIZE + locId;
+            int g = base + i;
+            ldsVals[i] = g < size ? input[g] : identity;
+            if (SEGMENTED)
+                ldsHeads[i] = g < size ? heads[g] : 0;
+        }
+        tidx.barrier.wait();
 
-    hc::parallel_for_each(control->accl_view, t_ext_block, [=] (hc::tiled_index<1> &tidx) [[hc]]
-    {
-        tile_static T lds[BLOCK_SIZE];
-        size_t gloId = tidx.global[0];
-        size_t locId = tidx.local[0];
-        size_t wgSize = tidx.tile_dim[0];
-        uint mapId  = gloId * workPerThread;
-        // do offset of zero manually
-        uint offset;
-        T workSum = 0;
-         if (mapId < numWorkGroupsK0)
+        // each thread reduces its consecutive items
+        int first = locId * SCAN_ITEMS_PER_THREAD;
+        T sum = ldsVals[first];
+        int head = SEGMENTED ? ldsHeads[first] : 0;
+        for (int k = 1; k < SCAN_ITEMS_PER_THREAD; k++)
         {
-            // accumulate zeroth value manually
-            offset = 0;
-            workSum = preSumArray[mapId+offset];
-            //  Serial accumulation
-            for ( offset = offset + 1; offset < workPerThread; offset += 1 )
+            if (SEGMENTED && ldsHeads[first + k])
             {
-                if (mapId + offset < numWorkGroupsK0)
-                {
-                    T y = preSumArray[mapId+offset];
-                    workSum = operation<T, OP>(workSum,y);
-                }
+                sum = ldsVals[first + k];
+                head = 1;
+            }
+            else
+            {
+                sum = OPF::apply(sum, ldsVals[first + k]);
             }
         }
-        tidx.barrier.wait();
-        T scanSum = workSum;
-        lds[ locId ] = workSum;
-        offset = 1;
-        // scan in lds
-        for ( offset = offset*1; offset < wgSize; offset *= 2 )
+
+        // inclusive scan of the per thread sums
+        ldsScan[locId] = sum;
+        ldsScanHead[locId] = head;
+        for (int offset = 1; offset < BLOCK_SIZE; offset *= 2)
         {
             tidx.barrier.wait();
-            if (mapId < numWorkGroupsK0)
+            if (locId >= offset)
             {
-                if (locId >= offset)
-                {
-                    T y = lds[ locId - offset ];
-                    scanSum = operation<T, OP>(scanSum, y);
-                }
+                T left = ldsScan[locId - offset];
+                int leftHead = ldsScanHead[locId - offset];
+                if (!SEGMENTED || !head)
+                    sum = OPF::apply(left, sum);
+                head |= leftHead;
             }
             tidx.barrier.wait();
-            lds[ locId ] = scanSum;
-        } // for offset
-        tidx.barrier.wait();
-        // write final scan from pre-scan and lds scan
-        workSum = preSumArray[mapId];
-        if (locId > 0)
-        {
-            T y = lds[locId-1];
-            workSum = operation<T, OP>(workSum, y);
-            postSumArray[ mapId] = workSum;
+            ldsScan[locId] = sum;
+            ldsScanHead[locId] = head;
         }
-        else
+        tidx.barrier.wait();
+
+        T aggregate = ldsScan[BLOCK_SIZE - 1];
+        int aggregateHead = ldsScanHead[BLOCK_SIZE - 1];
+        unsigned int headBit = aggregateHead ? SCAN_STATUS_HEAD : 0;
+
+        if (locId == 0)
         {
-            postSumArray[ mapId] = workSum;
+            if (tile == 0)
+                prefixes[0] = aggregate;
+            else
+                aggregates[tile] = aggregate;
         }
-        for ( offset = 1; offset < workPerThread; offset += 1 )
+        tidx.barrier.wait_with_global_memory_fence();
+
+        if (locId == 0)
         {
-            tidx.barrier.wait();
-            if (mapId < numWorkGroupsK0 && locId > 0)
+            if (tile == 0)
             {
-                T y  = preSumArray[ mapId + offset ] ;
-                T y1 = operation<T, OP>(y, workSum);
-                postSumArray[ mapId + offset ] = y1;
-                workSum = y1;
-            } // thread in bounds
+                hc::atomic_exchange(&status[0], tag | headBit | SCAN_STATUS_PREFIX);
+                ldsPrefix = identity;
+            }
             else
             {
-                T y  = preSumArray[ mapId + offset ] ;
-                postSumArray[ mapId + offset ] = operation<T, OP>(y, workSum);
-                workSum = postSumArray[ mapId + offset ];
-            }
-        } // for
-    }).wait();
-
-    hc::extent<1> grdExt(numElementsRUP);
-    hc::tiled_extent<1> t_ext = grdExt.tile(BLOCK_SIZE);
+                hc::atomic_exchange(&status[tile], tag | headBit | SCAN_STATUS_AGGREGATE);
 
-    hc::parallel_for_each(control->accl_view, t_ext, [=] (hc::tiled_index<1> &tidx) [[hc]]
-    {
-        tile_static T lds[BLOCK_SIZE];
-        size_t gloId = tidx.global[0];
-        size_t groId = tidx.tile[0];
-        size_t locId = tidx.local[0];
-        size_t wgSize = tidx.tile_dim[0];
-        // if exclusive, load gloId=0 w/ identity, and all others shifted-1
-        T val;
-        if (gloId < size)
-        {
-            if (exclusive == 1)
-            {
-                if (gloId > 0)
-                {
-                    val = input[gloId-1];
-                    lds[ locId ] = val;
-                }
-                else
+                T exclusivePrefix = identity;
+                int pred = tile - 1;
+                while (true)
                 {
-                    val = identity;
-                    lds[ locId ] = val;
+                    unsigned int s;
+                    do
+                    {
+                        s = hc::atomic_fetch_add(&status[pred], 0u);
+                    } while ((s >> SCAN_EPOCH_SHIFT) != epoch);
+
+                    // acquire: the aggregate or prefix published before
+                    // the status word must not be read stale
+                    std::atomic_thread_fence(std::memory_order_acquire);
+
+                    bool isPrefix = (s & SCAN_STATUS_MASK) == SCAN_STATUS_PREFIX;
+                    T v = isPrefix ? prefixes[pred] : aggregates[pred];
+                    exclusivePrefix = OPF::apply(v, exclusivePrefix);
+
+                    if (isPrefix || (SEGMENTED && (s & SCAN_STATUS_HEAD)))
+                        break;
+                    pred--;
                 }
-            }
-            else
-            {
-                val = input[gloId];
-                lds[ locId ] = val;
+
+                ldsPrefix = exclusivePrefix;
+                prefixes[tile] = (SEGMENTED && aggregateHead) ? aggregate :
+                                 OPF::apply(exclusivePrefix, aggregate);
             }
         }
-        T scanResult = lds[locId];
-        T postBlockSum, newResult;
-        T y, y1, sum;
-        if (locId == 0 && gloId < size)
+        tidx.barrier.wait_with_global_memory_fence();
+
+        if (locId == 0 && tile > 0)
+            hc::atomic_exchange(&status[tile], tag | headBit | SCAN_STATUS_PREFIX);
+
+        // prefix of everything before this thread's first item
+        T running = ldsPrefix;
+        if (locId > 0)
         {
-            if (groId > 0)
-            {
-                if (groId % 2 == 0)
-                    postBlockSum = postSumArray[ groId/2 -1 ];
-                else if (groId == 1)
-                    postBlockSum = preSumArray1[0];
-                else
-                {
-                    y = postSumArray[ groId/2 -1 ];
-                    y1 = preSumArray1[groId/2];
-                    postBlockSum = operation<T, OP>(y, y1);
-                }
-                if (exclusive == 1)
-                    newResult = postBlockSum;
-                else
-                    newResult = operation<T, OP>(scanResult, postBlockSum);
-            }
+            if (SEGMENTED && ldsScanHead[locId - 1])
+                running = ldsScan[locId - 1];
             else
-            {
-                newResult = scanResult;
-            }
-            lds[ locId ] = newResult;
+                running = OPF::apply(running, ldsScan[locId - 1]);
         }
-        //  Computes a scan within a workgroup
-        sum = lds[ locId ];
-        for ( size_t offset = 1; offset < wgSize; offset *= 2 )
+
+        for (int k = 0; k < SCAN_ITEMS_PER_THREAD; k++)
         {
-            tidx.barrier.wait();
-            if (locId >= offset)
-            {
-                T y = lds[ locId - offset ];
-                sum = operation<T, OP>(sum, y);
-            }
-            tidx.barrier.wait();
-            lds[ locId ] = sum;
+            int i = first + k;
+            T x = ldsVals[i];
+            bool h = SEGMENTED && ldsHeads[i];
+            T inclusive = h ? x : OPF::apply(running, x);
+            if (exclusive == 1)
+                ldsVals[i] = h ? identity : running;
+            else
+                ldsVals[i] = inclusive;
+            running = inclusive;
         }
         tidx.barrier.wait();
-        //  Abort threads that are passed the end of the input vector
-        if (gloId >= size) return;
-        output[ gloId ] = sum;
-    }).wait();
-    control->accl_view.wait();
 
-    am_free(preSumArray);
-    am_free(preSumArray1);
-    am_free(postSumArray);
+        for (int k = 0; k < SCAN_ITEMS_PER_THREAD; k++)
+        {
+            int i = k * BLOCK_SIZE + locId;
+            int g = base + i;
+            if (g < size)
+                output[g] = ldsVals[i];
+        }
+    }).wait();
 
     return hcsparseSuccess;
 }
 
+template <typename T, ElementWiseOperator OP, bool SEGMENTED>
+hcsparseStatus
+scan_lookback (int size,
+               T *output,
+               const T *input,
+               const int *heads,
+               hcsparseControl* control,
+               int exclusive)
+{
+    return scan_lookback_by<T, scan_operator<T, OP>, SEGMENTED>(size, output, input, heads,
+                                                                scan_identity<T, OP>(),
+                                                                control, exclusive);
+}
+
+template <typename T, ElementWiseOperator OP>
+hcsparseStatus
+scan (int size,
+      T *output,
+      const T *input,
+      hcsparseControl* control,
+      int exclusive)
+{
+    return scan_lookback<T, OP, false>(size, output, input, nullptr, control, exclusive);
+}
+
 template <typename T, ElementWiseOperator OP>
 hcsparseStatus
 exclusive_scan (int size,
@@ -277,3 +347,25 @@ inclusive_scan (int size,
 {
   return scan<T, OP>(size, output, input, control, (int)false);
 }
+
+template <typename T, ElementWiseOperator OP>
+hcsparseStatus
+segmented_exclusive_scan (int size,
+                          T *output,
+                          const T *input,
+                          const int *heads,
+                          hcsparseControl* control)
+{
+   return scan_lookback<T, OP, true>(size, output, input, heads, control, (int)true);
+}
+
+template <typename T, ElementWiseOperator OP>
+hcsparseStatus
+segmented_inclusive_scan (int size,
+                          T *output,
+                          const T *input,
+                          const int *heads,
+                          hcsparseControl* control)
+{
+  return scan_lookback<T, OP, true>(size, output, input, heads, control, (int)false);
+}
@@ -0,0 +1,157 @@
+#include "hcsparse.h"
+
+#define BLOCK_SIZE 256
+
+// Compare-exchange of every pair (i, i + j) inside one tile's 2*BLOCK_SIZE
+// chunk, for all bitonic stages k in [k_begin, k_end] and strides
+// j <= BLOCK_SIZE. Wider strides are handled by sort_by_key_global_stage.
+template <typename K, typename V>
+void
+sort_by_key_local_stages (int k_begin,
+                          int k_end,
+                          K *keys,
+                          V *values,
+                          int num_pairs,
+                          hcsparseControl* control)
+{
+    hc::extent<1> grdExt(num_pairs);
+    hc::tiled_extent<1> t_ext = grdExt.tile(BLOCK_SIZE);
+    hc::parallel_for_each(control->accl_view, t_ext, [=] (hc::tiled_index<1> &tidx) [[hc]]
+    {
+        tile_static K ldsKeys[BLOCK_SIZE * 2];
+        tile_static V ldsVals[BLOCK_SIZE * 2];
+        int locId = tidx.local[0];
+        int base = tidx.tile[0] * BLOCK_SIZE * 2;
+
+        ldsKeys[locId] = keys[base + locId];
+        ldsVals[locId] = values[base + locId];
+        ldsKeys[locId + BLOCK_SIZE] = keys[base + locId + BLOCK_SIZE];
+        ldsVals[locId + BLOCK_SIZE] = values[base + locId + BLOCK_SIZE];
+        tidx.barrier.wait();
+
+        for (int k = k_begin; k <= k_end; k <<= 1)
+        {
+            int j = (k >> 1) < BLOCK_SIZE ? (k >> 1) : BLOCK_SIZE;
+            for (; j > 0; j >>= 1)
+            {
+                int i = 2 * j * (locId / j) + (locId & (j - 1));
+                bool ascending = ((base + i) & k) == 0;
+                K a = ldsKeys[i];
+                K b = ldsKeys[i + j];
+                if ((a > b) == ascending && a != b)
+                {
+                    V t = ldsVals[i];
+                    ldsKeys[i] = b;
+                    ldsKeys[i + j] = a;
+                    ldsVals[i] = ldsVals[i + j];
+                    ldsVals[i + j] = t;
+                }
+                tidx.barrier.wait();
+            }
+        }
+
+        keys[base + locId] = ldsKeys[locId];
+        values[base + locId] = ldsVals[locId];
+        keys[base + locId + BLOCK_SIZE] = ldsKeys[locId + BLOCK_SIZE];
+        values[base + locId + BLOCK_SIZE] = ldsVals[locId + BLOCK_SIZE];
+    }).wait();
+}
+
+template <typename K, typename V>
+void
+sort_by_key_global_stage (int k,
+                          int j,
+                          K *keys,
+                          V *values,
+                          int num_pairs,
+                          hcsparseControl* control)
+{
+    hc::extent<1> grdExt(num_pairs);
+    hc::tiled_extent<1> t_ext = grdExt.tile(BLOCK_SIZE);
+    hc::parallel_for_each(control->accl_view, t_ext, [=] (hc::tiled_index<1> &tidx) [[hc]]
+    {
+        int t = tidx.global[0];
+        int i = 2 * j * (t / j) + (t & (j - 1));
+        bool ascending = (i & k) == 0;
+        K a = keys[i];
+        K b = keys[i + j];
+        if ((a > b) == ascending && a != b)
+        {
+            V v = values[i];
+            keys[i] = b;
+            keys[i + j] = a;
+            values[i] = values[i + j];
+            values[i + j] = v;
+        }
+    }).wait();
+}
+
+// Sorts keys ascending on the device and applies the same permutation to
+// values. The data is staged in a power-of-two scratch buffer padded with
+// the largest representable key so the bitonic network needs no bounds checks.
+template <typename K, typename V>
+hcsparseStatus
+sort_by_key (int size,
+             K *keys,
+             V *values,
+             hcsparseControl* control)
+{
+    if (size <= 1)
+        return hcsparseSuccess;
+
+    hc::accelerator acc = (control->accl_view).get_accelerator();
+
+    int padded_size = BLOCK_SIZE * 2;
+    while (padded_size < size)
+        padded_size <<= 1;
+
+    K *sortKeys = (K*) am_alloc(padded_size * sizeof(K), acc, 0);
+    V *sortVals = (V*) am_alloc(padded_size * sizeof(V), acc, 0);
+
+    const K maxKey = std::numeric_limits<K>::max();
+
+    hc::extent<1> grdExt(padded_size);
+    hc::tiled_extent<1> t_ext = grdExt.tile(BLOCK_SIZE);
+    hc::parallel_for_each(control->accl_view, t_ext, [=] (hc::tiled_index<1> &tidx) [[hc]]
+    {
+        int i = tidx.global[0];
+        if (i < size)
+        {
+            sortKeys[i] = keys[i];
+            sortVals[i] = values[i];
+        }
+        else
+        {
+            sortKeys[i] = maxKey;
+            sortVals[i] = 0;
+        }
+    }).wait();
+
+    int num_pairs = padded_size / 2;
+
+    sort_by_key_local_stages<K, V> (2, BLOCK_SIZE * 2, sortKeys, sortVals, num_pairs, control);
+
+    for (int k = BLOCK_SIZE * 4; k <= padded_size; k <<= 1)
+    {
+        for (int j = k >> 1; j > BLOCK_SIZE; j >>= 1)
+        {
+            sort_by_key_global_stage<K, V> (k, j, sortKeys, sortVals, num_pairs, control);
+        }
+        sort_by_key_local_stages<K, V> (k, k, sortKeys, sortVals, num_pairs, control);
+    }
+
+    hc::parallel_for_each(control->accl_view, t_ext, [=] (hc::tiled_index<1> &tidx) [[hc]]
+    {
+        int i = tidx.global[0];
+        if (i < size)
+        {
+            keys[i] = sortKeys[i];
+            values[i] = sortVals[i];
+        }
+    }).wait();
+
+    am_free(sortKeys);
+    am_free(sortVals);
+
+    return hcsparseSuccess;
+}
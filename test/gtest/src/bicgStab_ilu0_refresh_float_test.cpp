@@ -0,0 +1,125 @@
+#include <hcsparse.h>
+#include <iostream>
+#include <vector>
+#include "gtest/gtest.h"
+
+TEST(bicgStab_ilu0_refresh_float_test, func_check)
+{
+    hcsparseCsrMatrix gA;
+    hcdenseVector gX;
+    hcdenseVector gB;
+
+    std::vector<accelerator>acc = accelerator::get_all();
+    accelerator_view accl_view = (acc[1].create_view());
+
+    hcsparseControl control(accl_view);
+
+    const char* filename = "./../../../../test/gtest/src/input.mtx";
+
+    int num_nonzero, num_row, num_col;
+
+    hcsparseStatus status;
+
+    status = hcsparseHeaderfromFile(&num_nonzero, &num_row, &num_col, filename);
+
+    std::vector<float> host_X(num_col, 0);
+    std::vector<float> host_B(num_row);
+
+    srand (time(NULL));
+    for (int i = 0; i < num_row; i++)
+    {
+        host_B[i] = rand()%100;
+    }
+
+    hcsparseSetup();
+    hcsparseInitCsrMatrix(&gA);
+    hcsparseInitVector(&gX);
+    hcsparseInitVector(&gB);
+
+    gX.values = am_alloc(sizeof(float)*num_col, acc[1], 0);
+    gB.values = am_alloc(sizeof(float)*num_row, acc[1], 0);
+
+    gX.offValues = 0;
+    gB.offValues = 0;
+
+    gX.num_values = num_col;
+    gB.num_values = num_row;
+
+    gA.offValues = 0;
+    gA.offColInd = 0;
+    gA.offRowOff = 0;
+
+    control.accl_view.copy(host_B.data(), gB.values, sizeof(float) * num_row);
+
+    gA.values = am_alloc(sizeof(float) * num_nonzero, acc[1], 0);
+    gA.rowOffsets = am_alloc(sizeof(int) * (num_row+1), acc[1], 0);
+    gA.colIndices = am_alloc(sizeof(int) * num_nonzero, acc[1], 0);
+
+    status = hcsparseSCsrMatrixfromFile(&gA, filename, &control, false);
+
+    if (status != hcsparseSuccess)
+    {
+        std::cout<<"The input file should be in mtx format"<<std::endl;
+        exit (1);
+    }
+
+    // start tracking the pattern of A
+    EXPECT_EQ(hcsparseCsrStructureChanged(&gA), hcsparseSuccess);
+
+    int maxIter = 1000;
+    float relTol = 0.0001;
+    float absTol = 0.0001;
+
+    hcsparseSolverControl *solver_control;
+
+    solver_control = hcsparseCreateSolverControl(ILU0, maxIter, relTol, absTol);
+
+    std::vector<float> values(num_nonzero);
+    control.accl_view.copy(gA.values, values.data(), sizeof(float) * num_nonzero);
+
+    // first solve with A, then with 2*A on the same pattern, then after a
+    // change of the pattern
+    void *cached = nullptr;
+    for (int pass = 0; pass < 3; pass++)
+    {
+        control.accl_view.copy(host_X.data(), gX.values, sizeof(float) * num_col);
+        status = hcsparseScsrbicgStab(&gX, &gA, &gB, solver_control, &control);
+        EXPECT_EQ(status, hcsparseSuccess);
+
+        EXPECT_LT(solver_control->nIters, maxIter);
+        EXPECT_TRUE(solver_control->currentResidual <= relTol ||
+                    solver_control->currentResidual <= absTol * solver_control->initialResidual);
+
+        ASSERT_TRUE(solver_control->precondCache != nullptr);
+        if (pass == 0)
+            cached = solver_control->precondCache.get();
+        else if (pass == 1)
+            EXPECT_EQ(solver_control->precondCache.get(), cached);
+        else
+            EXPECT_EQ(solver_control->precondValues, gA.valuesVersion);
+
+        if (pass == 0)
+        {
+            for (int p = 0; p < num_nonzero; p++)
+                values[p] *= 2;
+            control.accl_view.copy(values.data(), gA.values, sizeof(float) * num_nonzero);
+            EXPECT_EQ(hcsparseCsrValuesChanged(&gA), hcsparseSuccess);
+        }
+        else if (pass == 1)
+        {
+            EXPECT_EQ(solver_control->precondValues, gA.valuesVersion);
+            EXPECT_EQ(hcsparseCsrStructureChanged(&gA), hcsparseSuccess);
+        }
+    }
+
+    EXPECT_EQ(solver_control->precondStructure, gA.structureVersion);
+
+    hcsparseReleaseSolverControl(solver_control);
+    hcsparseTeardown();
+
+    am_free(gX.values);
+    am_free(gB.values);
+    am_free(gA.values);
+    am_free(gA.rowOffsets);
+    am_free(gA.colIndices);
+}
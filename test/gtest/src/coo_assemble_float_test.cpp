@@ -0,0 +1,94 @@
+#include <hcsparse.h>
+#include <iostream>
+#include <hc_am.hpp>
+#include "gtest/gtest.h"
+
+#define TOLERANCE 0.01
+
+TEST(coo_assemble_float_test, func_check)
+{
+    hcsparseCsrMatrix gCsrMat;
+    hcsparseCooMatrix gCooMat;
+
+    std::vector<accelerator>acc = accelerator::get_all();
+    accelerator_view accl_view = (acc[1].create_view());
+
+    hcsparseControl control(accl_view);
+
+    hcsparseSetup();
+    hcsparseInitCsrMatrix(&gCsrMat);
+    hcsparseInitCooMatrix(&gCooMat);
+
+    // 3x4 matrix given as unsorted triplets; (0, 1) and (2, 3) appear twice
+    const int num_row = 3;
+    const int num_col = 4;
+    const int num_nonzero = 7;
+
+    int coo_rowIndices[num_nonzero] = {2, 0, 1, 0, 2, 2, 0};
+    int coo_colIndices[num_nonzero] = {3, 1, 2, 1, 0, 3, 3};
+    float coo_values[num_nonzero] = {1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0};
+
+    int ref_rowOff[num_row+1] = {0, 2, 3, 5};
+    int ref_colIndices[5] = {1, 3, 2, 0, 3};
+    float ref_values[5] = {6.0, 7.0, 3.0, 5.0, 7.0};
+
+    gCooMat.num_rows = num_row;
+    gCooMat.num_cols = num_col;
+    gCooMat.num_nonzeros = num_nonzero;
+    gCooMat.offValues = 0;
+    gCooMat.offColInd = 0;
+    gCooMat.offRowInd = 0;
+
+    gCsrMat.offValues = 0;
+    gCsrMat.offColInd = 0;
+    gCsrMat.offRowOff = 0;
+
+    gCooMat.values = (float*) am_alloc(num_nonzero * sizeof(float), acc[1], 0);
+    gCooMat.rowIndices = (int*) am_alloc(num_nonzero * sizeof(int), acc[1], 0);
+    gCooMat.colIndices = (int*) am_alloc(num_nonzero * sizeof(int), acc[1], 0);
+
+    gCsrMat.values = (float*) am_alloc(num_nonzero * sizeof(float), acc[1], 0);
+    gCsrMat.rowOffsets = (int*) am_alloc((num_row+1) * sizeof(int), acc[1], 0);
+    gCsrMat.colIndices = (int*) am_alloc(num_nonzero * sizeof(int), acc[1], 0);
+
+    control.accl_view.copy(coo_values, gCooMat.values, num_nonzero * sizeof(float));
+    control.accl_view.copy(coo_rowIndices, gCooMat.rowIndices, num_nonzero * sizeof(int));
+    control.accl_view.copy(coo_colIndices, gCooMat.colIndices, num_nonzero * sizeof(int));
+
+    hcsparseStatus status = hcsparseScoo2csrAssemble(&gCooMat, &gCsrMat, &control);
+
+    EXPECT_EQ(status, hcsparseSuccess);
+    EXPECT_EQ(gCsrMat.num_nonzeros, 5);
+
+    float *csr_values = (float*)calloc(num_nonzero, sizeof(float));
+    int *csr_rowOff = (int*)calloc(num_row+1, sizeof(int));
+    int *csr_colIndices = (int*)calloc(num_nonzero, sizeof(int));
+
+    control.accl_view.copy(gCsrMat.values, csr_values, num_nonzero * sizeof(float));
+    control.accl_view.copy(gCsrMat.rowOffsets, csr_rowOff, (num_row+1) * sizeof(int));
+    control.accl_view.copy(gCsrMat.colIndices, csr_colIndices, num_nonzero * sizeof(int));
+
+    for (int i = 0; i < 5; i++)
+    {
+        float diff = std::abs(ref_values[i] - csr_values[i]);
+        EXPECT_LT(diff, TOLERANCE);
+        EXPECT_EQ(ref_colIndices[i], csr_colIndices[i]);
+    }
+
+    for (int i = 0; i < num_row+1; i++)
+    {
+        EXPECT_EQ(ref_rowOff[i], csr_rowOff[i]);
+    }
+
+    hcsparseTeardown();
+
+    free(csr_values);
+    free(csr_rowOff);
+    free(csr_colIndices);
+    am_free(gCsrMat.values);
+    am_free(gCsrMat.rowOffsets);
+    am_free(gCsrMat.colIndices);
+    am_free(gCooMat.values);
+    am_free(gCooMat.rowIndices);
+    am_free(gCooMat.colIndices);
+}
@@ -0,0 +1,137 @@
+#include <hcsparse.h>
+#include <iostream>
+#include <hc_am.hpp>
+#include "gtest/gtest.h"
+
+TEST(csrmv_semiring_float_test, func_check)
+{
+    hcsparseCsrMatrix gCsrMat;
+    hcdenseVector gX;
+    hcdenseVector gY;
+
+    std::vector<accelerator>acc = accelerator::get_all();
+    accelerator_view accl_view = (acc[1].create_view());
+
+    hcsparseControl control(accl_view);
+
+    const char* filename = "./../../../../test/gtest/src/input.mtx";
+
+    int num_nonzero, num_row, num_col;
+
+    hcsparseStatus status;
+
+    status = hcsparseHeaderfromFile(&num_nonzero, &num_row, &num_col, filename);
+
+    if (status != hcsparseSuccess)
+    {
+        std::cout<<"The input file should be in mtx format"<<std::endl;
+        exit (1);
+    }
+
+    float *host_res = (float*) calloc(num_row, sizeof(float));
+    float *host_X = (float*) calloc(num_col, sizeof(float));
+    float *host_Y = (float*) calloc(num_row, sizeof(float));
+
+    srand (time(NULL));
+    for (int i = 0; i < num_col; i++)
+    {
+       host_X[i] = rand()%100;
+    }
+
+    for (int i = 0; i < num_row; i++)
+    {
+        host_res[i] = host_Y[i] = rand()%100;
+    }
+
+    hcsparseSetup();
+    hcsparseInitCsrMatrix(&gCsrMat);
+    hcsparseInitVector(&gX);
+    hcsparseInitVector(&gY);
+
+    gX.offValues = 0;
+    gY.offValues = 0;
+
+    gX.num_values = num_col;
+    gY.num_values = num_row;
+
+    gCsrMat.offValues = 0;
+    gCsrMat.offColInd = 0;
+    gCsrMat.offRowOff = 0;
+
+    float *values = (float*)calloc(num_nonzero, sizeof(float));
+    int *rowOffsets = (int*)calloc(num_row+1, sizeof(int));
+    int *colIndices = (int*)calloc(num_nonzero, sizeof(int));
+
+    gX.values = am_alloc(sizeof(float) * num_col, acc[1], 0);
+    gY.values = am_alloc(sizeof(float) * num_row, acc[1], 0);
+
+    control.accl_view.copy(host_X, gX.values, sizeof(float) * num_col);
+    control.accl_view.copy(host_Y, gY.values, sizeof(float) * num_row);
+
+    gCsrMat.values = am_alloc(sizeof(float) * num_nonzero, acc[1], 0);
+    gCsrMat.rowOffsets = am_alloc(sizeof(int) * (num_row+1), acc[1], 0);
+    gCsrMat.colIndices = am_alloc(sizeof(int) * num_nonzero, acc[1], 0);
+
+    status = hcsparseSCsrMatrixfromFile(&gCsrMat, filename, &control, false);
+
+    if (status != hcsparseSuccess)
+    {
+        std::cout<<"The input file should be in mtx format"<<std::endl;
+        exit (1);
+    }
+
+    control.accl_view.copy(gCsrMat.values, values, sizeof(float) * num_nonzero);
+    control.accl_view.copy(gCsrMat.rowOffsets, rowOffsets, sizeof(int) * (num_row+1));
+    control.accl_view.copy(gCsrMat.colIndices, colIndices, sizeof(int) * num_nonzero);
+
+    // one shortest path relaxation: y_i = min(y_i, min_j A_ij + x_j)
+    status = hcsparseScsrmvSemiring(SR_MIN_PLUS, &gCsrMat, &gX, &gY, true, &control);
+    EXPECT_EQ(status, hcsparseSuccess);
+
+    for (int row = 0; row < num_row; row++)
+    {
+        for (int j = rowOffsets[row]; j < rowOffsets[row+1]; j++)
+        {
+            host_res[row] = std::min(host_res[row], values[j] + host_X[colIndices[j]]);
+        }
+    }
+    control.accl_view.copy(gY.values, host_Y, sizeof(float) * num_row);
+
+    for (int i = 0; i < num_row; i++)
+    {
+        EXPECT_FLOAT_EQ(host_res[i], host_Y[i]);
+    }
+
+    // widest path step, overwriting y: y_i = max_j min(A_ij, x_j)
+    status = hcsparseScsrmvSemiring(SR_MAX_MIN, &gCsrMat, &gX, &gY, false, &control);
+    EXPECT_EQ(status, hcsparseSuccess);
+
+    for (int row = 0; row < num_row; row++)
+    {
+        host_res[row] = 0;
+        for (int j = rowOffsets[row]; j < rowOffsets[row+1]; j++)
+        {
+            host_res[row] = std::max(host_res[row], std::min(values[j], host_X[colIndices[j]]));
+        }
+    }
+    control.accl_view.copy(gY.values, host_Y, sizeof(float) * num_row);
+
+    for (int i = 0; i < num_row; i++)
+    {
+        EXPECT_FLOAT_EQ(host_res[i], host_Y[i]);
+    }
+
+    hcsparseTeardown();
+
+    free(host_res);
+    free(host_X);
+    free(host_Y);
+    free(values);
+    free(rowOffsets);
+    free(colIndices);
+    am_free(gX.values);
+    am_free(gY.values);
+    am_free(gCsrMat.values);
+    am_free(gCsrMat.rowOffsets);
+    am_free(gCsrMat.colIndices);
+}
@@ -0,0 +1,148 @@
+#include <hcsparse.h>
+#include <iostream>
+#include <cmath>
+#include <vector>
+#include <hc_am.hpp>
+#include "gtest/gtest.h"
+#include "blas1/elementwise-operators.h"
+#include "blas1/hcdense-reduce.h"
+#include "blas1/hcdense-fused.h"
+
+#define TOLERANCE 1e-4
+
+static void
+expect_close (float ref, float res)
+{
+    EXPECT_LE(std::abs(ref - res), TOLERANCE * std::max(1.0f, std::abs(ref)));
+}
+
+// r = x - alpha * y with <r, z> and a norm of r in the same kernel, against
+// the separate axpy, dot and norm calls
+TEST(fused_float_test, func_check)
+{
+    hcdenseVector gX, gY, gZ, gR, gRef;
+    hcsparseScalar gAlpha, gNegAlpha, gDot, gNrm, gDotRef, gNrmRef;
+
+    std::vector<accelerator>acc = accelerator::get_all();
+    accelerator_view accl_view = (acc[1].create_view());
+
+    hcsparseControl control(accl_view);
+    hcsparseSetup();
+
+    hcdenseVector *vectors[] = { &gX, &gY, &gZ, &gR, &gRef };
+    hcsparseScalar *scalars[] = { &gAlpha, &gNegAlpha, &gDot, &gNrm, &gDotRef, &gNrmRef };
+
+    // one partial tile and more tiles than REDUCE_MAX_BLOCKS
+    const int sizes[] = { 100, 1000000 };
+
+    for (hcsparseScalar *s : scalars)
+    {
+        hcsparseInitScalar(s);
+        s->value = am_alloc(sizeof(float), acc[1], 0);
+        s->offValue = 0;
+    }
+
+    float alpha = 0.75f;
+    float negAlpha = -alpha;
+    control.accl_view.copy(&alpha, gAlpha.value, sizeof(float));
+    control.accl_view.copy(&negAlpha, gNegAlpha.value, sizeof(float));
+
+    srand (time(NULL));
+
+    for (int num_elements : sizes)
+    {
+        std::vector<float> host_X(num_elements), host_Y(num_elements), host_Z(num_elements);
+        std::vector<float> host_R(num_elements), host_Ref(num_elements);
+
+        for (int i = 0; i < num_elements; i++)
+        {
+            host_X[i] = rand()%100 - 50;
+            host_Y[i] = rand()%10 - 5;
+            host_Z[i] = rand()%10 - 5;
+        }
+
+        for (hcdenseVector *v : vectors)
+        {
+            hcsparseInitVector(v);
+            v->values = am_alloc(sizeof(float) * num_elements, acc[1], 0);
+            v->offValues = 0;
+            v->num_values = num_elements;
+        }
+
+        control.accl_view.copy(host_X.data(), gX.values, sizeof(float) * num_elements);
+        control.accl_view.copy(host_Y.data(), gY.values, sizeof(float) * num_elements);
+        control.accl_view.copy(host_Z.data(), gZ.values, sizeof(float) * num_elements);
+
+        // reference: ref = x - alpha * y, then separate reductions
+        hcdenseSaxpy(&gRef, &gNegAlpha, &gY, &gX, &control);
+        hcdenseSdot(&gDotRef, &gRef, &gZ, &control);
+        control.accl_view.copy(gRef.values, host_Ref.data(), sizeof(float) * num_elements);
+
+        float dotRef = 0;
+        control.accl_view.copy(gDotRef.value, &dotRef, sizeof(float));
+
+        const SOLVER_NORM norms[] = { NORM_L1, NORM_L2, NORM_LINF };
+        for (SOLVER_NORM norm : norms)
+        {
+            if (norm == NORM_L1)
+                hcdenseSnrm1(&gNrmRef, &gRef, &control);
+            else if (norm == NORM_L2)
+                hcdenseSnrm2(&gNrmRef, &gRef, &control);
+            else
+                reduce<float, RO_FMAX>(&gNrmRef, &gRef, &control);
+
+            // norm in the first reduction slot, dot in the second
+            control.accl_view.copy(gX.values, gR.values, sizeof(float) * num_elements);
+            hcsparseStatus status =
+                fused_blas1_norm<float>(num_elements,
+                                        fused_sub(&gR, fused_scal<float>(&gAlpha) * fused_vec<float>(&gY)),
+                                        fused_nop(),
+                                        norm, &gNrm, fused_vec<float>(&gR),
+                                        fused_dot(&gDot, fused_vec<float>(&gR), fused_vec<float>(&gZ)),
+                                        &control);
+            EXPECT_EQ(status, hcsparseSuccess);
+
+            float nrm = 0, nrmRef = 0, dot = 0;
+            control.accl_view.copy(gNrm.value, &nrm, sizeof(float));
+            control.accl_view.copy(gNrmRef.value, &nrmRef, sizeof(float));
+            control.accl_view.copy(gDot.value, &dot, sizeof(float));
+            expect_close(nrmRef, nrm);
+            expect_close(dotRef, dot);
+
+            control.accl_view.copy(gR.values, host_R.data(), sizeof(float) * num_elements);
+            for (int i = 0; i < num_elements; i++)
+                expect_close(host_Ref[i], host_R[i]);
+        }
+
+        // swapped slots: the second reduction combines with max, the
+        // first with plus
+        float nrmRef = 0;
+        reduce<float, RO_FMAX>(&gNrmRef, &gRef, &control);
+        control.accl_view.copy(gNrmRef.value, &nrmRef, sizeof(float));
+
+        control.accl_view.copy(gX.values, gR.values, sizeof(float) * num_elements);
+        hcsparseStatus status =
+            fused_blas1<float>(num_elements,
+                               fused_sub(&gR, fused_scal<float>(&gAlpha) * fused_vec<float>(&gY)),
+                               fused_nop(),
+                               fused_dot(&gDot, fused_vec<float>(&gR), fused_vec<float>(&gZ)),
+                               fused_norminf(&gNrm, fused_vec<float>(&gR)),
+                               &control);
+        EXPECT_EQ(status, hcsparseSuccess);
+
+        float nrm = 0, dot = 0;
+        control.accl_view.copy(gNrm.value, &nrm, sizeof(float));
+        control.accl_view.copy(gDot.value, &dot, sizeof(float));
+        expect_close(nrmRef, nrm);
+        expect_close(dotRef, dot);
+
+        for (hcdenseVector *v : vectors)
+            am_free(v->values);
+    }
+
+    reduce_release_scratch();
+    hcsparseTeardown();
+
+    for (hcsparseScalar *s : scalars)
+        am_free(s->value);
+}
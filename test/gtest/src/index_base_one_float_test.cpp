@@ -0,0 +1,240 @@
+#include <hcsparse.h>
+#include <iostream>
+#include <vector>
+#include <hc_am.hpp>
+#include "mmio_wrapper.h"
+#include "gtest/gtest.h"
+
+// The one-based paths read the same matrix with every row offset and column
+// index shifted by one and must match the zero-based results.
+
+static const char* filename = "./../../../../test/gtest/src/input.mtx";
+
+struct one_based_fixture
+{
+    std::vector<accelerator> acc;
+    hcsparseHandle_t handle;
+    hcsparseMatDescr_t descrZero;
+    hcsparseMatDescr_t descrOne;
+
+    int num_nonzero, num_row, num_col;
+    float *values;
+    int *rowOffsets;
+    int *colIndices;
+
+    float *valA;
+    int *rowPtrZero;
+    int *colIndZero;
+    int *rowPtrOne;
+    int *colIndOne;
+
+    one_based_fixture()
+    {
+        acc = accelerator::get_all();
+
+        values = NULL;
+        rowOffsets = NULL;
+        colIndices = NULL;
+
+        if ((hcsparseCsrMatrixfromFile<float>(filename, false, &values, &rowOffsets, &colIndices,
+                                               &num_row, &num_col, &num_nonzero))) {
+          std::cout << "Error reading the matrix file" << std::endl;
+          exit(1);
+        }
+
+        hc::accelerator accl;
+        hc::accelerator_view av = accl.get_default_view();
+
+        if (hcsparseCreate(&handle, &av) != HCSPARSE_STATUS_SUCCESS) {
+          std::cout << "Error Initializing the sparse library."<<std::endl;
+          exit(1);
+        }
+
+        hcsparseCreateMatDescr(&descrZero);
+        hcsparseCreateMatDescr(&descrOne);
+        hcsparseSetMatIndexBase(descrOne, HCSPARSE_INDEX_BASE_ONE);
+
+        std::vector<int> rowOffsetsOne(num_row + 1);
+        std::vector<int> colIndicesOne(num_nonzero);
+        for (int i = 0; i <= num_row; i++)
+            rowOffsetsOne[i] = rowOffsets[i] + 1;
+        for (int i = 0; i < num_nonzero; i++)
+            colIndicesOne[i] = colIndices[i] + 1;
+
+        valA = (float*) am_alloc(num_nonzero * sizeof(float), acc[1], 0);
+        rowPtrZero = (int*) am_alloc((num_row + 1) * sizeof(int), acc[1], 0);
+        colIndZero = (int*) am_alloc(num_nonzero * sizeof(int), acc[1], 0);
+        rowPtrOne = (int*) am_alloc((num_row + 1) * sizeof(int), acc[1], 0);
+        colIndOne = (int*) am_alloc(num_nonzero * sizeof(int), acc[1], 0);
+
+        hc::accelerator_view view = acc[1].get_default_view();
+        view.copy(values, valA, sizeof(float) * num_nonzero);
+        view.copy(rowOffsets, rowPtrZero, sizeof(int) * (num_row + 1));
+        view.copy(colIndices, colIndZero, sizeof(int) * num_nonzero);
+        view.copy(rowOffsetsOne.data(), rowPtrOne, sizeof(int) * (num_row + 1));
+        view.copy(colIndicesOne.data(), colIndOne, sizeof(int) * num_nonzero);
+    }
+
+    ~one_based_fixture()
+    {
+        hcsparseDestroyMatDescr(descrZero);
+        hcsparseDestroyMatDescr(descrOne);
+        hcsparseDestroy(&handle);
+
+        free(values);
+        free(rowOffsets);
+        free(colIndices);
+        am_free(valA);
+        am_free(rowPtrZero);
+        am_free(colIndZero);
+        am_free(rowPtrOne);
+        am_free(colIndOne);
+    }
+};
+
+TEST(index_base_one_float_test, csrmv)
+{
+    one_based_fixture f;
+    hc::accelerator_view view = f.acc[1].get_default_view();
+
+    std::vector<float> host_X(f.num_col);
+    std::vector<float> host_Y(f.num_row);
+    std::vector<float> host_zero(f.num_row);
+    std::vector<float> host_one(f.num_row);
+    float host_scalars[2] = { 2.0f, 0.5f };
+
+    srand (time(NULL));
+    for (int i = 0; i < f.num_col; i++)
+        host_X[i] = rand()%100;
+    for (int i = 0; i < f.num_row; i++)
+        host_Y[i] = rand()%100;
+
+    float *gX = (float*) am_alloc(sizeof(float) * f.num_col, f.acc[1], 0);
+    float *gY = (float*) am_alloc(sizeof(float) * f.num_row, f.acc[1], 0);
+    float *gScalars = (float*) am_alloc(sizeof(float) * 2, f.acc[1], 0);
+
+    view.copy(host_X.data(), gX, sizeof(float) * f.num_col);
+    view.copy(host_scalars, gScalars, sizeof(float) * 2);
+
+    hcsparseOperation_t transA = HCSPARSE_OPERATION_NON_TRANSPOSE;
+
+    view.copy(host_Y.data(), gY, sizeof(float) * f.num_row);
+    EXPECT_EQ(hcsparseScsrmv(f.handle, transA, f.num_row, f.num_col, f.num_nonzero,
+                             gScalars, f.descrZero, f.valA, f.rowPtrZero, f.colIndZero,
+                             gX, gScalars + 1, gY), HCSPARSE_STATUS_SUCCESS);
+    view.copy(gY, host_zero.data(), sizeof(float) * f.num_row);
+
+    view.copy(host_Y.data(), gY, sizeof(float) * f.num_row);
+    EXPECT_EQ(hcsparseScsrmv(f.handle, transA, f.num_row, f.num_col, f.num_nonzero,
+                             gScalars, f.descrOne, f.valA, f.rowPtrOne, f.colIndOne,
+                             gX, gScalars + 1, gY), HCSPARSE_STATUS_SUCCESS);
+    view.copy(gY, host_one.data(), sizeof(float) * f.num_row);
+
+    for (int i = 0; i < f.num_row; i++)
+    {
+        float diff = std::abs(host_zero[i] - host_one[i]);
+        EXPECT_LT(diff, 0.01);
+    }
+
+    am_free(gX);
+    am_free(gY);
+    am_free(gScalars);
+}
+
+TEST(index_base_one_float_test, csrmm2)
+{
+    one_based_fixture f;
+    hc::accelerator_view view = f.acc[1].get_default_view();
+
+    int num_col_X = 7;
+    std::vector<float> host_X(f.num_col * num_col_X);
+    std::vector<float> host_Y(f.num_row * num_col_X);
+    std::vector<float> host_zero(f.num_row * num_col_X);
+    std::vector<float> host_one(f.num_row * num_col_X);
+    float host_scalars[2] = { 2.0f, 0.5f };
+
+    srand (time(NULL));
+    for (size_t i = 0; i < host_X.size(); i++)
+        host_X[i] = rand()%100;
+    for (size_t i = 0; i < host_Y.size(); i++)
+        host_Y[i] = rand()%100;
+
+    float *gX = (float*) am_alloc(sizeof(float) * host_X.size(), f.acc[1], 0);
+    float *gY = (float*) am_alloc(sizeof(float) * host_Y.size(), f.acc[1], 0);
+    float *gScalars = (float*) am_alloc(sizeof(float) * 2, f.acc[1], 0);
+
+    view.copy(host_X.data(), gX, sizeof(float) * host_X.size());
+    view.copy(host_scalars, gScalars, sizeof(float) * 2);
+
+    hcsparseOperation_t trans = HCSPARSE_OPERATION_NON_TRANSPOSE;
+
+    view.copy(host_Y.data(), gY, sizeof(float) * host_Y.size());
+    EXPECT_EQ(hcsparseScsrmm2(f.handle, trans, trans, f.num_row, num_col_X, f.num_col,
+                              f.num_nonzero, gScalars, f.descrZero, f.valA, f.rowPtrZero,
+                              f.colIndZero, gX, f.num_col, gScalars + 1, gY, f.num_row),
+              HCSPARSE_STATUS_SUCCESS);
+    view.copy(gY, host_zero.data(), sizeof(float) * host_Y.size());
+
+    view.copy(host_Y.data(), gY, sizeof(float) * host_Y.size());
+    EXPECT_EQ(hcsparseScsrmm2(f.handle, trans, trans, f.num_row, num_col_X, f.num_col,
+                              f.num_nonzero, gScalars, f.descrOne, f.valA, f.rowPtrOne,
+                              f.colIndOne, gX, f.num_col, gScalars + 1, gY, f.num_row),
+              HCSPARSE_STATUS_SUCCESS);
+    view.copy(gY, host_one.data(), sizeof(float) * host_Y.size());
+
+    for (size_t i = 0; i < host_Y.size(); i++)
+    {
+        float diff = std::abs(host_zero[i] - host_one[i]);
+        EXPECT_LT(diff, 0.01);
+    }
+
+    am_free(gX);
+    am_free(gY);
+    am_free(gScalars);
+}
+
+TEST(index_base_one_float_test, coo2csr_csr2coo)
+{
+    one_based_fixture f;
+    hc::accelerator_view view = f.acc[1].get_default_view();
+
+    std::vector<int> host_cooZero(f.num_nonzero);
+    std::vector<int> host_cooOne(f.num_nonzero);
+    std::vector<int> host_rowPtrZero(f.num_row + 1);
+    std::vector<int> host_rowPtrOne(f.num_row + 1);
+
+    int *gCoo = (int*) am_alloc(sizeof(int) * f.num_nonzero, f.acc[1], 0);
+    int *gRowPtr = (int*) am_alloc(sizeof(int) * (f.num_row + 1), f.acc[1], 0);
+
+    // csr2coo: one-based row indices are the zero-based ones plus one
+    EXPECT_EQ(hcsparseXcsr2coo(f.handle, f.rowPtrZero, f.num_nonzero, f.num_row, gCoo,
+                               HCSPARSE_INDEX_BASE_ZERO), HCSPARSE_STATUS_SUCCESS);
+    view.copy(gCoo, host_cooZero.data(), sizeof(int) * f.num_nonzero);
+
+    EXPECT_EQ(hcsparseXcsr2coo(f.handle, f.rowPtrOne, f.num_nonzero, f.num_row, gCoo,
+                               HCSPARSE_INDEX_BASE_ONE), HCSPARSE_STATUS_SUCCESS);
+    view.copy(gCoo, host_cooOne.data(), sizeof(int) * f.num_nonzero);
+
+    for (int i = 0; i < f.num_nonzero; i++)
+        EXPECT_EQ(host_cooOne[i], host_cooZero[i] + 1);
+
+    // coo2csr back from both, with the real row count
+    view.copy(host_cooZero.data(), gCoo, sizeof(int) * f.num_nonzero);
+    EXPECT_EQ(hcsparseXcoo2csr(f.handle, gCoo, f.num_nonzero, f.num_row, gRowPtr,
+                               HCSPARSE_INDEX_BASE_ZERO), HCSPARSE_STATUS_SUCCESS);
+    view.copy(gRowPtr, host_rowPtrZero.data(), sizeof(int) * (f.num_row + 1));
+
+    view.copy(host_cooOne.data(), gCoo, sizeof(int) * f.num_nonzero);
+    EXPECT_EQ(hcsparseXcoo2csr(f.handle, gCoo, f.num_nonzero, f.num_row, gRowPtr,
+                               HCSPARSE_INDEX_BASE_ONE), HCSPARSE_STATUS_SUCCESS);
+    view.copy(gRowPtr, host_rowPtrOne.data(), sizeof(int) * (f.num_row + 1));
+
+    for (int i = 0; i <= f.num_row; i++)
+    {
+        EXPECT_EQ(host_rowPtrZero[i], f.rowOffsets[i]);
+        EXPECT_EQ(host_rowPtrOne[i], f.rowOffsets[i] + 1);
+    }
+
+    am_free(gCoo);
+    am_free(gRowPtr);
+}
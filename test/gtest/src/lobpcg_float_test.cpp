@@ -0,0 +1,101 @@
+#include <hcsparse.h>
+#include <iostream>
+#include "gtest/gtest.h"
+
+TEST(lobpcg_float_test, func_check)
+{
+    hcsparseCsrMatrix gA;
+    hcdenseMatrix gX;
+    hcdenseVector gLambda;
+
+    std::vector<accelerator>acc = accelerator::get_all();
+    accelerator_view accl_view = (acc[1].create_view());
+
+    hcsparseControl control(accl_view);
+
+    const char* filename = "./../../../../test/gtest/src/input.mtx";
+
+    int num_nonzero, num_row, num_col;
+
+    hcsparseStatus status;
+
+    status = hcsparseHeaderfromFile(&num_nonzero, &num_row, &num_col, filename);
+
+    const int num_eig = 4;
+
+    float *host_X = (float*) calloc(num_row * num_eig, sizeof(float));
+    float *host_lambda = (float*) calloc(num_eig, sizeof(float));
+
+    srand (time(NULL));
+    for (int i = 0; i < num_row * num_eig; i++)
+    {
+        host_X[i] = rand()%100;
+    }
+
+    hcsparseSetup();
+    hcsparseInitCsrMatrix(&gA);
+    hcdenseInitMatrix(&gX);
+    hcsparseInitVector(&gLambda);
+
+    gX.values = am_alloc(sizeof(float)*num_row*num_eig, acc[1], 0);
+    gLambda.values = am_alloc(sizeof(float)*num_eig, acc[1], 0);
+
+    gX.offValues = 0;
+    gX.num_rows = num_row;
+    gX.num_cols = num_eig;
+    gX.lead_dim = num_row;
+    gX.major = columnMajor;
+
+    gLambda.offValues = 0;
+    gLambda.num_values = num_eig;
+
+    gA.offValues = 0;
+    gA.offColInd = 0;
+    gA.offRowOff = 0;
+
+    control.accl_view.copy(host_X, gX.values, sizeof(float) * num_row * num_eig);
+
+    gA.values = am_alloc(sizeof(float) * num_nonzero, acc[1], 0);
+    gA.rowOffsets = am_alloc(sizeof(int) * (num_row+1), acc[1], 0);
+    gA.colIndices = am_alloc(sizeof(int) * num_nonzero, acc[1], 0);
+
+    status = hcsparseSCsrMatrixfromFile(&gA, filename, &control, false);
+
+    if (status != hcsparseSuccess)
+    {
+        std::cout<<"The input file should be in mtx format"<<std::endl;
+        exit (1);
+    }
+
+    int maxIter = 1000;
+    float relTol = 0.0001;
+    float absTol = 0.0001;
+
+    hcsparseSolverControl *solver_control;
+
+    solver_control = hcsparseCreateSolverControl(DIAGONAL, maxIter, relTol, absTol);
+
+    status = hcsparseScsrlobpcg(&gX, &gLambda, &gA, EIG_LARGEST, solver_control, &control);
+    EXPECT_EQ(status, hcsparseSuccess);
+
+    EXPECT_LT(solver_control->nIters, maxIter);
+
+    control.accl_view.copy(gLambda.values, host_lambda, sizeof(float) * num_eig);
+
+    // eigenvalues come in order from the wanted end of the spectrum
+    for (int i = 1; i < num_eig; i++)
+    {
+        EXPECT_GE(host_lambda[i-1], host_lambda[i]);
+    }
+
+    hcsparseReleaseSolverControl(solver_control);
+    hcsparseTeardown();
+
+    free(host_X);
+    free(host_lambda);
+    am_free(gX.values);
+    am_free(gLambda.values);
+    am_free(gA.values);
+    am_free(gA.rowOffsets);
+    am_free(gA.colIndices);
+}
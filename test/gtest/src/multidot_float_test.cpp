@@ -0,0 +1,95 @@
+#include <hcsparse.h>
+#include <iostream>
+#include <hc_am.hpp>
+#include "gtest/gtest.h"
+
+#define TOLERANCE 0.01
+
+TEST(multidot_float_test, func_check)
+{
+    hcdenseVector gR;
+    hcdenseVector gX;
+    hcdenseVector gY;
+    hcdenseVector gZ;
+
+    std::vector<accelerator>acc = accelerator::get_all();
+    accelerator_view accl_view = (acc[1].create_view()); 
+
+    hcsparseControl control(accl_view);
+    hcsparseSetup();
+    hcsparseInitVector(&gR);
+    hcsparseInitVector(&gX);
+    hcsparseInitVector(&gY);
+    hcsparseInitVector(&gZ);
+
+    int num_elements = 100000;
+    int k = 3;
+    float *host_res = (float*) calloc(k, sizeof(float));
+    float *host_X = (float*) calloc(num_elements, sizeof(float));
+    float *host_Y = (float*) calloc(num_elements, sizeof(float));
+    float *host_Z = (float*) calloc(num_elements, sizeof(float));
+    float *host_R = (float*) calloc(k, sizeof(float));
+
+    srand (time(NULL));
+    for (int i = 0; i < num_elements; i++)
+    {
+        host_X[i] = rand()%10;
+        host_Y[i] = rand()%10;
+        host_Z[i] = rand()%10;
+    }
+    
+    gR.values = am_alloc(sizeof(float) * k, acc[1], 0);
+    gX.values = am_alloc(sizeof(float) * num_elements, acc[1], 0);
+    gY.values = am_alloc(sizeof(float) * num_elements, acc[1], 0);
+    gZ.values = am_alloc(sizeof(float) * num_elements, acc[1], 0);
+
+    control.accl_view.copy(host_X, gX.values, sizeof(float) * num_elements);
+    control.accl_view.copy(host_Y, gY.values, sizeof(float) * num_elements);
+    control.accl_view.copy(host_Z, gZ.values, sizeof(float) * num_elements);
+
+    gR.offValues = 0;
+    gX.offValues = 0;
+    gY.offValues = 0;
+    gZ.offValues = 0;
+
+    gR.num_values = k;
+    gX.num_values = num_elements;
+    gY.num_values = num_elements;
+    gZ.num_values = num_elements;
+
+    // <x, y>, <x, z>, <z, z>
+    const hcdenseVector *left[3] = {&gX, &gX, &gZ};
+    const hcdenseVector *right[3] = {&gY, &gZ, &gZ};
+
+    hcsparseStatus status;
+
+    status = hcdenseSmultiDot(&gR, k, left, right, &control);
+    EXPECT_EQ(status, hcsparseSuccess);
+
+    for (int i = 0; i < num_elements; i++)
+    {
+        host_res[0] += host_X[i] * host_Y[i];
+        host_res[1] += host_X[i] * host_Z[i];
+        host_res[2] += host_Z[i] * host_Z[i];
+    }
+
+    control.accl_view.copy(gR.values, host_R, sizeof(float) * k);
+
+    for (int j = 0; j < k; j++)
+    {
+        float diff = std::abs(host_res[j] - host_R[j]);     
+        EXPECT_LT(diff, TOLERANCE);
+    }
+
+    hcsparseTeardown();
+
+    free(host_res);
+    free(host_X);
+    free(host_Y);
+    free(host_Z);
+    free(host_R);
+    am_free(gR.values);
+    am_free(gX.values);
+    am_free(gY.values);
+    am_free(gZ.values);
+}
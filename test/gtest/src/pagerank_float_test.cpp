@@ -0,0 +1,122 @@
+#include <hcsparse.h>
+#include <iostream>
+#include <cmath>
+#include <vector>
+#include "gtest/gtest.h"
+
+TEST(pagerank_float_test, func_check)
+{
+    hcsparseCsrMatrix gM;
+    hcdenseVector gX;
+
+    std::vector<accelerator>acc = accelerator::get_all();
+    accelerator_view accl_view = (acc[1].create_view());
+
+    hcsparseControl control(accl_view);
+
+    // node j links to j + 1 and j + 3, every fifth node is dangling
+    const int num_row = 1000;
+    const float damping = 0.85;
+
+    std::vector<int> outdeg(num_row);
+    for (int j = 0; j < num_row; j++)
+    {
+        outdeg[j] = (j % 5 == 4) ? 0 : 2;
+    }
+
+    std::vector<int> host_rowOff(num_row + 1, 0);
+    std::vector<int> host_colInd;
+    std::vector<float> host_vals;
+    for (int i = 0; i < num_row; i++)
+    {
+        int src[2] = { (i + num_row - 3) % num_row, (i + num_row - 1) % num_row };
+        for (int s = 0; s < 2; s++)
+        {
+            if (outdeg[src[s]] > 0)
+            {
+                host_colInd.push_back(src[s]);
+                host_vals.push_back(1.0f / outdeg[src[s]]);
+            }
+        }
+        host_rowOff[i + 1] = host_colInd.size();
+    }
+    int num_nonzero = host_colInd.size();
+
+    // reference power iteration in double precision
+    std::vector<double> ref(num_row, 1.0 / num_row), next(num_row);
+    for (int it = 0; it < 200; it++)
+    {
+        double dangling = 0;
+        for (int j = 0; j < num_row; j++)
+        {
+            if (outdeg[j] == 0)
+                dangling += ref[j];
+        }
+        for (int i = 0; i < num_row; i++)
+        {
+            double sum = 0;
+            for (int p = host_rowOff[i]; p < host_rowOff[i + 1]; p++)
+                sum += host_vals[p] * ref[host_colInd[p]];
+            next[i] = damping * sum + (damping * dangling + 1 - damping) / num_row;
+        }
+        ref.swap(next);
+    }
+
+    float *host_x = (float*) calloc(num_row, sizeof(float));
+
+    hcsparseSetup();
+    hcsparseInitCsrMatrix(&gM);
+    hcsparseInitVector(&gX);
+
+    gX.values = am_alloc(sizeof(float) * num_row, acc[1], 0);
+    gX.offValues = 0;
+    gX.num_values = num_row;
+
+    gM.values = am_alloc(sizeof(float) * num_nonzero, acc[1], 0);
+    gM.rowOffsets = am_alloc(sizeof(int) * (num_row+1), acc[1], 0);
+    gM.colIndices = am_alloc(sizeof(int) * num_nonzero, acc[1], 0);
+    gM.offValues = 0;
+    gM.offColInd = 0;
+    gM.offRowOff = 0;
+    gM.num_rows = num_row;
+    gM.num_cols = num_row;
+    gM.num_nonzeros = num_nonzero;
+
+    control.accl_view.copy(host_vals.data(), gM.values, sizeof(float) * num_nonzero);
+    control.accl_view.copy(host_rowOff.data(), gM.rowOffsets, sizeof(int) * (num_row+1));
+    control.accl_view.copy(host_colInd.data(), gM.colIndices, sizeof(int) * num_nonzero);
+
+    int maxIter = 1000;
+    float relTol = 1e-6;
+    float absTol = 1e-6;
+
+    hcsparseSolverControl *solver_control;
+
+    solver_control = hcsparseCreateSolverControl(NOPRECOND, maxIter, relTol, absTol);
+
+    hcsparseStatus status;
+
+    status = hcsparseScsrpagerank(&gX, &gM, nullptr, damping, solver_control, &control);
+    EXPECT_EQ(status, hcsparseSuccess);
+
+    EXPECT_LT(solver_control->nIters, maxIter);
+
+    control.accl_view.copy(gX.values, host_x, sizeof(float) * num_row);
+
+    double total = 0;
+    for (int i = 0; i < num_row; i++)
+    {
+        total += host_x[i];
+        EXPECT_NEAR(host_x[i], ref[i], 1e-5);
+    }
+    EXPECT_NEAR(total, 1.0, 1e-4);
+
+    hcsparseReleaseSolverControl(solver_control);
+    hcsparseTeardown();
+
+    free(host_x);
+    am_free(gX.values);
+    am_free(gM.values);
+    am_free(gM.rowOffsets);
+    am_free(gM.colIndices);
+}
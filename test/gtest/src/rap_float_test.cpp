@@ -0,0 +1,176 @@
+#include <hcsparse.h>
+#include <iostream>
+#include <hc_am.hpp>
+#include <cmath>
+#include <map>
+#include <vector>
+#include "gtest/gtest.h"
+
+#define TOLERANCE 0.01
+
+TEST(rap_float_test, func_check)
+{
+    hcsparseCsrMatrix gMatA;
+    hcsparseCsrMatrix gMatP;
+    hcsparseCsrMatrix gMatC;
+
+    std::vector<accelerator>acc = accelerator::get_all();
+    accelerator_view accl_view = (acc[1].create_view());
+
+    hcsparseControl control(accl_view);
+
+    const char* filename = "./../../../../test/gtest/src/input.mtx";
+
+    int num_nonzero, num_row, num_col;
+
+    hcsparseStatus status;
+
+    status = hcsparseHeaderfromFile(&num_nonzero, &num_row, &num_col, filename);
+
+    if (status != hcsparseSuccess)
+    {
+        std::cout<<"The input file should be in mtx format"<<std::endl;
+        exit (1);
+    }
+
+    hcsparseSetup();
+    hcsparseInitCsrMatrix(&gMatA);
+    hcsparseInitCsrMatrix(&gMatP);
+    hcsparseInitCsrMatrix(&gMatC);
+
+    gMatA.offValues = 0;
+    gMatA.offColInd = 0;
+    gMatA.offRowOff = 0;
+    gMatP.offValues = 0;
+    gMatP.offColInd = 0;
+    gMatP.offRowOff = 0;
+    gMatC.offValues = 0;
+    gMatC.offColInd = 0;
+    gMatC.offRowOff = 0;
+
+    gMatA.values = am_alloc(sizeof(float) * num_nonzero, acc[1], 0);
+    gMatA.rowOffsets = am_alloc(sizeof(int) * (num_row+1), acc[1], 0);
+    gMatA.colIndices = am_alloc(sizeof(int) * num_nonzero, acc[1], 0);
+
+    status = hcsparseSCsrMatrixfromFile(&gMatA, filename, &control, false);
+
+    if (status != hcsparseSuccess)
+    {
+        std::cout<<"The input file should be in mtx format"<<std::endl;
+        exit (1);
+    }
+
+    // prolongation from pairs of rows, overlapping with the next pair
+    int nc = (num_row + 1) / 2;
+    std::vector<int> rowOffsetsP(num_row+1, 0);
+    std::vector<int> colIndicesP;
+    std::vector<float> valuesP;
+    for (int i = 0; i < num_row; i++)
+    {
+        colIndicesP.push_back(i / 2);
+        valuesP.push_back(1.0f);
+        if (i / 2 + 1 < nc)
+        {
+            colIndicesP.push_back(i / 2 + 1);
+            valuesP.push_back(0.5f);
+        }
+        rowOffsetsP[i+1] = colIndicesP.size();
+    }
+    int nnzP = colIndicesP.size();
+
+    gMatP.num_rows = num_row;
+    gMatP.num_cols = nc;
+    gMatP.num_nonzeros = nnzP;
+    gMatP.values = am_alloc(sizeof(float) * nnzP, acc[1], 0);
+    gMatP.rowOffsets = am_alloc(sizeof(int) * (num_row+1), acc[1], 0);
+    gMatP.colIndices = am_alloc(sizeof(int) * nnzP, acc[1], 0);
+    control.accl_view.copy(valuesP.data(), gMatP.values, sizeof(float) * nnzP);
+    control.accl_view.copy(rowOffsetsP.data(), gMatP.rowOffsets, sizeof(int) * (num_row+1));
+    control.accl_view.copy(colIndicesP.data(), gMatP.colIndices, sizeof(int) * nnzP);
+
+    std::vector<float> values(num_nonzero);
+    std::vector<int> rowOffsets(num_row+1);
+    std::vector<int> colIndices(num_nonzero);
+
+    control.accl_view.copy(gMatA.values, values.data(), sizeof(float) * num_nonzero);
+    control.accl_view.copy(gMatA.rowOffsets, rowOffsets.data(), sizeof(int) * (num_row+1));
+    control.accl_view.copy(gMatA.colIndices, colIndices.data(), sizeof(int) * num_nonzero);
+
+    // reference P^T * A * P, entry by entry
+    std::vector<std::map<int, float>> ref(nc);
+    for (int i = 0; i < num_row; i++)
+    {
+        for (int p = rowOffsets[i]; p < rowOffsets[i+1]; p++)
+        {
+            int k = colIndices[p];
+            for (int r = rowOffsetsP[i]; r < rowOffsetsP[i+1]; r++)
+                for (int q = rowOffsetsP[k]; q < rowOffsetsP[k+1]; q++)
+                    ref[colIndicesP[r]][colIndicesP[q]] += valuesP[r] * values[p] * valuesP[q];
+        }
+    }
+
+    hcsparseRapInfo_t info;
+    status = hcsparseCreateRapInfo(&info);
+    EXPECT_EQ(status, hcsparseSuccess);
+
+    int nnzC = 0;
+    status = hcsparseXcsrRapSymbolic(&gMatA, &gMatP, info, &nnzC, &control);
+    EXPECT_EQ(status, hcsparseSuccess);
+
+    int refNnz = 0;
+    for (int I = 0; I < nc; I++)
+        refNnz += ref[I].size();
+    ASSERT_EQ(nnzC, refNnz);
+
+    gMatC.values = am_alloc(sizeof(float) * nnzC, acc[1], 0);
+    gMatC.rowOffsets = am_alloc(sizeof(int) * (nc+1), acc[1], 0);
+    gMatC.colIndices = am_alloc(sizeof(int) * nnzC, acc[1], 0);
+
+    std::vector<float> valuesC(nnzC);
+    std::vector<int> rowOffsetsC(nc+1);
+    std::vector<int> colIndicesC(nnzC);
+
+    // the second numeric phase reuses the analysis with A doubled
+    for (int pass = 1; pass <= 2; pass++)
+    {
+        status = hcsparseScsrRapNumeric(&gMatA, &gMatP, info, &gMatC, &control);
+        EXPECT_EQ(status, hcsparseSuccess);
+        EXPECT_EQ(gMatC.num_nonzeros, nnzC);
+
+        control.accl_view.copy(gMatC.values, valuesC.data(), sizeof(float) * nnzC);
+        control.accl_view.copy(gMatC.rowOffsets, rowOffsetsC.data(), sizeof(int) * (nc+1));
+        control.accl_view.copy(gMatC.colIndices, colIndicesC.data(), sizeof(int) * nnzC);
+
+        int p = 0;
+        for (int I = 0; I < nc; I++)
+        {
+            EXPECT_EQ(rowOffsetsC[I], p);
+            for (auto &e : ref[I])
+            {
+                float expected = pass * e.second;
+                EXPECT_EQ(colIndicesC[p], e.first);
+                EXPECT_LT(std::abs(valuesC[p] - expected), TOLERANCE * std::max(1.0f, std::abs(expected)));
+                p++;
+            }
+        }
+        EXPECT_EQ(rowOffsetsC[nc], nnzC);
+
+        for (int q = 0; q < num_nonzero; q++)
+            values[q] *= 2;
+        control.accl_view.copy(values.data(), gMatA.values, sizeof(float) * num_nonzero);
+    }
+
+    hcsparseDestroyRapInfo(info);
+
+    hcsparseTeardown();
+
+    am_free(gMatA.values);
+    am_free(gMatA.rowOffsets);
+    am_free(gMatA.colIndices);
+    am_free(gMatP.values);
+    am_free(gMatP.rowOffsets);
+    am_free(gMatP.colIndices);
+    am_free(gMatC.values);
+    am_free(gMatC.rowOffsets);
+    am_free(gMatC.colIndices);
+}
@@ -0,0 +1,108 @@
+#include <hcsparse.h>
+#include <iostream>
+#include <cmath>
+#include <vector>
+#include <hc_am.hpp>
+#include "gtest/gtest.h"
+#include "blas1/hcdense-reduce.h"
+
+#define TOLERANCE 1e-4
+
+static void
+expect_close (double ref, float res)
+{
+    EXPECT_LE(std::abs(ref - res), TOLERANCE * std::max(1.0, std::abs(ref)));
+}
+
+TEST(reduce_tiles_float_test, func_check)
+{
+    hcsparseScalar gR;
+    hcdenseVector gX;
+    hcdenseVector gY;
+
+    std::vector<accelerator>acc = accelerator::get_all();
+    accelerator_view accl_view = (acc[1].create_view());
+
+    hcsparseControl control(accl_view);
+    hcsparseSetup();
+    hcsparseInitScalar(&gR);
+    hcsparseInitVector(&gX);
+    hcsparseInitVector(&gY);
+
+    // less than one tile, exactly one tile, a few tiles and more tiles
+    // than REDUCE_MAX_BLOCKS, where every thread strides over the input
+    const int sizes[] = { 100, BLOCK_SIZE, 5 * BLOCK_SIZE + 3, 1000000 };
+
+    gR.value = am_alloc(sizeof(float), acc[1], 0);
+    gR.offValue = 0;
+
+    srand (time(NULL));
+
+    for (int num_elements : sizes)
+    {
+        std::vector<float> host_X(num_elements);
+        std::vector<float> host_Y(num_elements);
+
+        for (int i = 0; i < num_elements; i++)
+        {
+            host_X[i] = rand()%100 - 50;
+            host_Y[i] = rand()%10 - 5;
+        }
+
+        double sum = 0, l1 = 0, l2 = 0, linf = 0, dot = 0;
+        for (int i = 0; i < num_elements; i++)
+        {
+            sum += host_X[i];
+            l1 += std::abs(host_X[i]);
+            l2 += (double)host_X[i] * host_X[i];
+            linf = std::max(linf, (double)std::abs(host_X[i]));
+            dot += (double)host_X[i] * host_Y[i];
+        }
+        l2 = std::sqrt(l2);
+
+        gX.values = am_alloc(sizeof(float) * num_elements, acc[1], 0);
+        gY.values = am_alloc(sizeof(float) * num_elements, acc[1], 0);
+        gX.offValues = 0;
+        gY.offValues = 0;
+        gX.num_values = num_elements;
+        gY.num_values = num_elements;
+
+        control.accl_view.copy(host_X.data(), gX.values, sizeof(float) * num_elements);
+        control.accl_view.copy(host_Y.data(), gY.values, sizeof(float) * num_elements);
+
+        // twice in a row: the last tile has to hand the counter back as zero
+        for (int rep = 0; rep < 2; rep++)
+        {
+            float host_R = 0;
+
+            EXPECT_EQ(hcdenseSreduce(&gR, &gX, &control), hcsparseSuccess);
+            control.accl_view.copy(gR.value, &host_R, sizeof(float));
+            expect_close(sum, host_R);
+
+            EXPECT_EQ(hcdenseSnrm1(&gR, &gX, &control), hcsparseSuccess);
+            control.accl_view.copy(gR.value, &host_R, sizeof(float));
+            expect_close(l1, host_R);
+
+            EXPECT_EQ(hcdenseSnrm2(&gR, &gX, &control), hcsparseSuccess);
+            control.accl_view.copy(gR.value, &host_R, sizeof(float));
+            expect_close(l2, host_R);
+
+            // RO_FMAX is the infinity norm, max |x_i|
+            EXPECT_EQ((reduce<float, RO_FMAX>(&gR, &gX, &control)), hcsparseSuccess);
+            control.accl_view.copy(gR.value, &host_R, sizeof(float));
+            expect_close(linf, host_R);
+
+            EXPECT_EQ(hcdenseSdot(&gR, &gX, &gY, &control), hcsparseSuccess);
+            control.accl_view.copy(gR.value, &host_R, sizeof(float));
+            expect_close(dot, host_R);
+        }
+
+        am_free(gX.values);
+        am_free(gY.values);
+    }
+
+    reduce_release_scratch();
+    hcsparseTeardown();
+
+    am_free(gR.value);
+}
@@ -0,0 +1,101 @@
+#include <hcsparse.h>
+#include <iostream>
+#include <vector>
+#include <hc_am.hpp>
+#include "gtest/gtest.h"
+#include "blas1/elementwise-operators.h"
+#include "transform/scan.h"
+
+// host reference of the (segmented) scans; heads is nullptr when unsegmented
+static void
+scan_reference (const std::vector<int> &in,
+                const int *heads,
+                bool exclusive,
+                std::vector<int> &out)
+{
+    int running = 0;
+    for (size_t i = 0; i < in.size(); i++)
+    {
+        if (heads != nullptr && heads[i])
+            running = 0;
+        out[i] = exclusive ? running : running + in[i];
+        running += in[i];
+    }
+}
+
+TEST(scan_int_test, func_check)
+{
+    std::vector<accelerator>acc = accelerator::get_all();
+    accelerator_view accl_view = (acc[1].create_view());
+
+    hcsparseControl control(accl_view);
+    hcsparseSetup();
+
+    // one partial tile, exactly one tile, one past it and several tiles
+    // with a partial last one
+    const int sizes[] = { 1, 100, SCAN_TILE_ITEMS, SCAN_TILE_ITEMS + 1,
+                          3 * SCAN_TILE_ITEMS + 7, 50 * SCAN_TILE_ITEMS - 13 };
+
+    srand (time(NULL));
+
+    for (int num_elements : sizes)
+    {
+        std::vector<int> host_in(num_elements);
+        std::vector<int> host_heads(num_elements);
+        std::vector<int> host_out(num_elements);
+        std::vector<int> host_ref(num_elements);
+
+        for (int i = 0; i < num_elements; i++)
+        {
+            host_in[i] = rand()%100 - 50;
+            // segments both inside a tile and across tile borders
+            host_heads[i] = (i == 0 || rand()%700 == 0) ? 1 : 0;
+        }
+
+        int *in = (int*) am_alloc(sizeof(int) * num_elements, acc[1], 0);
+        int *heads = (int*) am_alloc(sizeof(int) * num_elements, acc[1], 0);
+        int *out = (int*) am_alloc(sizeof(int) * num_elements, acc[1], 0);
+
+        control.accl_view.copy(host_in.data(), in, sizeof(int) * num_elements);
+        control.accl_view.copy(host_heads.data(), heads, sizeof(int) * num_elements);
+
+        // every variant twice in a row, the second run reuses the scratch
+        // of the first under a new epoch
+        for (int rep = 0; rep < 2; rep++)
+        {
+            for (int exclusive = 0; exclusive < 2; exclusive++)
+            {
+                hcsparseStatus status;
+
+                if (exclusive)
+                    status = exclusive_scan<int, EW_PLUS>(num_elements, out, in, &control);
+                else
+                    status = inclusive_scan<int, EW_PLUS>(num_elements, out, in, &control);
+                EXPECT_EQ(status, hcsparseSuccess);
+
+                control.accl_view.copy(out, host_out.data(), sizeof(int) * num_elements);
+                scan_reference(host_in, nullptr, exclusive, host_ref);
+                for (int i = 0; i < num_elements; i++)
+                    EXPECT_EQ(host_out[i], host_ref[i]);
+
+                if (exclusive)
+                    status = segmented_exclusive_scan<int, EW_PLUS>(num_elements, out, in, heads, &control);
+                else
+                    status = segmented_inclusive_scan<int, EW_PLUS>(num_elements, out, in, heads, &control);
+                EXPECT_EQ(status, hcsparseSuccess);
+
+                control.accl_view.copy(out, host_out.data(), sizeof(int) * num_elements);
+                scan_reference(host_in, host_heads.data(), exclusive, host_ref);
+                for (int i = 0; i < num_elements; i++)
+                    EXPECT_EQ(host_out[i], host_ref[i]);
+            }
+        }
+
+        am_free(in);
+        am_free(heads);
+        am_free(out);
+    }
+
+    scan_release_scratch();
+    hcsparseTeardown();
+}
@@ -141,6 +141,48 @@ TEST(spcsrmm_float_test, func_check)
         EXPECT_LT(diff, 0.01);
     }*/
 
+    // a second product of tracked operands with new values reuses the
+    // symbolic phase of the first and must scale with A
+    hcsparseCsrStructureChanged(&gMatA);
+    hcsparseCsrStructureChanged(&gMatB);
+
+    hcsparseScsrSpGemm(&gMatA, &gMatB, &gMatC, &control);
+    control.accl_view.wait();
+
+    int nnzC = gMatC.num_nonzeros;
+    float *values_ref = (float*)calloc(nnzC, sizeof(float));
+    int *colIndices_ref = (int*)calloc(nnzC, sizeof(int));
+    control.accl_view.copy(gMatC.values, values_ref, sizeof(float)*nnzC);
+    control.accl_view.copy(gMatC.colIndices, colIndices_ref, sizeof(int)*nnzC);
+
+    control.accl_view.copy(gMatA.values, values_A, sizeof(float)*num_nonzero);
+    for (int i = 0; i < num_nonzero; i++)
+        values_A[i] *= 2;
+    control.accl_view.copy(values_A, gMatA.values, sizeof(float)*num_nonzero);
+    hcsparseCsrValuesChanged(&gMatA);
+
+    hcsparseScsrSpGemm(&gMatA, &gMatB, &gMatC, &control);
+    control.accl_view.wait();
+
+    EXPECT_EQ(gMatC.num_nonzeros, nnzC);
+
+    float *values_new = (float*)calloc(nnzC, sizeof(float));
+    int *colIndices_new = (int*)calloc(nnzC, sizeof(int));
+    control.accl_view.copy(gMatC.values, values_new, sizeof(float)*nnzC);
+    control.accl_view.copy(gMatC.colIndices, colIndices_new, sizeof(int)*nnzC);
+
+    for (int i = 0; i < nnzC; i++)
+    {
+        EXPECT_EQ(colIndices_new[i], colIndices_ref[i]);
+        float diff = std::abs(values_new[i] - 2 * values_ref[i]);
+        EXPECT_LT(diff, 0.01);
+    }
+
+    free(values_ref);
+    free(colIndices_ref);
+    free(values_new);
+    free(colIndices_new);
+
     hcsparseTeardown();
 
     free(dense_val_A);
@@ -0,0 +1,149 @@
+#include <hcsparse.h>
+#include <iostream>
+#include <hc_am.hpp>
+#include <cmath>
+#include <vector>
+#include "gtest/gtest.h"
+
+#define TOLERANCE 0.01
+
+TEST(spgemm_masked_float_test, func_check)
+{
+    hcsparseCsrMatrix gMatA;
+    hcsparseCsrMatrix gMatC;
+    hcsparseMask mask;
+
+    std::vector<accelerator>acc = accelerator::get_all();
+    accelerator_view accl_view = (acc[1].create_view());
+
+    hcsparseControl control(accl_view);
+
+    const char* filename = "./../../../../test/gtest/src/input.mtx";
+
+    int num_nonzero, num_row, num_col;
+
+    hcsparseStatus status;
+
+    status = hcsparseHeaderfromFile(&num_nonzero, &num_row, &num_col, filename);
+
+    if (status != hcsparseSuccess)
+    {
+        std::cout<<"The input file should be in mtx format"<<std::endl;
+        exit (1);
+    }
+
+    hcsparseSetup();
+    hcsparseInitCsrMatrix(&gMatA);
+    hcsparseInitCsrMatrix(&gMatC);
+    hcsparseInitMask(&mask);
+
+    gMatA.offValues = 0;
+    gMatA.offColInd = 0;
+    gMatA.offRowOff = 0;
+    gMatC.offValues = 0;
+    gMatC.offColInd = 0;
+    gMatC.offRowOff = 0;
+
+    gMatA.values = am_alloc(sizeof(float) * num_nonzero, acc[1], 0);
+    gMatA.rowOffsets = am_alloc(sizeof(int) * (num_row+1), acc[1], 0);
+    gMatA.colIndices = am_alloc(sizeof(int) * num_nonzero, acc[1], 0);
+
+    status = hcsparseSCsrMatrixfromFile(&gMatA, filename, &control, false);
+
+    if (status != hcsparseSuccess)
+    {
+        std::cout<<"The input file should be in mtx format"<<std::endl;
+        exit (1);
+    }
+
+    // C = (A * A) .* A: the result has at most the entries of A
+    gMatC.values = am_alloc(sizeof(float) * num_nonzero, acc[1], 0);
+    gMatC.rowOffsets = am_alloc(sizeof(int) * (num_row+1), acc[1], 0);
+    gMatC.colIndices = am_alloc(sizeof(int) * num_nonzero, acc[1], 0);
+
+    mask.pattern = &gMatA;
+
+    int nnzC = -1;
+    status = hcsparseScsrSpGemmMaskedNnz(&gMatA, &gMatA, &mask, &nnzC, &control);
+    EXPECT_EQ(status, hcsparseSuccess);
+
+    status = hcsparseScsrSpGemmMasked(&gMatA, &gMatA, &mask, &gMatC, &control);
+    EXPECT_EQ(status, hcsparseSuccess);
+
+    std::vector<float> values(num_nonzero);
+    std::vector<int> rowOffsets(num_row+1);
+    std::vector<int> colIndices(num_nonzero);
+
+    control.accl_view.copy(gMatA.values, values.data(), sizeof(float) * num_nonzero);
+    control.accl_view.copy(gMatA.rowOffsets, rowOffsets.data(), sizeof(int) * (num_row+1));
+    control.accl_view.copy(gMatA.colIndices, colIndices.data(), sizeof(int) * num_nonzero);
+
+    // reference: row i of A * A restricted to the pattern of row i of A
+    std::vector<int> refRowOffsets(num_row+1, 0);
+    std::vector<int> refColIndices;
+    std::vector<float> refValues;
+    std::vector<float> acc_row(num_col, 0);
+    std::vector<bool> hit(num_col, false);
+    for (int i = 0; i < num_row; i++)
+    {
+        for (int p = rowOffsets[i]; p < rowOffsets[i+1]; p++)
+        {
+            int k = colIndices[p];
+            for (int q = rowOffsets[k]; q < rowOffsets[k+1]; q++)
+            {
+                acc_row[colIndices[q]] += values[p] * values[q];
+                hit[colIndices[q]] = true;
+            }
+        }
+        for (int p = rowOffsets[i]; p < rowOffsets[i+1]; p++)
+        {
+            int j = colIndices[p];
+            if (hit[j])
+            {
+                refColIndices.push_back(j);
+                refValues.push_back(acc_row[j]);
+            }
+        }
+        for (int p = rowOffsets[i]; p < rowOffsets[i+1]; p++)
+        {
+            int k = colIndices[p];
+            for (int q = rowOffsets[k]; q < rowOffsets[k+1]; q++)
+            {
+                acc_row[colIndices[q]] = 0;
+                hit[colIndices[q]] = false;
+            }
+        }
+        refRowOffsets[i+1] = refColIndices.size();
+    }
+
+    ASSERT_EQ(gMatC.num_nonzeros, (int)refValues.size());
+    EXPECT_EQ(nnzC, (int)refValues.size());
+
+    std::vector<float> valuesC(gMatC.num_nonzeros);
+    std::vector<int> rowOffsetsC(num_row+1);
+    std::vector<int> colIndicesC(gMatC.num_nonzeros);
+
+    control.accl_view.copy(gMatC.values, valuesC.data(), sizeof(float) * gMatC.num_nonzeros);
+    control.accl_view.copy(gMatC.rowOffsets, rowOffsetsC.data(), sizeof(int) * (num_row+1));
+    control.accl_view.copy(gMatC.colIndices, colIndicesC.data(), sizeof(int) * gMatC.num_nonzeros);
+
+    for (int i = 0; i <= num_row; i++)
+    {
+        EXPECT_EQ(rowOffsetsC[i], refRowOffsets[i]);
+    }
+
+    for (int p = 0; p < gMatC.num_nonzeros; p++)
+    {
+        EXPECT_EQ(colIndicesC[p], refColIndices[p]);
+        EXPECT_LT(std::abs(valuesC[p] - refValues[p]), TOLERANCE * std::max(1.0f, std::abs(refValues[p])));
+    }
+
+    hcsparseTeardown();
+
+    am_free(gMatA.values);
+    am_free(gMatA.rowOffsets);
+    am_free(gMatA.colIndices);
+    am_free(gMatC.values);
+    am_free(gMatC.rowOffsets);
+    am_free(gMatC.colIndices);
+}
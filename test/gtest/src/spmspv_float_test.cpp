@@ -0,0 +1,171 @@
+#include <hcsparse.h>
+#include <iostream>
+#include <hc_am.hpp>
+#include <algorithm>
+#include <map>
+#include <set>
+#include <vector>
+#include "gtest/gtest.h"
+
+// min-plus product of A with x on the host, absent entries being infinite
+static std::map<int, float>
+host_min_plus (const std::vector<int> &colOff,
+               const std::vector<int> &rowInd,
+               const std::vector<float> &vals,
+               const std::vector<int> &xInd,
+               const std::vector<float> &xVal)
+{
+    std::map<int, float> y;
+    for (size_t k = 0; k < xInd.size(); k++)
+    {
+        for (int p = colOff[xInd[k]]; p < colOff[xInd[k] + 1]; p++)
+        {
+            float d = vals[p] + xVal[k];
+            auto it = y.find(rowInd[p]);
+            if (it == y.end())
+                y[rowInd[p]] = d;
+            else
+                it->second = std::min(it->second, d);
+        }
+    }
+    return y;
+}
+
+TEST(spmspv_float_test, func_check)
+{
+    hcsparseCscMatrix gCscMat;
+    hcsparseCsrMatrix gCsrMat;
+    hcsparseVector gX;
+    hcsparseVector gY;
+
+    std::vector<accelerator>acc = accelerator::get_all();
+    accelerator_view accl_view = (acc[1].create_view());
+
+    hcsparseControl control(accl_view);
+
+    // node j has edges to j + 1, j + 7 and 3j with weight j % 5 + 1;
+    // column j of A lists the nodes reached from j
+    const int n = 2000;
+
+    std::vector<std::set<int>> out(n);
+    for (int j = 0; j < n; j++)
+    {
+        out[j].insert((j + 1) % n);
+        out[j].insert((j + 7) % n);
+        out[j].insert((3 * j) % n);
+    }
+
+    std::vector<int> colOff(n + 1, 0), rowInd;
+    std::vector<float> cscVals;
+    for (int j = 0; j < n; j++)
+    {
+        for (int i : out[j])
+        {
+            rowInd.push_back(i);
+            cscVals.push_back(j % 5 + 1);
+        }
+        colOff[j + 1] = rowInd.size();
+    }
+    int nnz = rowInd.size();
+
+    std::vector<int> rowOff(n + 1, 0), colInd(nnz);
+    std::vector<float> csrVals(nnz);
+    for (int p = 0; p < nnz; p++)
+        rowOff[rowInd[p] + 1]++;
+    for (int i = 0; i < n; i++)
+        rowOff[i + 1] += rowOff[i];
+    std::vector<int> next(rowOff.begin(), rowOff.end() - 1);
+    for (int j = 0; j < n; j++)
+    {
+        for (int p = colOff[j]; p < colOff[j + 1]; p++)
+        {
+            colInd[next[rowInd[p]]] = j;
+            csrVals[next[rowInd[p]]++] = cscVals[p];
+        }
+    }
+
+    hcsparseSetup();
+    hcsparseInitCsrMatrix(&gCsrMat);
+    hcsparseInitSparseVector(&gX);
+    hcsparseInitSparseVector(&gY);
+    gCscMat.clear();
+
+    gCscMat.num_rows = gCscMat.num_cols = n;
+    gCscMat.num_nonzeros = nnz;
+    gCscMat.offValues = gCscMat.offRowInd = gCscMat.offColOff = 0;
+    gCscMat.values = am_alloc(sizeof(float) * nnz, acc[1], 0);
+    gCscMat.rowIndices = am_alloc(sizeof(int) * nnz, acc[1], 0);
+    gCscMat.colOffsets = am_alloc(sizeof(int) * (n + 1), acc[1], 0);
+    control.accl_view.copy(cscVals.data(), gCscMat.values, sizeof(float) * nnz);
+    control.accl_view.copy(rowInd.data(), gCscMat.rowIndices, sizeof(int) * nnz);
+    control.accl_view.copy(colOff.data(), gCscMat.colOffsets, sizeof(int) * (n + 1));
+
+    gCsrMat.num_rows = gCsrMat.num_cols = n;
+    gCsrMat.num_nonzeros = nnz;
+    gCsrMat.offValues = gCsrMat.offColInd = gCsrMat.offRowOff = 0;
+    gCsrMat.values = am_alloc(sizeof(float) * nnz, acc[1], 0);
+    gCsrMat.colIndices = am_alloc(sizeof(int) * nnz, acc[1], 0);
+    gCsrMat.rowOffsets = am_alloc(sizeof(int) * (n + 1), acc[1], 0);
+    control.accl_view.copy(csrVals.data(), gCsrMat.values, sizeof(float) * nnz);
+    control.accl_view.copy(colInd.data(), gCsrMat.colIndices, sizeof(int) * nnz);
+    control.accl_view.copy(rowOff.data(), gCsrMat.rowOffsets, sizeof(int) * (n + 1));
+
+    gX.num_values = gY.num_values = n;
+    gX.offValues = gX.offIndices = gY.offValues = gY.offIndices = 0;
+    gX.values = am_alloc(sizeof(float) * n, acc[1], 0);
+    gX.indices = am_alloc(sizeof(int) * n, acc[1], 0);
+    gY.values = am_alloc(sizeof(float) * n, acc[1], 0);
+    gY.indices = am_alloc(sizeof(int) * n, acc[1], 0);
+
+    std::vector<int> host_yInd(n);
+    std::vector<float> host_yVal(n);
+
+    // a small frontier takes the gather path, the full vertex set the dense one
+    std::vector<int> frontiers[2];
+    frontiers[0] = { 0, 5, 17, 1234 };
+    for (int j = 0; j < n; j++)
+        frontiers[1].push_back(j);
+
+    for (int f = 0; f < 2; f++)
+    {
+        std::vector<int> &xInd = frontiers[f];
+        std::vector<float> xVal(xInd.size());
+        for (size_t k = 0; k < xInd.size(); k++)
+            xVal[k] = xInd[k] % 11;
+
+        gX.num_nonzeros = xInd.size();
+        control.accl_view.copy(xInd.data(), gX.indices, sizeof(int) * xInd.size());
+        control.accl_view.copy(xVal.data(), gX.values, sizeof(float) * xVal.size());
+
+        hcsparseStatus status = hcsparseSspmspv(SR_MIN_PLUS, &gCscMat, &gCsrMat, &gX, &gY, &control);
+        EXPECT_EQ(status, hcsparseSuccess);
+
+        std::map<int, float> ref = host_min_plus(colOff, rowInd, cscVals, xInd, xVal);
+
+        ASSERT_EQ(gY.num_nonzeros, (int)ref.size());
+
+        control.accl_view.copy(gY.indices, host_yInd.data(), sizeof(int) * gY.num_nonzeros);
+        control.accl_view.copy(gY.values, host_yVal.data(), sizeof(float) * gY.num_nonzeros);
+
+        int k = 0;
+        for (auto &entry : ref)
+        {
+            EXPECT_EQ(host_yInd[k], entry.first);
+            EXPECT_FLOAT_EQ(host_yVal[k], entry.second);
+            k++;
+        }
+    }
+
+    hcsparseTeardown();
+
+    am_free(gCscMat.values);
+    am_free(gCscMat.rowIndices);
+    am_free(gCscMat.colOffsets);
+    am_free(gCsrMat.values);
+    am_free(gCsrMat.colIndices);
+    am_free(gCsrMat.rowOffsets);
+    am_free(gX.values);
+    am_free(gX.indices);
+    am_free(gY.values);
+    am_free(gY.indices);
+}
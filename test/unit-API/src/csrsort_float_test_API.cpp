@@ -0,0 +1,148 @@
+#include <hcsparse.h>
+#include <iostream>
+#include "hc_am.hpp"
+int main(int argc, char *argv[])
+{
+    hcsparseCsrMatrix gCsrMat;
+
+    std::vector<accelerator>acc = accelerator::get_all();
+    accelerator_view accl_view = (acc[1].create_view()); 
+
+    hcsparseControl control(accl_view);
+    hcsparseSetup();
+    hcsparseInitCsrMatrix(&gCsrMat);
+
+    gCsrMat.offValues = 0;
+    gCsrMat.offColInd = 0;
+    gCsrMat.offRowOff = 0;
+
+    if (argc != 2)
+    {
+        std::cout<<"Required mtx input file"<<std::endl;
+        return 0;
+    }
+
+    const char* filename = argv[1];
+    int num_nonzero, num_row, num_col;
+    hcsparseStatus status;
+
+    status = hcsparseHeaderfromFile(&num_nonzero, &num_row, &num_col, filename);
+    if (status != hcsparseSuccess)
+    {
+        std::cout<<"The input file should be in mtx format"<<std::endl;
+        return 0;
+    }
+
+    gCsrMat.values = (float*) am_alloc(num_nonzero * sizeof(float), acc[1], 0);
+    gCsrMat.rowOffsets = (int*) am_alloc((num_row+1) * sizeof(int), acc[1], 0);
+    gCsrMat.colIndices = (int*) am_alloc(num_nonzero * sizeof(int), acc[1], 0);
+
+    hcsparseSCsrMatrixfromFile(&gCsrMat, filename, &control, false);
+
+     /* Test New APIs */
+    hcsparseHandle_t handle;
+    hcsparseStatus_t status1;
+    hc::accelerator accl;
+    hc::accelerator_view av = accl.get_default_view();
+
+    status1 = hcsparseCreate(&handle, &av);
+    if (status1 != HCSPARSE_STATUS_SUCCESS) {
+      std::cout << "Error Initializing the sparse library."<<std::endl;
+      return -1;
+    }
+    std::cout << "Successfully initialized sparse library"<<std::endl;
+
+    hcsparseMatDescr_t descrA;
+
+    status1 = hcsparseCreateMatDescr(&descrA);
+    if (status1 != HCSPARSE_STATUS_SUCCESS) {
+      std::cout << "error creating mat descrptr"<<std::endl;
+      return -1;
+    }
+    std::cout << "successfully created mat descriptor"<<std::endl;
+
+    int *csr_rowPtr = (int*)calloc(num_row+1, sizeof(int));
+    int *csr_colInd = (int*)calloc(num_nonzero, sizeof(int));
+    float *csr_val = (float*)calloc(num_nonzero, sizeof(float));
+    int *res_colInd = (int*)calloc(num_nonzero, sizeof(int));
+    float *res_val = (float*)calloc(num_nonzero, sizeof(float));
+
+    control.accl_view.copy(gCsrMat.rowOffsets, csr_rowPtr, (num_row+1) * sizeof(int));
+    control.accl_view.copy(gCsrMat.colIndices, csr_colInd, num_nonzero * sizeof(int));
+    control.accl_view.copy(gCsrMat.values, csr_val, num_nonzero * sizeof(float));
+
+    // Reverse the entries of every row to produce an unsorted matrix
+    for (int i = 0; i < num_row; i++)
+    {
+        int start = csr_rowPtr[i];
+        int len = csr_rowPtr[i+1] - start;
+        for (int j = 0; j < len; j++)
+        {
+            res_colInd[start + j] = csr_colInd[start + len - 1 - j];
+            res_val[start + j] = csr_val[start + len - 1 - j];
+        }
+    }
+
+    int* csrRowPtrA = (int*) am_alloc((num_row+1) * sizeof(int), handle->currentAccl, 0);
+    int* csrColIndA = (int*) am_alloc(num_nonzero * sizeof(int), handle->currentAccl, 0);
+    float* csrValA = (float*) am_alloc(num_nonzero * sizeof(float), handle->currentAccl, 0);
+    float* csrValSorted = (float*) am_alloc(num_nonzero * sizeof(float), handle->currentAccl, 0);
+    int* P = (int*) am_alloc(num_nonzero * sizeof(int), handle->currentAccl, 0);
+
+    control.accl_view.copy(csr_rowPtr, csrRowPtrA, (num_row+1) * sizeof(int));
+    control.accl_view.copy(res_colInd, csrColIndA, num_nonzero * sizeof(int));
+    control.accl_view.copy(res_val, csrValA, num_nonzero * sizeof(float));
+
+    status1 = hcsparseCreateIdentityPermutation(handle, num_nonzero, P);
+    if (status1 != HCSPARSE_STATUS_SUCCESS) {
+      std::cout << "Error creating identity permutation "<<std::endl;
+      return -1;
+    }
+
+    status1 = hcsparseXcsrsort(handle, num_row, num_col, num_nonzero, descrA,
+                               csrRowPtrA, csrColIndA, P);
+    if (status1 != HCSPARSE_STATUS_SUCCESS) {
+      std::cout << "Error csrsort "<<std::endl;
+      return -1;
+    }
+
+    status1 = hcsparseSgthr(handle, num_nonzero, csrValA, csrValSorted, P,
+                            HCSPARSE_INDEX_BASE_ZERO);
+    if (status1 != HCSPARSE_STATUS_SUCCESS) {
+      std::cout << "Error gthr "<<std::endl;
+      return -1;
+    }
+    std::cout << "csrsort - success"<<std::endl;
+
+    control.accl_view.copy(csrColIndA, res_colInd, num_nonzero * sizeof(int));
+    control.accl_view.copy(csrValSorted, res_val, num_nonzero * sizeof(float));
+
+    bool ispassed = 1;
+
+    for (int i = 0; i < num_nonzero; i++)
+    {
+        if (csr_colInd[i] != res_colInd[i] || csr_val[i] != res_val[i])
+        {
+            std::cout << i << " " << csr_colInd[i] << " " << res_colInd[i] << std::endl;
+            ispassed = 0;
+            break;
+        }
+    }
+    std::cout << (ispassed?"TEST PASSED":"TEST FAILED") << std::endl;
+
+    free(csr_rowPtr);
+    free(csr_colInd);
+    free(csr_val);
+    free(res_colInd);
+    free(res_val);
+    am_free(csrRowPtrA);
+    am_free(csrColIndA);
+    am_free(csrValA);
+    am_free(csrValSorted);
+    am_free(P);
+    am_free(gCsrMat.values);
+    am_free(gCsrMat.rowOffsets);
+    am_free(gCsrMat.colIndices);
+
+    return 0;
+}
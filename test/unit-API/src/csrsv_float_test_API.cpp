@@ -0,0 +1,182 @@
+#include <hcsparse.h>
+#include <iostream>
+#include <cmath>
+#include "hc_am.hpp"
+int main(int argc, char *argv[])
+{
+    hcsparseCsrMatrix gCsrMat;
+
+    std::vector<accelerator>acc = accelerator::get_all();
+    accelerator_view accl_view = (acc[1].create_view());
+
+    hcsparseControl control(accl_view);
+    hcsparseSetup();
+    hcsparseInitCsrMatrix(&gCsrMat);
+
+    gCsrMat.offValues = 0;
+    gCsrMat.offColInd = 0;
+    gCsrMat.offRowOff = 0;
+
+    if (argc != 2)
+    {
+        std::cout<<"Required mtx input file"<<std::endl;
+        return 0;
+    }
+
+    const char* filename = argv[1];
+    int num_nonzero, num_row, num_col;
+    hcsparseStatus status;
+
+    status = hcsparseHeaderfromFile(&num_nonzero, &num_row, &num_col, filename);
+    if (status != hcsparseSuccess)
+    {
+        std::cout<<"The input file should be in mtx format"<<std::endl;
+        return 0;
+    }
+
+    gCsrMat.values = (float*) am_alloc(num_nonzero * sizeof(float), acc[1], 0);
+    gCsrMat.rowOffsets = (int*) am_alloc((num_row+1) * sizeof(int), acc[1], 0);
+    gCsrMat.colIndices = (int*) am_alloc(num_nonzero * sizeof(int), acc[1], 0);
+
+    hcsparseSCsrMatrixfromFile(&gCsrMat, filename, &control, false);
+
+     /* Test New APIs */
+    hcsparseHandle_t handle;
+    hcsparseStatus_t status1;
+    hc::accelerator accl;
+    hc::accelerator_view av = accl.get_default_view();
+
+    status1 = hcsparseCreate(&handle, &av);
+    if (status1 != HCSPARSE_STATUS_SUCCESS) {
+      std::cout << "Error Initializing the sparse library."<<std::endl;
+      return -1;
+    }
+    std::cout << "Successfully initialized sparse library"<<std::endl;
+
+    hcsparseMatDescr_t descrA;
+
+    status1 = hcsparseCreateMatDescr(&descrA);
+    if (status1 != HCSPARSE_STATUS_SUCCESS) {
+      std::cout << "error creating mat descrptr"<<std::endl;
+      return -1;
+    }
+    std::cout << "successfully created mat descriptor"<<std::endl;
+
+    descrA->FillMode = HCSPARSE_FILL_MODE_LOWER;
+    descrA->DiagType = HCSPARSE_DIAG_TYPE_NON_UNIT;
+
+    int *csr_rowPtr = (int*)calloc(num_row+1, sizeof(int));
+    int *csr_colInd = (int*)calloc(num_nonzero, sizeof(int));
+    float *csr_val = (float*)calloc(num_nonzero, sizeof(float));
+
+    control.accl_view.copy(gCsrMat.rowOffsets, csr_rowPtr, (num_row+1) * sizeof(int));
+    control.accl_view.copy(gCsrMat.colIndices, csr_colInd, num_nonzero * sizeof(int));
+    control.accl_view.copy(gCsrMat.values, csr_val, num_nonzero * sizeof(float));
+
+    // Make the diagonal dominant so the lower triangle is well conditioned
+    for (int i = 0; i < num_row; i++)
+    {
+        float sum = 1;
+        for (int j = csr_rowPtr[i]; j < csr_rowPtr[i+1]; j++)
+            if (csr_colInd[j] < i)
+                sum += fabs(csr_val[j]);
+        for (int j = csr_rowPtr[i]; j < csr_rowPtr[i+1]; j++)
+            if (csr_colInd[j] == i)
+                csr_val[j] = sum;
+    }
+
+    const int nrhs = 2;
+    float *host_X = (float*)calloc(num_row * nrhs, sizeof(float));
+    float *host_Y = (float*)calloc(num_row * nrhs, sizeof(float));
+    float host_alpha = 2;
+
+    srand (time(NULL));
+    for (int i = 0; i < num_row * nrhs; i++)
+        host_X[i] = rand()%100;
+
+    float* csrValA = (float*) am_alloc(num_nonzero * sizeof(float), handle->currentAccl, 0);
+    float* alpha = (float*) am_alloc(sizeof(float), handle->currentAccl, 0);
+    float* X = (float*) am_alloc(num_row * nrhs * sizeof(float), handle->currentAccl, 0);
+    float* Y = (float*) am_alloc(num_row * nrhs * sizeof(float), handle->currentAccl, 0);
+
+    control.accl_view.copy(csr_val, csrValA, num_nonzero * sizeof(float));
+    control.accl_view.copy(&host_alpha, alpha, sizeof(float));
+    control.accl_view.copy(host_X, X, num_row * nrhs * sizeof(float));
+
+    hcsparseSolveAnalysisInfo_t info;
+
+    status1 = hcsparseCreateSolveAnalysisInfo(&info);
+    if (status1 != HCSPARSE_STATUS_SUCCESS) {
+      std::cout << "Error creating analysis info "<<std::endl;
+      return -1;
+    }
+
+    status1 = hcsparseXcsrsv_analysis(handle, HCSPARSE_OPERATION_NON_TRANSPOSE, num_row,
+                                      num_nonzero, descrA, (int*)gCsrMat.rowOffsets,
+                                      (int*)gCsrMat.colIndices, info);
+    if (status1 != HCSPARSE_STATUS_SUCCESS) {
+      std::cout << "Error csrsv_analysis "<<std::endl;
+      return -1;
+    }
+
+    status1 = hcsparseScsrsv_solve(handle, HCSPARSE_OPERATION_NON_TRANSPOSE, num_row, alpha,
+                                   descrA, csrValA, (int*)gCsrMat.rowOffsets,
+                                   (int*)gCsrMat.colIndices, info, X, Y);
+    if (status1 != HCSPARSE_STATUS_SUCCESS) {
+      std::cout << "Error csrsv_solve "<<std::endl;
+      return -1;
+    }
+
+    // The analysis is reused for the second column through csrsm
+    status1 = hcsparseScsrsm_solve(handle, HCSPARSE_OPERATION_NON_TRANSPOSE, num_row, nrhs - 1,
+                                   alpha, descrA, csrValA, (int*)gCsrMat.rowOffsets,
+                                   (int*)gCsrMat.colIndices, info, X + num_row, num_row,
+                                   Y + num_row, num_row);
+    if (status1 != HCSPARSE_STATUS_SUCCESS) {
+      std::cout << "Error csrsm_solve "<<std::endl;
+      return -1;
+    }
+
+    control.accl_view.copy(Y, host_Y, num_row * nrhs * sizeof(float));
+
+    bool ispassed = 1;
+
+    // Check L * y = alpha * x row by row
+    for (int k = 0; k < nrhs && ispassed; k++)
+    {
+        float *x = host_X + k * num_row;
+        float *y = host_Y + k * num_row;
+        for (int i = 0; i < num_row; i++)
+        {
+            float sum = 0;
+            for (int j = csr_rowPtr[i]; j < csr_rowPtr[i+1]; j++)
+                if (csr_colInd[j] <= i)
+                    sum += csr_val[j] * y[csr_colInd[j]];
+            float expected = host_alpha * x[i];
+            if (fabs(sum - expected) > 1e-3 * fabs(expected) + 1e-3)
+            {
+                std::cout << k << " " << i << " " << sum << " " << expected << std::endl;
+                ispassed = 0;
+                break;
+            }
+        }
+    }
+    std::cout << (ispassed?"TEST PASSED":"TEST FAILED") << std::endl;
+
+    hcsparseDestroySolveAnalysisInfo(info);
+
+    free(csr_rowPtr);
+    free(csr_colInd);
+    free(csr_val);
+    free(host_X);
+    free(host_Y);
+    am_free(csrValA);
+    am_free(alpha);
+    am_free(X);
+    am_free(Y);
+    am_free(gCsrMat.values);
+    am_free(gCsrMat.rowOffsets);
+    am_free(gCsrMat.colIndices);
+
+    return 0;
+}